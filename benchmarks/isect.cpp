@@ -0,0 +1,247 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+/*
+ * Microbenchmark of the batched intersection test (H5VL_logi_isect_batch)
+ * q query blocks are tested against n index blocks, as the metadata index does when searching for
+ * a read request. The index blocks are stored dimension-major, as in the compact index, and as an
+ * array of H5VL_logi_metasel_t, as in the list index. Every implementation the CPU supports is
+ * compared with testing the blocks one pair at a time (H5VL_logi_isect), the scheme used before.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+//
+#include <mpi.h>
+#include <unistd.h>
+//
+#include "H5VL_logi_isect.hpp"
+#include "H5VL_logi_meta.hpp"
+
+static const char *impl_names[] = {"scalar", "AVX2", "AVX-512"};
+
+// Number of hits of query block i, testing the blocks one pair at a time
+static size_t count_pair (int ndim,
+                          int nbox,
+                          hsize_t *qstart,
+                          hsize_t *qcount,
+                          std::vector<H5VL_logi_metasel_t> &sels) {
+    int k;
+    size_t nhit = 0;
+    hsize_t os[H5S_MAX_RANK], oc[H5S_MAX_RANK];
+
+    for (k = 0; k < nbox; k++) {
+        if (H5VL_logi_isect (ndim, sels[k].start, sels[k].count, qstart, qcount, os, oc)) {
+            nhit++;
+        }
+    }
+
+    return nhit;
+}
+
+// Number of hits of a query block, testing the blocks in batches
+static size_t count_batch (int ndim,
+                           int nbox,
+                           hsize_t *qstart,
+                           hsize_t *qend,
+                           const hsize_t *starts,
+                           const hsize_t *counts,
+                           size_t bstride,
+                           size_t dstride) {
+    int k;
+    size_t nhit = 0;
+    uint64_t mask;
+
+    for (k = 0; k < nbox; k += H5VL_LOGI_ISECT_BATCH) {
+        mask = H5VL_logi_isect_batch (ndim, qstart, qend, starts + k * bstride,
+                                      counts + k * bstride, bstride, dstride,
+                                      std::min (nbox - k, H5VL_LOGI_ISECT_BATCH));
+        while (mask) {
+            H5VL_logi_isect_next (mask);
+            nhit++;
+        }
+    }
+
+    return nhit;
+}
+
+/*----< usage() >------------------------------------------------------------*/
+static void usage (char *argv0) {
+    char *help = (char *)"Usage: %s [OPTION]\n\
+       [-h] Print this help message\n\
+       [-n] Number of index blocks (default 1000000)\n\
+       [-q] Number of query blocks (default 16)\n\
+       [-D] Number of dimensions (default 2)\n\
+       [-e] Size of the dataset along each dimension (default 4096)\n\
+       [-b] Maximal size of an index block along each dimension (default 64)\n\
+       [-w] Size of a query block along each dimension (default 256)\n\
+       [-r] Number of repeats (default 5)\n";
+    fprintf (stderr, help, argv0);
+}
+
+int main (int argc, char *argv[]) {
+    int i, j, k;
+    int opt;
+    int ndim     = 2;        // Number of dimensions
+    int nbox     = 1000000;  // Number of index blocks
+    int nq       = 16;       // Number of query blocks
+    int nrep     = 5;        // Number of repeats
+    int nerr     = 0;
+    hsize_t ext  = 4096;  // Size of the dataset along each dimension
+    hsize_t bmax = 64;    // Maximal size of an index block
+    hsize_t qw   = 256;   // Size of a query block
+    size_t nhit, nhit_pair, nhit_cur;
+    double t, tmin_pair = 1e30;
+    double tmin[3][2];
+    bool supported[3];
+    std::vector<H5VL_logi_metasel_t> sels;  // Array of blocks, as in the list index
+    std::vector<hsize_t> dm;                // Dimension-major blocks, as in the compact index
+    std::vector<hsize_t> qstart, qcount, qend;
+    H5VL_logi_isect_impl_t impl, impl_def;
+    std::mt19937_64 rng (0);
+
+    MPI_Init (&argc, &argv);
+
+    while ((opt = getopt (argc, argv, "hn:q:D:e:b:w:r:")) != -1) {
+        switch (opt) {
+            case 'n':
+                nbox = atoi (optarg);
+                break;
+            case 'q':
+                nq = atoi (optarg);
+                break;
+            case 'D':
+                ndim = atoi (optarg);
+                break;
+            case 'e':
+                ext = (hsize_t)atoll (optarg);
+                break;
+            case 'b':
+                bmax = (hsize_t)atoll (optarg);
+                break;
+            case 'w':
+                qw = (hsize_t)atoll (optarg);
+                break;
+            case 'r':
+                nrep = atoi (optarg);
+                break;
+            case 'h':
+            default:
+                usage (argv[0]);
+                MPI_Finalize ();
+                return 0;
+        }
+    }
+    if (nbox < 1 || nq < 1 || ndim < 1 || ndim > H5S_MAX_RANK || ext < 1 || bmax < 1 || qw < 1 ||
+        nrep < 1) {
+        usage (argv[0]);
+        MPI_Finalize ();
+        return 1;
+    }
+
+    // Random index blocks
+    sels.resize (nbox);
+    dm.resize ((size_t)nbox * ndim * 2);
+    for (k = 0; k < nbox; k++) {
+        for (j = 0; j < ndim; j++) {
+            sels[k].start[j] = rng () % ext;
+            sels[k].count[j] = rng () % bmax + 1;
+
+            dm[(size_t)j * nbox + k]                       = sels[k].start[j];
+            dm[(size_t)nbox * ndim + (size_t)j * nbox + k] = sels[k].count[j];
+        }
+    }
+
+    // Random query blocks
+    qstart.resize (nq * ndim);
+    qcount.resize (nq * ndim);
+    qend.resize (nq * ndim);
+    for (i = 0; i < nq; i++) {
+        for (j = 0; j < ndim; j++) {
+            qstart[i * ndim + j] = rng () % ext;
+            qcount[i * ndim + j] = qw;
+            qend[i * ndim + j]   = qstart[i * ndim + j] + qw;
+        }
+    }
+
+    // One pair at a time
+    for (k = 0; k < nrep; k++) {
+        t         = MPI_Wtime ();
+        nhit_pair = 0;
+        for (i = 0; i < nq; i++) {
+            nhit_pair += count_pair (ndim, nbox, qstart.data () + i * ndim,
+                                     qcount.data () + i * ndim, sels);
+        }
+        t = MPI_Wtime () - t;
+        if (t < tmin_pair) tmin_pair = t;
+    }
+
+    // Batches, dimension-major and gathered from the array of blocks
+    impl_def = H5VL_logi_isect_get_impl ();
+    for (impl = H5VL_LOGI_ISECT_SCALAR; impl <= H5VL_LOGI_ISECT_AVX512;
+         impl = (H5VL_logi_isect_impl_t)(impl + 1)) {
+        supported[impl] = H5VL_logi_isect_set_impl (impl);
+        if (!supported[impl]) continue;
+
+        for (j = 0; j < 2; j++) {
+            tmin[impl][j] = 1e30;
+            for (k = 0; k < nrep; k++) {
+                t    = MPI_Wtime ();
+                nhit = 0;
+                for (i = 0; i < nq; i++) {
+                    if (j == 0) {
+                        nhit_cur = count_batch (ndim, nbox, qstart.data () + i * ndim,
+                                                qend.data () + i * ndim, dm.data (),
+                                                dm.data () + (size_t)nbox * ndim, 1, nbox);
+                    } else {
+                        nhit_cur = count_batch (ndim, nbox, qstart.data () + i * ndim,
+                                                qend.data () + i * ndim, sels[0].start,
+                                                sels[0].count,
+                                                sizeof (H5VL_logi_metasel_t) / sizeof (hsize_t), 1);
+                    }
+                    nhit += nhit_cur;
+                }
+                t = MPI_Wtime () - t;
+                if (t < tmin[impl][j]) tmin[impl][j] = t;
+            }
+            if (nhit != nhit_pair) {
+                printf ("Error: %s kernel found %zu hits, expect %zu\n", impl_names[impl], nhit,
+                        nhit_pair);
+                nerr++;
+            }
+        }
+    }
+    H5VL_logi_isect_set_impl (impl_def);
+
+    printf ("Number of index blocks:  %d\n", nbox);
+    printf ("Number of query blocks:  %d\n", nq);
+    printf ("Number of dimensions:    %d\n", ndim);
+    printf ("Number of hits:          %zu\n", nhit_pair);
+    printf ("Default kernel:          %s\n", impl_names[impl_def]);
+    printf ("Pair time (min):         %lf s\n", tmin_pair);
+    for (impl = H5VL_LOGI_ISECT_SCALAR; impl <= H5VL_LOGI_ISECT_AVX512;
+         impl = (H5VL_logi_isect_impl_t)(impl + 1)) {
+        if (!supported[impl]) {
+            printf ("%-8s kernel:         not supported\n", impl_names[impl]);
+            continue;
+        }
+        printf ("%-8s dim-major (min): %lf s, speedup %.2lf\n", impl_names[impl], tmin[impl][0],
+                tmin_pair / tmin[impl][0]);
+        printf ("%-8s gathered (min):  %lf s, speedup %.2lf\n", impl_names[impl], tmin[impl][1],
+                tmin_pair / tmin[impl][1]);
+    }
+
+    MPI_Finalize ();
+
+    return nerr > 0;
+}
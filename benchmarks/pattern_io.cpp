@@ -0,0 +1,580 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+/*
+ * Write and read benchmark of the Log VOL connector on decompositions modeled after E3SM and WRF.
+ * Every process writes nvar variables through H5Dwrite_n, flushes, closes the file, then opens it
+ * again and reads the variables back through H5Dread_n. The run is repeated for every combination
+ * of the connector settings given on the command line. One line is printed per combination with
+ * the bandwidth and the time of each phase, taking the slowest process.
+ *
+ * Patterns:
+ *   block1d  - 1-D array, every process writes a contiguous block
+ *   block2d  - 2-D array divided into b x b tiles dealt block-cyclically over a 2-D process grid
+ *   block3d  - 3-D array divided into b x b x b tiles dealt block-cyclically over a 3-D process grid
+ *   unstruct - 1-D array cut into segments of random length dealt randomly to the processes, as in
+ *              the unstructured mesh decompositions of E3SM
+ *   record   - 2-D array with an unlimited record dimension, every process writes a contiguous
+ *              block of each record and the dataset is extended before each record, as in WRF
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+//
+#include <getopt.h>
+#include <hdf5.h>
+#include <mpi.h>
+//
+#include "H5VL_log.h"
+
+#define CHECK_HERR(A)                                                              \
+    {                                                                              \
+        if ((A) < 0) {                                                             \
+            printf ("Error at line %d in %s: %s failed\n", __LINE__, __FILE__, #A); \
+            MPI_Abort (MPI_COMM_WORLD, -1);                                        \
+        }                                                                          \
+    }
+
+// Selection of a process, the blocks of one record
+typedef struct pattern_t {
+    int ndim;                     // Number of dimensions of the datasets
+    bool rec;                     // Has a record dimension
+    hsize_t dims[3];              // Dataset size, one record for record variables
+    std::vector<hsize_t> starts;  // Start of each block, ndim values per block
+    std::vector<hsize_t> counts;  // Size of each block, ndim values per block
+    size_t nelem;                 // Number of elements selected
+} pattern_t;
+
+// One combination of connector settings
+typedef struct config_t {
+    int merge;
+    int share;
+    int zip;
+    int encoding;   // H5VL_log_sel_encoding_t
+    int nsubfiles;  // 0: off, -1: one per node
+    int idx;        // 0: compact, 1: list
+    ssize_t bsize;  // Write buffer size, -1 for unlimited
+} config_t;
+
+enum { PHASE_CREATE = 0, PHASE_WRITE, PHASE_FLUSH, PHASE_CLOSE, PHASE_OPEN, PHASE_READ, NPHASE };
+static const char *phase_name[NPHASE] = {"create", "write", "flush", "close", "open", "read"};
+static const char *encoding_name[]     = {"offset", "canonical", "varint"};
+
+/*----< usage() >------------------------------------------------------------*/
+static void usage (char *argv0) {
+    char *help = (char *)"Usage: %s [OPTION]\n\
+       [-h] Print this help message\n\
+       [-p] Pattern, block1d, block2d, block3d, unstruct, or record (default block2d)\n\
+       [-n] Number of elements written by each process per variable and record (default 1048576)\n\
+       [-b] Tile size of block2d and block3d, maximal segment length of unstruct (default 16)\n\
+       [-v] Number of variables (default 4)\n\
+       [-r] Number of records of the record pattern (default 4)\n\
+       [-o] Output file path (default pattern_io.h5)\n\
+       [-P] Write the profiling report of the connector after each phase to this path,\n\
+            %%s is replaced by the file name\n\
+       [-k] Keep the output file\n\
+       Connector settings, each takes a comma separated list of values to sweep:\n\
+       [--merge]     Metadata merging, 0 or 1 (default 0)\n\
+       [--share]     Metadata deduplication, 0 or 1 (default 0)\n\
+       [--zip]       Metadata compression, 0 or 1 (default 0)\n\
+       [--encoding]  Selection encoding, offset, canonical, or varint (default offset)\n\
+       [--subfiling] Number of subfiles, 0 disables, -1 for one per node (default 0)\n\
+       [--index]     Metadata index type, compact or list (default compact)\n\
+       [--buffer]    Write buffer size in bytes, -1 for unlimited (default -1)\n";
+    fprintf (stderr, help, argv0);
+}
+
+// Split a comma separated list of integers, names in alt map to their position
+static std::vector<long long> parse_list (const char *str, std::vector<std::string> alt) {
+    size_t i;
+    std::vector<long long> ret;
+    std::string s (str), tok;
+    size_t pos = 0, next;
+
+    while (pos <= s.size ()) {
+        next = s.find (',', pos);
+        if (next == std::string::npos) { next = s.size (); }
+        tok = s.substr (pos, next - pos);
+        for (i = 0; i < alt.size (); i++) {
+            if (tok == alt[i]) break;
+        }
+        ret.push_back (i < alt.size () ? (long long)i : atoll (tok.c_str ()));
+        pos = next + 1;
+    }
+
+    return ret;
+}
+
+// Blocks of an ndim array divided into b^ndim tiles dealt cyclically over a process grid
+static void gen_block_cyclic (int rank, int np, size_t n, int b, pattern_t &pat) {
+    int i, j;
+    int pdims[3] = {0, 0, 0}, pc[3];
+    size_t nb;  // Tiles per process along each dimension
+    size_t ntile, k, t;
+    size_t tc[3];  // Tile coordinate among the tiles of the process
+    int ndim = pat.ndim;
+
+    MPI_Dims_create (np, ndim, pdims);
+    for (i = ndim - 1, j = rank; i >= 0; i--) {
+        pc[i] = j % pdims[i];
+        j /= pdims[i];
+    }
+
+    nb = (size_t)(std::round (std::pow ((double)n / std::pow ((double)b, ndim), 1.0 / ndim)));
+    if (nb < 1) { nb = 1; }
+
+    ntile = 1;
+    for (i = 0; i < ndim; i++) {
+        pat.dims[i] = pdims[i] * nb * b;
+        ntile *= nb;
+    }
+
+    for (k = 0; k < ntile; k++) {
+        for (i = ndim - 1, t = k; i >= 0; i--) {
+            tc[i] = t % nb;
+            t /= nb;
+        }
+        for (i = 0; i < ndim; i++) {
+            pat.starts.push_back ((tc[i] * pdims[i] + pc[i]) * b);
+            pat.counts.push_back (b);
+        }
+    }
+    pat.nelem = ntile;
+    for (i = 0; i < ndim; i++) { pat.nelem *= b; }
+}
+
+// Segments of random length in [1, b] dealt randomly, every process draws the same sequence
+static void gen_unstruct (int rank, int np, size_t n, int b, pattern_t &pat) {
+    hsize_t off = 0, len;
+    std::mt19937_64 rng (12345);
+
+    pat.dims[0] = (hsize_t)n * np;
+    pat.nelem   = 0;
+    while (off < pat.dims[0]) {
+        len = rng () % b + 1;
+        if (off + len > pat.dims[0]) { len = pat.dims[0] - off; }
+        if ((int)(rng () % np) == rank) {
+            pat.starts.push_back (off);
+            pat.counts.push_back (len);
+            pat.nelem += len;
+        }
+        off += len;
+    }
+}
+
+static void gen_pattern (std::string &name, int rank, int np, size_t n, int b, pattern_t &pat) {
+    pat.rec = false;
+    if (name == "block1d") {
+        pat.ndim    = 1;
+        pat.dims[0] = (hsize_t)n * np;
+        pat.starts.push_back ((hsize_t)n * rank);
+        pat.counts.push_back (n);
+        pat.nelem = n;
+    } else if (name == "block2d") {
+        pat.ndim = 2;
+        gen_block_cyclic (rank, np, n, b, pat);
+    } else if (name == "block3d") {
+        pat.ndim = 3;
+        gen_block_cyclic (rank, np, n, b, pat);
+    } else if (name == "unstruct") {
+        pat.ndim = 1;
+        gen_unstruct (rank, np, n, b, pat);
+    } else if (name == "record") {
+        pat.ndim    = 2;
+        pat.rec     = true;
+        pat.dims[0] = 1;
+        pat.dims[1] = (hsize_t)n * np;
+        pat.starts.push_back (0);
+        pat.starts.push_back ((hsize_t)n * rank);
+        pat.counts.push_back (1);
+        pat.counts.push_back (n);
+        pat.nelem = n;
+    } else {
+        if (rank == 0) { printf ("Unknown pattern %s\n", name.c_str ()); }
+        MPI_Abort (MPI_COMM_WORLD, -1);
+    }
+}
+
+// Fill buf with the value of every selected element, the global linear index times nvar plus v
+static void fill_buf (pattern_t &pat, hsize_t rec, int v, int nvar, long long *buf) {
+    int i;
+    size_t j, k, nblock = pat.counts.size () / pat.ndim;
+    hsize_t *start, *count;
+    hsize_t cord[3], lin;
+
+    for (j = 0; j < nblock; j++) {
+        start = pat.starts.data () + j * pat.ndim;
+        count = pat.counts.data () + j * pat.ndim;
+        for (i = 0; i < pat.ndim; i++) { cord[i] = 0; }
+        for (k = 0;; k++) {
+            lin = 0;
+            for (i = 0; i < pat.ndim; i++) {
+                lin = lin * pat.dims[i] + start[i] + cord[i] + ((pat.rec && i == 0) ? rec : 0);
+            }
+            *(buf++) = (long long)lin * nvar + v;
+
+            // Next element in the block, row major
+            for (i = pat.ndim - 1; i >= 0; i--) {
+                if (++cord[i] < count[i]) break;
+                cord[i] = 0;
+            }
+            if (i < 0) break;
+        }
+    }
+}
+
+static hid_t make_fapl (hid_t vlid, config_t &cfg) {
+    herr_t err;
+    hid_t faplid;
+
+    faplid = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_HERR (faplid)
+    err = H5Pset_fapl_mpio (faplid, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_HERR (err)
+    err = H5Pset_all_coll_metadata_ops (faplid, 1);
+    CHECK_HERR (err)
+    err = H5Pset_coll_metadata_write (faplid, 1);
+    CHECK_HERR (err)
+    err = H5Pset_vol (faplid, vlid, NULL);
+    CHECK_HERR (err)
+    err = H5Pset_meta_merge (faplid, cfg.merge);
+    CHECK_HERR (err)
+    err = H5Pset_meta_share (faplid, cfg.share);
+    CHECK_HERR (err)
+    err = H5Pset_meta_zip (faplid, cfg.zip);
+    CHECK_HERR (err)
+    err = H5Pset_sel_encoding (faplid, (H5VL_log_sel_encoding_t)cfg.encoding);
+    CHECK_HERR (err)
+    err = H5Pset_nb_buffer_size (faplid, cfg.bsize);
+    CHECK_HERR (err)
+
+    // The index type can only be chosen through the environment
+    setenv ("H5VL_LOG_INDEX_TYPE", cfg.idx ? "list" : "compact", 1);
+
+    return faplid;
+}
+
+// Run one configuration, return the number of mismatched elements
+static int run (hid_t vlid,
+                const char *path,
+                const char *prof,
+                pattern_t &pat,
+                int nvar,
+                int nrec,
+                config_t &cfg,
+                double *t,
+                size_t *mdsize) {
+    herr_t err;
+    int i, v, r;
+    int nerrs = 0;
+    hid_t faplid, fcplid, dcplid, sid, fid;
+    std::vector<hid_t> dids (nvar);
+    size_t nblock = pat.counts.size () / pat.ndim;
+    hsize_t dims[3], mdims[3], chunk[3];
+    std::vector<hsize_t *> starts (nblock), counts (nblock);
+    std::vector<hsize_t> rstarts (pat.starts);
+    std::vector<long long> wbuf (pat.nelem * nvar), rbuf (pat.nelem * nvar);
+    char name[32];
+    double t0;
+    H5VL_log_io_stat_t stat;
+
+    for (i = 0; i < NPHASE; i++) { t[i] = 0; }
+    for (size_t j = 0; j < nblock; j++) {
+        starts[j] = rstarts.data () + j * pat.ndim;
+        counts[j] = pat.counts.data () + j * pat.ndim;
+    }
+    for (i = 0; i < pat.ndim; i++) {
+        dims[i]  = pat.dims[i];
+        mdims[i] = pat.dims[i];
+        chunk[i] = pat.dims[i];
+    }
+    if (pat.rec) {
+        dims[0]  = 0;
+        mdims[0] = H5S_UNLIMITED;
+        chunk[0] = 1;
+    }
+
+    faplid = make_fapl (vlid, cfg);
+    fcplid = H5Pcreate (H5P_FILE_CREATE);
+    CHECK_HERR (fcplid)
+    err = H5Pset_subfiling (fcplid, cfg.nsubfiles);
+    CHECK_HERR (err)
+
+    // Create the file and the variables
+    MPI_Barrier (MPI_COMM_WORLD);
+    t0  = MPI_Wtime ();
+    fid = H5Fcreate (path, H5F_ACC_TRUNC, fcplid, faplid);
+    CHECK_HERR (fid)
+    sid = H5Screate_simple (pat.ndim, dims, mdims);
+    CHECK_HERR (sid)
+    dcplid = H5Pcreate (H5P_DATASET_CREATE);
+    CHECK_HERR (dcplid)
+    if (pat.rec) {
+        err = H5Pset_chunk (dcplid, pat.ndim, chunk);
+        CHECK_HERR (err)
+    }
+    for (v = 0; v < nvar; v++) {
+        sprintf (name, "var%d", v);
+        dids[v] = H5Dcreate2 (fid, name, H5T_NATIVE_LLONG, sid, H5P_DEFAULT, dcplid, H5P_DEFAULT);
+        CHECK_HERR (dids[v])
+    }
+    t[PHASE_CREATE] = MPI_Wtime () - t0;
+
+    for (r = 0; r < nrec; r++) {
+        // Move the selection to the current record and extend the variables
+        if (pat.rec) {
+            for (size_t j = 0; j < nblock; j++) { starts[j][0] = r; }
+            dims[0] = r + 1;
+        }
+
+        MPI_Barrier (MPI_COMM_WORLD);
+        t0 = MPI_Wtime ();
+        for (v = 0; v < nvar; v++) {
+            fill_buf (pat, r, v, nvar, wbuf.data () + pat.nelem * v);
+            if (pat.rec) {
+                err = H5Dset_extent (dids[v], dims);
+                CHECK_HERR (err)
+            }
+            err = H5Dwrite_n (dids[v], H5T_NATIVE_LLONG, (int)nblock, starts.data (),
+                              counts.data (), H5P_DEFAULT, wbuf.data () + pat.nelem * v);
+            CHECK_HERR (err)
+        }
+        t[PHASE_WRITE] += MPI_Wtime () - t0;
+
+        MPI_Barrier (MPI_COMM_WORLD);
+        t0  = MPI_Wtime ();
+        err = H5Fflush (fid, H5F_SCOPE_GLOBAL);
+        CHECK_HERR (err)
+        t[PHASE_FLUSH] += MPI_Wtime () - t0;
+    }
+
+    if (prof) {
+        err = H5Fprofile_report (fid, prof);
+        CHECK_HERR (err)
+    }
+
+    MPI_Barrier (MPI_COMM_WORLD);
+    t0 = MPI_Wtime ();
+    for (v = 0; v < nvar; v++) {
+        err = H5Dclose (dids[v]);
+        CHECK_HERR (err)
+    }
+    err = H5Fget_io_stat (fid, &stat);
+    CHECK_HERR (err)
+    err = H5Fclose (fid);
+    CHECK_HERR (err)
+    t[PHASE_CLOSE] = MPI_Wtime () - t0;
+    *mdsize        = stat.meta_bytes_written + stat.pending_meta_bytes;
+
+    // Open the file and read the variables back
+    MPI_Barrier (MPI_COMM_WORLD);
+    t0  = MPI_Wtime ();
+    fid = H5Fopen (path, H5F_ACC_RDONLY, faplid);
+    CHECK_HERR (fid)
+    for (v = 0; v < nvar; v++) {
+        sprintf (name, "var%d", v);
+        dids[v] = H5Dopen2 (fid, name, H5P_DEFAULT);
+        CHECK_HERR (dids[v])
+    }
+    t[PHASE_OPEN] = MPI_Wtime () - t0;
+
+    for (r = 0; r < nrec; r++) {
+        if (pat.rec) {
+            for (size_t j = 0; j < nblock; j++) { starts[j][0] = r; }
+        }
+
+        MPI_Barrier (MPI_COMM_WORLD);
+        t0 = MPI_Wtime ();
+        for (v = 0; v < nvar; v++) {
+            err = H5Dread_n (dids[v], H5T_NATIVE_LLONG, (int)nblock, starts.data (),
+                             counts.data (), H5P_DEFAULT, rbuf.data () + pat.nelem * v);
+            CHECK_HERR (err)
+        }
+        t[PHASE_READ] += MPI_Wtime () - t0;
+
+        for (v = 0; v < nvar; v++) {
+            fill_buf (pat, r, v, nvar, wbuf.data () + pat.nelem * v);
+        }
+        for (size_t j = 0; j < wbuf.size (); j++) {
+            if (wbuf[j] != rbuf[j]) { nerrs++; }
+        }
+    }
+
+    if (prof) {
+        err = H5Fprofile_report (fid, prof);
+        CHECK_HERR (err)
+    }
+
+    for (v = 0; v < nvar; v++) {
+        err = H5Dclose (dids[v]);
+        CHECK_HERR (err)
+    }
+    err = H5Fclose (fid);
+    CHECK_HERR (err)
+    H5Sclose (sid);
+    H5Pclose (dcplid);
+    H5Pclose (fcplid);
+    H5Pclose (faplid);
+
+    return nerrs;
+}
+
+int main (int argc, char *argv[]) {
+    int i, opt;
+    int rank, np;
+    int nerrs = 0, err_all;
+    std::string pname = "block2d";
+    size_t n          = 1048576;
+    int b = 16, nvar = 4, nrec = 4;
+    bool keep        = false;
+    const char *path = "pattern_io.h5";
+    const char *prof = NULL;
+    std::vector<std::vector<long long>> knobs = {{0}, {0}, {0}, {0}, {0}, {0}, {-1}};
+    std::vector<size_t> pos (knobs.size (), 0);
+    hid_t vlid;
+    pattern_t pat;
+    config_t cfg;
+    double t[NPHASE], tmax[NPHASE];
+    size_t mdsize, mdsize_all;
+    double wsize;  // Total data size of all processes in MiB
+    struct option longopts[] = {{"merge", required_argument, NULL, 0},
+                                {"share", required_argument, NULL, 1},
+                                {"zip", required_argument, NULL, 2},
+                                {"encoding", required_argument, NULL, 3},
+                                {"subfiling", required_argument, NULL, 4},
+                                {"index", required_argument, NULL, 5},
+                                {"buffer", required_argument, NULL, 6},
+                                {0, 0, 0, 0}};
+
+    MPI_Init (&argc, &argv);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+
+    while ((opt = getopt_long (argc, argv, "hp:n:b:v:r:o:P:k", longopts, NULL)) != -1) {
+        switch (opt) {
+            case 0:
+            case 1:
+            case 2:
+            case 6:
+                knobs[opt] = parse_list (optarg, {});
+                break;
+            case 3:
+                knobs[opt] = parse_list (optarg, {"offset", "canonical", "varint"});
+                break;
+            case 4:
+                knobs[opt] = parse_list (optarg, {});
+                break;
+            case 5:
+                knobs[opt] = parse_list (optarg, {"compact", "list"});
+                break;
+            case 'p':
+                pname = optarg;
+                break;
+            case 'n':
+                n = strtoull (optarg, NULL, 10);
+                break;
+            case 'b':
+                b = atoi (optarg);
+                break;
+            case 'v':
+                nvar = atoi (optarg);
+                break;
+            case 'r':
+                nrec = atoi (optarg);
+                break;
+            case 'o':
+                path = optarg;
+                break;
+            case 'P':
+                prof = optarg;
+                break;
+            case 'k':
+                keep = true;
+                break;
+            case 'h':
+            default:
+                if (rank == 0) { usage (argv[0]); }
+                MPI_Finalize ();
+                return 0;
+        }
+    }
+    if (n < 1 || b < 1 || nvar < 1 || nrec < 1) {
+        if (rank == 0) { usage (argv[0]); }
+        MPI_Finalize ();
+        return 1;
+    }
+
+    gen_pattern (pname, rank, np, n, b, pat);
+    if (!pat.rec) { nrec = 1; }
+
+    wsize = (double)pat.nelem * sizeof (long long) * nvar * nrec;
+    MPI_Allreduce (MPI_IN_PLACE, &wsize, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    wsize /= 1048576;
+
+    if (rank == 0) {
+        printf ("Pattern: %s, processes: %d, variables: %d, records: %d, total size: %.2lf MiB\n",
+                pname.c_str (), np, nvar, nrec, wsize);
+        printf ("merge,share,zip,encoding,subfiling,index,buffer,metadata_MiB,write_MiB/s,"
+                "read_MiB/s");
+        for (i = 0; i < NPHASE; i++) { printf (",%s_s", phase_name[i]); }
+        printf ("\n");
+    }
+
+    vlid = H5VL_log_register ();
+    CHECK_HERR (vlid)
+
+    // Iterate over every combination of the settings
+    while (true) {
+        cfg.merge     = (int)knobs[0][pos[0]];
+        cfg.share     = (int)knobs[1][pos[1]];
+        cfg.zip       = (int)knobs[2][pos[2]];
+        cfg.encoding  = (int)knobs[3][pos[3]];
+        cfg.nsubfiles = (int)knobs[4][pos[4]];
+        cfg.idx       = (int)knobs[5][pos[5]];
+        cfg.bsize     = (ssize_t)knobs[6][pos[6]];
+
+        nerrs += run (vlid, path, prof, pat, nvar, nrec, cfg, t, &mdsize);
+
+        MPI_Reduce (t, tmax, NPHASE, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce (&mdsize, &mdsize_all, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            printf ("%d,%d,%d,%s,%d,%s,%zd,%.3lf,%.2lf,%.2lf", cfg.merge, cfg.share, cfg.zip,
+                    encoding_name[cfg.encoding], cfg.nsubfiles,
+                    cfg.idx ? "list" : "compact", cfg.bsize, (double)mdsize_all / 1048576,
+                    wsize / (tmax[PHASE_WRITE] + tmax[PHASE_FLUSH] + tmax[PHASE_CLOSE]),
+                    wsize / (tmax[PHASE_OPEN] + tmax[PHASE_READ]));
+            for (i = 0; i < NPHASE; i++) { printf (",%.4lf", tmax[i]); }
+            printf ("\n");
+            fflush (stdout);
+        }
+
+        for (i = 0; i < (int)knobs.size (); i++) {
+            if (++pos[i] < knobs[i].size ()) break;
+            pos[i] = 0;
+        }
+        if (i == (int)knobs.size ()) break;
+    }
+
+    H5VLclose (vlid);
+
+    if (!keep && rank == 0) { remove (path); }
+
+    MPI_Allreduce (&nerrs, &err_all, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0 && err_all) { printf ("Mismatched elements: %d\n", err_all); }
+
+    MPI_Finalize ();
+
+    return err_all > 0 ? 1 : 0;
+}
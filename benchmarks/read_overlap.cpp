@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+/*
+ * Regression benchmark of overlap resolution in read datatype generation
+ * (H5VL_log_dataseti_resolve_overlaps). n contiguous sections are placed at random offsets of a
+ * small file region so that most of them overlap, as when many log entries cover the same part of
+ * a dataset. The resolved reads and memory copies are replayed against a synthetic file image to
+ * verify every section receives the right bytes.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+//
+#include <mpi.h>
+#include <unistd.h>
+//
+#include "H5VL_log_dataseti.hpp"
+
+/*----< usage() >------------------------------------------------------------*/
+static void usage (char *argv0) {
+    char *help = (char *)"Usage: %s [OPTION]\n\
+       [-h] Print this help message\n\
+       [-n] Number of sections (default 200000)\n\
+       [-l] Length of each section in bytes (default 64)\n\
+       [-s] Size of the file region the sections are placed in (default 65536)\n\
+       [-r] Number of repeats (default 3)\n";
+    fprintf (stderr, help, argv0);
+}
+
+int main (int argc, char *argv[]) {
+    int i, j;
+    int opt;
+    int nerrs = 0;
+    int n     = 200000;  // Number of sections
+    int len   = 64;      // Section length
+    int fsize = 65536;   // Size of the file region
+    int nrep  = 3;       // Number of repeats
+    std::vector<char> fbuf;             // Synthetic file image
+    std::vector<char> mbuf;             // Destination memory of all sections
+    std::vector<MPI_Aint> foff0;        // Original file offset of each section
+    std::vector<MPI_Aint> foffs, moffs;  // Sections to resolve
+    std::vector<int> lens;
+    std::vector<H5VL_log_copy_ctx> overlaps;
+    double t, tmin = 1e30, tsum = 0;  // Timing
+    size_t nread;                     // Bytes left to read after resolution
+    std::mt19937 rng (0);
+
+    MPI_Init (&argc, &argv);
+
+    while ((opt = getopt (argc, argv, "hn:l:s:r:")) != -1) {
+        switch (opt) {
+            case 'n':
+                n = atoi (optarg);
+                break;
+            case 'l':
+                len = atoi (optarg);
+                break;
+            case 's':
+                fsize = atoi (optarg);
+                break;
+            case 'r':
+                nrep = atoi (optarg);
+                break;
+            case 'h':
+            default:
+                usage (argv[0]);
+                MPI_Finalize ();
+                return 0;
+        }
+    }
+    if (n < 1 || len < 1 || fsize <= len || nrep < 1) {
+        usage (argv[0]);
+        MPI_Finalize ();
+        return 1;
+    }
+
+    fbuf.resize (fsize);
+    for (i = 0; i < fsize; i++) { fbuf[i] = (char)rng (); }
+    mbuf.resize ((size_t)n * len);
+    foff0.resize (n);
+    for (i = 0; i < n; i++) { foff0[i] = rng () % (fsize - len); }
+
+    for (j = 0; j < nrep; j++) {
+        foffs = foff0;
+        moffs.resize (n);
+        lens.assign (n, len);
+        for (i = 0; i < n; i++) { moffs[i] = (MPI_Aint) (mbuf.data () + (size_t)i * len); }
+        overlaps.clear ();
+
+        t = MPI_Wtime ();
+        H5VL_log_dataseti_resolve_overlaps (n, foffs.data (), moffs.data (), lens.data (),
+                                            overlaps);
+        t = MPI_Wtime () - t;
+
+        tsum += t;
+        if (t < tmin) tmin = t;
+    }
+
+    // Replay the reads and the copies, then check the result
+    memset (mbuf.data (), 0, mbuf.size ());
+    nread = 0;
+    for (i = 0; i < n; i++) {
+        if (lens[i] > 0) {
+            memcpy ((char *)moffs[i], fbuf.data () + foffs[i], lens[i]);
+            nread += lens[i];
+        }
+    }
+    for (auto &o : overlaps) { memcpy (o.dst, o.src, o.size); }
+    for (i = 0; i < n; i++) {
+        if (memcmp (mbuf.data () + (size_t)i * len, fbuf.data () + foff0[i], len)) { nerrs++; }
+    }
+
+    printf ("Number of sections:       %d\n", n);
+    printf ("Section length:           %d\n", len);
+    printf ("File region size:         %d\n", fsize);
+    printf ("Overlap copies:           %zu\n", overlaps.size ());
+    printf ("Bytes left to read:       %zu\n", nread);
+    printf ("Resolve time (min):       %lf s\n", tmin);
+    printf ("Resolve time (mean):      %lf s\n", tsum / nrep);
+    printf ("Mismatched sections:      %d\n", nerrs);
+
+    MPI_Finalize ();
+
+    return nerrs > 0 ? 1 : 0;
+}
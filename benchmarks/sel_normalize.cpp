@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+/*
+ * Microbenchmark of selection normalization (H5VL_log_selections (hid_t))
+ * A dataspace is selected with n scattered points or blocks in random order, then the time to
+ * convert the selection into sorted and coalesced start/count lists is reported.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+//
+#include <hdf5.h>
+#include <mpi.h>
+#include <unistd.h>
+//
+#include "H5VL_logi_dataspace.hpp"
+
+/*----< usage() >------------------------------------------------------------*/
+static void usage (char *argv0) {
+    char *help = (char *)"Usage: %s [OPTION]\n\
+       [-h] Print this help message\n\
+       [-n] Number of points or blocks to select (default 1000000)\n\
+       [-b] Select hyperslab blocks instead of points\n\
+       [-k] Length of each hyperslab block along the last dimension (default 2)\n\
+       [-d] Number of dimensions, 1 to 3 (default 2)\n\
+       [-r] Number of repeats (default 5)\n";
+    fprintf (stderr, help, argv0);
+}
+
+int main (int argc, char *argv[]) {
+    herr_t err = 0;
+    int i, j;
+    int opt;
+    int ndim    = 2;        // Number of dimensions
+    int nrep    = 5;        // Number of repeats
+    int blen    = 2;        // Block length along the last dimension
+    bool hyper  = false;    // Select blocks instead of points
+    hsize_t n   = 1000000;  // Number of points or blocks
+    hsize_t ncell;          // Number of candidate cells
+    hsize_t dims[3];        // Dataspace size
+    hsize_t start[3], count[3];
+    hid_t sid = -1;                   // Dataspace
+    std::vector<hsize_t> cells;       // Linearized cell offsets
+    std::vector<hsize_t> cords;       // Point coordinates
+    double t, tmin = 1e30, tsum = 0;  // Timing
+    int nsel = 0;                     // Number of blocks after normalization
+    std::mt19937_64 rng (0);
+
+    MPI_Init (&argc, &argv);
+
+    while ((opt = getopt (argc, argv, "hbn:k:d:r:")) != -1) {
+        switch (opt) {
+            case 'b':
+                hyper = true;
+                break;
+            case 'n':
+                n = (hsize_t)atoll (optarg);
+                break;
+            case 'k':
+                blen = atoi (optarg);
+                break;
+            case 'd':
+                ndim = atoi (optarg);
+                break;
+            case 'r':
+                nrep = atoi (optarg);
+                break;
+            case 'h':
+            default:
+                usage (argv[0]);
+                MPI_Finalize ();
+                return 0;
+        }
+    }
+    if (ndim < 1 || ndim > 3 || n == 0 || blen < 1 || nrep < 1) {
+        usage (argv[0]);
+        MPI_Finalize ();
+        return 1;
+    }
+
+    // Dataspace about 4 times the number of cells selected, blocks are separated by a gap
+    for (i = 0; i < ndim; i++) { dims[i] = 1; }
+    ncell = n * 4;
+    for (i = ndim - 1; i > 0; i--) {
+        dims[i] = 64;
+        ncell   = (ncell + 63) / 64;
+    }
+    dims[0] = ncell;
+    if (hyper) { dims[ndim - 1] *= (hsize_t) (blen + 1); }
+
+    sid = H5Screate_simple (ndim, dims, NULL);
+    if (sid < 0) {
+        err = -1;
+        goto err_out;
+    }
+
+    // Pick n distinct cells in random order
+    ncell = 1;
+    for (i = 0; i < ndim; i++) { ncell *= dims[i]; }
+    if (hyper) { ncell /= (hsize_t) (blen + 1); }
+    cells.resize (ncell);
+    for (hsize_t c = 0; c < ncell; c++) { cells[c] = c; }
+    std::shuffle (cells.begin (), cells.end (), rng);
+    cells.resize (n);
+
+    if (hyper) {
+        hsize_t ncol = dims[ndim - 1] / (blen + 1);
+
+        // HDF5 builds span trees for unions of blocks, keep the default size moderate for -b
+        for (i = 0; i < ndim; i++) { count[i] = 1; }
+        count[ndim - 1] = blen;
+        for (hsize_t c = 0; c < n; c++) {
+            hsize_t off = cells[c];
+
+            start[ndim - 1] = (off % ncol) * (blen + 1);
+            off /= ncol;
+            for (j = ndim - 2; j >= 0; j--) {
+                start[j] = off % dims[j];
+                off /= dims[j];
+            }
+            err = H5Sselect_hyperslab (sid, c ? H5S_SELECT_OR : H5S_SELECT_SET, start, NULL,
+                                       count, NULL);
+            if (err < 0) goto err_out;
+        }
+    } else {
+        cords.resize (n * ndim);
+        for (hsize_t c = 0; c < n; c++) {
+            hsize_t off = cells[c];
+
+            for (j = ndim - 1; j >= 0; j--) {
+                cords[c * ndim + j] = off % dims[j];
+                off /= dims[j];
+            }
+        }
+        err = H5Sselect_elements (sid, H5S_SELECT_SET, n, cords.data ());
+        if (err < 0) goto err_out;
+    }
+
+    for (i = 0; i < nrep; i++) {
+        t = MPI_Wtime ();
+        H5VL_log_selections sel (sid);
+        t = MPI_Wtime () - t;
+
+        nsel = sel.nsel;
+        tsum += t;
+        if (t < tmin) tmin = t;
+    }
+
+    printf ("Selection type:        %s\n", hyper ? "hyperslab" : "points");
+    printf ("Number of dimensions:  %d\n", ndim);
+    printf ("Selected %s:       %llu\n", hyper ? "blocks" : "points", (unsigned long long)n);
+    printf ("Normalized blocks:     %d\n", nsel);
+    printf ("Normalize time (min):  %lf s\n", tmin);
+    printf ("Normalize time (mean): %lf s\n", tsum / nrep);
+    printf ("Throughput (min):      %lf M blocks/s\n", (double)n / tmin / 1e6);
+
+err_out:
+    if (sid >= 0) H5Sclose (sid);
+
+    MPI_Finalize ();
+
+    return err < 0 ? 1 : 0;
+}
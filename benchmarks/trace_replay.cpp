@@ -0,0 +1,470 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+/*
+ * Replay an I/O trace recorded by the Log VOL connector (see H5VL_LOG_TRACE in doc/usage.md)
+ * against the connector with synthetic data. Every process reads the trace of its rank and repeats
+ * the dataset writes, reads, extensions, and flushes in the recorded order. Datasets are created
+ * with the sizes and element sizes in the trace; no names or data of the original application are
+ * needed. The connector settings are taken from the H5VL_LOG_* environment variables, so the same
+ * trace can be replayed under different settings. One summary is printed with the number of calls,
+ * the amount of data, and the time of each phase, taking the slowest process.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+//
+#include <hdf5.h>
+#include <mpi.h>
+#include <unistd.h>
+//
+#include "H5VL_log.h"
+#include "H5VL_logi_trace.hpp"
+
+#define CHECK_HERR(A)                                                              \
+    {                                                                              \
+        if ((A) < 0) {                                                             \
+            printf ("Error at line %d in %s: %s failed\n", __LINE__, __FILE__, #A); \
+            MPI_Abort (MPI_COMM_WORLD, -1);                                        \
+        }                                                                          \
+    }
+
+// Dataset definition in the trace
+typedef struct dset_t {
+    int ndim;
+    size_t esize;
+    std::vector<hsize_t> dims;   // Size when the dataset first appears in the trace
+    std::vector<hsize_t> mdims;  // Maximal size
+} dset_t;
+
+// One replayed call
+typedef struct op_t {
+    int type;
+    double time;
+    int did;
+    int flag;
+    int nsel;
+    size_t nelem;              // Number of elements selected
+    std::vector<hsize_t> sel;  // Start and count of each block, or the new size of EXTENT
+} op_t;
+
+enum { PHASE_CREATE = 0, PHASE_WRITE, PHASE_READ, PHASE_EXTENT, PHASE_FLUSH, PHASE_CLOSE, NPHASE };
+static const char *phase_name[NPHASE] = {"create", "write", "read", "extent", "flush", "close"};
+
+/*----< usage() >------------------------------------------------------------*/
+static void usage (char *argv0) {
+    char *help = (char *)"Usage: %s [OPTION]\n\
+       [-h] Print this help message\n\
+       [-i] Trace path prefix, process i reads <prefix>.<i> (required)\n\
+       [-o] Output file path (default trace_replay.h5)\n\
+       [-t] Keep the recorded time between calls\n\
+       [-k] Keep the output file\n\
+       Connector settings are taken from the H5VL_LOG_* environment variables\n";
+    fprintf (stderr, help, argv0);
+}
+
+// Cursor over the trace of this process
+typedef struct trace_buf_t {
+    std::vector<char> data;
+    size_t off;
+
+    void get (void *buf, size_t size) {
+        if (off + size > data.size ()) {
+            printf ("Error: trace truncated at byte %zu\n", off);
+            MPI_Abort (MPI_COMM_WORLD, -1);
+        }
+        memcpy (buf, data.data () + off, size);
+        off += size;
+    }
+} trace_buf_t;
+
+static void read_trace (const char *prefix,
+                        int rank,
+                        int np,
+                        std::map<int, dset_t> &dsets,
+                        std::vector<op_t> &ops) {
+    int i;
+    int32_t hdr[3], i32;
+    uint8_t type, flag;
+    uint64_t u64;
+    char magic[4];
+    FILE *fin;
+    long size;
+    std::string path = std::string (prefix) + "." + std::to_string (rank);
+    trace_buf_t tb;
+
+    fin = fopen (path.c_str (), "rb");
+    if (!fin) {
+        printf ("Error: cannot open %s\n", path.c_str ());
+        MPI_Abort (MPI_COMM_WORLD, -1);
+    }
+    fseek (fin, 0, SEEK_END);
+    size = ftell (fin);
+    fseek (fin, 0, SEEK_SET);
+    tb.data.resize (size);
+    tb.off = 0;
+    if (fread (tb.data.data (), 1, size, fin) != (size_t)size) {
+        printf ("Error: cannot read %s\n", path.c_str ());
+        MPI_Abort (MPI_COMM_WORLD, -1);
+    }
+    fclose (fin);
+
+    tb.get (magic, 4);
+    tb.get (hdr, sizeof (hdr));
+    if (memcmp (magic, H5VL_LOGI_TRACE_MAGIC, 4) || hdr[0] != H5VL_LOGI_TRACE_VERSION) {
+        printf ("Error: %s is not a trace of this version\n", path.c_str ());
+        MPI_Abort (MPI_COMM_WORLD, -1);
+    }
+    if (hdr[2] != np) {
+        if (rank == 0) { printf ("Error: the trace is recorded with %d processes\n", hdr[2]); }
+        MPI_Abort (MPI_COMM_WORLD, -1);
+    }
+
+    while (tb.off < tb.data.size ()) {
+        op_t op;
+
+        tb.get (&type, sizeof (uint8_t));
+        tb.get (&(op.time), sizeof (double));
+        op.type  = type;
+        op.did   = -1;
+        op.flag  = 0;
+        op.nsel  = 0;
+        op.nelem = 0;
+        switch (type) {
+            case H5VL_LOGI_TRACE_DEF: {
+                dset_t d;
+
+                tb.get (&i32, sizeof (int32_t));
+                op.did = i32;
+                tb.get (&i32, sizeof (int32_t));
+                d.ndim = i32;
+                tb.get (&u64, sizeof (uint64_t));
+                d.esize = u64;
+                d.dims.resize (d.ndim);
+                d.mdims.resize (d.ndim);
+                tb.get (d.dims.data (), sizeof (hsize_t) * d.ndim);
+                tb.get (d.mdims.data (), sizeof (hsize_t) * d.ndim);
+                dsets[op.did] = d;
+            }
+                continue;  // Not replayed
+            case H5VL_LOGI_TRACE_EXTENT:
+                tb.get (&i32, sizeof (int32_t));
+                op.did = i32;
+                op.sel.resize (dsets[op.did].ndim);
+                tb.get (op.sel.data (), sizeof (hsize_t) * op.sel.size ());
+                break;
+            case H5VL_LOGI_TRACE_WRITE:
+            case H5VL_LOGI_TRACE_READ:
+                tb.get (&i32, sizeof (int32_t));
+                op.did = i32;
+                tb.get (&flag, sizeof (uint8_t));
+                op.flag = flag;
+                tb.get (&u64, sizeof (uint64_t));  // Memory element size, not used
+                tb.get (&u64, sizeof (uint64_t));  // Bytes in memory, not used
+                tb.get (&i32, sizeof (int32_t));
+                op.nsel = i32;
+                op.sel.resize ((size_t)op.nsel * dsets[op.did].ndim * 2);
+                tb.get (op.sel.data (), sizeof (hsize_t) * op.sel.size ());
+                for (i = 0; i < op.nsel; i++) {
+                    int j;
+                    size_t n       = 1;
+                    hsize_t *count = op.sel.data () + ((size_t)i * 2 + 1) * dsets[op.did].ndim;
+
+                    for (j = 0; j < dsets[op.did].ndim; j++) { n *= count[j]; }
+                    op.nelem += n;
+                }
+                break;
+            case H5VL_LOGI_TRACE_FLUSH:
+                break;
+            default:
+                printf ("Error: unknown record type %d in %s\n", (int)type, path.c_str ());
+                MPI_Abort (MPI_COMM_WORLD, -1);
+        }
+        ops.push_back (op);
+    }
+}
+
+// Merge the dataset definitions of all processes, the smallest size is the size at creation
+static void merge_dsets (std::map<int, dset_t> &dsets) {
+    int i, j, n;
+    int len;
+    std::vector<long long> sbuf, rbuf;
+    std::vector<int> lens, offs;
+    int np;
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+
+    // did, ndim, esize, dims, mdims
+    for (auto &it : dsets) {
+        sbuf.push_back (it.first);
+        sbuf.push_back (it.second.ndim);
+        sbuf.push_back ((long long)it.second.esize);
+        for (j = 0; j < it.second.ndim; j++) { sbuf.push_back ((long long)it.second.dims[j]); }
+        for (j = 0; j < it.second.ndim; j++) { sbuf.push_back ((long long)it.second.mdims[j]); }
+    }
+
+    len = (int)sbuf.size ();
+    lens.resize (np);
+    offs.resize (np);
+    MPI_Allgather (&len, 1, MPI_INT, lens.data (), 1, MPI_INT, MPI_COMM_WORLD);
+    for (i = 0, n = 0; i < np; i++) {
+        offs[i] = n;
+        n += lens[i];
+    }
+    rbuf.resize (n);
+    MPI_Allgatherv (sbuf.data (), len, MPI_LONG_LONG, rbuf.data (), lens.data (), offs.data (),
+                    MPI_LONG_LONG, MPI_COMM_WORLD);
+
+    for (i = 0; i < n;) {
+        int did = (int)rbuf[i++];
+        dset_t d;
+
+        d.ndim  = (int)rbuf[i++];
+        d.esize = (size_t)rbuf[i++];
+        d.dims.assign (rbuf.begin () + i, rbuf.begin () + i + d.ndim);
+        i += d.ndim;
+        d.mdims.assign (rbuf.begin () + i, rbuf.begin () + i + d.ndim);
+        i += d.ndim;
+
+        auto it = dsets.find (did);
+        if (it == dsets.end ()) {
+            dsets[did] = d;
+        } else {
+            for (j = 0; j < d.ndim; j++) {
+                if (d.dims[j] < it->second.dims[j]) { it->second.dims[j] = d.dims[j]; }
+            }
+        }
+    }
+}
+
+static hid_t esize_type (size_t esize) {
+    hid_t tid;
+
+    switch (esize) {
+        case 1:
+            return H5Tcopy (H5T_NATIVE_UINT8);
+        case 2:
+            return H5Tcopy (H5T_NATIVE_UINT16);
+        case 4:
+            return H5Tcopy (H5T_NATIVE_UINT32);
+        case 8:
+            return H5Tcopy (H5T_NATIVE_UINT64);
+        default:
+            tid = H5Tcreate (H5T_OPAQUE, esize);
+            CHECK_HERR (tid)
+            return tid;
+    }
+}
+
+int main (int argc, char **argv) {
+    herr_t err;
+    int i, j, rank, np;
+    int nerrs = 0;
+    const char *prefix = NULL, *path = "trace_replay.h5";
+    bool keep_gap = false, keep = false;
+    hid_t vlid, faplid, fid, sid, dcplid;
+    hid_t dxplids[4];
+    std::map<int, dset_t> dsets;
+    std::map<int, hid_t> dids;
+    std::map<int, hid_t> tids;
+    std::vector<op_t> ops;
+    std::vector<hsize_t> chunk;
+    std::vector<hsize_t *> starts, counts;
+    std::vector<char> buf;
+    unsigned long long ncall[NPHASE] = {0}, nbyte[NPHASE] = {0}, gcall[NPHASE], gbyte[NPHASE];
+    double t[NPHASE] = {0}, tmax[NPHASE], t0, tstart;
+
+    MPI_Init (&argc, &argv);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+
+    while ((i = getopt (argc, argv, "hi:o:tk")) != EOF) switch (i) {
+            case 'i':
+                prefix = optarg;
+                break;
+            case 'o':
+                path = optarg;
+                break;
+            case 't':
+                keep_gap = true;
+                break;
+            case 'k':
+                keep = true;
+                break;
+            case 'h':
+            default:
+                if (rank == 0) usage (argv[0]);
+                goto err_out;
+        }
+    if (!prefix) {
+        if (rank == 0) usage (argv[0]);
+        nerrs++;
+        goto err_out;
+    }
+
+    read_trace (prefix, rank, np, dsets, ops);
+    merge_dsets (dsets);
+
+    vlid = H5VL_log_register ();
+    CHECK_HERR (vlid)
+    faplid = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_HERR (faplid)
+    err = H5Pset_fapl_mpio (faplid, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_HERR (err)
+    err = H5Pset_all_coll_metadata_ops (faplid, 1);
+    CHECK_HERR (err)
+    err = H5Pset_coll_metadata_write (faplid, 1);
+    CHECK_HERR (err)
+    err = H5Pset_vol (faplid, vlid, NULL);
+    CHECK_HERR (err)
+
+    // Transfer property of each combination of the record flags
+    for (i = 0; i < 4; i++) {
+        dxplids[i] = H5Pcreate (H5P_DATASET_XFER);
+        CHECK_HERR (dxplids[i])
+        if (i & H5VL_LOGI_TRACE_FLAG_COLL) {
+            err = H5Pset_dxpl_mpio (dxplids[i], H5FD_MPIO_COLLECTIVE);
+            CHECK_HERR (err)
+        }
+        err = H5Pset_buffered (dxplids[i], (i & H5VL_LOGI_TRACE_FLAG_BUFFERED) ? 1 : 0);
+        CHECK_HERR (err)
+    }
+
+    // Create the file and the datasets, named by the ID in the trace
+    MPI_Barrier (MPI_COMM_WORLD);
+    t0  = MPI_Wtime ();
+    fid = H5Fcreate (path, H5F_ACC_TRUNC, H5P_DEFAULT, faplid);
+    CHECK_HERR (fid)
+    for (auto &it : dsets) {
+        char name[32];
+        dset_t &d = it.second;
+
+        sid = H5Screate_simple (d.ndim, d.dims.data (), d.mdims.data ());
+        CHECK_HERR (sid)
+        dcplid = H5Pcreate (H5P_DATASET_CREATE);
+        CHECK_HERR (dcplid)
+        chunk.resize (d.ndim);
+        for (j = 0; j < d.ndim; j++) {
+            if (d.mdims[j] == H5S_UNLIMITED) break;
+        }
+        if (j < d.ndim) {
+            for (j = 0; j < d.ndim; j++) {
+                chunk[j] = (d.mdims[j] == H5S_UNLIMITED || d.dims[j] == 0) ? 1 : d.dims[j];
+            }
+            err = H5Pset_chunk (dcplid, d.ndim, chunk.data ());
+            CHECK_HERR (err)
+        }
+        tids[it.first] = esize_type (d.esize);
+        CHECK_HERR (tids[it.first])
+        sprintf (name, "d%d", it.first);
+        dids[it.first] = H5Dcreate2 (fid, name, tids[it.first], sid, H5P_DEFAULT, dcplid,
+                                     H5P_DEFAULT);
+        CHECK_HERR (dids[it.first])
+        H5Sclose (sid);
+        H5Pclose (dcplid);
+    }
+    t[PHASE_CREATE] = MPI_Wtime () - t0;
+    ncall[PHASE_CREATE] = dsets.size ();
+
+    // Replay the calls in order
+    MPI_Barrier (MPI_COMM_WORLD);
+    tstart = MPI_Wtime ();
+    for (auto &op : ops) {
+        int phase;
+
+        if (keep_gap) {
+            double gap = op.time - (MPI_Wtime () - tstart);
+            if (gap > 0) { usleep ((useconds_t)(gap * 1e6)); }
+        }
+
+        t0 = MPI_Wtime ();
+        switch (op.type) {
+            case H5VL_LOGI_TRACE_EXTENT:
+                phase = PHASE_EXTENT;
+                err   = H5Dset_extent (dids[op.did], op.sel.data ());
+                CHECK_HERR (err)
+                break;
+            case H5VL_LOGI_TRACE_WRITE:
+            case H5VL_LOGI_TRACE_READ: {
+                int ndim = dsets[op.did].ndim;
+
+                phase = op.type == H5VL_LOGI_TRACE_WRITE ? PHASE_WRITE : PHASE_READ;
+                starts.resize (op.nsel);
+                counts.resize (op.nsel);
+                for (i = 0; i < op.nsel; i++) {
+                    starts[i] = op.sel.data () + (size_t)i * 2 * ndim;
+                    counts[i] = starts[i] + ndim;
+                }
+                nbyte[phase] += op.nelem * dsets[op.did].esize;
+                if (buf.size () < op.nelem * dsets[op.did].esize) {
+                    buf.resize (op.nelem * dsets[op.did].esize, (char)rank);
+                }
+                if (phase == PHASE_WRITE) {
+                    err = H5Dwrite_n (dids[op.did], tids[op.did], op.nsel, starts.data (),
+                                      counts.data (), dxplids[op.flag & 3], buf.data ());
+                } else {
+                    err = H5Dread_n (dids[op.did], tids[op.did], op.nsel, starts.data (),
+                                     counts.data (), dxplids[op.flag & 3], buf.data ());
+                }
+                CHECK_HERR (err)
+            } break;
+            case H5VL_LOGI_TRACE_FLUSH:
+            default:
+                phase = PHASE_FLUSH;
+                err   = H5Fflush (fid, H5F_SCOPE_GLOBAL);
+                CHECK_HERR (err)
+                break;
+        }
+        t[phase] += MPI_Wtime () - t0;
+        ncall[phase]++;
+    }
+
+    MPI_Barrier (MPI_COMM_WORLD);
+    t0 = MPI_Wtime ();
+    for (auto &it : dids) {
+        err = H5Dclose (it.second);
+        CHECK_HERR (err)
+    }
+    err = H5Fclose (fid);
+    CHECK_HERR (err)
+    t[PHASE_CLOSE] = MPI_Wtime () - t0;
+    ncall[PHASE_CLOSE] = 1;
+
+    for (auto &it : tids) { H5Tclose (it.second); }
+    for (i = 0; i < 4; i++) { H5Pclose (dxplids[i]); }
+    H5Pclose (faplid);
+    H5VLclose (vlid);
+
+    MPI_Reduce (t, tmax, NPHASE, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce (ncall, gcall, NPHASE, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce (nbyte, gbyte, NPHASE, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        printf ("Trace: %s, %d processes, %zu datasets\n", prefix, np, dsets.size ());
+        printf ("phase,calls,MiB,time(s),bandwidth(MiB/s)\n");
+        for (i = 0; i < NPHASE; i++) {
+            double mib = (double)gbyte[i] / 1048576;
+
+            printf ("%s,%llu,%.2lf,%.4lf,%.2lf\n", phase_name[i], gcall[i], mib, tmax[i],
+                    (gbyte[i] && tmax[i] > 0) ? mib / tmax[i] : 0.0);
+        }
+    }
+
+    if (!keep && rank == 0) { remove (path); }
+
+err_out:;
+    MPI_Finalize ();
+
+    return nerrs > 0;
+}
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+/*
+ * Microbenchmark of metadata deduplication (H5VL_logi_wreq_hash)
+ * n write requests are drawn from d distinct selections of b blocks, then every request is looked
+ * up in the deduplication table as H5Dwrite does when H5VL_LOG_METADATA_SHARE is enabled. The
+ * table is compared with an std::unordered_map keyed by copies of the requests and hashed by
+ * XOR-ing the 8-byte words of the selection, the scheme used before.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+//
+#include <mpi.h>
+#include <unistd.h>
+//
+#include "H5VL_logi_dedup.hpp"
+#include "H5VL_logi_nb.hpp"
+
+// Hash of the XOR scheme
+struct xor_hash {
+    size_t operator() (H5VL_log_wreq_t const &r) const noexcept {
+        size_t ret = 0;
+        size_t *val;
+        size_t *end;
+        size_t selsize = r.hdr->meta_size - (r.sel_buf - r.meta_buf);
+
+        end = (size_t *)((char *)(r.sel_buf) + selsize - selsize % sizeof (size_t));
+        for (val = (size_t *)(r.sel_buf); val < end; val++) { ret ^= *val; }
+
+        return ret;
+    }
+};
+
+// Request with a canonical selection of nblock blocks, taken from cords (start and count)
+static H5VL_log_wreq_t *make_req (int ndim, int nblock, MPI_Offset *cords) {
+    size_t size;
+    H5VL_log_wreq_t *r;
+
+    size = sizeof (H5VL_logi_meta_hdr) + sizeof (int) + sizeof (MPI_Offset) * ndim * 2 * nblock;
+
+    r           = new H5VL_log_wreq_t ();
+    r->meta_buf = (char *)malloc (size);
+    r->hdr      = (H5VL_logi_meta_hdr *)r->meta_buf;
+    r->sel_buf  = r->meta_buf + sizeof (H5VL_logi_meta_hdr);
+    r->nsel     = nblock;
+
+    memset (r->hdr, 0, sizeof (H5VL_logi_meta_hdr));
+    r->hdr->meta_size    = size;
+    r->hdr->flag         = H5VL_LOGI_META_FLAG_MUL_SEL;
+    *((int *)r->sel_buf) = nblock;
+    memcpy (r->sel_buf + sizeof (int), cords, sizeof (MPI_Offset) * ndim * 2 * nblock);
+
+    return r;
+}
+
+/*----< usage() >------------------------------------------------------------*/
+static void usage (char *argv0) {
+    char *help = (char *)"Usage: %s [OPTION]\n\
+       [-h] Print this help message\n\
+       [-n] Number of write requests (default 1000000)\n\
+       [-d] Number of distinct selections (default n / 4)\n\
+       [-b] Number of blocks in each selection (default 4)\n\
+       [-D] Number of dimensions (default 2)\n\
+       [-s] Symmetric selections, the count of every block equals its start\n\
+       [-x] Skip the XOR hash table\n\
+       [-r] Number of repeats (default 5)\n";
+    fprintf (stderr, help, argv0);
+}
+
+int main (int argc, char *argv[]) {
+    int i, j, k;
+    int opt;
+    int ndim    = 2;        // Number of dimensions
+    int nblock  = 4;        // Blocks per selection
+    int nrep    = 5;        // Number of repeats
+    bool sym    = false;    // Symmetric selections
+    bool skip   = false;    // Skip the XOR hash table
+    size_t n    = 1000000;  // Number of requests
+    size_t d    = 0;        // Number of distinct selections
+    size_t ndup = 0, ndup_xor = 0;
+    double t, tmin = 1e30, tmin_xor = 1e30;
+    std::vector<MPI_Offset> cords;
+    std::vector<H5VL_log_wreq_t *> reqs;
+    H5VL_logi_wreq_hash table;
+    std::mt19937_64 rng (0);
+
+    MPI_Init (&argc, &argv);
+
+    while ((opt = getopt (argc, argv, "hsxn:d:b:D:r:")) != -1) {
+        switch (opt) {
+            case 's':
+                sym = true;
+                break;
+            case 'x':
+                skip = true;
+                break;
+            case 'n':
+                n = (size_t)atoll (optarg);
+                break;
+            case 'd':
+                d = (size_t)atoll (optarg);
+                break;
+            case 'b':
+                nblock = atoi (optarg);
+                break;
+            case 'D':
+                ndim = atoi (optarg);
+                break;
+            case 'r':
+                nrep = atoi (optarg);
+                break;
+            case 'h':
+            default:
+                usage (argv[0]);
+                MPI_Finalize ();
+                return 0;
+        }
+    }
+    if (d == 0) { d = n / 4 ? n / 4 : 1; }
+    if (n == 0 || d > n || nblock < 1 || ndim < 1 || ndim > H5S_MAX_RANK || nrep < 1) {
+        usage (argv[0]);
+        MPI_Finalize ();
+        return 1;
+    }
+
+    // Distinct selections, blocks are sorted along the first dimension as in the metadata
+    cords.resize (d * nblock * ndim * 2);
+    for (size_t s = 0; s < d; s++) {
+        MPI_Offset *cp  = cords.data () + s * nblock * ndim * 2;
+        MPI_Offset base = (MPI_Offset) (s * nblock);
+
+        for (j = 0; j < nblock; j++) {
+            for (k = 0; k < ndim; k++) {
+                cp[k]        = k ? (MPI_Offset) (rng () % 1048576) : (base + j) * 2;
+                cp[ndim + k] = sym ? cp[k] : (MPI_Offset) (rng () % 64 + 1);
+            }
+            cp += ndim * 2;
+        }
+    }
+
+    // Every distinct selection appears at least once, the rest are drawn at random
+    reqs.resize (n);
+    for (size_t s = 0; s < n; s++) {
+        size_t sel = s < d ? s : rng () % d;
+        reqs[s]    = make_req (ndim, nblock, cords.data () + sel * nblock * ndim * 2);
+    }
+    for (size_t s = n - 1; s > 0; s--) { std::swap (reqs[s], reqs[rng () % (s + 1)]); }
+
+    for (i = 0; i < nrep; i++) {
+        t    = MPI_Wtime ();
+        ndup = 0;
+        for (auto r : reqs) {
+            if (table.find_or_insert (r)) { ndup++; }
+        }
+        table.clear ();
+        t = MPI_Wtime () - t;
+        if (t < tmin) tmin = t;
+
+        if (skip) continue;
+
+        t        = MPI_Wtime ();
+        ndup_xor = 0;
+        {
+            std::unordered_map<H5VL_log_wreq_t, H5VL_log_wreq_t *, xor_hash> map;
+            for (auto r : reqs) {
+                auto ret = map.find (*r);
+                if (ret == map.end ()) {
+                    map[*r] = r;
+                } else {
+                    ndup_xor++;
+                }
+            }
+        }
+        t = MPI_Wtime () - t;
+        if (t < tmin_xor) tmin_xor = t;
+    }
+
+    printf ("Number of requests:      %zu\n", n);
+    printf ("Distinct selections:     %zu\n", d);
+    printf ("Blocks per selection:    %d\n", nblock);
+    printf ("Number of dimensions:    %d\n", ndim);
+    printf ("Symmetric selections:    %s\n", sym ? "yes" : "no");
+    printf ("Duplicated requests:     %zu\n", ndup);
+    printf ("Dedup time (min):        %lf s\n", tmin);
+    printf ("Dedup throughput (min):  %lf M requests/s\n", (double)n / tmin / 1e6);
+    if (!skip) {
+        if (ndup_xor != ndup) { printf ("Error: XOR hash table found %zu duplicates\n", ndup_xor); }
+        printf ("XOR hash time (min):     %lf s\n", tmin_xor);
+        printf ("XOR hash throughput:     %lf M requests/s\n", (double)n / tmin_xor / 1e6);
+    }
+
+    for (auto r : reqs) { delete r; }
+
+    MPI_Finalize ();
+
+    return ndup_xor != ndup && !skip ? 1 : 0;
+}
@@ -8,9 +8,13 @@
 #include <config.h>
 #endif
 
+#include <cstdlib>
+#include <cstring>
+//
 #include "H5VL_log.h"
 #include "H5VL_log_dataset.hpp"
 #include "H5VL_log_dataseti.hpp"
+#include "H5VL_log_file.hpp"
 #include "H5VL_log_info.hpp"
 #include "H5VL_logi.hpp"
 
@@ -131,6 +135,42 @@ err_out:;
     return err;
 }
 
+herr_t H5Fprofile_report (hid_t fid, const char *path) {
+    herr_t err = 0;
+    H5VL_optional_args_t arg;
+
+    try {
+        if (!path) { RET_ERR ("Output path is NULL") }
+
+        arg.op_type = H5Fprofile_report_op_val;
+        arg.args    = (void *)path;
+        err         = H5VLfile_optional_op (fid, &arg, H5P_DATASET_XFER_DEFAULT, H5ES_NONE);
+        CHECK_ERR
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
+herr_t H5Fget_io_stat (hid_t fid, H5VL_log_io_stat_t *stat) {
+    herr_t err = 0;
+    H5VL_optional_args_t arg;
+
+    try {
+        if (!stat) { RET_ERR ("Statistics buffer is NULL") }
+
+        arg.op_type = H5Fget_io_stat_op_val;
+        arg.args    = stat;
+        err         = H5VLfile_optional_op (fid, &arg, H5P_DATASET_XFER_DEFAULT, H5ES_NONE);
+        CHECK_ERR
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
 #define NB_PROPERTY_NAME "H5VL_log_nonblocking"
 herr_t H5Pset_buffered (hid_t plist, hbool_t nonblocking) {
     herr_t err = 0;
@@ -304,6 +344,62 @@ err_out:;
     return err;
 }
 
+#define IDX_NTHREAD_PROPERTY_NAME "H5VL_log_idx_nthread"
+herr_t H5Pset_idx_nthread (hid_t plist, int nthread) {
+    herr_t err = 0;
+    htri_t isfapl;
+    htri_t pexist;
+
+    try {
+        isfapl = H5Pisa_class (plist, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl)
+        if (isfapl == 0) ERR_OUT ("Not faplid")
+        if (nthread < 1) ERR_OUT ("Number of threads must be positive")
+
+        pexist = H5Pexist (plist, IDX_NTHREAD_PROPERTY_NAME);
+        CHECK_ID (pexist)
+        if (!pexist) {
+            int one = 1;
+            err     = H5Pinsert2 (plist, IDX_NTHREAD_PROPERTY_NAME, sizeof (int), &one, NULL, NULL,
+                                  NULL, NULL, NULL, NULL);
+            CHECK_ERR
+        }
+
+        err = H5Pset (plist, IDX_NTHREAD_PROPERTY_NAME, &nthread);
+        CHECK_ERR
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
+herr_t H5Pget_idx_nthread (hid_t plist, int *nthread) {
+    herr_t err = 0;
+    htri_t isfapl, pexist;
+
+    try {
+        isfapl = H5Pisa_class (plist, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl)
+        if (isfapl == 0)
+            *nthread = 1;  // Default property will not pass class check
+        else {
+            pexist = H5Pexist (plist, IDX_NTHREAD_PROPERTY_NAME);
+            CHECK_ID (pexist)
+            if (pexist) {
+                err = H5Pget (plist, IDX_NTHREAD_PROPERTY_NAME, nthread);
+                CHECK_ERR
+            } else {
+                *nthread = 1;
+            }
+        }
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
 #define MERGE_META_NAME_PROPERTY_NAME "H5VL_log_metadata_merge"
 herr_t H5Pset_meta_merge (hid_t plist, hbool_t merge) {
     herr_t err = 0;
@@ -480,6 +576,116 @@ err_out:;
     return err;
 }
 
+#define ZIP_META_SECTION_PROPERTY_NAME "H5VL_log_metadata_section_zip"
+herr_t H5Pset_meta_section_zip (hid_t plist, hbool_t zip) {
+    herr_t err = 0;
+    htri_t isfapl;
+    htri_t pexist;
+
+    try {
+        isfapl = H5Pisa_class (plist, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl)
+        if (isfapl == 0) ERR_OUT ("Not faplid")
+
+        pexist = H5Pexist (plist, ZIP_META_SECTION_PROPERTY_NAME);
+        CHECK_ID (pexist)
+        if (!pexist) {
+            hbool_t f = false;
+            err = H5Pinsert2 (plist, ZIP_META_SECTION_PROPERTY_NAME, sizeof (hbool_t), &f, NULL,
+                              NULL, NULL, NULL, NULL, NULL);
+            CHECK_ERR
+        }
+
+        err = H5Pset (plist, ZIP_META_SECTION_PROPERTY_NAME, &zip);
+        CHECK_ERR
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
+herr_t H5Pget_meta_section_zip (hid_t plist, hbool_t *zip) {
+    herr_t err = 0;
+    htri_t isfapl, pexist;
+
+    try {
+        isfapl = H5Pisa_class (plist, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl)
+        if (isfapl == 0)
+            *zip = false;  // Default property will not pass class check
+        else {
+            pexist = H5Pexist (plist, ZIP_META_SECTION_PROPERTY_NAME);
+            CHECK_ID (pexist)
+            if (pexist) {
+                err = H5Pget (plist, ZIP_META_SECTION_PROPERTY_NAME, zip);
+                CHECK_ERR
+            } else {
+                *zip = false;
+            }
+        }
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
+#define META_DICT_PROPERTY_NAME "H5VL_log_metadata_dict"
+herr_t H5Pset_meta_dict (hid_t plist, hbool_t dict) {
+    herr_t err = 0;
+    htri_t isfapl;
+    htri_t pexist;
+
+    try {
+        isfapl = H5Pisa_class (plist, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl)
+        if (isfapl == 0) ERR_OUT ("Not faplid")
+
+        pexist = H5Pexist (plist, META_DICT_PROPERTY_NAME);
+        CHECK_ID (pexist)
+        if (!pexist) {
+            hbool_t f = false;
+            err = H5Pinsert2 (plist, META_DICT_PROPERTY_NAME, sizeof (hbool_t), &f, NULL,
+                              NULL, NULL, NULL, NULL, NULL);
+            CHECK_ERR
+        }
+
+        err = H5Pset (plist, META_DICT_PROPERTY_NAME, &dict);
+        CHECK_ERR
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
+herr_t H5Pget_meta_dict (hid_t plist, hbool_t *dict) {
+    herr_t err = 0;
+    htri_t isfapl, pexist;
+
+    try {
+        isfapl = H5Pisa_class (plist, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl)
+        if (isfapl == 0)
+            *dict = false;  // Default property will not pass class check
+        else {
+            pexist = H5Pexist (plist, META_DICT_PROPERTY_NAME);
+            CHECK_ID (pexist)
+            if (pexist) {
+                err = H5Pget (plist, META_DICT_PROPERTY_NAME, dict);
+                CHECK_ERR
+            } else {
+                *dict = false;
+            }
+        }
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    return err;
+}
+
 #define SEL_ENCODING_PROPERTY_NAME "H5VL_log_sel_encoding"
 herr_t H5Pset_sel_encoding (hid_t plist, H5VL_log_sel_encoding_t encoding) {
     herr_t err = 0;
@@ -759,3 +965,220 @@ herr_t H5Pget_passthru (hid_t faplid, hbool_t *enable) {
 err_out:;
     return err;
 }
+
+#define SHADOW_ELIM_PROPERTY_NAME "H5VL_log_shadow_elim"
+herr_t H5Pset_shadow_elim (hid_t faplid, hbool_t enable) {
+    herr_t err = 0;
+    htri_t isfapl;
+    htri_t pexist;
+
+    try {
+        isfapl = H5Pisa_class (faplid, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl);
+        if (isfapl == 0) { ERR_OUT ("Not faplid"); }
+
+        pexist = H5Pexist (faplid, SHADOW_ELIM_PROPERTY_NAME);
+        CHECK_ID (pexist);
+        if (!pexist) {
+            hbool_t f = false;
+            err = H5Pinsert2 (faplid, SHADOW_ELIM_PROPERTY_NAME, sizeof (hbool_t), &f, NULL, NULL,
+                              NULL, NULL, NULL, NULL);
+            CHECK_ERR;
+        }
+
+        err = H5Pset (faplid, SHADOW_ELIM_PROPERTY_NAME, &enable);
+        CHECK_ERR;
+    }
+    H5VL_LOGI_EXP_CATCH_ERR;
+
+err_out:;
+    return err;
+}
+herr_t H5Pget_shadow_elim (hid_t faplid, hbool_t *enable) {
+    herr_t err = 0;
+    htri_t isfapl, pexist;
+
+    try {
+        isfapl = H5Pisa_class (faplid, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl);
+        if (isfapl == 0) {
+            ERR_OUT ("Not faplid");
+        } else {
+            pexist = H5Pexist (faplid, SHADOW_ELIM_PROPERTY_NAME);
+            CHECK_ID (pexist);
+            if (pexist) {
+                err = H5Pget (faplid, SHADOW_ELIM_PROPERTY_NAME, enable);
+                CHECK_ERR;
+            } else {
+                *enable = false;
+            }
+        }
+    }
+    H5VL_LOGI_EXP_CATCH_ERR;
+
+err_out:;
+    return err;
+}
+
+#define READ_OWN_WRITES_PROPERTY_NAME "H5VL_log_read_own_writes"
+herr_t H5Pset_read_own_writes (hid_t faplid, hbool_t enable) {
+    herr_t err = 0;
+    htri_t isfapl;
+    htri_t pexist;
+
+    try {
+        isfapl = H5Pisa_class (faplid, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl);
+        if (isfapl == 0) { ERR_OUT ("Not faplid"); }
+
+        pexist = H5Pexist (faplid, READ_OWN_WRITES_PROPERTY_NAME);
+        CHECK_ID (pexist);
+        if (!pexist) {
+            hbool_t f = false;
+            err = H5Pinsert2 (faplid, READ_OWN_WRITES_PROPERTY_NAME, sizeof (hbool_t), &f, NULL,
+                              NULL, NULL, NULL, NULL, NULL);
+            CHECK_ERR;
+        }
+
+        err = H5Pset (faplid, READ_OWN_WRITES_PROPERTY_NAME, &enable);
+        CHECK_ERR;
+    }
+    H5VL_LOGI_EXP_CATCH_ERR;
+
+err_out:;
+    return err;
+}
+herr_t H5Pget_read_own_writes (hid_t faplid, hbool_t *enable) {
+    herr_t err = 0;
+    htri_t isfapl, pexist;
+
+    try {
+        isfapl = H5Pisa_class (faplid, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl);
+        if (isfapl == 0) {
+            ERR_OUT ("Not faplid");
+        } else {
+            pexist = H5Pexist (faplid, READ_OWN_WRITES_PROPERTY_NAME);
+            CHECK_ID (pexist);
+            if (pexist) {
+                err = H5Pget (faplid, READ_OWN_WRITES_PROPERTY_NAME, enable);
+                CHECK_ERR;
+            } else {
+                *enable = false;
+            }
+        }
+    }
+    H5VL_LOGI_EXP_CATCH_ERR;
+
+err_out:;
+    return err;
+}
+
+/* The trace path is a string owned by the property list
+ * It is duplicated when set or copied with the list, and freed when replaced, removed, or closed.
+ */
+#define TRACE_PROPERTY_NAME "H5VL_log_trace"
+static herr_t H5VL_log_trace_prop_set (hid_t prop_id,
+                                       const char *name,
+                                       size_t size,
+                                       void *value) {
+    char **path = (char **)value;
+
+    if (*path) { *path = strdup (*path); }
+    return 0;
+}
+static herr_t H5VL_log_trace_prop_del (hid_t prop_id,
+                                       const char *name,
+                                       size_t size,
+                                       void *value) {
+    free (*(char **)value);
+    return 0;
+}
+static herr_t H5VL_log_trace_prop_copy (const char *name, size_t size, void *value) {
+    char **path = (char **)value;
+
+    if (*path) { *path = strdup (*path); }
+    return 0;
+}
+static int H5VL_log_trace_prop_cmp (const void *value1, const void *value2, size_t size) {
+    const char *a = *(char *const *)value1;
+    const char *b = *(char *const *)value2;
+
+    if (a == NULL || b == NULL) { return (a != NULL) - (b != NULL); }
+    return strcmp (a, b);
+}
+static herr_t H5VL_log_trace_prop_close (const char *name, size_t size, void *value) {
+    free (*(char **)value);
+    return 0;
+}
+herr_t H5Pset_trace (hid_t faplid, const char *path) {
+    herr_t err = 0;
+    htri_t isfapl;
+    htri_t pexist;
+    char *p;
+
+    try {
+        isfapl = H5Pisa_class (faplid, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl);
+        if (isfapl == 0) { ERR_OUT ("Not faplid"); }
+
+        pexist = H5Pexist (faplid, TRACE_PROPERTY_NAME);
+        CHECK_ID (pexist);
+        if (!pexist) {
+            p   = NULL;
+            err = H5Pinsert2 (faplid, TRACE_PROPERTY_NAME, sizeof (char *), &p,
+                              H5VL_log_trace_prop_set, NULL, H5VL_log_trace_prop_del,
+                              H5VL_log_trace_prop_copy, H5VL_log_trace_prop_cmp,
+                              H5VL_log_trace_prop_close);
+            CHECK_ERR;
+        }
+
+        // An empty path disables tracing
+        p   = (path && *path != '\0') ? (char *)path : NULL;
+        err = H5Pset (faplid, TRACE_PROPERTY_NAME, &p);
+        CHECK_ERR;
+    }
+    H5VL_LOGI_EXP_CATCH_ERR;
+
+err_out:;
+    return err;
+}
+ssize_t H5Pget_trace (hid_t faplid, char *path, size_t size) {
+    ssize_t err = 0;
+    htri_t isfapl, pexist;
+    char *p = NULL;
+    size_t len;
+
+    try {
+        isfapl = H5Pisa_class (faplid, H5P_FILE_ACCESS);
+        CHECK_ID (isfapl);
+        if (isfapl == 0) {
+            ERR_OUT ("Not faplid");
+        } else {
+            pexist = H5Pexist (faplid, TRACE_PROPERTY_NAME);
+            CHECK_ID (pexist);
+            if (pexist) {
+                err = H5Pget (faplid, TRACE_PROPERTY_NAME, &p);
+                CHECK_ERR;
+            }
+        }
+
+        // Same as H5Pget_efile_prefix, the length is returned and at most size - 1 bytes copied
+        len = p ? strlen (p) : 0;
+        if (path && size > 0) {
+            if (len >= size) {
+                memcpy (path, p, size - 1);
+                path[size - 1] = '\0';
+            } else if (len) {
+                memcpy (path, p, len + 1);
+            } else {
+                path[0] = '\0';
+            }
+        }
+        err = (ssize_t)len;
+    }
+    H5VL_LOGI_EXP_CATCH_ERR;
+
+err_out:;
+    return err;
+}
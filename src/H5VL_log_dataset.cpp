@@ -172,19 +172,27 @@ void *H5VL_log_dataset_create (void *obj,
         // Reset hdf5 context to allow attr operations within a dataset operation
         H5VL_logi_reset_lib_stat (lib_state, lib_context);
 
+        // Path of the anchor dataset for the dataset catalog
+        dip->path = H5VL_logi_object_get_name (dp->fp, dp->uo, H5I_DATASET, dp->uvlid, dxpl_id);
+
         // Record dataset metadata as attributes
-        H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_DIMS, H5T_STD_I64LE, H5T_NATIVE_INT64,
-                           dip->ndim, dip->dims, dxpl_id, ureqp);
-        if (req) { rp->append (ureq); }
-        H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_MDIMS, H5T_STD_I64LE, H5T_NATIVE_INT64,
-                           dip->ndim, dip->mdims, dxpl_id, ureqp);
-        if (req) { rp->append (ureq); }
-        H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_ID, H5T_STD_I32LE, H5T_NATIVE_INT32, 1,
-                           &(dp->id), dxpl_id, ureqp);
-        if (req) {
-            rp->append (ureq);
-            *req = rp;
+        // They are written when the dataset is closed, while the anchor dataset is still open
+        // Anchor datasets without a path can't be found by H5Dopen before that, write them now
+        if (dip->path.size ()) {
+            dip->att_flag = H5VL_LOG_DATASETI_ATT_NEW;
+            dp->fp->att_pending.push_back (dp->id);
+        } else {
+            H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_DIMS, H5T_STD_I64LE, H5T_NATIVE_INT64,
+                               dip->ndim, dip->dims, dxpl_id, ureqp);
+            if (req) { rp->append (ureq); }
+            H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_MDIMS, H5T_STD_I64LE, H5T_NATIVE_INT64,
+                               dip->ndim, dip->mdims, dxpl_id, ureqp);
+            if (req) { rp->append (ureq); }
+            H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_ID, H5T_STD_I32LE, H5T_NATIVE_INT32, 1,
+                               &(dp->id), dxpl_id, ureqp);
+            if (req) { rp->append (ureq); }
         }
+        if (req) { *req = rp; }
 
         // Append dataset to the file
         LOG_VOL_ASSERT (dp->fp->ndset == (int)(dp->fp->dsets_info.size ()))
@@ -193,6 +201,7 @@ void *H5VL_log_dataset_create (void *obj,
         dp->fp->dsets_info.push_back (dip);          // Dataset info
         dp->fp->idx->reserve (dp->fp->ndset);        // Index for H5Dread
         dp->fp->mreqs.resize (dp->fp->ndset, nullptr);  // Merged requests
+        dp->fp->catalog_dirty = true;                   // New dataset to record in the catalog
 
         // Create soft link to aid dataset visiting on file opening
         // Broken, not used anymore
@@ -546,6 +555,8 @@ herr_t H5VL_log_dataset_specific (void *obj,
                 int32_t i;
                 const hsize_t *new_sizes = args->args.set_extent.size;
 
+                if (dp->fp->trace) { H5VL_logi_trace_extent (dp->fp, dp->id, new_sizes); }
+
                 // Adjust dim
                 for (i = 0; i < (int32_t)(dip->ndim); i++) {
                     if (dip->mdims[i] != H5S_UNLIMITED && new_sizes[i] > dip->mdims[i]) {
@@ -555,9 +566,9 @@ herr_t H5VL_log_dataset_specific (void *obj,
                     dip->dims[i] = new_sizes[i];
                 }
 
-                // Record new size
-                H5VL_logi_put_att (dp, H5VL_LOG_DATASETI_ATTR_DIMS, H5T_NATIVE_INT64, dip->dims,
-                                   dxpl_id);
+                // Record new size, deferred to dataset close
+                dip->att_flag |= H5VL_LOG_DATASETI_ATT_DIMS;
+                dp->fp->catalog_dirty = true;
 
                 // Recalculate dsteps if needed
                 if (dp->fp->config & H5VL_FILEI_CONFIG_SEL_ENCODE) {
@@ -707,6 +718,11 @@ herr_t H5VL_log_dataset_close (void *dset, hid_t dxpl_id, void **req) {
 
         H5VL_LOGI_PROFILING_TIMER_START;
 
+        // Attributes deferred by dataset creation and extension
+        if (dp->fp->is_log_based_file && dp->fp->dsets_info[dp->id]->att_flag) {
+            H5VL_log_dataseti_put_atts (dp, dxpl_id);
+        }
+
         H5VL_LOGI_PROFILING_TIMER_START;
         err = H5VLdataset_close (dp->uo, dp->uvlid, dxpl_id, NULL);
         CHECK_ERR
@@ -9,6 +9,8 @@
 #include <H5VLconnector.h>
 #include <mpi.h>
 
+#include <string>
+
 #include "H5VL_log_obj.hpp"
 #include "H5VL_log_wrap.hpp"
 #include "H5VL_logi_filter.hpp"
@@ -27,6 +29,8 @@ typedef struct H5VL_log_dset_info_t {
     MPI_Offset dsteps[H5S_MAX_RANK];  // Number of elements in the subspace below each dimension
     std::vector<H5VL_log_filter_t> filters;  // Declared filters
     char *fill;                              // Fill value
+    std::string path;                        // Path of the anchor dataset, recorded in the catalog
+    int att_flag = 0;  // Attributes of the anchor dataset to be written at dataset close
 } H5VL_log_dset_info_t;
 
 /* The log VOL dataset object */
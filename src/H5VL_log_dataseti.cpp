@@ -41,53 +41,71 @@ static bool interleve (int ndim, int *sa, int *ca, int *sb) {
     return true;
 }
 
-#define OSWAP(A, B)    \
-    {                  \
-        to    = oa[A]; \
-        oa[A] = oa[B]; \
-        oa[B] = to;    \
-        to    = ob[A]; \
-        ob[A] = ob[B]; \
-        ob[B] = to;    \
-        tl    = l[A];  \
-        l[A]  = l[B];  \
-        l[B]  = tl;    \
-    }
-void sortoffsets (int len, MPI_Aint *oa, MPI_Aint *ob, int *l) {
-    int i, j, p;
-    MPI_Aint to;
-    int tl;
-
-    if (len < 16) {
-        j = 1;
-        while (j) {
-            j = 0;
-            for (i = 0; i < len - 1; i++) {
-                if (oa[i + 1] < oa[i]) {
-                    OSWAP (i, i + 1)
-                    j = 1;
-                }
-            }
-        }
-        return;
-    }
+/*
+Sort the contiguous sections broken down from a group of interleaving blocks by file offset, then
+trim off the part of each section that is already read by previous sections. The trimmed parts are
+recorded in overlaps and copied from the memory of the covering section after the read.
 
-    p = len / 2;
-    OSWAP (p, len - 1);
-    p = len - 1;
+Sections are visited in file offset order, so the previous section reaching the furthest always
+starts before the current one and covers the whole overlapping part. Copies are recorded in
+dependency order, a section trimmed by an earlier copy is complete before it is copied from.
 
-    j = 0;
-    for (i = 0; i < len; i++) {
-        if (oa[i] < oa[p]) {
-            if (i != j) { OSWAP (i, j) }
-            j++;
+len: number of sections.
+foffs, moffs, lens: file offset, memory address, and length of each section.
+*/
+void H5VL_log_dataseti_resolve_overlaps (int len,
+                                         MPI_Aint *foffs,
+                                         MPI_Aint *moffs,
+                                         int *lens,
+                                         std::vector<H5VL_log_copy_ctx> &overlaps) {
+    int i;
+    int cover;            // Section reaching the furthest so far
+    MPI_Aint end;         // File offset after the end of the current section
+    MPI_Aint cend;        // File offset after the end of the covering section
+    std::vector<int> idx;  // Sorted order of the sections
+    std::vector<MPI_Aint> otmp;
+    std::vector<int> ltmp;
+    H5VL_log_copy_ctx ctx;
+
+    if (len < 2) { return; }
+
+    // Sort into order, ties are kept in the order of the breakdown
+    idx.resize (len);
+    for (i = 0; i < len; i++) { idx[i] = i; }
+    std::stable_sort (idx.begin (), idx.end (),
+                      [&foffs] (const int &l, const int &r) -> bool { return foffs[l] < foffs[r]; });
+
+    otmp.resize (len);
+    for (i = 0; i < len; i++) { otmp[i] = foffs[idx[i]]; }
+    memcpy (foffs, otmp.data (), sizeof (MPI_Aint) * len);
+    for (i = 0; i < len; i++) { otmp[i] = moffs[idx[i]]; }
+    memcpy (moffs, otmp.data (), sizeof (MPI_Aint) * len);
+    ltmp.resize (len);
+    for (i = 0; i < len; i++) { ltmp[i] = lens[idx[i]]; }
+    memcpy (lens, ltmp.data (), sizeof (int) * len);
+
+    // Sweep
+    cover = 0;
+    cend  = foffs[0] + lens[0];
+    for (i = 1; i < len; i++) {
+        end = foffs[i] + lens[i];
+        if (cend > foffs[i]) {  // Adjust for overlap
+            // Record a memory copy req that copy the result from the covering read
+            ctx.dst  = (char *)moffs[i];
+            ctx.size = std::min ((size_t)lens[i], (size_t) (cend - foffs[i]));
+            ctx.src  = (char *)(moffs[cover] + (foffs[i] - foffs[cover]));
+            overlaps.push_back (ctx);
+
+            // Trim off the later one
+            foffs[i] += ctx.size;
+            moffs[i] += ctx.size;
+            lens[i] -= ctx.size;
+        }
+        if (end > cend) {
+            cover = i;
+            cend  = end;
         }
     }
-
-    OSWAP (p, j)
-
-    sortoffsets (j, oa, ob, l);
-    sortoffsets (len - j - 1, oa + j + 1, ob + j + 1, l + j + 1);
 }
 
 /*
@@ -163,7 +181,7 @@ void H5VL_log_dataset_readi_passthru (std::vector<H5VL_log_idx_search_ret_t> &bl
                                         H5VL_log_file_t *fp) {
     herr_t err;
     hsize_t ii;
-    int32_t i, j, k, l;
+    int32_t i, j, k;
     int nblock = blocks.size ();  // Number of place to read
     std::vector<bool> newgroup (
         nblock,
@@ -180,8 +198,6 @@ void H5VL_log_dataset_readi_passthru (std::vector<H5VL_log_idx_search_ret_t> &bl
                                       // memory dataspace
     MPI_Offset ctr[H5S_MAX_RANK];     // Logical position of the current contiguous section in the
                                       // dataspace of the block being broken down
-    H5VL_log_copy_ctx ctx;  // Datastructure to record overlaps so we can copy the data to all the
-                            // destination buffer
     char dname[16];         // name of log dataset
     void **ldps = NULL;     // array of all log datasets
     H5VL_loc_params_t loc;
@@ -398,29 +414,13 @@ void H5VL_log_dataset_readi_passthru (std::vector<H5VL_log_idx_search_ret_t> &bl
                     }
                 }
 
-                // Sort into order
-                sortoffsets (nt - old_nt, foffs + old_nt, moffs + old_nt, lens + old_nt);
+                // Sort into order, should there be overlapping read, we have to adjust
+                H5VL_log_dataseti_resolve_overlaps (nt - old_nt, foffs + old_nt, moffs + old_nt,
+                                                    lens + old_nt, overlaps);
 
-                // Should there be overlapping read, we have to adjust
-                for (k = old_nt; k < nt; k++) {
-                    for (l = k + 1; l < nt; l++) {
-                        if (foffs[k] + lens[k] > foffs[l]) {  // Adjust for overlap
-                            // Record a memory copy req that copy the result from the former read to
-                            // cover the later one
-                            ctx.dst = (char *)moffs[l];
-                            ctx.size =
-                                std::min ((size_t)lens[l], (size_t)(foffs[k] - foffs[l] + lens[k]));
-                            ctx.src = (char *)(moffs[k] - ctx.size + lens[k]);
-                            overlaps.push_back (ctx);
-
-                            // Trim off the later one
-                            foffs[l] += ctx.size;
-                            moffs[l] += ctx.size;
-                            lens[l] -= ctx.size;
-                        }
-                    }
-                }
                 for (k = old_nt; k < nt; k++) {
+                    if (lens[k] == 0) { continue; }  // Fully covered by previous sections
+
                     log_dset = foff2logidx (foffs[k], doffs, fp->nldset);
                     CHECK_ID (log_dset);
                     err = sel_space (fspace_ids[log_dset], foffs[k] - doffs[log_dset], 1, NULL,
@@ -446,7 +446,7 @@ void H5VL_log_dataset_readi_gen_rtypes (std::vector<H5VL_log_idx_search_ret_t> &
                                         MPI_Datatype *mtype,
                                         std::vector<H5VL_log_copy_ctx> &overlaps) {
     int mpierr;
-    int32_t i, j, k, l;
+    int32_t i, j, k;
     int nblock = blocks.size ();  // Number of place to read
     std::vector<bool> newgroup (
         nblock,
@@ -466,8 +466,6 @@ void H5VL_log_dataset_readi_gen_rtypes (std::vector<H5VL_log_idx_search_ret_t> &
                                       // memory dataspace
     MPI_Offset ctr[H5S_MAX_RANK];     // Logical position of the current contiguous section in the
                                       // dataspace of the block being broken down
-    H5VL_log_copy_ctx ctx;  // Datastructure to record overlaps so we can copy the data to all the
-                            // destination buffer
     H5VL_logi_err_finally finally ([&ftypes, &mtypes, &foffs, &moffs, &lens, &nt] () -> void {
         int i;
         if (ftypes != NULL) {
@@ -640,28 +638,9 @@ void H5VL_log_dataset_readi_gen_rtypes (std::vector<H5VL_log_idx_search_ret_t> &
                     }
                 }
 
-                // Sort into order
-                sortoffsets (nt - old_nt, foffs + old_nt, moffs + old_nt, lens + old_nt);
-
-                // Should there be overlapping read, we have to adjust
-                for (k = old_nt; k < nt; k++) {
-                    for (l = k + 1; l < nt; l++) {
-                        if (foffs[k] + lens[k] > foffs[l]) {  // Adjust for overlap
-                            // Record a memory copy req that copy the result from the former read to
-                            // cover the later one
-                            ctx.dst  = (char *)moffs[l];
-                            ctx.size = std::min ((size_t)lens[l],
-                                                 (size_t) (foffs[k] - foffs[l] + lens[k]));
-                            ctx.src  = (char *)(moffs[k] - ctx.size + lens[k]);
-                            overlaps.push_back (ctx);
-
-                            // Trim off the later one
-                            foffs[l] += ctx.size;
-                            moffs[l] += ctx.size;
-                            lens[l] -= ctx.size;
-                        }
-                    }
-                }
+                // Sort into order, should there be overlapping read, we have to adjust
+                H5VL_log_dataseti_resolve_overlaps (nt - old_nt, foffs + old_nt, moffs + old_nt,
+                                                    lens + old_nt, overlaps);
             }
         }
     }
@@ -710,7 +689,23 @@ void *H5VL_log_dataseti_open (void *obj, void *uo, hid_t dxpl_id) {
     if (!op->fp->is_log_based_file) { return (void *)(dp.release ()); }
 
     // Atts
-    H5VL_logi_get_att (dp.get (), H5VL_LOG_DATASETI_ATTR_ID, H5T_NATIVE_INT32, &(dp->id), dxpl_id);
+    // Datasets still open since they were defined don't have attributes yet, look them up by path
+    dp->id = -1;
+    if (!dp->fp->att_pending.empty ()) {
+        std::string path =
+            H5VL_logi_object_get_name (dp->fp, dp->uo, H5I_DATASET, dp->uvlid, dxpl_id);
+        for (auto id : dp->fp->att_pending) {
+            if ((dp->fp->dsets_info[id]->att_flag & H5VL_LOG_DATASETI_ATT_NEW) &&
+                (dp->fp->dsets_info[id]->path == path)) {
+                dp->id = id;
+                break;
+            }
+        }
+    }
+    if (dp->id < 0) {
+        H5VL_logi_get_att (dp.get (), H5VL_LOG_DATASETI_ATTR_ID, H5T_NATIVE_INT32, &(dp->id),
+                           dxpl_id);
+    }
 
     // Construct new dataset info if not already constructed
     if (!(dp->fp->dsets_info[dp->id])) {
@@ -752,6 +747,9 @@ void *H5VL_log_dataseti_open (void *obj, void *uo, hid_t dxpl_id) {
             dip->fill = NULL;
         }
 
+        // Path of the anchor dataset for the dataset catalog
+        dip->path = H5VL_logi_object_get_name (dp->fp, dp->uo, H5I_DATASET, dp->uvlid, dxpl_id);
+
         // Record metadata in fp
         dp->fp->dsets_info[dp->id] = dip.release ();
         // dp->fp->mreqs[dp->id]	   = new H5VL_log_merged_wreq_t (dp, 1);
@@ -775,6 +773,41 @@ void *H5VL_log_dataseti_wrap (void *uo, H5VL_log_obj_t *cp) {
     return H5VL_log_dataseti_open (cp, uo, cp->fp->dxplid);
 } /* end H5VL_log_dataset_open() */
 
+/*
+ * Write the anchor dataset attributes deferred by dataset creation and extension
+ * Called with the anchor dataset of dp still open, so it does not need to be looked up
+ */
+void H5VL_log_dataseti_put_atts (H5VL_log_dset_t *dp, hid_t dxpl_id) {
+    H5VL_log_dset_info_t *dip = dp->fp->dsets_info[dp->id];  // Dataset info
+    void *lib_state           = NULL;
+    void *lib_context         = NULL;
+    H5VL_logi_err_finally finally (
+        [&lib_state, &lib_context] () -> void { H5VL_logi_restore_lib_stat (lib_state, lib_context); });
+
+    H5VL_LOGI_PROFILING_TIMER_START;
+
+    // Reset hdf5 context to allow attr operations within a dataset operation
+    H5VL_logi_reset_lib_stat (lib_state, lib_context);
+
+    if (dip->att_flag & H5VL_LOG_DATASETI_ATT_NEW) {
+        H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_DIMS, H5T_STD_I64LE, H5T_NATIVE_INT64,
+                           dip->ndim, dip->dims, dxpl_id, NULL);
+        H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_MDIMS, H5T_STD_I64LE, H5T_NATIVE_INT64,
+                           dip->ndim, dip->mdims, dxpl_id, NULL);
+        H5VL_logi_add_att (dp, H5VL_LOG_DATASETI_ATTR_ID, H5T_STD_I32LE, H5T_NATIVE_INT32, 1,
+                           &(dp->id), dxpl_id, NULL);
+
+        // No longer looked up by path when reopened
+        auto &pending = dp->fp->att_pending;
+        pending.erase (std::remove (pending.begin (), pending.end (), dp->id), pending.end ());
+    } else if (dip->att_flag & H5VL_LOG_DATASETI_ATT_DIMS) {
+        H5VL_logi_put_att (dp, H5VL_LOG_DATASETI_ATTR_DIMS, H5T_NATIVE_INT64, dip->dims, dxpl_id);
+    }
+    dip->att_flag = 0;
+
+    H5VL_LOGI_PROFILING_TIMER_STOP (dp->fp, TIMER_H5VL_LOG_DATASETI_PUT_ATTS);
+}
+
 /*-------------------------------------------------------------------------
  * Function:    H5VL_log_dataset_write
  *
@@ -797,6 +830,7 @@ void H5VL_log_dataseti_write (H5VL_log_dset_t *dp,
     H5VL_log_dset_info_t *dip = dp->fp->dsets_info[dp->id];  // Dataset info
     size_t esize;                                            // Element size of the memory type
     size_t selsize;                // Size of metadata selection after deduplication and compression
+    size_t mdsize;                 // Size of metadata entry before deduplication
     H5VL_log_wreq_t *r;            // Request obj
     H5VL_log_req_data_block_t db;  // Request data
     htri_t eqtype;                 // user buffer type equals dataset type?
@@ -831,6 +865,10 @@ void H5VL_log_dataseti_write (H5VL_log_dset_t *dp,
     if (!buf) ERR_OUT ("user buffer can't be NULL");
     H5VL_LOGI_PROFILING_TIMER_STOP (dp->fp, TIMER_H5VL_LOG_DATASET_WRITE_INIT);
 
+    if (dp->fp->trace) {
+        H5VL_logi_trace_io (dp->fp, H5VL_LOGI_TRACE_WRITE, dp->id, mem_type_id, dsel, plist_id);
+    }
+
     // Reset hdf5 context to allow file operations within a dataset operation
     H5VL_logi_reset_lib_stat (lib_state, lib_context);
 
@@ -845,43 +883,60 @@ void H5VL_log_dataseti_write (H5VL_log_dset_t *dp,
 
         H5VL_LOGI_PROFILING_TIMER_STOP (dp->fp, TIMER_H5VL_LOG_DATASET_WRITE_ENCODE);
 
-#ifdef LOGVOL_PROFILING
         H5VL_log_profile_add_time (dp->fp, TIMER_H5VL_LOG_FILEI_METASIZE_RAW,
                                    (double)(r->hdr->meta_size) / 1048576);
-#endif
         // Deduplication
         H5VL_LOGI_PROFILING_TIMER_START;
-        if (dp->fp->config & H5VL_FILEI_CONFIG_METADATA_SHARE) {
+        if (dp->fp->config & H5VL_FILEI_CONFIG_SEL_DICT) {
+            if (selsize > sizeof (MPI_Offset)) {  // If selection larger than the record ID
+                MPI_Offset id = dp->fp->sel_dict.lookup (
+                    r->hdr->flag & H5VL_LOGI_META_FLAG_SEL_MASK & ~H5VL_LOGI_META_FLAG_SEL_DEFLATE,
+                    r->sel_buf, (int32_t)selsize);
+                if (id >= 0) {
+                    mdsize = r->sel_buf - r->meta_buf + selsize;
+                    // The selection is in the dictionary, not compressed
+                    r->hdr->flag &= ~(H5VL_LOGI_META_FLAG_SEL_MASK);
+                    r->hdr->flag |= H5VL_LOGI_META_FLAG_SEL_DICT;
+                    *((MPI_Offset *)(r->sel_buf)) = id;  // Pending IDs are replaced on metaflush
+                    selsize = sizeof (MPI_Offset);       // New metadata size
+                    dp->fp->stat.meta_bytes_dedup_saved +=
+                        mdsize - (r->sel_buf - r->meta_buf + selsize);
+                    // Count size saved by duplication
+                    H5VL_log_profile_add_time (
+                        dp->fp, TIMER_H5VL_LOG_FILEI_METASIZE_DEDUP,
+                        (double)(r->sel_buf - r->meta_buf + selsize) / 1048576);
+                }
+            }
+        } else if (dp->fp->config & H5VL_FILEI_CONFIG_METADATA_SHARE) {
             if (selsize > sizeof (MPI_Offset)) {  // If selection larger than reference
-                auto ret = dp->fp->wreq_hash.find (*r);
-                if (ret == dp->fp->wreq_hash.end ()) {
-                    dp->fp->wreq_hash[*r] = r;
-                } else {
+                H5VL_log_wreq_t *ref = dp->fp->wreq_hash.find_or_insert (r);
+                if (ref) {
+                    mdsize = r->sel_buf - r->meta_buf + selsize;
                     r->hdr->flag |= H5VL_LOGI_META_FLAG_SEL_REF;
                     r->hdr->flag &= ~(H5VL_LOGI_META_FLAG_SEL_DEFLATE);  // Remove compression flag
                     if (r->hdr->flag & H5VL_LOGI_META_FLAG_REC) {
                         // If same record, we can remove the record field and make it a full
                         // reference
-                        if (ret->second->hdr->flag & H5VL_LOGI_META_FLAG_REC) {
+                        if (ref->hdr->flag & H5VL_LOGI_META_FLAG_REC) {
                             if (*((MPI_Offset *)(r->hdr + 1)) ==
-                                *((MPI_Offset *)(ret->second->hdr + 1))) {
+                                *((MPI_Offset *)(ref->hdr + 1))) {
                                 r->sel_buf -= sizeof (MPI_Offset);
                                 r->hdr->flag &= ~(H5VL_LOGI_META_FLAG_REC);
                             }
                         }
                     }
                     *((MPI_Offset *)(r->sel_buf)) =
-                        ret->second->meta_off - dp->fp->mdsize;  // Record the relative offset
+                        ref->meta_off - dp->fp->mdsize;  // Record the relative offset
 #ifdef WORDS_BIGENDIAN
                     H5VL_logi_llreverse ((uint64_t *)(r->sel_buf));
 #endif
                     selsize = sizeof (MPI_Offset);  // New metadata size
-#ifdef LOGVOL_PROFILING
+                    dp->fp->stat.meta_bytes_dedup_saved +=
+                        mdsize - (r->sel_buf - r->meta_buf + selsize);
                     // Count size saved by duplication
                     H5VL_log_profile_add_time (
                         dp->fp, TIMER_H5VL_LOG_FILEI_METASIZE_DEDUP,
                         (double)(r->sel_buf - r->meta_buf + selsize) / 1048576);
-#endif
                 }
             }
         }
@@ -905,11 +960,9 @@ void H5VL_log_dataseti_write (H5VL_log_dset_t *dp,
             if ((err == 0) && (clen < inlen)) {
                 memcpy (r->sel_buf, dp->fp->zbuf, clen);
                 selsize = clen;  // New metadata size
-#ifdef LOGVOL_PROFILING
                 // Count size saved by compression
                 H5VL_log_profile_add_time (dp->fp, TIMER_H5VL_LOG_FILEI_METASIZE_ZIP,
                                            (double)(r->sel_buf - r->meta_buf + selsize) / 1048576);
-#endif
             } else {
                 // Compressed size larger, abort compression
                 r->hdr->flag &= ~(H5VL_LOGI_META_FLAG_SEL_DEFLATE);
@@ -1047,7 +1100,7 @@ void H5VL_log_dataseti_read (H5VL_log_dset_t *dp,
     H5VL_log_rreq_t *r;   // Request entry
     H5S_sel_type mstype;  // Type of selection in mem_space_id
     hbool_t rtype;        // Non-blocking?
-    size_t num_pending_writes = 0;
+    unsigned long flush_flags[2];  // Number of pending writes, whether a flush is needed
     void *lib_state = NULL;
     void *lib_context = NULL;
     H5FD_mpio_xfer_t xfer_mode;
@@ -1061,6 +1114,10 @@ void H5VL_log_dataseti_read (H5VL_log_dset_t *dp,
     if (!buf) ERR_OUT ("user buffer can't be NULL");
     H5VL_LOGI_PROFILING_TIMER_STOP (dp->fp, TIMER_H5VL_LOG_DATASET_READ_INIT);
 
+    if (dp->fp->trace) {
+        H5VL_logi_trace_io (dp->fp, H5VL_LOGI_TRACE_READ, dp->id, mem_type_id, dsel, plist_id);
+    }
+
     // Reset hdf5 context to allow file operations within a dataset operation
     H5VL_logi_reset_lib_stat (lib_state, lib_context);
 
@@ -1128,14 +1185,18 @@ void H5VL_log_dataseti_read (H5VL_log_dset_t *dp,
         // flush pending write requests if collective
         err = H5Pget_dxpl_mpio (dp->fp->dxplid, &xfer_mode);
         CHECK_ERR
+        std::vector<H5VL_log_rreq_t *> tmp (1, r);
         if ((xfer_mode == H5FD_MPIO_COLLECTIVE) || dp->fp->np == 1) {
-            num_pending_writes = H5VL_log_filei_get_num_pending_writes (dp->fp);
-            MPI_Allreduce (MPI_IN_PLACE, &num_pending_writes, 1, MPI_UNSIGNED_LONG, MPI_MAX,
-                           dp->fp->comm);
-            if (num_pending_writes > 0) { H5VL_log_nb_flush_write_reqs (dp->fp); }
+            // Flush if any process has pending writes and any process reads a region not fully
+            // covered by its own pending writes (read-own-writes serves the covered ones)
+            flush_flags[0] = H5VL_log_filei_get_num_pending_writes (dp->fp);
+            flush_flags[1] = H5VL_log_nb_own_writes_cover (dp->fp, tmp) ? 0 : 1;
+            MPI_Allreduce (MPI_IN_PLACE, flush_flags, 2, MPI_UNSIGNED_LONG, MPI_MAX, dp->fp->comm);
+            if (flush_flags[0] > 0 && flush_flags[1] > 0) {
+                H5VL_log_nb_flush_write_reqs (dp->fp);
+            }
         }
 
-        std::vector<H5VL_log_rreq_t *> tmp (1, r);
         H5VL_log_nb_flush_read_reqs (dp->fp, tmp, plist_id);
     } else {
         dp->fp->rreqs.push_back (r);
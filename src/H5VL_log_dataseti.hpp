@@ -17,6 +17,10 @@
 #define H5VL_LOG_DATASETI_ATTR_MDIMS "_mdims"
 #define H5VL_LOG_DATASETI_ATTR_ID    "_ID"
 
+// Anchor dataset attributes waiting to be written at dataset close (H5VL_log_dset_info_t::att_flag)
+#define H5VL_LOG_DATASETI_ATT_NEW  0x01  // All attributes are to be created
+#define H5VL_LOG_DATASETI_ATT_DIMS 0x02  // The dims attribute is outdated
+
 typedef struct H5VL_log_dio_n_arg_t {
     hid_t mem_type_id;
     int n;
@@ -33,6 +37,12 @@ typedef struct H5VL_log_copy_ctx {
 
 void *H5VL_log_dataseti_open (void *obj, void *uo, hid_t dxpl_id);
 void *H5VL_log_dataseti_wrap (void *uo, H5VL_log_obj_t *cp);
+void H5VL_log_dataseti_put_atts (H5VL_log_dset_t *dp, hid_t dxpl_id);
+void H5VL_log_dataseti_resolve_overlaps (int len,
+                                         MPI_Aint *foffs,
+                                         MPI_Aint *moffs,
+                                         int *lens,
+                                         std::vector<H5VL_log_copy_ctx> &overlaps);
 void H5VL_log_dataset_readi_gen_rtypes (std::vector<H5VL_log_idx_search_ret_t> &blocks,
                                         MPI_Datatype *ftype,
                                         MPI_Datatype *mtype,
@@ -20,6 +20,9 @@
 #include "H5VL_logi.hpp"
 #include "H5VL_logi_util.hpp"
 
+int H5Fprofile_report_op_val = 0;
+int H5Fget_io_stat_op_val    = 0;
+
 /********************* */
 /* Function prototypes */
 /********************* */
@@ -115,6 +118,7 @@ void *H5VL_log_file_create (
         fp->mdsize            = 0;
         fp->zbsize            = 0;
         fp->zbuf              = NULL;
+        fp->zstrm             = NULL;
         fp->is_log_based_file = true;
         fp->is_new            = true;
         mpierr                = MPI_Comm_dup (comm, &(fp->comm));
@@ -268,6 +272,7 @@ void *H5VL_log_file_open (
         fp->mdsize            = 0;
         fp->zbsize            = 0;
         fp->zbuf              = NULL;
+        fp->zstrm             = NULL;
         fp->is_log_based_file = true;
         fp->is_new            = false;
         mpierr                = MPI_Comm_dup (comm, &(fp->comm));
@@ -369,15 +374,29 @@ herr_t H5VL_log_file_get (void *file, H5VL_file_get_args_t *args, hid_t dxpl_id,
             if (fp->config & H5VL_FILEI_CONFIG_METADATA_MERGE) {
                 H5Pset_meta_merge (args->args.get_fapl.fapl_id, true);
             }
-            if (fp->config & H5VL_FILEI_CONFIG_SEL_ENCODE) {
+            if (fp->config & H5VL_FILEI_CONFIG_SEL_VARINT) {
+                H5Pset_sel_encoding (args->args.get_fapl.fapl_id, H5VL_LOG_ENCODING_VARINT);
+            } else if (fp->config & H5VL_FILEI_CONFIG_SEL_ENCODE) {
                 H5Pset_sel_encoding (args->args.get_fapl.fapl_id, H5VL_LOG_ENCODING_OFFSET);
             }
             if (fp->config & H5VL_FILEI_CONFIG_SEL_DEFLATE) {
                 H5Pset_meta_zip (args->args.get_fapl.fapl_id, true);
             }
+            if (fp->config & H5VL_FILEI_CONFIG_META_SEC_ZIP) {
+                H5Pset_meta_section_zip (args->args.get_fapl.fapl_id, true);
+            }
+            if (fp->config & H5VL_FILEI_CONFIG_SEL_DICT) {
+                H5Pset_meta_dict (args->args.get_fapl.fapl_id, true);
+            }
             if (fp->config & H5VL_FILEI_CONFIG_METADATA_SHARE) {
                 H5Pset_meta_share (args->args.get_fapl.fapl_id, true);
             }
+            if (fp->idx_nthread > 1) {
+                H5Pset_idx_nthread (args->args.get_fapl.fapl_id, fp->idx_nthread);
+            }
+            if (!fp->trace_path.empty ()) {
+                H5Pset_trace (args->args.get_fapl.fapl_id, fp->trace_path.c_str ());
+            }
         }
 
         H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILE_GET);
@@ -507,6 +526,20 @@ herr_t H5VL_log_file_optional (void *file, H5VL_optional_args_t *args, hid_t dxp
         }
 #endif
 
+        // Profiling report, args->args is the output path
+        if (args->op_type == H5Fprofile_report_op_val) {
+            if (!fp->is_log_based_file) { RET_ERR ("Not a log-based file") }
+            H5VL_log_profile_report (fp, (const char *)(args->args));
+            goto err_out;
+        }
+
+        // I/O statistics, args->args is the H5VL_log_io_stat_t to fill
+        if (args->op_type == H5Fget_io_stat_op_val) {
+            if (!fp->is_log_based_file) { RET_ERR ("Not a log-based file") }
+            H5VL_log_filei_get_io_stat (fp, (H5VL_log_io_stat_t *)(args->args));
+            goto err_out;
+        }
+
         H5VL_LOGI_PROFILING_TIMER_START;
         err = H5VLfile_optional (fp->uo, fp->uvlid, args, dxpl_id, req);
         CHECK_ERR
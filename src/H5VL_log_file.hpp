@@ -21,8 +21,10 @@
 #include "H5VL_log_dataset.hpp"
 #include "H5VL_log_obj.hpp"
 #include "H5VL_logi.hpp"
+#include "H5VL_logi_dedup.hpp"
 #include "H5VL_logi_idx.hpp"
 #include "H5VL_logi_nb.hpp"
+#include "H5VL_logi_trace.hpp"
 
 typedef struct H5VL_log_contig_buffer_t {
     char *begin, *end;
@@ -84,11 +86,13 @@ typedef struct H5VL_log_file_t : H5VL_log_obj_t {
 
     std::vector<H5VL_log_merged_wreq_t *> mreqs;     // Merged request for every dataset
     std::vector<H5VL_log_dset_info_t *> dsets_info;  // Opened datasets
+    std::vector<int> att_pending;  // Open datasets without anchor attributes created yet
 
     ssize_t bsize;  // Current data buffer size allocated
     size_t bused;   // Current data buffer size used
 
     ssize_t mbuf_size;  // Max buffer size allowed for indexing
+    int idx_nthread;    // Number of threads building and searching the index
 
     std::string name;     // File name
     std::string subname;  // Name of the target subfile
@@ -98,17 +102,29 @@ typedef struct H5VL_log_file_t : H5VL_log_obj_t {
     // H5VL_log_meta_cache_t meta_cache;
 
     // Write metadata handling
-    std::unordered_map<H5VL_log_wreq_t, H5VL_log_wreq_t *>
-        wreq_hash;  // Hash table for deduplication
+    H5VL_logi_wreq_hash wreq_hash;  // Hash table for deduplication
+    H5VL_logi_sel_dict sel_dict;    // Selections deduplicated across metadata flushes
     MPI_Offset mdsize;
     char *zbuf;     // Buffer for metadata compression
     size_t zbsize;  // size of zbuf
+    void *zstrm;    // Deflate stream reused to compress metadata sections
     // std::vector<int> meta_ref;
 
+    H5VL_logi_meta_dict_t dict;  // Selection dictionary records loaded, for reading
+    std::vector<H5VL_logi_meta_sec_table_t>
+        mdsecs;  // Section tables of the first metadata datasets, for reading a window at a time
+
     // std::vector<int> lut;
     H5VL_logi_idx_t *idx;  // Index of data, for reading
     bool idxvalid;         // Is index up to date
+    int idxwin_md;         // Metadata dataset of the window held in the index, -1 if none
+    int idxwin_sec;        // First section of the window held in the index
     bool metadirty;        // Is there pending metadata to 
+    bool catalog_dirty;    // Is the dataset catalog out of date
+
+    H5VL_log_io_stat_t stat;  // Cumulative I/O statistics, pending fields are filled on query
+    H5VL_logi_trace_t *trace;  // I/O trace, NULL if not tracing
+    std::string trace_path;    // Path of the I/O trace, empty if not tracing
 
     // Configuration flag
     int config;  // Config flags
@@ -118,12 +134,9 @@ typedef struct H5VL_log_file_t : H5VL_log_obj_t {
     bool is_log_based_file;  // indicate if a file is a regular file (false) or a log-based file
                              // (false)
 
-#ifdef ENABLE_PROFILING
 #ifndef REPLAY_BUILD
-    //#pragma message ( "C Preprocessor got here!" )
     double tlocal[H5VL_LOG_NTIMER];
     double clocal[H5VL_LOG_NTIMER];
-#endif
 #endif
 
     H5VL_log_file_t ();
@@ -156,3 +169,6 @@ herr_t H5VL_log_file_specific (void *file,
                                void **req);
 herr_t H5VL_log_file_optional (void *file, H5VL_optional_args_t *args, hid_t dxpl_id, void **req);
 herr_t H5VL_log_file_close (void *file, hid_t dxpl_id, void **req);
+
+extern int H5Fprofile_report_op_val;
+extern int H5Fget_io_stat_op_val;
@@ -127,6 +127,9 @@ void H5VL_log_filei_post_open (H5VL_log_file_t *fp) {
 
     // Att
     H5VL_logi_get_att (fp, H5VL_LOG_FILEI_ATTR, H5T_NATIVE_INT32, attbuf, fp->dxplid);
+    if (attbuf[3] & H5VL_FILEI_FEATURE_MASK & ~H5VL_FILEI_FEATURE_KNOWN) {
+        RET_ERR ("File uses a metadata format feature not supported by this version")
+    }
 
     fp->ndset  = attbuf[0];
     fp->nldset = attbuf[1];
@@ -186,15 +189,23 @@ void H5VL_log_filei_post_open (H5VL_log_file_t *fp) {
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILE_CREATE_FH);
     CHECK_MPIERR
 
-    // Visit all dataasets for info
-    args.op_type             = H5VL_OBJECT_VISIT;
-    args.args.visit.idx_type = H5_INDEX_CRT_ORDER;
-    args.args.visit.order    = H5_ITER_INC;
-    args.args.visit.op       = H5VL_log_filei_dset_visit;
-    args.args.visit.op_data  = NULL;
-    args.args.visit.fields   = H5O_INFO_ALL;
-    err = H5VLobject_specific (fp->uo, &loc, fp->uvlid, &args, fp->dxplid, NULL);
-    CHECK_ERR
+    // Rebuild dataset info from the dataset catalog, anchor datasets are opened on demand
+    if (!H5VL_log_filei_catalog_read (fp)) {
+        // No catalog, visit all dataasets for info
+        args.op_type             = H5VL_OBJECT_VISIT;
+        args.args.visit.idx_type = H5_INDEX_CRT_ORDER;
+        args.args.visit.order    = H5_ITER_INC;
+        args.args.visit.op       = H5VL_log_filei_dset_visit;
+        args.args.visit.op_data  = NULL;
+        args.args.visit.fields   = H5O_INFO_ALL;
+        err = H5VLobject_specific (fp->uo, &loc, fp->uvlid, &args, fp->dxplid, NULL);
+        CHECK_ERR
+
+        // Add the catalog on close
+        fp->catalog_dirty = true;
+    }
+
+    H5VL_logi_trace_open (fp);
 
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILE_OPEN);
 }
@@ -264,6 +275,7 @@ void H5VL_log_filei_post_create (H5VL_log_file_t *fp) {
                                         H5P_GROUP_CREATE_DEFAULT, fp->dxplid, NULL);
     CHECK_PTR (fp->lgp)
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILE_CREATE_GROUP);
+    fp->catalog_dirty = true;
 
     if (fp->config & H5VL_FILEI_CONFIG_DATA_ALIGN) {
         fp->fd = open (fp->name.c_str(), O_RDWR);
@@ -289,6 +301,8 @@ void H5VL_log_filei_post_create (H5VL_log_file_t *fp) {
                         H5VL_LOG_FILEI_NATTR, attbuf, fp->dxplid, NULL);
     H5VL_log_filei_register (fp);
 
+    H5VL_logi_trace_open (fp);
+
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILE_CREATE);
 }
 
@@ -338,6 +352,7 @@ void H5VL_log_filei_bfree (H5VL_log_file_t *fp, void *buf) {
 void H5VL_log_filei_parse_fapl (H5VL_log_file_t *fp, hid_t faplid) {
     herr_t err = 0;
     hbool_t ret;
+    ssize_t len;
     H5VL_log_sel_encoding_t encoding;
     char *env;
 
@@ -377,15 +392,53 @@ void H5VL_log_filei_parse_fapl (H5VL_log_file_t *fp, hid_t faplid) {
         }
     }
 
+    err = H5Pget_meta_section_zip (faplid, &ret);
+    CHECK_ERR
+    if (ret) { fp->config |= H5VL_FILEI_CONFIG_META_SEC_ZIP; }
+    env = getenv ("H5VL_LOG_METADATA_SECTION_ZIP");
+    if (env) {
+        if (strcmp (env, "1") == 0) {
+            fp->config |= H5VL_FILEI_CONFIG_META_SEC_ZIP;
+        } else {
+            fp->config &= ~H5VL_FILEI_CONFIG_META_SEC_ZIP;
+        }
+    }
+#ifndef ENABLE_ZLIB
+    fp->config &= ~H5VL_FILEI_CONFIG_META_SEC_ZIP;  // Needs zlib, ignored like entry compression
+#endif
+    // Entries are not deflated again when the whole section is compressed
+    if (fp->config & H5VL_FILEI_CONFIG_META_SEC_ZIP) {
+        fp->config &= ~H5VL_FILEI_CONFIG_SEL_DEFLATE;
+    }
+
+    err = H5Pget_meta_dict (faplid, &ret);
+    CHECK_ERR
+    if (ret) { fp->config |= H5VL_FILEI_CONFIG_SEL_DICT; }
+    env = getenv ("H5VL_LOG_METADATA_DICT");
+    if (env) {
+        if (strcmp (env, "1") == 0) {
+            fp->config |= H5VL_FILEI_CONFIG_SEL_DICT;
+        } else {
+            fp->config &= ~H5VL_FILEI_CONFIG_SEL_DICT;
+        }
+    }
+
     err = H5Pget_sel_encoding (faplid, &encoding);
     CHECK_ERR
     if (encoding == H5VL_LOG_ENCODING_OFFSET) { fp->config |= H5VL_FILEI_CONFIG_SEL_ENCODE; }
+    // Varint entries fall back to offset encoding where they do not apply (merged entries)
+    if (encoding == H5VL_LOG_ENCODING_VARINT) {
+        fp->config |= H5VL_FILEI_CONFIG_SEL_ENCODE | H5VL_FILEI_CONFIG_SEL_VARINT;
+    }
     env = getenv ("H5VL_LOG_SEL_ENCODING");
     if (env) {
         if (strcmp (env, "canonical") == 0) {
-            fp->config &= ~H5VL_FILEI_CONFIG_SEL_ENCODE;
+            fp->config &= ~(H5VL_FILEI_CONFIG_SEL_ENCODE | H5VL_FILEI_CONFIG_SEL_VARINT);
+        } else if (strcmp (env, "varint") == 0) {
+            fp->config |= H5VL_FILEI_CONFIG_SEL_ENCODE | H5VL_FILEI_CONFIG_SEL_VARINT;
         } else {
             fp->config |= H5VL_FILEI_CONFIG_SEL_ENCODE;
+            fp->config &= ~H5VL_FILEI_CONFIG_SEL_VARINT;
         }
     }
 
@@ -394,6 +447,12 @@ void H5VL_log_filei_parse_fapl (H5VL_log_file_t *fp, hid_t faplid) {
     env = getenv ("H5VL_LOG_IDX_BSIZE");
     if (env) { fp->mbuf_size = (MPI_Offset)(atoll (env)); }
 
+    err = H5Pget_idx_nthread (faplid, &(fp->idx_nthread));
+    CHECK_ERR
+    env = getenv ("H5VL_LOG_IDX_NTHREAD");
+    if (env) { fp->idx_nthread = atoi (env); }
+    if (fp->idx_nthread < 1) { fp->idx_nthread = 1; }
+
     /*
     err = H5Pget_sel_encoding (faplid, &encoding);
     CHECK_ERR
@@ -432,6 +491,45 @@ void H5VL_log_filei_parse_fapl (H5VL_log_file_t *fp, hid_t faplid) {
             fp->config &= ~H5VL_FILEI_CONFIG_PASSTHRU;
         }
     }
+
+    err = H5Pget_shadow_elim (faplid, &ret);
+    CHECK_ERR
+    if (ret) { fp->config |= H5VL_FILEI_CONFIG_SHADOW_ELIM; }
+    env = getenv ("H5VL_LOG_SHADOW_ELIM");
+    if (env) {
+        if (strcmp (env, "1") == 0) {
+            fp->config |= H5VL_FILEI_CONFIG_SHADOW_ELIM;
+        } else {
+            fp->config &= ~H5VL_FILEI_CONFIG_SHADOW_ELIM;
+        }
+    }
+
+    err = H5Pget_read_own_writes (faplid, &ret);
+    CHECK_ERR
+    if (ret) { fp->config |= H5VL_FILEI_CONFIG_READ_OWN_WRITES; }
+    env = getenv ("H5VL_LOG_READ_OWN_WRITES");
+    if (env) {
+        if (strcmp (env, "1") == 0) {
+            fp->config |= H5VL_FILEI_CONFIG_READ_OWN_WRITES;
+        } else {
+            fp->config &= ~H5VL_FILEI_CONFIG_READ_OWN_WRITES;
+        }
+    }
+    // Selections of merged requests are not decoded in memory
+    if (fp->config & H5VL_FILEI_CONFIG_METADATA_MERGE) {
+        fp->config &= ~H5VL_FILEI_CONFIG_READ_OWN_WRITES;
+    }
+
+    len = H5Pget_trace (faplid, NULL, 0);
+    CHECK_ID (len)
+    if (len > 0) {
+        fp->trace_path.resize (len + 1);
+        len = H5Pget_trace (faplid, &(fp->trace_path[0]), len + 1);
+        CHECK_ID (len)
+        fp->trace_path.resize (len);
+    }
+    env = getenv ("H5VL_LOG_TRACE");
+    if (env) { fp->trace_path = env; }
 }
 
 void H5VL_log_filei_parse_fcpl (H5VL_log_file_t *fp, hid_t fcplid) {
@@ -485,7 +583,8 @@ hid_t H5VL_log_filei_get_under_plist (hid_t faplid) {
         "H5VL_log_nb_buffer_size",      "H5VL_log_idx_buffer_size", "H5VL_log_metadata_merge",
         "H5VL_log_metadata_share",      "H5VL_log_metadata_zip",    "H5VL_log_sel_encoding",
         "H5VL_log_data_layout",         "H5VL_log_subfiling",       "H5VL_log_single_subfile_read",
-        "H5VL_log_passthru",
+        "H5VL_log_passthru",            "H5VL_log_shadow_elim",     "H5VL_log_read_own_writes",
+        "H5VL_log_idx_nthread",         "H5VL_log_trace",
     };
 
     try {
@@ -671,6 +770,9 @@ size_t H5VL_log_filei_get_num_pending_writes(H5VL_log_file_t *fp) {
 void H5VL_log_filei_flush (H5VL_log_file_t *fp, hid_t dxplid) {
     H5VL_LOGI_PROFILING_TIMER_START;
     size_t num_reqs[2] = {0};
+    double t0          = MPI_Wtime ();
+
+    if (fp->trace) { H5VL_logi_trace_flush (fp); }
 
     num_reqs[0] = H5VL_log_filei_get_num_pending_writes(fp);  // num of write requests
     num_reqs[1] = fp->rreqs.size ();  // num of read requests
@@ -685,9 +787,29 @@ void H5VL_log_filei_flush (H5VL_log_file_t *fp, hid_t dxplid) {
         H5VL_log_nb_flush_read_reqs (fp, fp->rreqs, dxplid);
     }
 
+    fp->stat.nflush++;
+    fp->stat.last_flush_time = MPI_Wtime () - t0;
+
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_FLUSH);
 }
-#if 0 // UNUSED
+
+void H5VL_log_filei_get_io_stat (H5VL_log_file_t *fp, H5VL_log_io_stat_t *stat) {
+    size_t i;
+
+    *stat                    = fp->stat;
+    stat->pending_bytes      = fp->bused;
+    stat->pending_reqs       = fp->wreqs.size () - fp->nflushed;
+    stat->pending_meta_bytes = fp->mdsize;
+    // Merged requests are not in wreqs until the flush
+    for (i = 0; i < fp->mreqs.size (); i++) {
+        if (fp->mreqs[i] && (fp->mreqs[i]->nsel > 0)) {
+            stat->pending_reqs++;
+            stat->pending_meta_bytes += fp->mreqs[i]->hdr->meta_size;
+        }
+    }
+    stat->idx_bytes = fp->idx->memsize ();
+}
+
 static inline void print_info (MPI_Info *info_used) {
     int i, nkeys;
 
@@ -708,7 +830,7 @@ static inline void print_info (MPI_Info *info_used) {
     }
     printf ("-----------------------------------------------------------\n");
 }
-#endif
+
 void H5VL_log_filei_close (H5VL_log_file_t *fp) {
     herr_t err = 0;
     int mpierr;
@@ -750,6 +872,9 @@ void H5VL_log_filei_close (H5VL_log_file_t *fp) {
         // Generate metadata table
         H5VL_log_filei_metaflush (fp);
 
+        // Record dataset info for the next file open
+        if (fp->catalog_dirty) { H5VL_log_filei_catalog_write (fp); }
+
         // Update file attr
         attbuf[0] = fp->ndset;
         attbuf[1] = fp->nldset;
@@ -778,8 +903,7 @@ void H5VL_log_filei_close (H5VL_log_file_t *fp) {
 
     H5VL_logi_restore_lib_stat (lib_state, lib_context);
 
-#ifdef LOGVOL_PROFILING
-    {
+    if (H5VL_log_profile_enabled) {
         MPI_Info info;
         char *_env_str = getenv ("H5VL_LOG_PRINT_MPI_INFO");
         if (_env_str != NULL && *_env_str != '0') {
@@ -790,7 +914,6 @@ void H5VL_log_filei_close (H5VL_log_file_t *fp) {
             }
         }
     }
-#endif
 
     // Close the file with MPI
     mpierr = MPI_File_close (&(fp->fh));
@@ -801,6 +924,9 @@ void H5VL_log_filei_close (H5VL_log_file_t *fp) {
 
     // Free compression buffer
     free (fp->zbuf);
+#ifdef ENABLE_ZLIB
+    H5VL_log_zip_stream_free (fp->zstrm);
+#endif
 
     // Free dataset info
     for (auto info : fp->dsets_info) {
@@ -825,12 +951,14 @@ void H5VL_log_filei_close (H5VL_log_file_t *fp) {
 
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILE_CLOSE);
 
-#ifdef ENABLE_PROFILING
-    {
+    if (H5VL_log_profile_enabled) {
         char *_env_str = getenv ("H5VL_LOG_SHOW_PROFILING_INFO");
         if (_env_str != NULL && *_env_str != '0') { H5VL_log_profile_print (fp); }
+        _env_str = getenv ("H5VL_LOG_PROFILING_OUTPUT");
+        if (_env_str != NULL && *_env_str != '\0') { H5VL_log_profile_report (fp, _env_str); }
     }
-#endif
+
+    H5VL_logi_trace_close (fp);
 
     H5VL_log_filei_rm (fp);
 
@@ -1094,13 +1222,16 @@ H5VL_log_file_t::H5VL_log_file_t () {
     this->nflushed  = 0;
     this->type      = H5I_FILE;
     this->idxvalid  = false;
+    this->idxwin_md = -1;
     this->metadirty = false;
+    this->catalog_dirty = false;
+    this->idx_nthread = 1;
+    memset (&(this->stat), 0, sizeof (H5VL_log_io_stat_t));
+    this->trace = NULL;
 #ifdef LOGVOL_DEBUG
     this->ext_ref = 0;
 #endif
-#ifdef LOGVOL_PROFILING
     H5VL_log_profile_reset (fp);
-#endif
 }
 H5VL_log_file_t::H5VL_log_file_t (hid_t uvlid) : H5VL_log_file_t () {
     this->uvlid = uvlid;
@@ -14,20 +14,49 @@
 #define H5VL_FILEI_CONFIG_SEL_DEFLATE         0x04
 #define H5VL_FILEI_CONFIG_METADATA_SHARE      0x08
 #define H5VL_FILEI_CONFIG_PASSTHRU            0x10
+#define H5VL_FILEI_CONFIG_SEL_VARINT          0x20
+#define H5VL_FILEI_CONFIG_META_SEC_ZIP        0x40
+#define H5VL_FILEI_CONFIG_SEL_DICT            0x80
 
 #define H5VL_FILEI_CONFIG_DATA_ALIGN 0x100
 #define H5VL_FILEI_CONFIG_SUBFILING  0x200
 // Read only the subfile matching the rank of the process
 #define H5VL_FILEI_CONFIG_SINGLE_SUBFILE_READ 0x400
+// Only read the newest log entry covering each part of the read selection
+#define H5VL_FILEI_CONFIG_SHADOW_ELIM 0x800
+// Serve reads from the write requests queued on this process instead of flushing them
+#define H5VL_FILEI_CONFIG_READ_OWN_WRITES 0x1000
+
+// Metadata format features used by any session of the file, kept in the config attribute
+// A file using a feature outside H5VL_FILEI_FEATURE_KNOWN is refused on open
+#define H5VL_FILEI_FEATURE_META_SEC_ZIP 0x10000  // Compressed metadata sections
+#define H5VL_FILEI_FEATURE_SEL_VARINT   0x20000  // Varint selections and packed entry headers
+#define H5VL_FILEI_FEATURE_SEL_DICT     0x40000  // Selection dictionary references
+#define H5VL_FILEI_FEATURE_MASK         0x7fff0000
+#define H5VL_FILEI_FEATURE_KNOWN                                                         \
+    (H5VL_FILEI_FEATURE_META_SEC_ZIP | H5VL_FILEI_FEATURE_SEL_VARINT |                   \
+     H5VL_FILEI_FEATURE_SEL_DICT)
 
 #define H5VL_LOG_FILEI_GROUP_LOG "_LOG"
 #define H5VL_LOG_FILEI_ATTR      "_int_att"
 #define H5VL_LOG_FILEI_NATTR     5
 #define H5VL_LOG_FILEI_DSET_META "_md"
+#define H5VL_LOG_FILEI_DSET_DICT "_dict"
 #define H5VL_LOG_FILEI_DSET_DATA "_ld"
+#define H5VL_LOG_FILEI_DSET_CATALOG "_catalog"
 
 // File internals
 
+// Consecutive metadata sections of a metadata dataset, loaded into the index together
+typedef struct H5VL_log_filei_metawin_t {
+    int md          = -1;                // Metadata dataset, -1 if the window is empty
+    int sec         = -1;                // First section of the window in md
+    bool held       = false;             // The index holds the window, buf is not read
+    MPI_Offset size = 0;                 // Size of the raw sections
+    char *buf       = NULL;              // Raw sections
+    MPI_Request req = MPI_REQUEST_NULL;  // Nonblocking read of buf, if not done
+} H5VL_log_filei_metawin_t;
+
 inline void H5VL_log_filei_init_idx (H5VL_log_file_t *fp) {
     switch (fp->index_type) {
         case list:
@@ -51,9 +80,22 @@ extern herr_t H5VL_log_filei_dset_visit (hid_t o_id,
                                          void *op_data);
 extern size_t H5VL_log_filei_get_num_pending_writes(H5VL_log_file_t *fp);
 extern void H5VL_log_filei_flush (H5VL_log_file_t *fp, hid_t dxplid);
+extern void H5VL_log_filei_get_io_stat (H5VL_log_file_t *fp, H5VL_log_io_stat_t *stat);
 extern void H5VL_log_filei_metaflush (H5VL_log_file_t *fp);
 extern void H5VL_log_filei_metaupdate (H5VL_log_file_t *fp);
-extern void H5VL_log_filei_metaupdate_part (H5VL_log_file_t *fp, int &md, int &sec);
+extern void H5VL_log_filei_catalog_write (H5VL_log_file_t *fp);
+extern bool H5VL_log_filei_catalog_read (H5VL_log_file_t *fp);
+extern void H5VL_log_filei_catalog_relink (H5VL_log_file_t *fp,
+                                           const std::string &from,
+                                           const std::string &to);
+extern void H5VL_log_filei_metawin_start (H5VL_log_file_t *fp,
+                                          int &md,
+                                          int &sec,
+                                          H5VL_log_filei_metawin_t &win);
+extern void H5VL_log_filei_metawin_load (H5VL_log_file_t *fp, H5VL_log_filei_metawin_t &win);
+extern void H5VL_log_filei_metawin_free (H5VL_log_filei_metawin_t &win);
+extern void H5VL_log_filei_dictflush (H5VL_log_file_t *fp);
+extern void H5VL_log_filei_dictload (H5VL_log_file_t *fp);
 extern void H5VL_log_filei_balloc (H5VL_log_file_t *fp, size_t size, void **buf);
 extern void H5VL_log_filei_bfree (H5VL_log_file_t *fp, void *buf);
 
@@ -0,0 +1,433 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <mpi.h>
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "H5VL_log_dataset.hpp"
+#include "H5VL_log_file.hpp"
+#include "H5VL_log_filei.hpp"
+#include "H5VL_logi.hpp"
+#include "H5VL_logi_err.hpp"
+#include "H5VL_logi_util.hpp"
+#include "H5VL_logi_wrapper.hpp"
+
+/*
+ * The dataset catalog is a byte dataset in the log group holding the information of every user
+ * dataset, indexed by dataset ID. It lets file open rebuild fp->dsets_info without visiting and
+ * opening every anchor dataset. The catalog is an array of little-endian 64-bit integers:
+ *   version, ndset,
+ *   then per dataset ID:
+ *     ndim (-1 if the dataset info is not available), dims[ndim], mdims[ndim],
+ *     encoded datatype (bytes), nfilter,
+ *     per filter: id, flags, filter_config, cd_nelmts, cd_values[cd_nelmts], name (bytes),
+ *     fill value (bytes, empty if not defined), path of the anchor dataset (bytes)
+ * Bytes are stored as their length followed by the data, padded to a multiple of 8.
+ */
+
+#define H5VL_LOG_FILEI_CATALOG_VERSION 1
+
+static inline void H5VL_log_filei_catalog_put (std::vector<char> &buf, int64_t val) {
+    size_t off = buf.size ();
+
+    buf.resize (off + sizeof (int64_t));
+#ifdef WORDS_BIGENDIAN
+    H5VL_logi_llreverse ((uint64_t *)&val);
+#endif
+    memcpy (buf.data () + off, &val, sizeof (int64_t));
+}
+
+static inline void H5VL_log_filei_catalog_put (std::vector<char> &buf,
+                                               const void *data,
+                                               size_t len) {
+    size_t off;
+
+    H5VL_log_filei_catalog_put (buf, (int64_t)len);
+    off = buf.size ();
+    buf.resize (off + (len + sizeof (int64_t) - 1) / sizeof (int64_t) * sizeof (int64_t), 0);
+    if (len) { memcpy (buf.data () + off, data, len); }
+}
+
+// Cursor over a catalog read from the file
+typedef struct H5VL_log_filei_catalog_cursor_t {
+    char *cur;
+    char *end;
+
+    int64_t get () {
+        int64_t val;
+
+        if (cur + sizeof (int64_t) > end) { RET_ERR ("Dataset catalog is truncated") }
+        memcpy (&val, cur, sizeof (int64_t));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_llreverse ((uint64_t *)&val);
+#endif
+        cur += sizeof (int64_t);
+
+        return val;
+    }
+
+    // Returns the location of the bytes and sets len to their length
+    char *get (size_t &len) {
+        char *ret;
+        int64_t plen;
+
+        plen = get ();
+        if (plen < 0) { RET_ERR ("Dataset catalog is corrupted") }
+        len = (size_t)plen;
+        ret = cur;
+        cur += (len + sizeof (int64_t) - 1) / sizeof (int64_t) * sizeof (int64_t);
+        if (cur > end) { RET_ERR ("Dataset catalog is truncated") }
+
+        return ret;
+    }
+} H5VL_log_filei_catalog_cursor_t;
+
+static hbool_t H5VL_log_filei_catalog_exists (H5VL_log_file_t *fp) {
+    herr_t err = 0;
+    H5VL_link_specific_args_t arg;
+    hbool_t exists = false;
+    H5VL_loc_params_t loc;
+
+    arg.op_type            = H5VL_LINK_EXISTS;
+    arg.args.exists.exists = &exists;
+
+    loc.type                         = H5VL_OBJECT_BY_NAME;
+    loc.obj_type                     = H5I_GROUP;
+    loc.loc_data.loc_by_name.name    = H5VL_LOG_FILEI_DSET_CATALOG;
+    loc.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+
+    err = H5VLlink_specific (fp->lgp, &loc, fp->uvlid, &arg, fp->dxplid, NULL);
+    CHECK_ERR
+
+    return exists;
+}
+
+/*
+ * Serialize the info of all datasets in fp into buf
+ */
+static void H5VL_log_filei_catalog_encode (H5VL_log_file_t *fp, std::vector<char> &buf) {
+    herr_t err = 0;
+    int i;
+    size_t tlen;                // Size of the encoded datatype
+    std::vector<char> tbuf;     // Encoded datatype
+    H5VL_log_dset_info_t *dip;  // Dataset info
+
+    H5VL_log_filei_catalog_put (buf, H5VL_LOG_FILEI_CATALOG_VERSION);
+    H5VL_log_filei_catalog_put (buf, (int64_t)fp->ndset);
+    for (i = 0; i < fp->ndset; i++) {
+        dip = fp->dsets_info[i];
+        if (!dip) {
+            H5VL_log_filei_catalog_put (buf, -1);
+            continue;
+        }
+
+        // Dimensions
+        H5VL_log_filei_catalog_put (buf, (int64_t)dip->ndim);
+        for (hsize_t j = 0; j < dip->ndim; j++) {
+            H5VL_log_filei_catalog_put (buf, (int64_t)dip->dims[j]);
+        }
+        for (hsize_t j = 0; j < dip->ndim; j++) {
+            H5VL_log_filei_catalog_put (buf, (int64_t)dip->mdims[j]);
+        }
+
+        // Datatype
+        tlen = 0;
+        err  = H5Tencode (dip->dtype, NULL, &tlen);
+        CHECK_ERR
+        tbuf.resize (tlen);
+        err = H5Tencode (dip->dtype, tbuf.data (), &tlen);
+        CHECK_ERR
+        H5VL_log_filei_catalog_put (buf, tbuf.data (), tlen);
+
+        // Filters
+        H5VL_log_filei_catalog_put (buf, (int64_t)dip->filters.size ());
+        for (auto &f : dip->filters) {
+            H5VL_log_filei_catalog_put (buf, (int64_t)f.id);
+            H5VL_log_filei_catalog_put (buf, (int64_t)f.flags);
+            H5VL_log_filei_catalog_put (buf, (int64_t)f.filter_config);
+            H5VL_log_filei_catalog_put (buf, (int64_t)f.cd_nelmts);
+            for (size_t j = 0; j < f.cd_nelmts; j++) {
+                H5VL_log_filei_catalog_put (buf, (int64_t)f.cd_values[j]);
+            }
+            H5VL_log_filei_catalog_put (buf, f.name, strnlen (f.name, LOGVOL_FILTER_NAME_MAX));
+        }
+
+        // Fill value
+        H5VL_log_filei_catalog_put (buf, dip->fill, dip->fill ? dip->esize : 0);
+
+        // Anchor dataset
+        H5VL_log_filei_catalog_put (buf, dip->path.c_str (), dip->path.size ());
+    }
+}
+
+/*
+ * Rebuild fp->dsets_info from a serialized catalog
+ * Returns false if the catalog is not written by this version or does not cover all datasets
+ */
+static bool H5VL_log_filei_catalog_decode (H5VL_log_file_t *fp, char *buf, size_t size) {
+    int i;
+    int64_t ndim;
+    size_t len;
+    char *data;
+    H5VL_log_filei_catalog_cursor_t cur;
+    std::unique_ptr<H5VL_log_dset_info_t> dip;  // Dataset info
+
+    cur.cur = buf;
+    cur.end = buf + size;
+
+    if (cur.get () != H5VL_LOG_FILEI_CATALOG_VERSION) { return false; }
+    if (cur.get () != (int64_t)fp->ndset) { return false; }
+
+    for (i = 0; i < fp->ndset; i++) {
+        ndim = cur.get ();
+        if (ndim < 0) { continue; }
+        if (ndim > H5S_MAX_RANK) { RET_ERR ("Dataset catalog is corrupted") }
+
+        dip = std::make_unique<H5VL_log_dset_info_t> ();
+        CHECK_PTR (dip)
+
+        // Dimensions
+        dip->ndim = (hsize_t)ndim;
+        for (hsize_t j = 0; j < dip->ndim; j++) { dip->dims[j] = (hsize_t)cur.get (); }
+        for (hsize_t j = 0; j < dip->ndim; j++) { dip->mdims[j] = (hsize_t)cur.get (); }
+
+        // Dstep for encoding selection
+        if ((fp->config & H5VL_FILEI_CONFIG_SEL_ENCODE) && dip->ndim > 0) {
+            dip->dsteps[dip->ndim - 1] = 1;
+            for (int j = (int)dip->ndim - 2; j > -1; j--) {
+                dip->dsteps[j] = dip->dsteps[j + 1] * dip->dims[j + 1];
+            }
+        }
+
+        // Datatype
+        data       = cur.get (len);
+        dip->dtype = H5Tdecode (data);
+        CHECK_ID (dip->dtype)
+        dip->esize = H5Tget_size (dip->dtype);
+        CHECK_ID (dip->esize)
+
+        // Filters
+        dip->filters.resize ((size_t)cur.get ());
+        for (auto &f : dip->filters) {
+            f.id            = (H5Z_filter_t)cur.get ();
+            f.flags         = (unsigned int)cur.get ();
+            f.filter_config = (unsigned int)cur.get ();
+            f.cd_nelmts     = (size_t)cur.get ();
+            if (f.cd_nelmts > f.cd_values.size ()) { f.cd_values.resize (f.cd_nelmts); }
+            for (size_t j = 0; j < f.cd_nelmts; j++) { f.cd_values[j] = (unsigned int)cur.get (); }
+            data = cur.get (len);
+            if (len >= LOGVOL_FILTER_NAME_MAX) { len = LOGVOL_FILTER_NAME_MAX - 1; }
+            memcpy (f.name, data, len);
+            f.name[len] = '\0';
+        }
+
+        // Fill value
+        data = cur.get (len);
+        if (len) {
+            if (len != dip->esize) { RET_ERR ("Dataset catalog is corrupted") }
+            dip->fill = (char *)malloc (len);
+            CHECK_PTR (dip->fill)
+            memcpy (dip->fill, data, len);
+        } else {
+            dip->fill = NULL;
+        }
+
+        // Anchor dataset
+        data      = cur.get (len);
+        dip->path = std::string (data, len);
+
+        fp->dsets_info[i] = dip.release ();
+    }
+
+    return true;
+}
+
+/*
+ * Write the info of all datasets to the dataset catalog in the log group
+ * The catalog is replaced if it already exists
+ */
+void H5VL_log_filei_catalog_write (H5VL_log_file_t *fp) {
+    herr_t err = 0;
+    H5VL_loc_params_t loc;
+    H5VL_link_specific_args_t arg;
+    void *cdp    = NULL;  // Catalog dataset
+    hid_t csid   = -1;    // Catalog dataset space
+    hid_t msid   = -1;    // Memory space
+    hid_t dxplid = -1;
+    hid_t fdid;           // File driver ID
+    hsize_t csize;        // Size of the catalog
+    std::vector<char> buf;
+    char *bufp;
+    H5VL_logi_err_finally finally ([&csid, &msid, &dxplid] () -> void {
+        H5VL_log_Sclose (csid);
+        H5VL_log_Sclose (msid);
+        H5VL_log_Pclose (dxplid);
+    });
+
+    H5VL_LOGI_PROFILING_TIMER_START;
+
+    // Every process holds the same dataset info, no communication required to agree on the size
+    H5VL_log_filei_catalog_encode (fp, buf);
+    csize = (hsize_t)buf.size ();
+
+    loc.type     = H5VL_OBJECT_BY_SELF;
+    loc.obj_type = H5I_GROUP;
+
+    // Remove the outdated catalog
+    if (H5VL_log_filei_catalog_exists (fp)) {
+        H5VL_loc_params_t dloc;
+
+        dloc.type                         = H5VL_OBJECT_BY_NAME;
+        dloc.obj_type                     = H5I_GROUP;
+        dloc.loc_data.loc_by_name.name    = H5VL_LOG_FILEI_DSET_CATALOG;
+        dloc.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+
+        arg.op_type = H5VL_LINK_DELETE;
+        err         = H5VLlink_specific (fp->lgp, &dloc, fp->uvlid, &arg, fp->dxplid, NULL);
+        CHECK_ERR
+    }
+
+    csid = H5Screate_simple (1, &csize, &csize);
+    CHECK_ID (csid)
+    msid = H5Screate_simple (1, &csize, &csize);
+    CHECK_ID (msid)
+
+    dxplid = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ID (dxplid)
+    fdid = H5Pget_driver (fp->ufaplid);
+    CHECK_ID (fdid)
+    if (fdid == H5FD_MPIO) {
+        err = H5Pset_dxpl_mpio (dxplid, H5FD_MPIO_COLLECTIVE);
+        CHECK_ERR
+    }
+
+    cdp = H5VLdataset_create (fp->lgp, &loc, fp->uvlid, H5VL_LOG_FILEI_DSET_CATALOG,
+                              H5P_LINK_CREATE_DEFAULT, H5T_STD_B8LE, csid,
+                              H5P_DATASET_CREATE_DEFAULT, H5P_DATASET_ACCESS_DEFAULT, dxplid, NULL);
+    CHECK_PTR (cdp)
+
+    // Only the first process in the group writes
+    if (fp->group_rank != 0) {
+        err = H5Sselect_none (csid);
+        CHECK_ERR
+        err = H5Sselect_none (msid);
+        CHECK_ERR
+    }
+    bufp = buf.data ();
+    err  = H5VL_log_under_dataset_write (cdp, fp->uvlid, H5T_NATIVE_B8, msid, csid, dxplid, bufp,
+                                         NULL);
+    CHECK_ERR
+
+    err = H5VLdataset_close (cdp, fp->uvlid, dxplid, NULL);
+    CHECK_ERR
+
+    fp->catalog_dirty = false;
+
+    H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_CATALOG_WRITE);
+}
+
+/*
+ * Rebuild fp->dsets_info from the dataset catalog in the log group
+ * The catalog is read by the first process in the group and broadcasted to the others
+ * Returns false if the file has no usable catalog
+ */
+bool H5VL_log_filei_catalog_read (H5VL_log_file_t *fp) {
+    herr_t err = 0;
+    int mpierr;
+    int ndim;
+    H5VL_loc_params_t loc;
+    void *cdp  = NULL;  // Catalog dataset
+    hid_t csid = -1;    // Catalog dataset space
+    hid_t msid = -1;    // Memory space
+    hsize_t csize;      // Size of the catalog
+    bool ret;
+    std::vector<char> buf;
+    char *bufp;
+    H5VL_logi_err_finally finally ([&csid, &msid] () -> void {
+        H5VL_log_Sclose (csid);
+        H5VL_log_Sclose (msid);
+    });
+
+    if (!H5VL_log_filei_catalog_exists (fp)) { return false; }
+
+    H5VL_LOGI_PROFILING_TIMER_START;
+
+    loc.type     = H5VL_OBJECT_BY_SELF;
+    loc.obj_type = H5I_GROUP;
+
+    cdp = H5VLdataset_open (fp->lgp, &loc, fp->uvlid, H5VL_LOG_FILEI_DSET_CATALOG,
+                            H5P_DATASET_ACCESS_DEFAULT, fp->dxplid, NULL);
+    CHECK_PTR (cdp)
+
+    csid = H5VL_logi_dataset_get_space (fp, cdp, fp->uvlid, fp->dxplid);
+    CHECK_ID (csid)
+    ndim = H5Sget_simple_extent_dims (csid, &csize, NULL);
+    if (ndim != 1) { RET_ERR ("Dataset catalog is corrupted") }
+    // Checked by every process before the read, the catalog is broadcast in one call
+    if (fp->group_np > 1 && csize > INT_MAX) { RET_ERR ("Dataset catalog exceeds 2 GiB") }
+    msid = H5Screate_simple (1, &csize, &csize);
+    CHECK_ID (msid)
+
+    if (fp->group_rank == 0) {
+        buf.resize (csize);
+    } else {
+        err = H5Sselect_none (csid);
+        CHECK_ERR
+        err = H5Sselect_none (msid);
+        CHECK_ERR
+    }
+    bufp = buf.data ();
+    err  = H5VL_log_under_dataset_read (cdp, fp->uvlid, H5T_NATIVE_B8, msid, csid, fp->dxplid,
+                                        bufp, NULL);
+    CHECK_ERR
+
+    err = H5VLdataset_close (cdp, fp->uvlid, fp->dxplid, NULL);
+    CHECK_ERR
+
+    if (fp->group_np > 1) {
+        buf.resize (csize);
+        mpierr = MPI_Bcast (buf.data (), (int)csize, MPI_BYTE, 0, fp->group_comm);
+        CHECK_MPIERR
+    }
+
+    ret = H5VL_log_filei_catalog_decode (fp, buf.data (), buf.size ());
+
+    H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_CATALOG_READ);
+
+    return ret;
+}
+
+/*
+ * Update the anchor dataset paths recorded in the catalog after the link at from is moved to to
+ * Datasets reached through a deleted link (empty to) are left without a path
+ */
+void H5VL_log_filei_catalog_relink (H5VL_log_file_t *fp,
+                                    const std::string &from,
+                                    const std::string &to) {
+    fp->catalog_dirty = true;
+    if (from.empty ()) { return; }
+
+    for (auto dip : fp->dsets_info) {
+        if (!dip || dip->path.compare (0, from.size (), from) != 0) { continue; }
+        if (dip->path.size () > from.size () && dip->path[from.size ()] != '/') { continue; }
+
+        if (to.empty ()) {
+            dip->path.clear ();
+        } else {
+            dip->path = to + dip->path.substr (from.size ());
+        }
+    }
+}
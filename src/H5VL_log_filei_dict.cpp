@@ -0,0 +1,246 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "H5VL_log_file.hpp"
+#include "H5VL_log_filei.hpp"
+#include "H5VL_logi.hpp"
+#include "H5VL_logi_err.hpp"
+#include "H5VL_logi_meta.hpp"
+#include "H5VL_logi_util.hpp"
+#include "H5VL_logi_wrapper.hpp"
+
+/*
+ * The selection dictionary holds selections shared by metadata entries across metadata flushes
+ * and datasets. Records added before a metadata flush are written to a byte dataset in the log
+ * group named after the metadata dataset of the flush (_dict_i along with _md_i). Each record is
+ *   flag (INT32), size (INT32), selection (size bytes)
+ * Records are numbered in the order of the dictionary datasets, then the order in the dataset.
+ * Entries referring to a record (H5VL_LOGI_META_FLAG_SEL_DICT) hold its number in place of the
+ * selection.
+ */
+
+static hbool_t H5VL_log_filei_dict_exists (H5VL_log_file_t *fp, const char *name) {
+    herr_t err = 0;
+    H5VL_link_specific_args_t arg;
+    hbool_t exists = false;
+    H5VL_loc_params_t loc;
+
+    arg.op_type            = H5VL_LINK_EXISTS;
+    arg.args.exists.exists = &exists;
+
+    loc.type                         = H5VL_OBJECT_BY_NAME;
+    loc.obj_type                     = H5I_GROUP;
+    loc.loc_data.loc_by_name.name    = name;
+    loc.loc_data.loc_by_name.lapl_id = H5P_LINK_ACCESS_DEFAULT;
+
+    err = H5VLlink_specific (fp->lgp, &loc, fp->uvlid, &arg, fp->dxplid, NULL);
+    CHECK_ERR
+
+    return exists;
+}
+
+/*
+ * Load the dictionary datasets written since the last call into fp->dict
+ * Each dataset is read by the first process in the group and broadcasted to the others
+ */
+void H5VL_log_filei_dictload (H5VL_log_file_t *fp) {
+    herr_t err = 0;
+    int mpierr;
+    int ndim;
+    H5VL_loc_params_t loc;
+    void *ddp  = NULL;  // Dictionary dataset
+    hid_t dsid = -1;    // Dictionary dataset space
+    hid_t msid = -1;    // Memory space
+    hsize_t dsize;      // Size of the dictionary dataset
+    std::vector<char> buf;
+    char *bufp;
+    char name[32];
+    H5VL_logi_err_finally finally ([&dsid, &msid] () -> void {
+        H5VL_log_Sclose (dsid);
+        H5VL_log_Sclose (msid);
+    });
+
+    if (fp->dict.nmd >= fp->nmdset) { return; }
+
+    H5VL_LOGI_PROFILING_TIMER_START;
+
+    loc.type     = H5VL_OBJECT_BY_SELF;
+    loc.obj_type = H5I_GROUP;
+
+    for (; fp->dict.nmd < fp->nmdset; fp->dict.nmd++) {
+        sprintf (name, "%s_%d", H5VL_LOG_FILEI_DSET_DICT, fp->dict.nmd);
+        if (!H5VL_log_filei_dict_exists (fp, name)) continue;
+
+        ddp = H5VLdataset_open (fp->lgp, &loc, fp->uvlid, name, H5P_DATASET_ACCESS_DEFAULT,
+                                fp->dxplid, NULL);
+        CHECK_PTR (ddp)
+
+        dsid = H5VL_logi_dataset_get_space (fp, ddp, fp->uvlid, fp->dxplid);
+        CHECK_ID (dsid)
+        ndim = H5Sget_simple_extent_dims (dsid, &dsize, NULL);
+        if (ndim != 1) { RET_ERR ("Selection dictionary is corrupted") }
+        msid = H5Screate_simple (1, &dsize, &dsize);
+        CHECK_ID (msid)
+
+        buf.resize (dsize);
+        if (fp->group_rank != 0) {
+            err = H5Sselect_none (dsid);
+            CHECK_ERR
+            err = H5Sselect_none (msid);
+            CHECK_ERR
+        }
+        bufp = buf.data ();
+        err  = H5VL_log_under_dataset_read (ddp, fp->uvlid, H5T_NATIVE_B8, msid, dsid, fp->dxplid,
+                                            bufp, NULL);
+        CHECK_ERR
+
+        err = H5VLdataset_close (ddp, fp->uvlid, fp->dxplid, NULL);
+        CHECK_ERR
+
+        if (fp->group_np > 1) {
+            mpierr = MPI_Bcast (buf.data (), (int)dsize, MPI_BYTE, 0, fp->group_comm);
+            CHECK_MPIERR
+        }
+
+        H5VL_logi_meta_dict_append (fp->dict, buf.data (), (MPI_Offset)dsize);
+
+        H5VL_log_Sclose (dsid);
+        dsid = -1;
+        H5VL_log_Sclose (msid);
+        msid = -1;
+    }
+
+    H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_DICTLOAD);
+}
+
+/*
+ * Write the dictionary records added since the last metadata flush and assign their IDs
+ * Must be called before the metadata dataset of the flush is created. Entries in fp->wreqs
+ * referring to new records are updated with the assigned IDs, then all references are converted to
+ * the file byte order.
+ */
+void H5VL_log_filei_dictflush (H5VL_log_file_t *fp) {
+    herr_t err = 0;
+    int mpierr;
+    int i;
+    H5VL_loc_params_t loc;
+    void *ddp    = NULL;  // Dictionary dataset
+    hid_t dsid   = -1;    // Dictionary dataset space
+    hid_t msid   = -1;    // Memory space
+    hid_t dxplid = -1;
+    hid_t fdid;                    // File driver ID
+    MPI_Offset cnt[2];             // Number and size of the new records of this process
+    std::vector<MPI_Offset> cnts;  // Number and size of the new records of every process
+    MPI_Offset nrec  = 0;          // Number of new records
+    MPI_Offset dsize = 0;          // Size of new records
+    MPI_Offset base;               // Number of records already in the file
+    MPI_Offset rbase = 0;          // ID of the first new record of this process
+    MPI_Offset doff  = 0;          // Offset of the new records of this process
+    MPI_Offset id;                 // Record ID referred by an entry
+    hsize_t start, count, one = 1;
+    std::vector<char> buf;
+    char *bufp;
+    char name[32];
+    H5VL_logi_err_finally finally ([&dsid, &msid, &dxplid] () -> void {
+        H5VL_log_Sclose (dsid);
+        H5VL_log_Sclose (msid);
+        H5VL_log_Pclose (dxplid);
+    });
+
+    H5VL_LOGI_PROFILING_TIMER_START;
+
+    // Records are numbered after the ones already in the file
+    H5VL_log_filei_dictload (fp);
+    base = (MPI_Offset)fp->dict.offs.size ();
+
+    cnt[0] = (MPI_Offset)fp->sel_dict.npending ();
+    cnt[1] = (MPI_Offset)fp->sel_dict.pending_size ();
+    cnts.resize (fp->group_np * 2);
+    mpierr = MPI_Allgather (cnt, 2, MPI_LONG_LONG, cnts.data (), 2, MPI_LONG_LONG, fp->group_comm);
+    CHECK_MPIERR
+    for (i = 0; i < fp->group_np; i++) {
+        if (i == fp->group_rank) {
+            rbase = base + nrec;
+            doff  = dsize;
+        }
+        nrec += cnts[i * 2];
+        dsize += cnts[i * 2 + 1];
+    }
+
+    if (nrec) {
+        loc.type     = H5VL_OBJECT_BY_SELF;
+        loc.obj_type = H5I_GROUP;
+
+        buf.resize (cnt[1] ? cnt[1] : 1);
+        fp->sel_dict.pack_pending (buf.data ());
+
+        start = (hsize_t)dsize;
+        dsid  = H5Screate_simple (1, &start, &start);
+        CHECK_ID (dsid)
+        count = (hsize_t) (cnt[1] ? cnt[1] : 1);
+        msid  = H5Screate_simple (1, &count, &count);
+        CHECK_ID (msid)
+        if (cnt[1]) {
+            start = (hsize_t)doff;
+            count = (hsize_t)cnt[1];
+            err   = H5Sselect_hyperslab (dsid, H5S_SELECT_SET, &start, NULL, &one, &count);
+            CHECK_ERR
+        } else {
+            err = H5Sselect_none (dsid);
+            CHECK_ERR
+            err = H5Sselect_none (msid);
+            CHECK_ERR
+        }
+
+        dxplid = H5Pcreate (H5P_DATASET_XFER);
+        CHECK_ID (dxplid)
+        fdid = H5Pget_driver (fp->ufaplid);
+        CHECK_ID (fdid)
+        if (fdid == H5FD_MPIO) {
+            err = H5Pset_dxpl_mpio (dxplid, H5FD_MPIO_COLLECTIVE);
+            CHECK_ERR
+        }
+
+        // Named after the metadata dataset created by this flush
+        sprintf (name, "%s_%d", H5VL_LOG_FILEI_DSET_DICT, fp->nmdset);
+        ddp = H5VLdataset_create (fp->lgp, &loc, fp->uvlid, name, H5P_LINK_CREATE_DEFAULT,
+                                  H5T_STD_B8LE, dsid, H5P_DATASET_CREATE_DEFAULT,
+                                  H5P_DATASET_ACCESS_DEFAULT, dxplid, NULL);
+        CHECK_PTR (ddp)
+
+        bufp = buf.data ();
+        err  = H5VL_log_under_dataset_write (ddp, fp->uvlid, H5T_NATIVE_B8, msid, dsid, dxplid,
+                                             bufp, NULL);
+        CHECK_ERR
+
+        err = H5VLdataset_close (ddp, fp->uvlid, dxplid, NULL);
+        CHECK_ERR
+    }
+
+    // Replace pending IDs with the assigned ones
+    for (auto &rp : fp->wreqs) {
+        if (!(rp->hdr->flag & H5VL_LOGI_META_FLAG_SEL_DICT)) continue;
+        id = *((MPI_Offset *)(rp->sel_buf));
+        if (id & H5VL_LOGI_SEL_DICT_PENDING) { id = rbase + (id & ~H5VL_LOGI_SEL_DICT_PENDING); }
+        *((MPI_Offset *)(rp->sel_buf)) = id;
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_llreverse ((uint64_t *)(rp->sel_buf));
+#endif
+    }
+    fp->sel_dict.commit (rbase);
+
+    H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_DICTFLUSH);
+}
@@ -12,6 +12,7 @@
 
 #include <array>
 #include <cassert>
+#include <climits>
 #include <cstdlib>
 #include <cstring>
 #include <map>
@@ -22,6 +23,7 @@
 #include "H5VL_log_filei.hpp"
 #include "H5VL_logi.hpp"
 #include "H5VL_logi_err.hpp"
+#include "H5VL_logi_meta.hpp"
 #include "H5VL_logi_util.hpp"
 #include "H5VL_logi_wrapper.hpp"
 #include "H5VL_logi_zip.hpp"
@@ -53,6 +55,7 @@ void H5VL_log_filei_metaflush (H5VL_log_file_t *fp) {
     MPI_Offset
         rbuf[2];  // [Local metadata offset within the metadata dataset, Global metadata size]
     MPI_Offset mdsize  = 0;  // Local metadata size
+    MPI_Offset mdxsize = 0;  // Local metadata size once decoded
     MPI_Offset *mdoffs = NULL;
     MPI_Offset *mdoffs_snd = NULL;
     MPI_Aint *offs = NULL;                    // Offset in MPI_Type_create_hindexed
@@ -70,10 +73,14 @@ void H5VL_log_filei_metaflush (H5VL_log_file_t *fp) {
     MPI_Status stat;                          // Status of MPI I/O
     H5VL_loc_params_t loc;
     bool perform_write_in_mpi = true;
-    H5VL_logi_err_finally finally ([&offs, &lens, &mdoffs, &mdsid, &dcplid, &dxplid, &mmtype] () -> void {
+    bool xsize;         // Whether the decoded section sizes are recorded
+    char *sbuf = NULL;  // Compressed metadata section
+    H5VL_logi_err_finally finally ([&offs, &lens, &mdoffs, &sbuf, &mdsid, &dcplid, &dxplid,
+                                    &mmtype] () -> void {
         H5VL_log_free (offs);
         H5VL_log_free (lens);
         H5VL_log_free (mdoffs);
+        H5VL_log_free (sbuf);
         H5VL_log_Sclose (mdsid);
         H5VL_log_Pclose (dcplid);
         H5VL_log_Pclose (dxplid);
@@ -87,20 +94,36 @@ void H5VL_log_filei_metaflush (H5VL_log_file_t *fp) {
     }
 
     H5VL_LOGI_PROFILING_TIMER_START;
+
+    // Format features of the metadata written, recorded in the file attribute on close
+    if (fp->config & H5VL_FILEI_CONFIG_META_SEC_ZIP) {
+        fp->config |= H5VL_FILEI_FEATURE_META_SEC_ZIP;
+    }
+    if (fp->config & H5VL_FILEI_CONFIG_SEL_VARINT) { fp->config |= H5VL_FILEI_FEATURE_SEL_VARINT; }
+    if (fp->config & H5VL_FILEI_CONFIG_SEL_DICT) { fp->config |= H5VL_FILEI_FEATURE_SEL_DICT; }
+
+    // Write new selection dictionary records, references are final after this
+    if (fp->config & H5VL_FILEI_CONFIG_SEL_DICT) { H5VL_log_filei_dictflush (fp); }
+
     H5VL_LOGI_PROFILING_TIMER_START;
 
+    // Sections that grow when read carry their decoded size, so readers can budget the memory
+    xsize = fp->config & (H5VL_FILEI_CONFIG_META_SEC_ZIP | H5VL_FILEI_CONFIG_SEL_VARINT |
+                          H5VL_FILEI_CONFIG_SEL_DICT);
+
     // Create memory datatype
     nentry = fp->wreqs.size ();
     if (fp->group_rank == 0) { nentry++; }
     offs = (MPI_Aint *)malloc (sizeof (MPI_Aint) * nentry);
     lens = (int *)malloc (sizeof (int) * nentry);
     if (fp->group_rank == 0) {
-        mdoffs = (MPI_Offset *)malloc (sizeof (MPI_Offset) * (fp->group_np + 1) * 3);
+        // [decomp, ending offsets, decoded sizes, scatter buffer]
+        mdoffs = (MPI_Offset *)malloc (sizeof (MPI_Offset) * (fp->group_np * 4 + 1));
         CHECK_PTR (mdoffs)
-        mdoffs_snd = mdoffs + fp->group_np + 1;
+        mdoffs_snd = mdoffs + fp->group_np * 2 + 1;
 
         offs[0] = (MPI_Aint) (mdoffs);
-        lens[0] = (int)(sizeof (MPI_Offset) * (fp->group_np + 1));
+        lens[0] = (int)(sizeof (MPI_Offset) * ((xsize ? fp->group_np * 2 : fp->group_np) + 1));
 
         nentry = 1;
         mdsize += lens[0];
@@ -113,7 +136,83 @@ void H5VL_log_filei_metaflush (H5VL_log_file_t *fp) {
         offs[nentry] = (MPI_Aint)rp->meta_buf;
         lens[nentry] = (int)rp->hdr->meta_size;
         mdsize += lens[nentry++];
+
+        // Readers replace dictionary references with the selection
+        if (rp->hdr->flag & H5VL_LOGI_META_FLAG_SEL_DICT) {
+            int32_t flag, sel_size;
+            char *sel;
+
+            if (!fp->sel_dict.get (*((MPI_Offset *)(rp->sel_buf)), &flag, &sel, &sel_size)) {
+                RET_ERR ("Selection dictionary record not found")
+            }
+            mdxsize += (MPI_Offset) (rp->sel_buf - rp->meta_buf) + sel_size;
+        } else {
+            mdxsize += rp->hdr->meta_size;
+        }
     }
+
+    // Swap endian of metadata headers before writing
+#ifdef WORDS_BIGENDIAN
+    for (auto &rp : fp->wreqs) {
+        H5VL_logi_lreverse ((uint32_t *)rp->meta_buf,
+                            (uint32_t *)(rp->meta_buf + sizeof (H5VL_logi_meta_hdr)));
+    }
+#endif
+
+    // Replace the entries with one packed or compressed section
+    if ((fp->config & (H5VL_FILEI_CONFIG_SEL_VARINT | H5VL_FILEI_CONFIG_META_SEC_ZIP)) &&
+        fp->wreqs.size ()) {
+        MPI_Offset esize = 0;  // Size of the entries
+        int first;             // First entry in offs
+        char *ebuf, *ep;       // Contiguous entries
+
+        first = fp->group_rank == 0 ? 1 : 0;
+        for (i = first; i < nentry; i++) { esize += lens[i]; }
+
+        ep = ebuf = (char *)malloc (esize);
+        CHECK_PTR (ebuf)
+        for (i = first; i < nentry; i++) {
+            memcpy (ep, (void *)offs[i], lens[i]);
+            ep += lens[i];
+        }
+
+        // File offsets are final, pack the headers
+        if (fp->config & H5VL_FILEI_CONFIG_SEL_VARINT) {
+            ep = (char *)malloc (H5VL_logi_meta_sec_pack_bound (esize));
+            CHECK_PTR (ep)
+            esize = H5VL_logi_meta_sec_pack (ebuf, esize, ep);
+            free (ebuf);
+            ebuf = ep;
+        }
+
+#ifdef ENABLE_ZLIB
+        if (fp->config & H5VL_FILEI_CONFIG_META_SEC_ZIP) {
+            int zsize;                     // Size of the deflate stream
+            H5VL_logi_meta_sec_hdr *shdr;  // Section header
+
+            sbuf = (char *)malloc (sizeof (H5VL_logi_meta_sec_hdr) +
+                                   H5VL_log_zip_stream_bound (&(fp->zstrm), (int)esize));
+            CHECK_PTR (sbuf)
+            H5VL_log_zip_stream_compress (&(fp->zstrm), ebuf, (int)esize,
+                                          sbuf + sizeof (H5VL_logi_meta_sec_hdr), &zsize);
+            free (ebuf);
+
+            shdr        = (H5VL_logi_meta_sec_hdr *)sbuf;
+            shdr->size  = esize;
+            shdr->zsize = zsize;
+            esize       = sizeof (H5VL_logi_meta_sec_hdr) + zsize;
+        } else
+#endif
+        {
+            sbuf = ebuf;
+        }
+
+        offs[first] = (MPI_Aint)sbuf;
+        lens[first] = (int)esize;
+        nentry      = first + 1;
+        mdsize      = first ? lens[0] + lens[1] : lens[0];
+    }
+
     if (nentry && perform_write_in_mpi) {
         mpierr = MPI_Type_create_hindexed (nentry, lens, offs, MPI_BYTE, &mmtype);
         CHECK_MPIERR
@@ -130,6 +229,11 @@ void H5VL_log_filei_metaflush (H5VL_log_file_t *fp) {
     mpierr =
         MPI_Gather (&mdsize, 1, MPI_LONG_LONG, mdoffs + 1, 1, MPI_LONG_LONG, 0, fp->group_comm);
     CHECK_MPIERR
+    if (xsize) {
+        mpierr = MPI_Gather (&mdxsize, 1, MPI_LONG_LONG, mdoffs + fp->group_np + 1, 1,
+                             MPI_LONG_LONG, 0, fp->group_comm);
+        CHECK_MPIERR
+    }
     if (fp->group_rank == 0) {  // Rank 0 calculate
         mdoffs[0] = 0;
         for (i = 0; i < fp->group_np; i++) { mdoffs[i + 1] += mdoffs[i]; }
@@ -146,7 +250,16 @@ void H5VL_log_filei_metaflush (H5VL_log_file_t *fp) {
     // CHECK_MPIERR
 
     // The first lens[0] byte is the decomposition map
-    if (fp->group_rank == 0) { mdoffs[0] = lens[0] / sizeof (MPI_Offset) - 1; }
+    if (fp->group_rank == 0) {
+        mdoffs[0] = fp->group_np;
+        if (fp->config & H5VL_FILEI_CONFIG_META_SEC_ZIP) {
+            mdoffs[0] |= H5VL_LOGI_META_DECOMP_FLAG_ZIP;
+        }
+        if (fp->config & H5VL_FILEI_CONFIG_SEL_VARINT) {
+            mdoffs[0] |= H5VL_LOGI_META_DECOMP_FLAG_PACK;
+        }
+        if (xsize) { mdoffs[0] |= H5VL_LOGI_META_DECOMP_FLAG_XSIZE; }
+    }
 
     // NOTE: Some MPI implementation do not produce output for rank 0, moffs must ne initialized
     // to 0
@@ -155,20 +268,13 @@ void H5VL_log_filei_metaflush (H5VL_log_file_t *fp) {
     // CHECK_MPIERR
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_METAFLUSH_SYNC);
 
-    // Swap endian of metadata headers before writing
-#ifdef WORDS_BIGENDIAN
-    for (auto &rp : fp->wreqs) {
-        H5VL_logi_lreverse ((uint32_t *)rp->meta_buf,
-                            (uint32_t *)(rp->meta_buf + sizeof (H5VL_logi_meta_hdr)));
-    }
-#endif
-
     // Where to create data dataset, main file or subfile
     loc.type     = H5VL_OBJECT_BY_SELF;
     loc.obj_type = H5I_GROUP;
 
     dsize = (hsize_t)rbuf[1];
-    if (dsize > (hsize_t) (sizeof (MPI_Offset) * (fp->group_np + 1))) {
+    if (dsize > (hsize_t) (sizeof (MPI_Offset) *
+                           ((xsize ? fp->group_np * 2 : fp->group_np) + 1))) {
         // Create metadata dataset
         H5VL_LOGI_PROFILING_TIMER_START;
         mdsid = H5Screate_simple (1, &dsize, &dsize);
@@ -310,9 +416,8 @@ sizeof(H5VL_logi_meta_hdr)));
     fp->nflushed = 0;
 
     // Recore metadata size
-#ifdef LOGVOL_PROFILING
+    fp->stat.meta_bytes_written += mdsize;
     H5VL_log_profile_add_time (fp, TIMER_H5VL_LOG_FILEI_METASIZE, (double)(fp->mdsize) / 1048576);
-#endif
     fp->mdsize = 0;
     // Record dedup hash
     fp->wreq_hash.clear ();
@@ -335,7 +440,9 @@ void H5VL_log_filei_metaupdate (H5VL_log_file_t *fp) {
     hsize_t start, count, one = 1;
     char *buf = NULL;             // Buffer for raw metadata
     int ndim;                     // metadata dataset dimensions (should be 1)
-    MPI_Offset nsec;              // Number of sections in current metadata dataset
+    MPI_Offset decomp;            // Number of sections and flags of current metadata dataset
+    MPI_Offset esize;             // Size of decoded metadata entries
+    char *ebuf;                   // Decoded metadata entries
     H5VL_logi_metaentry_t block;  // Buffer of decoded metadata entry
     std::map<char *, std::vector<H5VL_logi_metasel_t>> bcache;  // Cache for linked metadata entry
     char mdname[16];
@@ -356,6 +463,10 @@ void H5VL_log_filei_metaupdate (H5VL_log_file_t *fp) {
 
     // Remove all index entries
     fp->idx->clear ();
+    fp->idxwin_md = -1;
+
+    // Selections referred by the entries
+    H5VL_log_filei_dictload (fp);
 
     // iterate through all metadata datasets
     loc.type     = H5VL_OBJECT_BY_SELF;
@@ -380,13 +491,14 @@ void H5VL_log_filei_metaupdate (H5VL_log_file_t *fp) {
         CHECK_ERR
         err = H5Sselect_hyperslab (mdsid, H5S_SELECT_SET, &start, NULL, &one, &count);
         CHECK_ERR
-        MPI_Offset *nsecp = &nsec;
+        MPI_Offset *nsecp = &decomp;
         err =
             H5VL_log_under_dataset_read (mdp, fp->uvlid, H5T_NATIVE_B8, mmsid, mdsid, fp->dxplid, nsecp, NULL);
         CHECK_ERR
+        if (decomp & ~H5VL_LOGI_META_DECOMP_KNOWN) { RET_ERR ("Unknown metadata format") }
 
         // Allocate buffer for raw metadata
-        start = sizeof (MPI_Offset) * (nsec + 1);
+        start = H5VL_logi_meta_sec_begin (decomp);
         count = mdsize - start;
         buf   = (char *)malloc (sizeof (char) * count);
 
@@ -403,6 +515,14 @@ void H5VL_log_filei_metaupdate (H5VL_log_file_t *fp) {
         err = H5VLdataset_close (mdp, fp->uvlid, fp->dxplid, NULL);
         CHECK_ERR
 
+        // Inflate, unpack and expand the sections
+        ebuf = H5VL_logi_meta_sec_decode (decomp, fp->dict, buf, count, &esize);
+        if (ebuf) {
+            H5VL_log_free (buf);
+            buf   = ebuf;
+            count = esize;
+        }
+
         // Parse metadata
         fp->idx->parse_block (buf, count);
 
@@ -417,93 +537,141 @@ void H5VL_log_filei_metaupdate (H5VL_log_file_t *fp) {
 }
 
 /*
- * Remove all existing index entry in fp
- * Load the metadata starting from sec in md in the metadata index of fp until the metadata
- * buffer size is reached Advance sec to the next unprocessed section. If all section is
- * processed, advance md and set sec to 0 If all metadata datasset is processed, set md to -1
+ * Section table of metadata dataset md, the tables are read into fp->mdsecs in order on first use
+ * A metadata dataset is not modified after it is written, so its table is read only once
  */
-void H5VL_log_filei_metaupdate_part (H5VL_log_file_t *fp, int &md, int &sec) {
+static H5VL_logi_meta_sec_table_t &H5VL_log_filei_mdsec_get (H5VL_log_file_t *fp, int md) {
     herr_t err = 0;
-    int i;
+    int ndim;
     H5VL_loc_params_t loc;
     void *mdp   = NULL;  // Metadata dataset
     hid_t mdsid = -1;    // Metadata dataset space
     hid_t mmsid = -1;    // metadata buffer memory space
     hsize_t mdsize;      // Size of metadata dataset
     hsize_t start, count, one = 1;
-    char *buf = NULL;             // Buffer for raw metadata
-    int ndim;                     // metadata dataset dimensions (should be 1)
-    MPI_Offset nsec;              // Number of sections in current metadata dataset
-    MPI_Offset *offs;             // Section end offset array
-    H5VL_logi_metaentry_t block;  // Buffer of decoded metadata entry
-    std::map<char *, std::vector<H5VL_logi_metasel_t>> bcache;  // Cache for linked metadata entry
+    MPI_Offset i;
+    MPI_Offset nsec;  // Number of sections in current metadata dataset
+    bool xsize;       // Whether the decoded section sizes are recorded
     char mdname[16];
-    H5VL_logi_err_finally finally ([&mdsid, &mmsid, &buf] () -> void {
-        if (mdsid >= 0) H5Sclose (mdsid);
-        if (mmsid >= 0) H5Sclose (mmsid);
-        H5VL_log_free (buf);
+    H5VL_logi_err_finally finally ([&mdsid, &mmsid] () -> void {
+        H5VL_log_Sclose (mdsid);
+        H5VL_log_Sclose (mmsid);
     });
 
-    H5VL_LOGI_PROFILING_TIMER_START;
+    if (md < (int)(fp->mdsecs.size ())) { return fp->mdsecs[md]; }
 
     // Dataspace for memory buffer
     start = count = INT64_MAX - 1;
     mmsid         = H5Screate_simple (1, &start, &count);
+    CHECK_ID (mmsid)
 
-    // Flush all write requests
-    if (fp->metadirty) { H5VL_log_filei_metaflush (fp); }
-
-    // Remove all index entries
-    fp->idx->clear ();
-
-    // Open the metadata dataset
     loc.type     = H5VL_OBJECT_BY_SELF;
     loc.obj_type = H5I_GROUP;
-    sprintf (mdname, "%s_%d", H5VL_LOG_FILEI_DSET_META, md);
-    mdp = H5VLdataset_open (fp->lgp, &loc, fp->uvlid, mdname, H5P_DATASET_ACCESS_DEFAULT,
-                            fp->dxplid, NULL);
-    CHECK_PTR (mdp)
-
-    // Get data space and size
-    mdsid = H5VL_logi_dataset_get_space (fp, mdp, fp->uvlid, fp->dxplid);
-    CHECK_ID (mdsid)
-    ndim = H5Sget_simple_extent_dims (mdsid, &mdsize, NULL);
-    assert (ndim == 1);
-
-    // Get number of sections (first 8 bytes)
-    start = 0;
-    count = sizeof (MPI_Offset);
-    err   = H5Sselect_hyperslab (mmsid, H5S_SELECT_SET, &start, NULL, &one, &count);
-    CHECK_ERR
-    err = H5Sselect_hyperslab (mdsid, H5S_SELECT_SET, &start, NULL, &one, &count);
-    CHECK_ERR
-    MPI_Offset *nsecp = &nsec;
-    err = H5VL_log_under_dataset_read (mdp, fp->uvlid, H5T_NATIVE_B8, mmsid, mdsid, fp->dxplid, nsecp, NULL);
-    CHECK_ERR
-
-    // Get the ending offset of each section (next 8 * nsec bytes)
-    count = sizeof (MPI_Offset) * nsec;
-    offs  = (MPI_Offset *)malloc (count);
-    err   = H5Sselect_hyperslab (mmsid, H5S_SELECT_SET, &start, NULL, &one, &count);
-    CHECK_ERR
-    start = sizeof (MPI_Offset);
-    err   = H5Sselect_hyperslab (mdsid, H5S_SELECT_SET, &start, NULL, &one, &count);
-    CHECK_ERR
-    err = H5VL_log_under_dataset_read (mdp, fp->uvlid, H5T_NATIVE_B8, mmsid, mdsid, fp->dxplid, offs, NULL);
-    CHECK_ERR
+    while ((int)(fp->mdsecs.size ()) <= md) {
+        H5VL_logi_meta_sec_table_t table;
+
+        // Open the metadata dataset
+        sprintf (mdname, "%s_%d", H5VL_LOG_FILEI_DSET_META, (int)(fp->mdsecs.size ()));
+        mdp = H5VLdataset_open (fp->lgp, &loc, fp->uvlid, mdname, H5P_DATASET_ACCESS_DEFAULT,
+                                fp->dxplid, NULL);
+        CHECK_PTR (mdp)
+
+        // Get data space and size
+        mdsid = H5VL_logi_dataset_get_space (fp, mdp, fp->uvlid, fp->dxplid);
+        CHECK_ID (mdsid)
+        ndim = H5Sget_simple_extent_dims (mdsid, &mdsize, NULL);
+        assert (ndim == 1);
+
+        // Get number of sections (first 8 bytes)
+        start = 0;
+        count = sizeof (MPI_Offset);
+        err   = H5Sselect_hyperslab (mmsid, H5S_SELECT_SET, &start, NULL, &one, &count);
+        CHECK_ERR
+        err = H5Sselect_hyperslab (mdsid, H5S_SELECT_SET, &start, NULL, &one, &count);
+        CHECK_ERR
+        err = H5VL_log_under_dataset_read (mdp, fp->uvlid, H5T_NATIVE_B8, mmsid, mdsid, fp->dxplid,
+                                           &(table.decomp), NULL);
+        CHECK_ERR
+        if (table.decomp & ~H5VL_LOGI_META_DECOMP_KNOWN) { RET_ERR ("Unknown metadata format") }
+        nsec = table.decomp & H5VL_LOGI_META_DECOMP_NSEC_MASK;
+
+        // Get the ending offset of each section (next 8 * nsec bytes), followed by the decoded
+        // size of each section if recorded
+        table.offs.resize (nsec);
+        table.xsizes.resize (nsec);
+        if (nsec > 0) {
+            xsize = table.decomp & H5VL_LOGI_META_DECOMP_FLAG_XSIZE;
+            table.offs.resize (xsize ? nsec * 2 : nsec);
+            count = sizeof (MPI_Offset) * table.offs.size ();
+            err   = H5Sselect_hyperslab (mmsid, H5S_SELECT_SET, &start, NULL, &one, &count);
+            CHECK_ERR
+            start = sizeof (MPI_Offset);
+            err   = H5Sselect_hyperslab (mdsid, H5S_SELECT_SET, &start, NULL, &one, &count);
+            CHECK_ERR
+            err = H5VL_log_under_dataset_read (mdp, fp->uvlid, H5T_NATIVE_B8, mmsid, mdsid,
+                                               fp->dxplid, table.offs.data (), NULL);
+            CHECK_ERR
+
+            if (xsize) {
+                std::copy (table.offs.begin () + nsec, table.offs.end (), table.xsizes.begin ());
+                table.offs.resize (nsec);
+            } else {
+                table.xsizes[0] = table.offs[0] - H5VL_logi_meta_sec_begin (table.decomp);
+                for (i = 1; i < nsec; i++) { table.xsizes[i] = table.offs[i] - table.offs[i - 1]; }
+            }
+        }
+
+        // The sections are read with MPI-IO if the dataset is stored contiguously in the file
+        table.foff = HADDR_UNDEF;
+        if (!(fp->config & H5VL_FILEI_CONFIG_PASSTHRU)) {
+            H5VL_logi_dataset_get_foff (fp, mdp, fp->uvlid, fp->dxplid, &(table.foff));
+        }
+
+        // Close the metadata dataset
+        err = H5VLdataset_close (mdp, fp->uvlid, fp->dxplid, NULL);
+        CHECK_ERR
+        H5Sclose (mdsid);
+        mdsid = -1;
+
+        fp->mdsecs.push_back (std::move (table));
+    }
+
+    return fp->mdsecs[md];
+}
+
+/*
+ * Find the sections starting from sec in md that fit into the metadata buffer size, at least one
+ * Set start and count to their extent in the metadata dataset. Advance sec to the next unprocessed
+ * section. If all section is processed, advance md and set sec to 0 If all metadata datasset is
+ * processed, set md to -1
+ */
+static void H5VL_log_filei_metawin_next (H5VL_log_file_t *fp,
+                                         int &md,
+                                         int &sec,
+                                         hsize_t &start,
+                                         hsize_t &count) {
+    int i;
+    MPI_Offset nsec;   // Number of sections in current metadata dataset
+    MPI_Offset xsize;  // Size of the sections once decoded
+
+    auto &table = H5VL_log_filei_mdsec_get (fp, md);
+    nsec        = table.decomp & H5VL_LOGI_META_DECOMP_NSEC_MASK;
 
     // Determine #sec to fit
     if (sec >= nsec) { RET_ERR ("Invalid section") }
     if (sec == 0) {  // First section always starts after the sections offset array
-        start = sizeof (MPI_Offset) * (nsec + 1);
+        start = H5VL_logi_meta_sec_begin (table.decomp);
     } else {
-        start = offs[sec - 1];
+        start = table.offs[sec - 1];
     }
+    // At least 1 section is read even if it does not fit into buffer limit
+    // The buffer holds the sections after inflating and expanding them
+    xsize = table.xsizes[sec];
     for (i = sec + 1; i < nsec; i++) {
-        if (offs[i] - start > (size_t) (fp->mbuf_size)) { break; }
+        xsize += table.xsizes[i];
+        if (xsize > fp->mbuf_size) { break; }
     }
-    if (i <= sec) { RET_ERR ("OOM") }  // At least 1 section should fit into buffer limit
-    count = offs[i - 1] - start;
+    count = table.offs[i - 1] - start;
 
     // Advance sec and md
     sec = i;
@@ -512,25 +680,138 @@ void H5VL_log_filei_metaupdate_part (H5VL_log_file_t *fp, int &md, int &sec) {
         md++;
     }
     if (md >= fp->nmdset) { md = -1; }
+}
+
+/*
+ * Start reading the sections starting from sec in md that fit into the metadata buffer size into
+ * win. Advance sec and md as H5VL_log_filei_metawin_next does.
+ * The sections are read with nonblocking MPI-IO when the file offset of the metadata dataset is
+ * known, so the caller can work on the previous window while they are being read.
+ * If the index already holds the window (fp->idxwin_md and fp->idxwin_sec), it is not read and
+ * win.held is set instead.
+ */
+void H5VL_log_filei_metawin_start (H5VL_log_file_t *fp,
+                                   int &md,
+                                   int &sec,
+                                   H5VL_log_filei_metawin_t &win) {
+    herr_t err = 0;
+    int mpierr;
+    H5VL_loc_params_t loc;
+    void *mdp   = NULL;  // Metadata dataset
+    hid_t mdsid = -1;    // Metadata dataset space
+    hid_t mmsid = -1;    // metadata buffer memory space
+    hsize_t start, count, one = 1;
+    char mdname[16];
+    H5VL_logi_err_finally finally ([&mdsid, &mmsid] () -> void {
+        H5VL_log_Sclose (mdsid);
+        H5VL_log_Sclose (mmsid);
+    });
+
+    H5VL_LOGI_PROFILING_TIMER_START;
+
+    auto &table = H5VL_log_filei_mdsec_get (fp, md);
+
+    win.md  = md;
+    win.sec = sec;
+    H5VL_log_filei_metawin_next (fp, md, sec, start, count);
 
-    // Allocate buffer for raw metadata
-    buf = (char *)malloc (sizeof (char) * count);
+    // Searched in the index as is
+    if ((win.md == fp->idxwin_md) && (win.sec == fp->idxwin_sec)) {
+        win.held = true;
+        H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_METAUPDATE);
+        return;
+    }
+
+    win.size = (MPI_Offset)count;
+    win.buf  = (char *)malloc (sizeof (char) * count);
+    CHECK_PTR (win.buf)
 
     // Read metadata
-    err = H5Sselect_hyperslab (mdsid, H5S_SELECT_SET, &start, NULL, &one, &count);
-    CHECK_ERR
-    start = 0;
-    err   = H5Sselect_hyperslab (mmsid, H5S_SELECT_SET, &start, NULL, &one, &count);
-    CHECK_ERR
-    err = H5VL_log_under_dataset_read (mdp, fp->uvlid, H5T_NATIVE_B8, mmsid, mdsid, fp->dxplid, buf, NULL);
-    CHECK_ERR
-
-    // Close the metadata dataset
-    err = H5VLdataset_close (mdp, fp->uvlid, fp->dxplid, NULL);
-    CHECK_ERR
+    if ((table.foff != HADDR_UNDEF) && (count <= (hsize_t)INT_MAX)) {
+        mpierr = MPI_File_iread_at (fp->fh, (MPI_Offset)(table.foff + start), win.buf, (int)count,
+                                    MPI_BYTE, &(win.req));
+        CHECK_MPIERR
+    } else {
+        loc.type     = H5VL_OBJECT_BY_SELF;
+        loc.obj_type = H5I_GROUP;
+        sprintf (mdname, "%s_%d", H5VL_LOG_FILEI_DSET_META, win.md);
+        mdp = H5VLdataset_open (fp->lgp, &loc, fp->uvlid, mdname, H5P_DATASET_ACCESS_DEFAULT,
+                                fp->dxplid, NULL);
+        CHECK_PTR (mdp)
+        mdsid = H5VL_logi_dataset_get_space (fp, mdp, fp->uvlid, fp->dxplid);
+        CHECK_ID (mdsid)
+        mmsid = H5Screate_simple (1, &count, &count);
+        CHECK_ID (mmsid)
+
+        err = H5Sselect_hyperslab (mdsid, H5S_SELECT_SET, &start, NULL, &one, &count);
+        CHECK_ERR
+        err = H5VL_log_under_dataset_read (mdp, fp->uvlid, H5T_NATIVE_B8, mmsid, mdsid, fp->dxplid,
+                                           win.buf, NULL);
+        CHECK_ERR
+
+        // Close the metadata dataset
+        err = H5VLdataset_close (mdp, fp->uvlid, fp->dxplid, NULL);
+        CHECK_ERR
+    }
+
+    H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_METAUPDATE);
+}
+
+/*
+ * Remove all existing index entry in fp
+ * Wait for the sections in win and load them in the metadata index of fp, win is freed
+ */
+void H5VL_log_filei_metawin_load (H5VL_log_file_t *fp, H5VL_log_filei_metawin_t &win) {
+    int mpierr;
+    int cnt;
+    MPI_Offset size;   // Size of the entries in win.buf
+    MPI_Offset esize;  // Size of decoded metadata entries
+    char *ebuf;        // Decoded metadata entries
+    MPI_Status stat;
+
+    H5VL_LOGI_PROFILING_TIMER_START;
+
+    // Wait for the sections
+    if (win.req != MPI_REQUEST_NULL) {
+        mpierr = MPI_Wait (&(win.req), &stat);
+        CHECK_MPIERR
+        mpierr = MPI_Get_count (&stat, MPI_BYTE, &cnt);
+        CHECK_MPIERR
+        if (cnt != win.size) { RET_ERR ("Metadata read failed") }
+    }
+    size = win.size;
+
+    // Remove all index entries
+    fp->idx->clear ();
+    fp->idxwin_md = -1;
+
+    // Selections referred by the entries
+    H5VL_log_filei_dictload (fp);
+
+    // Inflate, unpack and expand the sections
+    ebuf = H5VL_logi_meta_sec_decode (fp->mdsecs[win.md].decomp, fp->dict, win.buf, size, &esize);
+    if (ebuf) {
+        H5VL_log_free (win.buf);
+        win.buf = ebuf;
+        size    = esize;
+    }
 
     // Parse metadata
-    fp->idx->parse_block (buf, count);
+    fp->idx->parse_block (win.buf, size);
+    fp->idxwin_md  = win.md;
+    fp->idxwin_sec = win.sec;
+
+    H5VL_log_filei_metawin_free (win);
 
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_FILEI_METAUPDATE);
 }
+
+// Free the buffer of win, a read in progress is completed first
+void H5VL_log_filei_metawin_free (H5VL_log_filei_metawin_t &win) {
+    if (win.req != MPI_REQUEST_NULL) { MPI_Wait (&(win.req), MPI_STATUS_IGNORE); }
+    H5VL_log_free (win.buf);
+    win.md   = -1;
+    win.sec  = -1;
+    win.size = 0;
+    win.held = false;
+}
@@ -9,9 +9,11 @@
 #endif
 
 #include <cassert>
+#include <string>
 
 #include "H5VL_log.h"
 #include "H5VL_log_file.hpp"
+#include "H5VL_log_filei.hpp"
 #include "H5VL_log_link.hpp"
 #include "H5VL_log_linki.hpp"
 #include "H5VL_log_obj.hpp"
@@ -136,6 +138,9 @@ herr_t H5VL_log_link_copy (void *src_obj,
                              loc_params2, uvlid, lcpl_id, lapl_id, dxpl_id, ureqp);
         CHECK_ERR
 
+        // Links changed, rewrite the dataset catalog at close
+        if (o_dst && o_dst->fp->is_log_based_file) { o_dst->fp->catalog_dirty = true; }
+
         if (req) {
             rp->append (ureq);
             *req = rp;
@@ -180,6 +185,7 @@ herr_t H5VL_log_link_move (void *src_obj,
     const char *original_name1 = NULL;  // Original value in loc_params before being remapped
     char *iname2               = NULL;  // Internal name of object
     const char *original_name2 = NULL;  // Original value in loc_params before being remapped
+    std::string from, to;               // Paths of the link before and after the move
 
     try {
 #ifdef LOGVOL_DEBUG
@@ -234,10 +240,20 @@ herr_t H5VL_log_link_move (void *src_obj,
             uvlid = o_dst->uvlid;
         assert (uvlid > 0);
 
+        // Paths of the link before and after the move, for the dataset catalog
+        if (o_src->fp->is_log_based_file && o_src->fp == o_dst->fp) {
+            from = H5VL_log_linki_path (o_src, loc_params1, dxpl_id);
+            to   = H5VL_log_linki_path (o_dst, loc_params2, dxpl_id);
+        }
+
         err = H5VLlink_move ((o_src ? o_src->uo : NULL), loc_params1, (o_dst ? o_dst->uo : NULL),
                              loc_params2, uvlid, lcpl_id, lapl_id, dxpl_id, ureqp);
         CHECK_ERR
 
+        if (o_src->fp->is_log_based_file) {
+            H5VL_log_filei_catalog_relink (o_src->fp, from, to);
+        }
+
         if (req) {
             rp->append (ureq);
             *req = rp;
@@ -352,6 +368,7 @@ herr_t H5VL_log_link_specific (void *obj,
     H5VL_log_linki_iterate_op_data *ctx = NULL;
     char *iname                         = NULL;  // Internal name of object
     const char *original_name = NULL;  // Original value in loc_params before being remapped
+    std::string from;                  // Path of the link to delete
 
     try {
 #ifdef LOGVOL_DEBUG
@@ -401,9 +418,18 @@ herr_t H5VL_log_link_specific (void *obj,
             args->args.iterate.op_data = ctx;
         }
 
+        // Path of the link to delete, for the dataset catalog
+        if (args->op_type == H5VL_LINK_DELETE) {
+            from = H5VL_log_linki_path (o, loc_params, dxpl_id);
+        }
+
         err = H5VLlink_specific (o->uo, loc_params, o->uvlid, args, dxpl_id, ureqp);
         CHECK_ERR
 
+        if (args->op_type == H5VL_LINK_DELETE) {
+            H5VL_log_filei_catalog_relink (o->fp, from, std::string ());
+        }
+
         if (args->op_type == H5VL_LINK_ITER) {
             args->args.iterate.op      = ctx->op;
             args->args.iterate.op_data = ctx->op_data;
@@ -8,7 +8,9 @@
 #include <config.h>
 #endif
 
+#include "H5VL_log_file.hpp"
 #include "H5VL_log_linki.hpp"
+#include "H5VL_logi_wrapper.hpp"
 
 herr_t H5VL_log_linki_iterate_op (hid_t group,
                                   const char *name,
@@ -30,3 +32,21 @@ herr_t H5VL_log_linki_iterate_op (hid_t group,
 
     return 0;
 }
+
+/*
+ * Full path in the under VOL of the link at loc, names in loc must be remapped already
+ * Empty if the location object is not linked
+ */
+std::string H5VL_log_linki_path (H5VL_log_obj_t *o, const H5VL_loc_params_t *loc, hid_t dxpl_id) {
+    std::string base;
+    std::string name;
+
+    base = H5VL_logi_object_get_name (o->fp, o->uo, loc->obj_type, o->uvlid, dxpl_id);
+    if (loc->type != H5VL_OBJECT_BY_NAME) { return base; }
+
+    name = loc->loc_data.loc_by_name.name;
+    if (name[0] == '/') { return name; }
+    if (base.empty ()) { return base; }
+    if (base.back () != '/') { base += '/'; }
+    return base + name;
+}
@@ -8,6 +8,10 @@
 
 #include <H5VLconnector.h>
 
+#include <string>
+
+#include "H5VL_log_obj.hpp"
+
 typedef struct H5VL_log_linki_iterate_op_data {
     H5L_iterate2_t op;
     void *op_data;
@@ -17,3 +21,4 @@ herr_t H5VL_log_linki_iterate_op (hid_t group,
                                   const char *name,
                                   const H5L_info2_t *info,
                                   void *op_data);
+std::string H5VL_log_linki_path (H5VL_log_obj_t *o, const H5VL_loc_params_t *loc, hid_t dxpl_id);
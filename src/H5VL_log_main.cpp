@@ -13,6 +13,7 @@
 
 #include "H5VL_log.h"
 #include "H5VL_log_dataset.hpp"
+#include "H5VL_log_file.hpp"
 #include "H5VL_log_info.hpp"
 #include "H5VL_log_main.hpp"
 #include "H5VL_logi.hpp"
@@ -82,7 +83,9 @@ herr_t H5VL_log_init (hid_t vipl_id) {
         CHECK_MPIERR
         if (!mpi_inited) { MPI_Init (NULL, NULL); }
 
-        // Register H5Dwrite_n and H5Dread_n
+        H5VL_log_profile_init ();
+
+        // Register H5Dwrite_n, H5Dread_n, H5Fprofile_report, and H5Fget_io_stat
         if (!h5dwriten_registered) {
             err = H5VLregister_opt_operation (H5VL_SUBCLS_DATASET, "H5VL_log.H5Dwrite_n",
                                               &H5Dwrite_n_op_val);
@@ -90,6 +93,12 @@ herr_t H5VL_log_init (hid_t vipl_id) {
             err = H5VLregister_opt_operation (H5VL_SUBCLS_DATASET, "H5VL_log.H5Dread_n",
                                               &H5Dread_n_op_val);
             CHECK_ERR
+            err = H5VLregister_opt_operation (H5VL_SUBCLS_FILE, "H5VL_log.H5Fprofile_report",
+                                              &H5Fprofile_report_op_val);
+            CHECK_ERR
+            err = H5VLregister_opt_operation (H5VL_SUBCLS_FILE, "H5VL_log.H5Fget_io_stat",
+                                              &H5Fget_io_stat_op_val);
+            CHECK_ERR
             h5dwriten_registered = true;
         }
 
@@ -154,6 +163,12 @@ herr_t H5VL_log_obj_term (void) {
             // Unregister H5Dread_n
             err = H5VLunregister_opt_operation (H5VL_SUBCLS_DATASET, "H5VL_log.H5Dread_n");
             CHECK_ERR
+            // Unregister H5Fprofile_report
+            err = H5VLunregister_opt_operation (H5VL_SUBCLS_FILE, "H5VL_log.H5Fprofile_report");
+            CHECK_ERR
+            // Unregister H5Fget_io_stat
+            err = H5VLunregister_opt_operation (H5VL_SUBCLS_FILE, "H5VL_log.H5Fget_io_stat");
+            CHECK_ERR
             h5dwriten_registered = false;
         }
 
@@ -12,6 +12,7 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <vector>
@@ -41,25 +42,112 @@ static bool lessthan (int ndim, T *a, T *b) {
     return false;
 }
 
-#define ELEM_SWAP_EX(A, B)     \
-    {                          \
-        tmp       = starts[A]; \
-        starts[A] = starts[B]; \
-        starts[B] = tmp;       \
-        tmp       = counts[A]; \
-        counts[A] = counts[B]; \
-        counts[B] = tmp;       \
+// Selections with fewer blocks than this are sorted with the comparison sort
+#define H5VL_LOGI_RADIX_SORT_THRESHOLD 256
+
+/*
+ * Compute the linearized offset of each block start in a dataspace of size dims
+ * Return false if the offsets cannot be represented in 64 bits
+ */
+static bool linearize_starts (
+    int ndim, hsize_t *dims, int len, hsize_t **starts, std::vector<uint64_t> &keys) {
+    int i, j;
+    uint64_t step[H5S_MAX_RANK];
+    uint64_t key;
+
+    if ((!dims) || (ndim <= 0)) { return false; }
+
+    step[ndim - 1] = 1;
+    for (i = ndim - 1; i > 0; i--) {
+        if (dims[i] && step[i] > UINT64_MAX / dims[i]) { return false; }
+        step[i - 1] = step[i] * dims[i];
+    }
+    if (dims[0] && step[0] > UINT64_MAX / dims[0]) { return false; }
+
+    keys.resize (len);
+    for (i = 0; i < len; i++) {
+        key = 0;
+        for (j = 0; j < ndim; j++) {
+            if (starts[i][j] >= dims[j]) { return false; }  // Out of extent, can't linearize
+            key += starts[i][j] * step[j];
+        }
+        keys[i] = key;
     }
 
-static void sortblocks (int ndim, int len, hsize_t **starts, hsize_t **counts) {
+    return true;
+}
+
+/*
+ * LSD radix sort on 8-bit digits, idx receives the sorted order of keys
+ * Digits that are identical across all keys are skipped
+ */
+static void radix_sort (std::vector<uint64_t> &keys, std::vector<int> &idx) {
+    int i, j;
+    int len = (int)keys.size ();
+    size_t cnt[8][256];
+    size_t off, tmp;
+    std::vector<uint64_t> kbuf (len);
+    std::vector<int> ibuf (len);
+    uint64_t *ksrc = keys.data (), *kdst = kbuf.data ();
+    int *isrc, *idst = ibuf.data ();
+
+    idx.resize (len);
+    isrc = idx.data ();
+    for (i = 0; i < len; i++) { isrc[i] = i; }
+
+    // Histogram of all digits in a single pass
+    memset (cnt, 0, sizeof (cnt));
+    for (i = 0; i < len; i++) {
+        for (j = 0; j < 8; j++) { cnt[j][(ksrc[i] >> (j * 8)) & 0xff]++; }
+    }
+
+    for (j = 0; j < 8; j++) {
+        if (cnt[j][(ksrc[0] >> (j * 8)) & 0xff] == (size_t)len) {
+            continue;
+        }  // All keys share the same digit
+
+        off = 0;
+        for (i = 0; i < 256; i++) {
+            tmp       = cnt[j][i];
+            cnt[j][i] = off;
+            off += tmp;
+        }
+        for (i = 0; i < len; i++) {
+            off       = cnt[j][(ksrc[i] >> (j * 8)) & 0xff]++;
+            kdst[off] = ksrc[i];
+            idst[off] = isrc[i];
+        }
+
+        std::swap (ksrc, kdst);
+        std::swap (isrc, idst);
+    }
+
+    // Result ended in the scratch buffer
+    if (isrc != idx.data ()) {
+        memcpy (idx.data (), isrc, sizeof (int) * len);
+        memcpy (keys.data (), ksrc, sizeof (uint64_t) * len);
+    }
+}
+
+static void sortblocks (int ndim, hsize_t *dims, int len, hsize_t **starts, hsize_t **counts) {
     int i, j, k;
     hsize_t *tmp1, *tmp2;
-    std::vector<int> idx (len);
+    std::vector<int> idx;
+    std::vector<uint64_t> keys;
 
-    for (i = 0; i < len; i++) { idx[i] = i; }
+    if (len < 2) { return; }
+
+    if (len >= H5VL_LOGI_RADIX_SORT_THRESHOLD &&
+        linearize_starts (ndim, dims, len, starts, keys)) {
+        // The linearized offset preserves the row-major order of the starts
+        radix_sort (keys, idx);
+    } else {
+        idx.resize (len);
+        for (i = 0; i < len; i++) { idx[i] = i; }
 
-    auto comp = [&] (int &l, int &r) -> bool { return lessthan (ndim, starts[l], starts[r]); };
-    std::sort (idx.begin (), idx.end (), comp);
+        auto comp = [&] (int &l, int &r) -> bool { return lessthan (ndim, starts[l], starts[r]); };
+        std::sort (idx.begin (), idx.end (), comp);
+    }
 
     // Reorder according to index
     for (i = 0; i < len; i++) {
@@ -87,12 +175,15 @@ static void sortblocks (int ndim, int len, hsize_t **starts, hsize_t **counts) {
     }
 }
 
+/*
+ * Coalesce adjacent blocks, one dimension at a time from the fastest changing one
+ * nmerged is the number of trailing dimensions that are already coalesced
+ */
 template <bool use_end, typename T>
-static void merge_blocks (int ndim, T &len, hsize_t **starts, hsize_t **counts) {
+static void merge_blocks (int ndim, T &len, hsize_t **starts, hsize_t **counts, int nmerged = 0) {
     int d, i, j, k;
-    std::vector<int> idx (len);
 
-    for (d = ndim - 1; d > -1; d--) {
+    for (d = ndim - 1 - nmerged; d > -1 && len > 1; d--) {
         j = 0;
         for (i = 1; i < len; i++) {
             for (k = 0; k < ndim; k++) {
@@ -252,7 +343,7 @@ H5VL_log_selections::H5VL_log_selections (hid_t dsid) {
 
                 merge_blocks<true> (ndim, nblock, hstarts, hends);
 
-                sortblocks (ndim, nblock, hstarts, hends);
+                sortblocks (ndim, this->dims, nblock, hstarts, hends);
 
                 merge_blocks<true> (ndim, nblock, hstarts, hends);
 
@@ -352,7 +443,7 @@ H5VL_log_selections::H5VL_log_selections (hid_t dsid) {
                             }
 
                             // Sort into non-decreasing order
-                            sortblocks (ndim, nreq - old_nreq, starts + old_nreq,
+                            sortblocks (ndim, this->dims, nreq - old_nreq, starts + old_nreq,
                                         counts + old_nreq);
 
                             // HDF5 selection guarantees no interleving, still merge coaleasable
@@ -373,26 +464,56 @@ H5VL_log_selections::H5VL_log_selections (hid_t dsid) {
             this->alloc (nblock);
 
             if (nblock) {
-                hstarts    = (hsize_t **)malloc (sizeof (hsize_t) * nblock);
+                std::vector<uint64_t> keys;
+                std::vector<int> idx;
+
+                hstarts    = (hsize_t **)malloc (sizeof (hsize_t *) * nblock);
+                CHECK_PTR (hstarts)
                 hstarts[0] = (hsize_t *)malloc (sizeof (hsize_t) * ndim * nblock);
+                CHECK_PTR (hstarts[0])
                 for (i = 1; i < nblock; i++) { hstarts[i] = hstarts[i - 1] + ndim; }
 
                 err = H5Sget_select_elem_pointlist (dsid, 0, nblock, hstarts[0]);
                 CHECK_ERR
 
-                for (i = 0; i < nblock; i++) {
-                    for (j = 0; j < ndim; j++) {
-                        starts[i][j] = (MPI_Offset)hstarts[i][j];
-                        counts[i][j] = 1;
+                if (nblock >= H5VL_LOGI_RADIX_SORT_THRESHOLD &&
+                    linearize_starts (ndim, this->dims, nblock, hstarts, keys)) {
+                    radix_sort (keys, idx);
+
+                    // Emit the points in sorted order, merging runs along the last dimension in
+                    // the same pass. Consecutive offsets are in the same row unless the latter
+                    // starts a new row.
+                    j = -1;
+                    for (i = 0; i < nblock; i++) {
+                        k = idx[i];
+                        if (j >= 0 && keys[i] == keys[i - 1] + 1 && hstarts[k][ndim - 1] != 0) {
+                            counts[j][ndim - 1]++;
+                        } else {
+                            j++;
+                            for (l = 0; l < ndim; l++) {
+                                starts[j][l] = hstarts[k][l];
+                                counts[j][l] = 1;
+                            }
+                        }
+                    }
+                    nblock = j + 1;
+
+                    merge_blocks<false> (ndim, nblock, starts, counts, 1);
+                } else {
+                    for (i = 0; i < nblock; i++) {
+                        for (j = 0; j < ndim; j++) {
+                            starts[i][j] = (MPI_Offset)hstarts[i][j];
+                            counts[i][j] = 1;
+                        }
                     }
-                }
 
-                // Merge blocks
-                auto comp = [this] (hsize_t *l, hsize_t *r) -> bool {
-                    return lessthan (this->ndim, l, r);
-                };
-                std::sort (starts, starts + nblock, comp);
-                merge_blocks<false> (ndim, nblock, starts, counts);
+                    // Merge blocks
+                    auto comp = [this] (hsize_t *l, hsize_t *r) -> bool {
+                        return lessthan (this->ndim, l, r);
+                    };
+                    std::sort (starts, starts + nblock, comp);
+                    merge_blocks<false> (ndim, nblock, starts, counts);
+                }
             }
             this->nsel = nblock;
         } break;
@@ -679,3 +800,87 @@ void H5VL_log_selections::encode (char *mbuf, MPI_Offset *dsteps, int dimoff) {
         }
     }
 }
+
+/*
+ * A selection can be encoded as a point list if every block is a single row segment (count 1 on
+ * all but the last dimension) and the blocks are sorted without overlap. Each block is stored as
+ * the distance from the end of the previous block and the length of the segment minus 1, both
+ * as varints of the linearized offset.
+ */
+size_t H5VL_log_selections::get_point_list_size (MPI_Offset *dsteps, int dimoff) {
+    int i, j;
+    size_t size = 0;
+    MPI_Offset off;      // Linearized offset of the block start
+    MPI_Offset end = 0;  // Linearized offset after the previous block
+
+    if ((!starts) || (!dsteps) || (ndim - dimoff < 1)) { return 0; }
+
+    for (i = 0; i < nsel; i++) {
+        for (j = dimoff; j < ndim - 1; j++) {
+            if (counts[i][j] != 1) { return 0; }
+        }
+        H5VL_logi_sel_encode (ndim - dimoff, dsteps + dimoff, starts[i] + dimoff, &off);
+        if (off < end) { return 0; }  // Not sorted or overlapping
+
+        size += H5VL_logi_varint_size ((uint64_t) (off - end));
+        size += H5VL_logi_varint_size ((uint64_t) (counts[i][ndim - 1] - 1));
+        end = off + (MPI_Offset)counts[i][ndim - 1];
+    }
+
+    return size;
+}
+
+// Assume get_point_list_size returned non-zero
+void H5VL_log_selections::encode_point_list (char *mbuf, MPI_Offset *dsteps, int dimoff) {
+    int i;
+    MPI_Offset off;
+    MPI_Offset end = 0;
+
+    for (i = 0; i < nsel; i++) {
+        H5VL_logi_sel_encode (ndim - dimoff, dsteps + dimoff, starts[i] + dimoff, &off);
+        mbuf = H5VL_logi_varint_encode ((uint64_t) (off - end), mbuf);
+        mbuf = H5VL_logi_varint_encode ((uint64_t) (counts[i][ndim - 1] - 1), mbuf);
+        end  = off + (MPI_Offset)counts[i][ndim - 1];
+    }
+}
+
+size_t H5VL_log_selections::get_varint_size (int dimoff) {
+    int i, j;
+    size_t size                  = 0;
+    hsize_t pstart[H5S_MAX_RANK] = {0};  // Start of the previous block
+    hsize_t pcount[H5S_MAX_RANK] = {0};  // Count of the previous block
+
+    for (i = 0; i < nsel; i++) {
+        for (j = dimoff; j < ndim; j++) {
+            size += H5VL_logi_varint_size (
+                H5VL_logi_zigzag_encode ((int64_t)starts[i][j] - (int64_t)pstart[j]));
+            pstart[j] = starts[i][j];
+        }
+        for (j = dimoff; j < ndim; j++) {
+            size += H5VL_logi_varint_size (
+                H5VL_logi_zigzag_encode ((int64_t)counts[i][j] - (int64_t)pcount[j]));
+            pcount[j] = counts[i][j];
+        }
+    }
+
+    return size;
+}
+
+void H5VL_log_selections::encode_varint (char *mbuf, int dimoff) {
+    int i, j;
+    hsize_t pstart[H5S_MAX_RANK] = {0};  // Start of the previous block
+    hsize_t pcount[H5S_MAX_RANK] = {0};  // Count of the previous block
+
+    for (i = 0; i < nsel; i++) {
+        for (j = dimoff; j < ndim; j++) {
+            mbuf = H5VL_logi_varint_encode (
+                H5VL_logi_zigzag_encode ((int64_t)starts[i][j] - (int64_t)pstart[j]), mbuf);
+            pstart[j] = starts[i][j];
+        }
+        for (j = dimoff; j < ndim; j++) {
+            mbuf = H5VL_logi_varint_encode (
+                H5VL_logi_zigzag_encode ((int64_t)counts[i][j] - (int64_t)pcount[j]), mbuf);
+            pcount[j] = counts[i][j];
+        }
+    }
+}
@@ -41,6 +41,15 @@ class H5VL_log_selections {
     void encode (char *mbuf,
                  MPI_Offset *dsteps = NULL,
                  int dimoff = 0);  // Encode the selection according to logvol metadata format
+    size_t get_point_list_size (MPI_Offset *dsteps,
+                                int dimoff = 0);  // Size of the point list encoding, 0 if not
+                                                  // applicable
+    void encode_point_list (char *mbuf,
+                            MPI_Offset *dsteps,
+                            int dimoff = 0);  // Encode the selection as a delta varint point list
+    size_t get_varint_size (int dimoff = 0);  // Size of the zigzag varint delta encoding
+    void encode_varint (char *mbuf, int dimoff = 0);  // Encode the starts and counts as zigzag
+                                                      // varint deltas from the previous block
 
    private:
     hsize_t **sels_arr = NULL;  // Allocated starts and counts pointer array, if present, need free
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "H5VL_logi_dedup.hpp"
+#include "H5VL_logi_err.hpp"
+#include "H5VL_logi_util.hpp"
+
+H5VL_logi_arena::H5VL_logi_arena () : bidx (0), boff (0), nbyte (0) {}
+
+H5VL_logi_arena::~H5VL_logi_arena () {
+    for (auto b : blocks) { free (b); }
+    for (auto b : large) { free (b); }
+}
+
+char *H5VL_logi_arena::alloc (size_t size) {
+    char *ret;
+
+    nbyte += size;
+
+    if (size > H5VL_LOGI_ARENA_BLOCK) {
+        ret = (char *)malloc (size);
+        CHECK_PTR (ret)
+        large.push_back (ret);
+        return ret;
+    }
+
+    if (blocks.empty () || boff + size > H5VL_LOGI_ARENA_BLOCK) {
+        if (!blocks.empty ()) { bidx++; }
+        if (bidx == blocks.size ()) {
+            ret = (char *)malloc (H5VL_LOGI_ARENA_BLOCK);
+            CHECK_PTR (ret)
+            blocks.push_back (ret);
+        }
+        boff = 0;
+    }
+
+    ret = blocks[bidx] + boff;
+    boff += size;
+
+    return ret;
+}
+
+void H5VL_logi_arena::reset () {
+    for (auto b : large) { free (b); }
+    large.clear ();
+    bidx  = 0;
+    boff  = 0;
+    nbyte = 0;
+}
+
+H5VL_logi_wreq_hash::H5VL_logi_wreq_hash () : nent (0) {
+    table.resize (H5VL_LOGI_WREQ_HASH_INIT, entry_t{0, NULL, NULL, 0, 0});
+}
+
+void H5VL_logi_wreq_hash::grow () {
+    size_t i, mask;
+    std::vector<entry_t> old (table.size () << 1, entry_t{0, NULL, NULL, 0, 0});
+
+    // Reinsert with the stored hashes
+    old.swap (table);
+    mask = table.size () - 1;
+    for (auto &e : old) {
+        if (!e.req) continue;
+        for (i = e.hash & mask; table[i].req; i = (i + 1) & mask);
+        table[i] = e;
+    }
+}
+
+H5VL_log_wreq_t *H5VL_logi_wreq_hash::find_or_insert (H5VL_log_wreq_t *r) {
+    size_t i, mask;
+    uint64_t hash;
+    int32_t sel_size = (int32_t) (r->hdr->meta_size - (r->sel_buf - r->meta_buf));
+
+    hash = H5VL_logi_hash64 (r->sel_buf, sel_size);
+
+    // Keep the load factor under 1/2
+    if ((nent + 1) << 1 > table.size ()) { grow (); }
+
+    mask = table.size () - 1;
+    for (i = hash & mask; table[i].req; i = (i + 1) & mask) {
+        entry_t &e = table[i];
+        if (e.hash == hash && e.meta_size == r->hdr->meta_size && e.sel_size == sel_size &&
+            memcmp (e.sel, r->sel_buf, sel_size) == 0) {
+            return e.req;
+        }
+    }
+
+    table[i].hash      = hash;
+    table[i].req       = r;
+    table[i].meta_size = r->hdr->meta_size;
+    table[i].sel_size  = sel_size;
+    table[i].sel       = arena.alloc (sel_size);
+    memcpy (table[i].sel, r->sel_buf, sel_size);
+    nent++;
+
+    return NULL;
+}
+
+void H5VL_logi_wreq_hash::clear () {
+    if (nent) {
+        std::fill (table.begin (), table.end (), entry_t{0, NULL, NULL, 0, 0});
+        nent = 0;
+    }
+
+    arena.reset ();
+}
+
+H5VL_logi_sel_dict::H5VL_logi_sel_dict () : psize (0) {
+    table.resize (H5VL_LOGI_WREQ_HASH_INIT, -1);
+}
+
+void H5VL_logi_sel_dict::grow () {
+    size_t i, mask;
+    std::vector<int64_t> old (table.size () << 1, -1);
+
+    // Reinsert with the stored hashes
+    old.swap (table);
+    mask = table.size () - 1;
+    for (auto r : old) {
+        if (r < 0) continue;
+        for (i = recs[r].hash & mask; table[i] >= 0; i = (i + 1) & mask);
+        table[i] = r;
+    }
+}
+
+MPI_Offset H5VL_logi_sel_dict::lookup (int32_t flag, char *sel, int32_t sel_size) {
+    size_t i, mask;
+    uint64_t hash;
+
+    // The same bytes mean different selections under different flags
+    hash = H5VL_logi_hash64 (sel, sel_size) ^ ((uint64_t)flag * 0x9e3779b97f4a7c15ULL);
+
+    mask = table.size () - 1;
+    for (i = hash & mask; table[i] >= 0; i = (i + 1) & mask) {
+        rec_t &e = recs[table[i]];
+        if (e.hash == hash && e.flag == flag && e.sel_size == sel_size &&
+            memcmp (e.sel, sel, sel_size) == 0) {
+            // Second time seen, add to the dictionary
+            if (e.id < 0) {
+                e.id = H5VL_LOGI_SEL_DICT_PENDING | (MPI_Offset)pending.size ();
+                pending.push_back (table[i]);
+                psize += sizeof (int32_t) * 2 + sel_size;
+            }
+            return e.id;
+        }
+    }
+
+    // First time seen, remember it if there is space
+    if (arena.size () + sel_size > H5VL_LOGI_SEL_DICT_MAX_SIZE) { return -1; }
+
+    recs.push_back (rec_t{hash, arena.alloc (sel_size), flag, sel_size, -1});
+    memcpy (recs.back ().sel, sel, sel_size);
+    table[i] = (int64_t) (recs.size () - 1);
+
+    // Keep the load factor under 1/2
+    if (recs.size () << 1 > table.size ()) { grow (); }
+
+    return -1;
+}
+
+bool H5VL_logi_sel_dict::get (MPI_Offset id, int32_t *flag, char **sel, int32_t *sel_size) {
+    size_t r;
+
+    if (id & H5VL_LOGI_SEL_DICT_PENDING) {
+        id &= ~H5VL_LOGI_SEL_DICT_PENDING;
+        if (id < 0 || id >= (MPI_Offset)pending.size ()) { return false; }
+        r = pending[id];
+    } else {
+        auto it = ids.find (id);
+        if (it == ids.end ()) { return false; }
+        r = it->second;
+    }
+
+    *flag     = recs[r].flag;
+    *sel      = recs[r].sel;
+    *sel_size = recs[r].sel_size;
+
+    return true;
+}
+
+void H5VL_logi_sel_dict::pack_pending (char *buf) {
+    int32_t *ip;
+
+    for (auto r : pending) {
+        ip    = (int32_t *)buf;
+        ip[0] = recs[r].flag;
+        ip[1] = recs[r].sel_size;
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)ip, (uint32_t *)(ip + 2));
+#endif
+        buf += sizeof (int32_t) * 2;
+        memcpy (buf, recs[r].sel, recs[r].sel_size);
+        buf += recs[r].sel_size;
+    }
+}
+
+void H5VL_logi_sel_dict::commit (MPI_Offset base) {
+    size_t i;
+
+    for (i = 0; i < pending.size (); i++) {
+        recs[pending[i]].id = base + (MPI_Offset)i;
+        ids[base + (MPI_Offset)i] = pending[i];
+    }
+    pending.clear ();
+    psize = 0;
+}
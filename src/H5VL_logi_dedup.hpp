@@ -0,0 +1,157 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#pragma once
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "H5VL_logi_nb.hpp"
+
+// 64-bit hash of a byte string (MurmurHash64A), every byte affects every bit of the result
+inline uint64_t H5VL_logi_hash64 (const void *buf, size_t len) {
+    const uint64_t m   = 0xc6a4a7935bd1e995ULL;
+    const int r        = 47;
+    const uint8_t *bp  = (const uint8_t *)buf;
+    const uint8_t *end = bp + (len - len % sizeof (uint64_t));
+    uint64_t h         = 0x5bd1e9955bd1e995ULL ^ (len * m);
+    uint64_t k;
+
+    for (; bp < end; bp += sizeof (uint64_t)) {
+        memcpy (&k, bp, sizeof (uint64_t));  // Selections are not aligned in meta_buf
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (len % sizeof (uint64_t)) {
+        case 7:
+            h ^= (uint64_t) (bp[6]) << 48;  // fall through
+        case 6:
+            h ^= (uint64_t) (bp[5]) << 40;  // fall through
+        case 5:
+            h ^= (uint64_t) (bp[4]) << 32;  // fall through
+        case 4:
+            h ^= (uint64_t) (bp[3]) << 24;  // fall through
+        case 3:
+            h ^= (uint64_t) (bp[2]) << 16;  // fall through
+        case 2:
+            h ^= (uint64_t) (bp[1]) << 8;  // fall through
+        case 1:
+            h ^= (uint64_t) (bp[0]);
+            h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+
+    return h;
+}
+
+#define H5VL_LOGI_ARENA_BLOCK    1048576  // Size of an arena block
+#define H5VL_LOGI_WREQ_HASH_INIT 1024     // Initial number of slots
+
+// Bump allocator for copies of selections, memory is only released on reset or destruction
+class H5VL_logi_arena {
+   public:
+    H5VL_logi_arena ();
+    ~H5VL_logi_arena ();
+
+    char *alloc (size_t size);
+    void reset ();                          // Reuse the blocks, free the large allocations
+    size_t size () const { return nbyte; }  // Bytes allocated since the last reset
+
+   private:
+    std::vector<char *> blocks;  // Arena blocks of H5VL_LOGI_ARENA_BLOCK bytes
+    std::vector<char *> large;   // Allocations larger than an arena block
+    size_t bidx;                 // Current arena block
+    size_t boff;                 // Next free byte in the current arena block
+    size_t nbyte;                // Bytes allocated since the last reset
+};
+
+/* Table of the selections written since the last metadata flush, for deduplication
+ * Open addressing with linear probing over (hash, request) pairs. The selection of a request is
+ * hashed once and copied into an arena when it is inserted, because the entry may be compressed
+ * in place afterwards. The arena is reused after clear.
+ */
+class H5VL_logi_wreq_hash {
+   public:
+    H5VL_logi_wreq_hash ();
+
+    // Return an earlier request with the same selection as r, or insert r and return NULL
+    H5VL_log_wreq_t *find_or_insert (H5VL_log_wreq_t *r);
+    void clear ();
+    size_t size () const { return nent; }
+
+   private:
+    typedef struct entry_t {
+        uint64_t hash;         // Hash of the selection
+        H5VL_log_wreq_t *req;  // Request, NULL if the slot is empty
+        char *sel;             // Copy of the selection in the arena
+        int32_t meta_size;     // Size of the metadata entry of the request
+        int32_t sel_size;      // Size of the selection
+    } entry_t;
+
+    std::vector<entry_t> table;  // Slots, the number of slots is a power of 2
+    size_t nent;                 // Number of requests in the table
+    H5VL_logi_arena arena;       // Copies of the selections
+
+    void grow ();  // Double the number of slots
+};
+
+#define H5VL_LOGI_SEL_DICT_PENDING  0x4000000000000000LL  // ID not assigned until the next flush
+#define H5VL_LOGI_SEL_DICT_MAX_SIZE 67108864              // Bytes of selections remembered
+
+/* Selections written to the file, for deduplication across metadata flushes and datasets
+ * A selection is remembered the first time it is seen. When it is seen again, it becomes a
+ * dictionary record and the entry refers to the record by ID. New records get a pending ID
+ * (H5VL_LOGI_SEL_DICT_PENDING | n for the n-th new record) that is replaced with the global ID once
+ * the records are written to the file on the next metadata flush. Selections stop being
+ * remembered after H5VL_LOGI_SEL_DICT_MAX_SIZE bytes; existing records are still matched.
+ */
+class H5VL_logi_sel_dict {
+   public:
+    H5VL_logi_sel_dict ();
+
+    // Return the ID of the record holding the selection, or -1 if there is none
+    MPI_Offset lookup (int32_t flag, char *sel, int32_t sel_size);
+    // Get the record of an ID returned by lookup, return false if it is unknown
+    bool get (MPI_Offset id, int32_t *flag, char **sel, int32_t *sel_size);
+
+    // New records, each is [flag (INT32), size (INT32), selection (size bytes)]
+    size_t npending () const { return pending.size (); }
+    size_t pending_size () const { return psize; }
+    void pack_pending (char *buf);
+    // Assign IDs base, base + 1, ... to the new records in order
+    void commit (MPI_Offset base);
+
+   private:
+    typedef struct rec_t {
+        uint64_t hash;     // Hash of the flag and the selection
+        char *sel;         // Copy of the selection in the arena
+        int32_t flag;      // Selection flags (H5VL_LOGI_META_FLAG_SEL_MASK)
+        int32_t sel_size;  // Size of the selection
+        MPI_Offset id;     // Record ID, -1 if seen only once
+    } rec_t;
+
+    std::vector<rec_t> recs;                     // Remembered selections
+    std::vector<int64_t> table;                  // Index in recs, -1 if the slot is empty
+    std::vector<size_t> pending;                 // Index in recs of the new records
+    size_t psize;                                // Size of the new records when packed
+    std::unordered_map<MPI_Offset, size_t> ids;  // Index in recs of committed records
+    H5VL_logi_arena arena;                       // Copies of the selections
+
+    void grow ();  // Double the number of slots
+};
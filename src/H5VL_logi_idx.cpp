@@ -8,10 +8,19 @@
 #include <config.h>
 #endif
 //
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <system_error>
+#include <thread>
+#include <vector>
+//
 #include <mpi.h>
 //
 #include "H5VL_log_dataset.hpp"
+#include "H5VL_log_file.hpp"
 #include "H5VL_logi_idx.hpp"
+#include "H5VL_logi_util.hpp"
 //
 // Order of the first element
 bool H5VL_log_idx_search_ret_t::operator< (const H5VL_log_idx_search_ret_t &rhs) const {
@@ -55,3 +64,212 @@ bool H5VL_log_idx_search_ret_t::operator> (const H5VL_log_idx_search_ret_t &rhs)
 }
 
 H5VL_logi_idx_t::H5VL_logi_idx_t (H5VL_log_file_t *fp) : fp (fp) {}
+
+void H5VL_logi_idx_parallel (int nthread, const std::function<void (int)> &fn) {
+    int i;
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errs (nthread);
+    auto run = [&fn, &errs] (int i) -> void {
+        try {
+            fn (i);
+        } catch (...) { errs[i] = std::current_exception (); }
+    };
+
+    for (i = 1; i < nthread; i++) {
+        try {
+            threads.emplace_back (run, i);
+        } catch (std::system_error &) {
+            run (i);  // Out of threads, run it here
+        }
+    }
+    run (0);
+    for (auto &t : threads) { t.join (); }
+
+    for (auto &e : errs) {
+        if (e) { std::rethrow_exception (e); }
+    }
+}
+
+void H5VL_logi_idx_t::scan_block (char *block, size_t size, std::vector<char *> &ents) {
+    char *bufp = block;  // Buffer for raw metadata
+
+    while (bufp < block + size) {
+        H5VL_logi_meta_hdr *hdr_tmp = (H5VL_logi_meta_hdr *)bufp;
+
+        // Skip the entry if dataset is unlinked
+        if (fp->dsets_info[hdr_tmp->did]) {
+#ifdef WORDS_BIGENDIAN
+            H5VL_logi_lreverse ((uint32_t *)bufp, (uint32_t *)(bufp + sizeof (H5VL_logi_meta_hdr)));
+#endif
+            ents.push_back (bufp);
+        }
+        bufp += hdr_tmp->meta_size;
+    }
+}
+
+int H5VL_logi_idx_t::parse_nthread (size_t n) {
+    size_t nthread = n / H5VL_LOGI_IDX_PARSE_MIN;
+
+    if (nthread > (size_t)(fp->idx_nthread)) { nthread = fp->idx_nthread; }
+
+    return nthread > 1 ? (int)nthread : 1;
+}
+
+char *H5VL_logi_idx_t::ref_target (char *ent, hssize_t *rec) {
+    H5VL_logi_meta_hdr *hdr = (H5VL_logi_meta_hdr *)ent;
+    MPI_Offset *bp          = (MPI_Offset *)(hdr + 1);
+    MPI_Offset roff;  // Related offset of the referenced entry
+
+    // The entry is not modified, it may be read by other threads
+    *rec = -1;
+    if (hdr->flag & H5VL_LOGI_META_FLAG_REC) {
+        *rec = bp[0];
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_llreverse ((uint64_t *)rec);
+#endif
+        bp++;
+    }
+    roff = bp[0];
+#ifdef WORDS_BIGENDIAN
+    H5VL_logi_llreverse ((uint64_t *)(&roff));
+#endif
+
+    return ent + roff;
+}
+
+/*
+ * Remove the part covered by b from the memory block of a, append the remaining pieces to out
+ * The pieces are peeled off a one dimension at a time, so there are at most 2 * ndim of them
+ */
+static void H5VL_logi_idx_subtract (int ndim,
+                                    const H5VL_log_idx_search_ret_t &a,
+                                    const H5VL_log_idx_search_ret_t &b,
+                                    std::vector<H5VL_log_idx_search_ret_t> &out) {
+    int i;
+    int lo, hi;  // Range of b along the current dimension
+    H5VL_log_idx_search_ret_t cur = a, piece;
+
+    // No overlap, a is kept as is
+    for (i = 0; i < ndim; i++) {
+        if ((a.mstart[i] >= b.mstart[i] + b.count[i]) ||
+            (b.mstart[i] >= a.mstart[i] + a.count[i])) {
+            out.push_back (a);
+            return;
+        }
+    }
+
+    for (i = 0; i < ndim; i++) {
+        lo = b.mstart[i];
+        hi = b.mstart[i] + b.count[i];
+        if (cur.mstart[i] < lo) {
+            piece          = cur;
+            piece.count[i] = lo - cur.mstart[i];
+            out.push_back (piece);
+
+            cur.dstart[i] += lo - cur.mstart[i];
+            cur.count[i] -= lo - cur.mstart[i];
+            cur.mstart[i] = lo;
+        }
+        if (cur.mstart[i] + cur.count[i] > hi) {
+            piece = cur;
+            piece.dstart[i] += hi - cur.mstart[i];
+            piece.count[i]  = cur.mstart[i] + cur.count[i] - hi;
+            piece.mstart[i] = hi;
+            out.push_back (piece);
+
+            cur.count[i] = hi - cur.mstart[i];
+        }
+    }
+    // What is left in cur lies inside b
+}
+
+/*
+ * Last-writer-wins shadow elimination
+ * ret[begin:] must hold the search result of a single request in log order, as returned by the
+ * index. For each selected block in the request, results are visited from the newest to the oldest
+ * and only the parts not yet covered by a newer entry are kept. The visit stops once the block is
+ * fully covered, so superseded log entries are never read.
+ */
+void H5VL_logi_idx_shadow_elim (std::vector<H5VL_log_idx_search_ret_t> &ret, size_t begin) {
+    size_t g, e, k;
+    int i;
+    int ndim;
+    hsize_t total, covered;  // Number of elements in the block and covered so far
+    hsize_t vol;
+    std::vector<H5VL_log_idx_search_ret_t> res;    // Results after elimination
+    std::vector<H5VL_log_idx_search_ret_t> cover;  // Disjoint pieces kept so far in the block
+    std::vector<H5VL_log_idx_search_ret_t> frags, tmp;
+
+    if (ret.size () - begin < 2) { return; }
+
+    // Group the results by selected block, each block has its own destination buffer
+    std::stable_sort (ret.begin () + begin, ret.end (),
+                      [] (const H5VL_log_idx_search_ret_t &l,
+                          const H5VL_log_idx_search_ret_t &r) -> bool { return l.xbuf < r.xbuf; });
+
+    for (g = begin; g < ret.size (); g = e) {
+        for (e = g + 1; (e < ret.size ()) && (ret[e].xbuf == ret[g].xbuf); e++);
+
+        ndim  = (int)(ret[g].info->ndim);
+        total = 1;
+        for (i = 0; i < ndim; i++) { total *= (hsize_t)(ret[g].msize[i]); }
+
+        cover.clear ();
+        covered = 0;
+        for (k = e; (k > g) && (covered < total); k--) {
+            frags.clear ();
+            frags.push_back (ret[k - 1]);
+            for (auto &c : cover) {
+                tmp.clear ();
+                for (auto &f : frags) { H5VL_logi_idx_subtract (ndim, f, c, tmp); }
+                std::swap (frags, tmp);
+                if (frags.empty ()) break;
+            }
+
+            for (auto &f : frags) {
+                vol = 1;
+                for (i = 0; i < ndim; i++) { vol *= (hsize_t)(f.count[i]); }
+                covered += vol;
+                res.push_back (f);
+                cover.push_back (f);
+            }
+        }
+    }
+
+    ret.resize (begin);
+    ret.insert (ret.end (), res.begin (), res.end ());
+}
+
+/*
+ * Remove the parts of ret covered by the results in newer that go to the same selected block
+ */
+void H5VL_logi_idx_shadow_cut (std::vector<H5VL_log_idx_search_ret_t> &ret,
+                               std::vector<H5VL_log_idx_search_ret_t> &newer) {
+    std::map<char *, std::vector<H5VL_log_idx_search_ret_t *>> cover;  // Newer results by block
+    std::vector<H5VL_log_idx_search_ret_t> res;  // Results after elimination
+    std::vector<H5VL_log_idx_search_ret_t> frags, tmp;
+
+    if (newer.empty ()) { return; }
+
+    for (auto &c : newer) { cover[c.xbuf].push_back (&c); }
+
+    for (auto &r : ret) {
+        auto it = cover.find (r.xbuf);
+        if (it == cover.end ()) {
+            res.push_back (r);
+            continue;
+        }
+
+        frags.clear ();
+        frags.push_back (r);
+        for (auto c : it->second) {
+            tmp.clear ();
+            for (auto &f : frags) { H5VL_logi_idx_subtract ((int)(r.info->ndim), f, *c, tmp); }
+            std::swap (frags, tmp);
+            if (frags.empty ()) break;
+        }
+        res.insert (res.end (), frags.begin (), frags.end ());
+    }
+
+    ret.swap (res);
+}
@@ -9,6 +9,10 @@
 #include <hdf5.h>
 #include <mpi.h>
 
+#include <functional>
+#include <map>
+#include <vector>
+
 #include "H5VL_logi_nb.hpp"
 
 enum H5VL_log_idx_type_t { list = 0, compact = 1 };
@@ -33,6 +37,15 @@ typedef struct H5VL_log_idx_search_ret_t {
     bool operator> (const H5VL_log_idx_search_ret_t &rhs) const;
 } H5VL_log_idx_search_ret_t;
 
+// Drop the parts of ret[begin:] shadowed by newer log entries
+void H5VL_logi_idx_shadow_elim (std::vector<H5VL_log_idx_search_ret_t> &ret, size_t begin);
+// Drop the parts of ret shadowed by the results in newer
+void H5VL_logi_idx_shadow_cut (std::vector<H5VL_log_idx_search_ret_t> &ret,
+                               std::vector<H5VL_log_idx_search_ret_t> &newer);
+
+// Run fn (0) to fn (nthread - 1) on nthread threads, rethrow the first exception after all return
+void H5VL_logi_idx_parallel (int nthread, const std::function<void (int)> &fn);
+
 typedef struct H5VL_log_metaentry_t {
     int did;                      // Dataset ID
     hsize_t start[H5S_MAX_RANK];  // Start of the selected block
@@ -41,10 +54,19 @@ typedef struct H5VL_log_metaentry_t {
     size_t fsize;                 // Size of data in file
 } H5VL_log_metaentry_t;
 
+#define H5VL_LOGI_IDX_PARSE_MIN 1024  // Minimal number of entries parsed by a thread
+
 class H5VL_logi_idx_t {
    protected:
     H5VL_log_file_t *fp;
 
+    // Byte-swap the headers and collect the entries of linked datasets in a block
+    void scan_block (char *block, size_t size, std::vector<char *> &ents);
+    // Number of threads to parse n entries
+    int parse_nthread (size_t n);
+    // Entry whose selection a SEL_REF entry refers to, set rec to its record number (-1 if none)
+    static char *ref_target (char *ent, hssize_t *rec);
+
    public:
     H5VL_logi_idx_t (H5VL_log_file_t *fp);
     virtual ~H5VL_logi_idx_t ()                       = default;
@@ -56,11 +78,14 @@ class H5VL_logi_idx_t {
         size_t size) = 0;  // Parse a block of encoded metadata and insert all entries
     virtual void search (H5VL_log_rreq_t *req,
                          std::vector<H5VL_log_idx_search_ret_t> &ret) = 0;  // Search for matchings
+    virtual size_t memsize () = 0;  // Memory used by the index in bytes
 };
 
 class H5VL_logi_array_idx_t : public H5VL_logi_idx_t {
     std::vector<std::vector<H5VL_logi_metaentry_t>> idxs;
 
+    void parse_block_parallel (char *block, size_t size);  // parse_block on fp->idx_nthread threads
+
    public:
     H5VL_logi_array_idx_t (H5VL_log_file_t *fp);
     H5VL_logi_array_idx_t (H5VL_log_file_t *fp, size_t size);
@@ -72,33 +97,66 @@ class H5VL_logi_array_idx_t : public H5VL_logi_idx_t {
                       size_t size);  // Parse a block of encoded metadata and insert all entries
     void search (H5VL_log_rreq_t *req,
                  std::vector<H5VL_log_idx_search_ret_t> &ret);  // Search for matchings
+    size_t memsize ();                                          // Memory used by the index
 };
 
+#define H5VL_LOGI_COMPACT_IDX_SEL_HDR   2                      // Words before the coordinates
+#define H5VL_LOGI_COMPACT_IDX_SEL_POINT 0x8000000000000000ULL  // Selection is a point list
+
 class H5VL_logi_compact_idx_t : public H5VL_logi_idx_t {
-    class H5VL_logi_compact_idx_entry_t {
-       public:
-        hssize_t rec = -1;  // record number, -1 for non-record
-        void
-            *blocks;  // Start and count pairs of the selected blocks, or reference to other entries
-        int nsel;     // # selections, -1 for ref entry
-        MPI_Offset foff;  // Offset of data in file
-        size_t fsize;     // Size of data in file
-        size_t dsize;
-
-        // H5VL_logi_compact_idx_entry_t (MPI_Offset foff, size_t fsize, int ndim, int nsel);
-        H5VL_logi_compact_idx_entry_t (MPI_Offset foff,
-                                       size_t fsize,
-                                       H5VL_logi_compact_idx_entry_t *ref);
-        H5VL_logi_compact_idx_entry_t (int ndim, H5VL_logi_metaentry_t &meta);
-        ~H5VL_logi_compact_idx_entry_t ();
-    };
-
-    std::vector<std::vector<H5VL_logi_compact_idx_entry_t *>> idxs;
+    // Entries of a dataset, one array per field
+    typedef struct H5VL_logi_compact_idx_dset_t {
+        std::vector<MPI_Offset> foff;  // Offset of data in file
+        std::vector<size_t> fsize;     // Size of data in file
+        std::vector<hssize_t> rec;     // Record number, -1 for non-record
+        std::vector<size_t> boff;      // Offset of the selection in blocks
+        // Record number and index of the record entries, sorted, for lookup along the record
+        // dimension
+        std::vector<std::pair<hssize_t, size_t>> recs;
+        std::vector<size_t> nonrecs;  // Non-record entries
+    } H5VL_logi_compact_idx_dset_t;
+
+    std::vector<H5VL_logi_compact_idx_dset_t> idxs;
+    // Selections of all entries, entries referring to another entry share its selection
+    // A selection is a header followed by the starts and the counts of the selected blocks
+    // (dimension-major), or by dsteps, linearized offsets of the row segments and prefix sums of
+    // their lengths for a point list (stored as MPI_Offset)
+    std::vector<hsize_t> blocks;
+
+    // Copy the selection of a decoded entry into buf, return its offset
+    size_t add_sel (std::vector<hsize_t> &buf,
+                    H5VL_log_dset_info_t &dset,
+                    H5VL_logi_metaentry_t &meta,
+                    hssize_t *rec);
+    // Copy the selection of a point list entry into buf, return its offset
+    size_t add_points (std::vector<hsize_t> &buf,
+                       H5VL_log_dset_info_t &dset,
+                       char *ent,
+                       hssize_t *rec);
+    // Append an entry of dataset did
+    void add (int did, MPI_Offset foff, size_t fsize, hssize_t rec, size_t boff);
+    // Sort the record entries of dataset did after the first nsorted ones and merge them
+    void sort_recs (int did, size_t nsorted);
+    // parse_block on fp->idx_nthread threads, nsorted is the number of sorted record entries of
+    // each dataset
+    void parse_block_parallel (char *block, size_t size, std::vector<size_t> &nsorted);
+    void search_entry (H5VL_log_rreq_t *req,
+                       int i,
+                       H5VL_logi_compact_idx_dset_t &idx,
+                       size_t e,
+                       size_t soff,
+                       std::vector<H5VL_log_idx_search_ret_t> &ret);  // Search an entry
+    void search_points (H5VL_log_rreq_t *req,
+                        int i,
+                        H5VL_logi_compact_idx_dset_t &idx,
+                        size_t e,
+                        size_t soff,
+                        std::vector<H5VL_log_idx_search_ret_t> &ret);  // Search a point list entry
 
    public:
     H5VL_logi_compact_idx_t (H5VL_log_file_t *fp);
     H5VL_logi_compact_idx_t (H5VL_log_file_t *fp, size_t size);
-    ~H5VL_logi_compact_idx_t ();
+    ~H5VL_logi_compact_idx_t () = default;
     void clear ();                              // Remove all entries
     void reserve (size_t size);                 // Make space for at least size datasets
     void insert (H5VL_logi_metaentry_t &meta);  // Add an entry
@@ -106,4 +164,5 @@ class H5VL_logi_compact_idx_t : public H5VL_logi_idx_t {
                       size_t size);  // Parse a block of encoded metadata and insert all entries
     void search (H5VL_log_rreq_t *req,
                  std::vector<H5VL_log_idx_search_ret_t> &ret);  // Search for matchings
+    size_t memsize ();                                          // Memory used by the index
 };
@@ -11,100 +11,194 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <map>
 #include <vector>
 
 #include "H5VL_log_file.hpp"
 #include "H5VL_log_filei.hpp"
 #include "H5VL_logi.hpp"
 #include "H5VL_logi_idx.hpp"
+#include "H5VL_logi_isect.hpp"
 #include "H5VL_logi_nb.hpp"
 
 /*
-H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_entry_t::H5VL_logi_compact_idx_entry_t (
-        MPI_Offset foff, size_t fsize, int ndim, int nsel)
-        : foff (foff), fsize (fsize), nsel (nsel), dsize (0) {
-        herr_t err	 = 0;
-        this->blocks = malloc (sizeof (hsize_t) * nsel * ndim * 2);
-        CHECK_PTR (this->blocks);
-err_out:;
-        if (err) { throw "OOM"; }
+ * Entries are kept per dataset in one array per field, the selections of all entries are kept in
+ * one array (blocks). Each selection starts with a header of H5VL_LOGI_COMPACT_IDX_SEL_HDR words:
+ *   size of the selected data, number of selected blocks or row segments
+ * The starts of the blocks follow, then their counts, both dimension-major so a search can test
+ * many blocks at once.
+ * The number of row segments of a point list is flagged with H5VL_LOGI_COMPACT_IDX_SEL_POINT.
+ * Record entries are also listed in recs as (record number, entry) pairs sorted by record.
+ * Search streams through the arrays and clear only resets their size.
+ */
+
+H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_t (H5VL_log_file_t *fp) : H5VL_logi_idx_t (fp) {}
+
+H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_t (H5VL_log_file_t *fp, size_t size)
+    : H5VL_logi_idx_t (fp) {
+    this->reserve (size);
+}
+
+void H5VL_logi_compact_idx_t::clear () {
+    for (auto &idx : this->idxs) {
+        idx.foff.clear ();
+        idx.fsize.clear ();
+        idx.rec.clear ();
+        idx.boff.clear ();
+        idx.recs.clear ();
+        idx.nonrecs.clear ();
+    }
+    this->blocks.clear ();
 }
-*/
 
-H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_entry_t::H5VL_logi_compact_idx_entry_t (
-    MPI_Offset foff, size_t fsize, H5VL_logi_compact_idx_entry_t *ref)
-    : blocks (ref), nsel (-1), foff (foff), fsize (fsize), dsize (0) {}
+void H5VL_logi_compact_idx_t::reserve (size_t size) {
+    if (this->idxs.size () < size) { this->idxs.resize (size); }
+}
 
-H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_entry_t::H5VL_logi_compact_idx_entry_t (
-    int ndim, H5VL_logi_metaentry_t &meta)
-    : nsel (meta.sels.size ()), foff (meta.hdr.foff), fsize (meta.hdr.fsize), dsize (meta.dsize) {
-    int encndim;
+size_t H5VL_logi_compact_idx_t::add_sel (std::vector<hsize_t> &buf,
+                                         H5VL_log_dset_info_t &dset,
+                                         H5VL_logi_metaentry_t &meta,
+                                         hssize_t *rec) {
+    int i, k;
+    int nsel;
+    int dimoff;   // 1 for record entries, the first dimension is not encoded
+    int encndim;  // Number of encoded dimensions
+    size_t boff;
     hsize_t *start, *count;
-    hsize_t *start_src, *count_src;
 
     if (meta.hdr.flag & H5VL_LOGI_META_FLAG_REC) {
-        encndim = ndim - 1;
-        rec     = meta.sels[0].start[0];
+        dimoff = 1;
+        *rec   = (hssize_t)(meta.sels[0].start[0]);
     } else {
-        encndim = ndim;
-        rec     = -1;
+        dimoff = 0;
+        *rec   = -1;
     }
-    blocks = malloc (sizeof (hsize_t) * nsel * encndim * 2);
-
-    start = (hsize_t *)(blocks);
-    count = start + encndim;
-    for (auto &sel : meta.sels) {
-        start_src = sel.start;
-        count_src = sel.count;
-        if (meta.hdr.flag & H5VL_LOGI_META_FLAG_REC) {
-            start_src += 1;
-            count_src += 1;
+    encndim = dset.ndim - dimoff;
+    nsel    = (int)(meta.sels.size ());
+    boff    = buf.size ();
+    buf.resize (boff + H5VL_LOGI_COMPACT_IDX_SEL_HDR + nsel * encndim * 2);
+    buf[boff]     = meta.dsize;
+    buf[boff + 1] = nsel;
+
+    // Dimension-major, coordinate i of all blocks are contiguous
+    start = buf.data () + boff + H5VL_LOGI_COMPACT_IDX_SEL_HDR;
+    count = start + nsel * encndim;
+    for (k = 0; k < nsel; k++) {
+        for (i = 0; i < encndim; i++) {
+            start[i * nsel + k] = meta.sels[k].start[i + dimoff];
+            count[i * nsel + k] = meta.sels[k].count[i + dimoff];
         }
-        memcpy (start, start_src, sizeof (hsize_t) * encndim);
-        memcpy (count, count_src, sizeof (hsize_t) * encndim);
-        start = count + encndim;
-        count = start + encndim;
     }
-}
 
-H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_entry_t::~H5VL_logi_compact_idx_entry_t () {
-    if (nsel >= 0) { free (this->blocks); }
+    return boff;
 }
 
-H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_t (H5VL_log_file_t *fp) : H5VL_logi_idx_t (fp) {}
+size_t H5VL_logi_compact_idx_t::add_points (std::vector<hsize_t> &buf,
+                                            H5VL_log_dset_info_t &dset,
+                                            char *ent,
+                                            hssize_t *rec) {
+    int i;
+    int nsel;
+    int encndim;
+    size_t boff;
+    hsize_t recnum;
+    H5VL_logi_meta_hdr hdr;
+    MPI_Offset dsteps[H5S_MAX_RANK];
+    MPI_Offset *offs, *pre;
+    std::vector<MPI_Offset> offv, lenv;
+
+    H5VL_logi_metaentry_point_decode (dset, ent, hdr, &recnum, dsteps, offv, lenv);
+
+    if (hdr.flag & H5VL_LOGI_META_FLAG_REC) {
+        encndim = dset.ndim - 1;
+        *rec    = (hssize_t)recnum;
+    } else {
+        encndim = dset.ndim;
+        *rec    = -1;
+    }
+    boff = buf.size ();
+    nsel = (int)offv.size ();
+
+    // Dsteps, followed by the segment offsets and the prefix sums of the segment lengths
+    buf.resize (boff + H5VL_LOGI_COMPACT_IDX_SEL_HDR + encndim + nsel * 2 + 1);
+    offs = (MPI_Offset *)(buf.data () + boff + H5VL_LOGI_COMPACT_IDX_SEL_HDR);
+    memcpy (offs, dsteps, sizeof (MPI_Offset) * encndim);
+    offs += encndim;
+    pre    = offs + nsel;
+    pre[0] = 0;
+    for (i = 0; i < nsel; i++) {
+        offs[i]    = offv[i];
+        pre[i + 1] = pre[i] + lenv[i];
+    }
+    buf[boff]     = pre[nsel] * dset.esize;
+    buf[boff + 1] = (hsize_t)nsel | H5VL_LOGI_COMPACT_IDX_SEL_POINT;
 
-H5VL_logi_compact_idx_t::H5VL_logi_compact_idx_t (H5VL_log_file_t *fp, size_t size)
-    : H5VL_logi_idx_t (fp) {
-    this->reserve (size);
+    return boff;
 }
 
-H5VL_logi_compact_idx_t::~H5VL_logi_compact_idx_t () {
-    for (auto &idx : idxs) {
-        for (auto ent : idx) { delete ent; }
+void H5VL_logi_compact_idx_t::add (int did,
+                                   MPI_Offset foff,
+                                   size_t fsize,
+                                   hssize_t rec,
+                                   size_t boff) {
+    H5VL_logi_compact_idx_dset_t &idx = this->idxs[did];
+
+    if (rec >= 0) {
+        // Order is restored by sort_recs once all entries of the block are added
+        idx.recs.push_back (std::pair<hssize_t, size_t> (rec, idx.foff.size ()));
+    } else {
+        idx.nonrecs.push_back (idx.foff.size ());
     }
+    idx.foff.push_back (foff);
+    idx.fsize.push_back (fsize);
+    idx.rec.push_back (rec);
+    idx.boff.push_back (boff);
 }
 
-void H5VL_logi_compact_idx_t::clear () {
-    for (auto &i : this->idxs) { i.clear (); }
-}
+/*
+ * Every section of the metadata restarts the record numbers, so record entries are appended out of
+ * order. The entries added after the first nsorted ones are sorted and merged with them. Pairs
+ * are unique as the entry index is, ties in the record number stay in the order of the entries.
+ */
+void H5VL_logi_compact_idx_t::sort_recs (int did, size_t nsorted) {
+    std::vector<std::pair<hssize_t, size_t>> &recs = this->idxs[did].recs;
 
-void H5VL_logi_compact_idx_t::reserve (size_t size) {
-    if (this->idxs.size () < size) { this->idxs.resize (size); }
+    if (recs.size () <= nsorted) { return; }
+    if (!std::is_sorted (recs.begin () + nsorted, recs.end ())) {
+        std::sort (recs.begin () + nsorted, recs.end ());
+    }
+    if (nsorted && (recs[nsorted] < recs[nsorted - 1])) {
+        std::inplace_merge (recs.begin (), recs.begin () + nsorted, recs.end ());
+    }
 }
 
 void H5VL_logi_compact_idx_t::insert (H5VL_logi_metaentry_t &meta) {
-    H5VL_logi_compact_idx_entry_t *entry;
-
-    entry = new H5VL_logi_compact_idx_entry_t (fp->dsets_info[meta.hdr.did]->ndim, meta);
-
-    this->idxs[meta.hdr.did].push_back (entry);
+    size_t boff;
+    size_t nsorted;
+    hssize_t rec;
+
+    nsorted = this->idxs[meta.hdr.did].recs.size ();
+    boff    = this->add_sel (this->blocks, *(fp->dsets_info[meta.hdr.did]), meta, &rec);
+    this->add (meta.hdr.did, meta.hdr.foff, meta.hdr.fsize, rec, boff);
+    this->sort_recs (meta.hdr.did, nsorted);
 }
 
 void H5VL_logi_compact_idx_t::parse_block (char *block, size_t size) {
-    char *bufp = block;                                        // Buffer for raw metadata
-    H5VL_logi_compact_idx_entry_t *centry;                     // Buffer of decoded metadata entry
-    H5VL_logi_metaentry_t entry;                               // Buffer of decoded metadata entry
-    std::map<char *, H5VL_logi_compact_idx_entry_t *> bcache;  // Cache for linked metadata entry
+    char *bufp = block;               // Buffer for raw metadata
+    hssize_t rec;                     // Record number of the entry
+    size_t boff;                      // Selection of the entry in blocks
+    H5VL_logi_metaentry_t entry;      // Buffer of decoded metadata entry
+    std::map<char *, size_t> bcache;  // Cache for linked metadata entry
+    std::vector<size_t> nsorted;      // Number of record entries of each dataset before the block
+    size_t i;
+
+    nsorted.resize (this->idxs.size ());
+    for (i = 0; i < this->idxs.size (); i++) { nsorted[i] = this->idxs[i].recs.size (); }
+
+    if (fp->idx_nthread > 1) {
+        this->parse_block_parallel (block, size, nsorted);
+        return;
+    }
 
     if (fp->config & H5VL_FILEI_CONFIG_METADATA_SHARE) {  // Need to maintina cache if file contains
                                                           // referenced metadata entries
@@ -119,8 +213,8 @@ void H5VL_logi_compact_idx_t::parse_block (char *block, size_t size) {
 #endif
                 // Have to parse all entries for reference purpose
                 if (hdr_tmp->flag & H5VL_LOGI_META_FLAG_SEL_REF) {
-                    MPI_Offset rec, roff;
-                    rec = -1; // rec must be initialized to -1, meaning non-record
+                    MPI_Offset roff;
+                    rec = -1;  // rec must be initialized to -1, meaning non-record
 
                     // Check if it is a record entry
                     if (hdr_tmp->flag & H5VL_LOGI_META_FLAG_REC) {
@@ -135,20 +229,24 @@ void H5VL_logi_compact_idx_t::parse_block (char *block, size_t size) {
 #ifdef WORDS_BIGENDIAN
                     H5VL_logi_llreverse ((uint64_t *)(&roff));
 #endif
-                    centry      = new H5VL_logi_compact_idx_entry_t (hdr_tmp->foff, hdr_tmp->fsize,
-                                                                bcache[bufp + roff]);
-                    centry->rec = (hssize_t)rec;
+                    // Share the selection of the referenced entry
+                    boff = bcache[bufp + roff];
+                } else if (hdr_tmp->flag & H5VL_LOGI_META_FLAG_SEL_POINT) {
+                    boff = this->add_points (this->blocks, *(fp->dsets_info[hdr_tmp->did]), bufp,
+                                            &rec);
+
+                    // Insert to cache
+                    bcache[bufp] = boff;
                 } else {
                     H5VL_logi_metaentry_decode (*(fp->dsets_info[hdr_tmp->did]), bufp, entry);
-
-                    centry = new H5VL_logi_compact_idx_entry_t (fp->dsets_info[hdr_tmp->did]->ndim,
-                                                                entry);
+                    boff = this->add_sel (this->blocks, *(fp->dsets_info[hdr_tmp->did]), entry,
+                                          &rec);
 
                     // Insert to cache
-                    bcache[bufp] = centry;
+                    bcache[bufp] = boff;
                 }
                 // Insert to the index
-                this->idxs[hdr_tmp->did].push_back (centry);
+                this->add (hdr_tmp->did, hdr_tmp->foff, hdr_tmp->fsize, rec, boff);
             }
             bufp += hdr_tmp->meta_size;
         }
@@ -163,130 +261,350 @@ void H5VL_logi_compact_idx_t::parse_block (char *block, size_t size) {
                                     (uint32_t *)(bufp + sizeof (H5VL_logi_meta_hdr)));
 #endif
 
-                H5VL_logi_metaentry_decode (*(fp->dsets_info[hdr_tmp->did]), bufp, entry);
-
-                centry =
-                    new H5VL_logi_compact_idx_entry_t (fp->dsets_info[hdr_tmp->did]->ndim, entry);
+                if (hdr_tmp->flag & H5VL_LOGI_META_FLAG_SEL_POINT) {
+                    boff = this->add_points (this->blocks, *(fp->dsets_info[hdr_tmp->did]), bufp,
+                                            &rec);
+                } else {
+                    H5VL_logi_metaentry_decode (*(fp->dsets_info[hdr_tmp->did]), bufp, entry);
+                    boff = this->add_sel (this->blocks, *(fp->dsets_info[hdr_tmp->did]), entry,
+                                          &rec);
+                }
 
                 // Insert to the index
-                this->idxs[hdr_tmp->did].push_back (centry);
+                this->add (hdr_tmp->did, hdr_tmp->foff, hdr_tmp->fsize, rec, boff);
             }
             bufp += hdr_tmp->meta_size;
         }
     }
+
+    for (i = 0; i < this->idxs.size (); i++) { this->sort_recs ((int)i, nsorted[i]); }
 }
 
-static bool intersect (
-    int ndim, hsize_t *sa, hsize_t *ca, hsize_t *sb, hsize_t *cb, hsize_t *so, hsize_t *co) {
-    int i;
+/*
+ * The entries are located first, then decoded by the threads in contiguous chunks, each into its
+ * own selection buffer. An entry referring to the selection of another chunk is resolved after all
+ * chunks are decoded. The buffers are appended to blocks and every thread adds the entries of its
+ * datasets in the order of the block, so the index is the same as the one built sequentially.
+ */
+void H5VL_logi_compact_idx_t::parse_block_parallel (char *block,
+                                                    size_t size,
+                                                    std::vector<size_t> &nsorted) {
+    int t;
+    int nt;                                  // Number of threads
+    size_t n;                                // Number of entries
+    std::vector<char *> ents;                // Entries of linked datasets
+    std::vector<hssize_t> recs;              // Record number of each entry
+    std::vector<size_t> boffs;               // Selection of each entry in the buffer of its chunk
+    std::vector<size_t> lo;                  // First entry of each chunk
+    std::vector<size_t> bases;               // Offset of the buffer of each chunk in blocks
+    std::vector<std::vector<hsize_t>> bufs;  // Selections decoded by each chunk
+    const size_t pending = (size_t)-1;       // Selection in another chunk
+    bool share           = fp->config & H5VL_FILEI_CONFIG_METADATA_SHARE;
+
+    this->scan_block (block, size, ents);
+    n  = ents.size ();
+    nt = this->parse_nthread (n);
+    recs.resize (n);
+    boffs.resize (n);
+    bufs.resize (nt);
+    lo.resize (nt + 1);
+    for (t = 0; t <= nt; t++) { lo[t] = n * t / nt; }
+
+    H5VL_logi_idx_parallel (nt, [&] (int t) -> void {
+        size_t e;
+        H5VL_logi_metaentry_t entry;      // Buffer of decoded metadata entry
+        std::map<char *, size_t> bcache;  // Cache for linked metadata entry
+
+        for (e = lo[t]; e < lo[t + 1]; e++) {
+            H5VL_logi_meta_hdr *hdr_tmp = (H5VL_logi_meta_hdr *)(ents[e]);
+            H5VL_log_dset_info_t &dset  = *(fp->dsets_info[hdr_tmp->did]);
+
+            if (share && (hdr_tmp->flag & H5VL_LOGI_META_FLAG_SEL_REF)) {
+                auto it  = bcache.find (ref_target (ents[e], &(recs[e])));
+                boffs[e] = it == bcache.end () ? pending : it->second;
+            } else {
+                if (hdr_tmp->flag & H5VL_LOGI_META_FLAG_SEL_POINT) {
+                    boffs[e] = this->add_points (bufs[t], dset, ents[e], &(recs[e]));
+                } else {
+                    H5VL_logi_metaentry_decode (dset, ents[e], entry);
+                    boffs[e] = this->add_sel (bufs[t], dset, entry, &(recs[e]));
+                }
+                if (share) { bcache[ents[e]] = boffs[e]; }
+            }
+        }
+    });
+
+    bases.resize (nt + 1);
+    bases[0] = this->blocks.size ();
+    for (t = 0; t < nt; t++) { bases[t + 1] = bases[t] + bufs[t].size (); }
+    this->blocks.resize (bases[nt]);
+
+    H5VL_logi_idx_parallel (nt, [&] (int w) -> void {
+        int t;
+        size_t e, j;
+        size_t boff;  // Selection of the entry in blocks
+        hssize_t rec;
+
+        if (!bufs[w].empty ()) {
+            memcpy (this->blocks.data () + bases[w], bufs[w].data (),
+                    sizeof (hsize_t) * bufs[w].size ());
+        }
 
-    for (i = 0; i < ndim; i++) {
-        so[i] = std::max (sa[i], sb[i]);
-        co[i] = std::min (sa[i] + ca[i], sb[i] + cb[i]);
-        if (co[i] <= so[i]) return false;
-        co[i] -= so[i];
-    }
+        // Entries of the datasets assigned to the thread
+        for (t = 0; t < nt; t++) {
+            for (e = lo[t]; e < lo[t + 1]; e++) {
+                H5VL_logi_meta_hdr *hdr_tmp = (H5VL_logi_meta_hdr *)(ents[e]);
+
+                if (hdr_tmp->did % nt != w) { continue; }
+
+                if (boffs[e] == pending) {
+                    char *target = ref_target (ents[e], &rec);
+
+                    // The referenced entry comes earlier in the block
+                    j = std::lower_bound (ents.begin (), ents.begin () + e, target) - ents.begin ();
+                    if ((j == e) || (ents[j] != target) || (boffs[j] == pending)) {
+                        RET_ERR ("Invalid metadata entry")
+                    }
+                    boff = boffs[j] + bases[std::upper_bound (lo.begin (), lo.end (), j) -
+                                            lo.begin () - 1];
+                } else {
+                    boff = boffs[e] + bases[t];
+                }
+
+                // Insert to the index
+                this->add (hdr_tmp->did, hdr_tmp->foff, hdr_tmp->fsize, recs[e], boff);
+            }
+        }
 
-    return true;
+        for (j = w; j < this->idxs.size (); j += nt) { this->sort_recs ((int)j, nsorted[j]); }
+    });
 }
 
-void H5VL_logi_compact_idx_t::search (H5VL_log_rreq_t *req,
-                                      std::vector<H5VL_log_idx_search_ret_t> &ret) {
-    int i, j, k;
-    int nsel;
+/*
+ * Point list entries keep the row segments sorted by linearized offset. Only segments within the
+ * linearized range of the query block can intersect it, they are located by binary search.
+ */
+void H5VL_logi_compact_idx_t::search_points (H5VL_log_rreq_t *req,
+                                             int i,
+                                             H5VL_logi_compact_idx_dset_t &idx,
+                                             size_t e,
+                                             size_t soff,
+                                             std::vector<H5VL_log_idx_search_ret_t> &ret) {
+    int j, k;
+    hsize_t *hdr = this->blocks.data () + idx.boff[e];  // Selection header
+    int nsel     = (int)(hdr[1] & ~H5VL_LOGI_COMPACT_IDX_SEL_POINT);
+    int dimoff;   // 1 for record entries, the first dimension is not encoded
+    int encndim;  // Number of encoded dimensions
+    MPI_Offset lo, hi;
+    MPI_Offset *dsteps, *offs, *pre;
+    hsize_t *qstart = req->sels->starts[i];
+    hsize_t *qcount = req->sels->counts[i];
+    hsize_t qend[H5S_MAX_RANK];  // Last cell of the query block
+    hsize_t start[H5S_MAX_RANK], count[H5S_MAX_RANK];
+    hsize_t os[H5S_MAX_RANK], oc[H5S_MAX_RANK];
+    H5VL_log_idx_search_ret_t cur;
+
+    if (idx.rec[e] >= 0) {
+        dimoff = 1;
+
+        cur.dstart[0] = 0;
+        cur.dsize[0]  = 1;
+        cur.mstart[0] = idx.rec[e] - qstart[0];
+        cur.msize[0]  = qcount[0];
+        cur.count[0]  = 1;
+
+        if ((cur.mstart[0] < 0) || (cur.mstart[0] >= cur.msize[0])) { return; }
+    } else {
+        dimoff = 0;
+    }
+    encndim = req->ndim - dimoff;
+
+    dsteps = (MPI_Offset *)(hdr + H5VL_LOGI_COMPACT_IDX_SEL_HDR);
+    offs   = dsteps + encndim;
+    pre    = offs + nsel;
+
+    // Any cell in the query block lies between the linearized offsets of its two corners
+    for (j = 0; j < encndim; j++) { qend[j] = qstart[j + dimoff] + qcount[j + dimoff] - 1; }
+    H5VL_logi_sel_encode (encndim, dsteps, qstart + dimoff, &lo);
+    H5VL_logi_sel_encode (encndim, dsteps, qend, &hi);
+
+    // First segment that ends after lo
+    k = (int)(std::upper_bound (offs, offs + nsel, lo) - offs);
+    if ((k > 0) && (offs[k - 1] + (pre[k] - pre[k - 1]) > lo)) { k--; }
+
+    for (j = 0; j < encndim; j++) { count[j] = 1; }
+    for (; (k < nsel) && (offs[k] <= hi); k++) {
+        H5VL_logi_sel_decode (encndim, dsteps, offs[k], start);
+        count[encndim - 1] = pre[k + 1] - pre[k];
+
+        if (H5VL_logi_isect (encndim, start, count, qstart + dimoff, qcount + dimoff, os, oc)) {
+            for (j = 0; j < encndim; j++) {
+                cur.dstart[j + dimoff] = os[j] - start[j];
+                cur.dsize[j + dimoff]  = count[j];
+                cur.mstart[j + dimoff] = os[j] - qstart[j + dimoff];
+                cur.msize[j + dimoff]  = qcount[j + dimoff];
+                cur.count[j + dimoff]  = oc[j];
+            }
+            cur.info  = req->info;
+            cur.foff  = idx.foff[e];
+            cur.fsize = idx.fsize[e];
+            cur.doff  = pre[k] * (MPI_Offset)(fp->dsets_info[req->hdr.did]->esize);
+            cur.xsize = hdr[0];
+            cur.xbuf  = req->xbuf + soff;
+            ret.push_back (cur);
+        }
+    }
+}
+
+/*
+ * The blocks of a selection are tested against the query block H5VL_LOGI_ISECT_BATCH at a time.
+ * Only the blocks that intersect it are visited, the data offset of a block is the total size of
+ * the blocks before it.
+ */
+void H5VL_logi_compact_idx_t::search_entry (H5VL_log_rreq_t *req,
+                                            int i,
+                                            H5VL_logi_compact_idx_dset_t &idx,
+                                            size_t e,
+                                            size_t soff,
+                                            std::vector<H5VL_log_idx_search_ret_t> &ret) {
+    int j, k, l;
+    int nsel, n;
+    int dimoff;   // 1 for record entries, the first dimension is not encoded
+    int encndim;  // Number of encoded dimensions
+    uint64_t mask;
     MPI_Offset doff = 0;
     hsize_t bsize;
-    size_t soff;
-    hsize_t *start, *count;
+    hsize_t esize = fp->dsets_info[req->hdr.did]->esize;
+    hsize_t *hdr;  // Selection header
+    hsize_t *starts, *counts;
+    hsize_t *qstart = req->sels->starts[i];
+    hsize_t *qcount = req->sels->counts[i];
+    hsize_t qend[H5S_MAX_RANK];  // End of the query block
+    hsize_t start[H5S_MAX_RANK], count[H5S_MAX_RANK];
     hsize_t os[H5S_MAX_RANK], oc[H5S_MAX_RANK];
     H5VL_log_idx_search_ret_t cur;
 
+    hdr = this->blocks.data () + idx.boff[e];
+    if (hdr[1] & H5VL_LOGI_COMPACT_IDX_SEL_POINT) {
+        search_points (req, i, idx, e, soff, ret);
+        return;
+    }
+    nsel = (int)(hdr[1]);
+
+    if (idx.rec[e] >= 0) {
+        dimoff = 1;
+
+        cur.dstart[0] = 0;
+        cur.dsize[0]  = 1;
+        cur.mstart[0] = idx.rec[e] - qstart[0];
+        cur.msize[0]  = qcount[0];
+        cur.count[0]  = 1;
+
+        if ((cur.mstart[0] < 0) || (cur.mstart[0] >= cur.msize[0])) { return; }
+    } else {
+        dimoff = 0;
+    }
+    encndim = req->ndim - dimoff;
+
+    starts = hdr + H5VL_LOGI_COMPACT_IDX_SEL_HDR;
+    counts = starts + nsel * encndim;
+    for (j = 0; j < encndim; j++) { qend[j] = qstart[j + dimoff] + qcount[j + dimoff]; }
+
+    l = 0;  // Blocks before l are counted in doff
+    for (k = 0; k < nsel; k += H5VL_LOGI_ISECT_BATCH) {
+        n    = std::min (nsel - k, H5VL_LOGI_ISECT_BATCH);
+        mask = H5VL_logi_isect_batch (encndim, qstart + dimoff, qend, starts + k, counts + k, 1,
+                                      nsel, n);
+        while (mask) {
+            int b = k + H5VL_logi_isect_next (mask);
+
+            // Calculate doff up to the block
+            for (; l < b; l++) {
+                bsize = esize;
+                for (j = 0; j < encndim; j++) { bsize *= counts[j * nsel + l]; }
+                doff += (MPI_Offset)bsize;
+            }
+
+            for (j = 0; j < encndim; j++) {
+                start[j] = starts[j * nsel + b];
+                count[j] = counts[j * nsel + b];
+            }
+            H5VL_logi_isect (encndim, start, count, qstart + dimoff, qcount + dimoff, os, oc);
+            for (j = 0; j < encndim; j++) {
+                cur.dstart[j + dimoff] = os[j] - start[j];
+                cur.dsize[j + dimoff]  = count[j];
+                cur.mstart[j + dimoff] = os[j] - qstart[j + dimoff];
+                cur.msize[j + dimoff]  = qcount[j + dimoff];
+                cur.count[j + dimoff]  = oc[j];
+            }
+            cur.info  = req->info;
+            cur.foff  = idx.foff[e];
+            cur.fsize = idx.fsize[e];
+            cur.doff  = doff;
+            cur.xsize = hdr[0];
+            cur.xbuf  = req->xbuf + soff;
+            ret.push_back (cur);
+        }
+    }
+}
+
+/*
+ * Record entries are looked up by record number, only the entries of the records in the query block
+ * and the non-record entries are visited. They are visited in the order they were inserted so newer
+ * entries come later in ret.
+ */
+void H5VL_logi_compact_idx_t::search (H5VL_log_rreq_t *req,
+                                      std::vector<H5VL_log_idx_search_ret_t> &ret) {
+    int i;
+    size_t e;
+    size_t soff;
+    hssize_t rstart, rend;  // Record range of the query block
+    std::vector<size_t> pos;
+
     // Skip the search if dataset is unlinked
     if (!(fp->dsets_info[req->hdr.did])) { return; }
 
+    auto &idx = this->idxs[req->hdr.did];
+
     soff = 0;
     for (i = 0; i < req->sels->nsel; i++) {
-        for (auto ent : this->idxs[req->hdr.did]) {
-            if (ent->nsel == -1) {
-                nsel  = ((H5VL_logi_compact_idx_entry_t *)(ent->blocks))->nsel;
-                start = (hsize_t *)(((H5VL_logi_compact_idx_entry_t *)(ent->blocks))->blocks);
-            } else {
-                nsel  = ent->nsel;
-                start = (hsize_t *)(ent->blocks);
+        if (idx.recs.empty ()) {
+            for (e = 0; e < idx.foff.size (); e++) { search_entry (req, i, idx, e, soff, ret); }
+        } else {
+            rstart = (hssize_t)(req->sels->starts[i][0]);
+            rend   = rstart + (hssize_t)(req->sels->counts[i][0]);
+
+            pos.clear ();
+            auto it = std::lower_bound (idx.recs.begin (), idx.recs.end (),
+                                        std::pair<hssize_t, size_t> (rstart, 0));
+            for (; (it != idx.recs.end ()) && (it->first < rend); it++) {
+                pos.push_back (it->second);
             }
 
-            if (ent->rec >= 0) {
-                cur.dstart[0] = 0;
-                cur.dsize[0]  = 1;
-                cur.mstart[0] = ent->rec - req->sels->starts[i][0];
-                cur.msize[0]  = req->sels->counts[i][0];
-                cur.count[0]  = 1;
-
-                if ((cur.mstart[0] < 0) || (cur.mstart[0] >= cur.msize[0])) { continue; }
-
-                count = start + req->ndim - 1;
-                doff  = 0;
-                while (nsel--) {
-                    if (intersect (req->ndim - 1, start, count, req->sels->starts[i] + 1,
-                                   req->sels->counts[i] + 1, os, oc)) {
-                        for (j = 1; j < req->ndim; j++) {
-                            cur.dstart[j] = os[j - 1] - start[j - 1];
-                            cur.dsize[j]  = count[j - 1];
-                            cur.mstart[j] = os[j - 1] - req->sels->starts[i][j];
-                            cur.msize[j]  = req->sels->counts[i][j];
-                            cur.count[j]  = oc[j - 1];
-                        }
-                        cur.info  = req->info;
-                        cur.foff  = ent->foff;
-                        cur.fsize = ent->fsize;
-                        cur.doff  = doff;
-                        cur.xsize = ent->dsize;
-                        cur.xbuf  = req->xbuf + soff;
-                        ret.push_back (cur);
-                    }
-
-                    // Calculate doff on the fly
-                    bsize = fp->dsets_info[req->hdr.did]->esize;
-                    for (k = 0; k < req->ndim - 1; k++) { bsize *= count[k]; }
-                    doff += (MPI_Offset)bsize;
-
-                    // Advance start and ount
-                    start = count + req->ndim - 1;
-                    count = start + req->ndim - 1;
-                }
+            if (pos.empty ()) {
+                for (auto p : idx.nonrecs) { search_entry (req, i, idx, p, soff, ret); }
             } else {
-                count = start + req->ndim;
-                doff  = 0;
-                while (nsel--) {
-                    if (intersect (req->ndim, start, count, req->sels->starts[i],
-                                   req->sels->counts[i], os, oc)) {
-                        for (j = 0; j < req->ndim; j++) {
-                            cur.dstart[j] = os[j] - start[j];
-                            cur.dsize[j]  = count[j];
-                            cur.mstart[j] = os[j] - req->sels->starts[i][j];
-                            cur.msize[j]  = req->sels->counts[i][j];
-                            cur.count[j]  = oc[j];
-                        }
-                        cur.info  = req->info;
-                        cur.foff  = ent->foff;
-                        cur.fsize = ent->fsize;
-                        cur.doff  = doff;
-                        cur.xsize = ent->dsize;
-                        cur.xbuf  = req->xbuf + soff;
-                        ret.push_back (cur);
-                    }
-
-                    // Calculate doff on the fly
-                    bsize = fp->dsets_info[req->hdr.did]->esize;
-                    for (k = 0; k < req->ndim; k++) { bsize *= count[k]; }
-                    doff += (MPI_Offset)bsize;
-
-                    // Advance start and ount
-                    start = count + req->ndim;
-                    count = start + req->ndim;
-                }
+                pos.insert (pos.end (), idx.nonrecs.begin (), idx.nonrecs.end ());
+                std::sort (pos.begin (), pos.end ());
+                for (auto p : pos) { search_entry (req, i, idx, p, soff, ret); }
             }
         }
         soff += req->sels->get_sel_size (i) * req->esize;
     }
 }
+
+size_t H5VL_logi_compact_idx_t::memsize () {
+    size_t size = sizeof (H5VL_logi_compact_idx_dset_t) * this->idxs.capacity ();
+
+    size += sizeof (hsize_t) * this->blocks.capacity ();
+    for (auto &idx : this->idxs) {
+        size += sizeof (MPI_Offset) * idx.foff.capacity ();
+        size += sizeof (size_t) * idx.fsize.capacity ();
+        size += sizeof (hssize_t) * idx.rec.capacity ();
+        size += sizeof (size_t) * idx.boff.capacity ();
+        size += sizeof (size_t) * idx.nonrecs.capacity ();
+        size += sizeof (std::pair<hssize_t, size_t>) * idx.recs.capacity ();
+    }
+
+    return size;
+}
@@ -11,12 +11,15 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "H5VL_log_file.hpp"
 #include "H5VL_log_filei.hpp"
 #include "H5VL_logi.hpp"
 #include "H5VL_logi_idx.hpp"
+#include "H5VL_logi_isect.hpp"
 #include "H5VL_logi_nb.hpp"
 
 H5VL_logi_array_idx_t::H5VL_logi_array_idx_t (H5VL_log_file_t *fp) : H5VL_logi_idx_t (fp) {}
@@ -42,6 +45,12 @@ void H5VL_logi_array_idx_t::parse_block (char *block, size_t size) {
     char *bufp = block;                                         // Buffer for raw metadata
     H5VL_logi_metaentry_t entry;                                // Buffer of decoded metadata entry
     std::map<char *, std::vector<H5VL_logi_metasel_t>> bcache;  // Cache for linked metadata entry
+
+    if (fp->idx_nthread > 1) {
+        this->parse_block_parallel (block, size);
+        return;
+    }
+
     if (fp->config & H5VL_FILEI_CONFIG_METADATA_SHARE) {  // Need to maintina cache if file contains
                                                           // referenced metadata entries
         while (bufp < block + size) {
@@ -92,33 +101,121 @@ void H5VL_logi_array_idx_t::parse_block (char *block, size_t size) {
     }
 }
 
-static bool intersect (
-    int ndim, hsize_t *sa, hsize_t *ca, hsize_t *sb, hsize_t *cb, hsize_t *so, hsize_t *co) {
-    int i;
+/*
+ * The entries are located first, then decoded by the threads in contiguous chunks. An entry
+ * referring to the selection of another chunk is decoded after all chunks are decoded. Every thread
+ * then moves the entries of its datasets into the index in the order of the block, so the index is
+ * the same as the one built sequentially.
+ */
+void H5VL_logi_array_idx_t::parse_block_parallel (char *block, size_t size) {
+    int t;
+    int nt;                                     // Number of threads
+    size_t n;                                   // Number of entries
+    std::vector<char *> ents;                   // Entries of linked datasets
+    std::vector<H5VL_logi_metaentry_t> decs;    // Decoded entries
+    std::vector<size_t> lo;                     // First entry of each chunk
+    std::vector<std::vector<size_t>> pendings;  // Entries referring to another chunk
+    bool share = fp->config & H5VL_FILEI_CONFIG_METADATA_SHARE;
+
+    this->scan_block (block, size, ents);
+    n  = ents.size ();
+    nt = this->parse_nthread (n);
+    decs.resize (n);
+    pendings.resize (nt);
+    lo.resize (nt + 1);
+    for (t = 0; t <= nt; t++) { lo[t] = n * t / nt; }
+
+    H5VL_logi_idx_parallel (nt, [&] (int t) -> void {
+        size_t e;
+        hssize_t rec;
+        std::map<char *, std::vector<H5VL_logi_metasel_t>> bcache;  // Cache for linked entry
+
+        for (e = lo[t]; e < lo[t + 1]; e++) {
+            H5VL_logi_meta_hdr *hdr_tmp = (H5VL_logi_meta_hdr *)(ents[e]);
+            H5VL_log_dset_info_t &dset  = *(fp->dsets_info[hdr_tmp->did]);
+
+            if (share && (hdr_tmp->flag & H5VL_LOGI_META_FLAG_SEL_REF)) {
+                if (bcache.count (ref_target (ents[e], &rec))) {
+                    H5VL_logi_metaentry_ref_decode (dset, ents[e], decs[e], bcache);
+                } else {
+                    pendings[t].push_back (e);
+                }
+            } else {
+                H5VL_logi_metaentry_decode (dset, ents[e], decs[e]);
+                if (share) { bcache[ents[e]] = decs[e].sels; }
+            }
+        }
+    });
+
+    // Entries referring to another chunk, the referenced entries are all decoded
+    H5VL_logi_idx_parallel (nt, [&] (int t) -> void {
+        size_t j;
+        hssize_t rec;
+        std::map<char *, std::vector<H5VL_logi_metasel_t>> bcache;  // The referenced entry
+
+        for (auto e : pendings[t]) {
+            H5VL_logi_meta_hdr *hdr_tmp = (H5VL_logi_meta_hdr *)(ents[e]);
+            char *target                = ref_target (ents[e], &rec);
+
+            // The referenced entry comes earlier in the block
+            j = std::lower_bound (ents.begin (), ents.begin () + e, target) - ents.begin ();
+            if ((j == e) || (ents[j] != target) ||
+                (((H5VL_logi_meta_hdr *)target)->flag & H5VL_LOGI_META_FLAG_SEL_REF)) {
+                RET_ERR ("Invalid metadata entry")
+            }
+            bcache.clear ();
+            bcache[target] = decs[j].sels;
+            H5VL_logi_metaentry_ref_decode (*(fp->dsets_info[hdr_tmp->did]), ents[e], decs[e],
+                                            bcache);
+        }
+    });
 
-    for (i = 0; i < ndim; i++) {
-        so[i] = std::max (sa[i], sb[i]);
-        co[i] = std::min (sa[i] + ca[i], sb[i] + cb[i]);
-        if (co[i] <= so[i]) return false;
-        co[i] -= so[i];
-    }
+    // Insert to the index
+    H5VL_logi_idx_parallel (nt, [&] (int w) -> void {
+        size_t e;
 
-    return true;
+        for (e = 0; e < n; e++) {
+            if (decs[e].hdr.did % nt == w) {
+                this->idxs[decs[e].hdr.did].push_back (std::move (decs[e]));
+            }
+        }
+    });
 }
 
+/*
+ * The selected blocks of an entry are tested H5VL_LOGI_ISECT_BATCH at a time, gathered from the
+ * array of H5VL_logi_metasel_t. Only the blocks that intersect the query block are visited.
+ */
 void H5VL_logi_array_idx_t::search (H5VL_log_rreq_t *req,
                                     std::vector<H5VL_log_idx_search_ret_t> &ret) {
-    int i, j;
+    int i, j, k, n;
+    int nsel;
+    uint64_t mask;
     size_t soff;
+    hsize_t qend[H5S_MAX_RANK];  // End of the query block
     hsize_t os[H5S_MAX_RANK], oc[H5S_MAX_RANK];
     H5VL_log_idx_search_ret_t cur;
+    const size_t bstride = sizeof (H5VL_logi_metasel_t) / sizeof (hsize_t);
+
+    static_assert (sizeof (H5VL_logi_metasel_t) % sizeof (hsize_t) == 0,
+                   "H5VL_logi_metasel_t must be an array of hsize_t");
 
     soff = 0;
     for (i = 0; i < req->sels->nsel; i++) {
+        for (j = 0; j < req->ndim; j++) {
+            qend[j] = req->sels->starts[i][j] + req->sels->counts[i][j];
+        }
         for (auto &ent : this->idxs[req->hdr.did]) {
-            for (auto &msel : ent.sels) {
-                if (intersect (req->ndim, msel.start, msel.count, req->sels->starts[i],
-                               req->sels->counts[i], os, oc)) {
+            nsel = (int)(ent.sels.size ());
+            for (k = 0; k < nsel; k += H5VL_LOGI_ISECT_BATCH) {
+                n    = std::min (nsel - k, H5VL_LOGI_ISECT_BATCH);
+                mask = H5VL_logi_isect_batch (req->ndim, req->sels->starts[i], qend,
+                                              ent.sels[k].start, ent.sels[k].count, bstride, 1, n);
+                while (mask) {
+                    auto &msel = ent.sels[k + H5VL_logi_isect_next (mask)];
+
+                    H5VL_logi_isect (req->ndim, msel.start, msel.count, req->sels->starts[i],
+                                     req->sels->counts[i], os, oc);
                     for (j = 0; j < req->ndim; j++) {
                         cur.dstart[j] = os[j] - msel.start[j];
                         cur.dsize[j]  = msel.count[j];
@@ -139,3 +236,14 @@ void H5VL_logi_array_idx_t::search (H5VL_log_rreq_t *req,
         soff += req->sels->get_sel_size (i) * req->esize;
     }
 }
+
+size_t H5VL_logi_array_idx_t::memsize () {
+    size_t size = sizeof (std::vector<H5VL_logi_metaentry_t>) * this->idxs.capacity ();
+
+    for (auto &idx : this->idxs) {
+        size += sizeof (H5VL_logi_metaentry_t) * idx.capacity ();
+        for (auto &ent : idx) { size += sizeof (H5VL_logi_metasel_t) * ent.sels.capacity (); }
+    }
+
+    return size;
+}
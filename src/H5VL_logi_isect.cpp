@@ -0,0 +1,219 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstdint>
+
+#include "H5VL_logi_isect.hpp"
+
+/*
+ * Box k intersects the query box if, along every dimension, it starts before the query box ends,
+ * ends after the query box starts, and is not empty. The vector kernels evaluate the test on 4
+ * (AVX2) or 8 (AVX-512) boxes at a time without branching, the remaining boxes are tested by the
+ * scalar kernel. The kernels are compiled with function target attributes, so the library does
+ * not need to be built for a particular CPU; the kernel is chosen when the library is loaded.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) && !defined(__INTEL_COMPILER) && !defined(__NVCOMPILER))
+#define H5VL_LOGI_ISECT_X86 1
+#include <immintrin.h>
+#endif
+
+typedef uint64_t (*H5VL_logi_isect_fn_t) (int ndim,
+                                          const hsize_t *qstart,
+                                          const hsize_t *qend,
+                                          const hsize_t *starts,
+                                          const hsize_t *counts,
+                                          size_t bstride,
+                                          size_t dstride,
+                                          int k,
+                                          int n);
+
+// Test boxes k to n - 1
+static uint64_t H5VL_logi_isect_scalar (int ndim,
+                                        const hsize_t *qstart,
+                                        const hsize_t *qend,
+                                        const hsize_t *starts,
+                                        const hsize_t *counts,
+                                        size_t bstride,
+                                        size_t dstride,
+                                        int k,
+                                        int n) {
+    int i;
+    uint64_t mask = 0;
+    const hsize_t *sp, *cp;
+
+    for (; k < n; k++) {
+        sp = starts + k * bstride;
+        cp = counts + k * bstride;
+        for (i = 0; i < ndim; i++) {
+            if ((cp[0] == 0) || (sp[0] >= qend[i]) || (sp[0] + cp[0] <= qstart[i])) break;
+            sp += dstride;
+            cp += dstride;
+        }
+        if (i == ndim) { mask |= (uint64_t)1 << k; }
+    }
+
+    return mask;
+}
+
+#ifdef H5VL_LOGI_ISECT_X86
+__attribute__ ((target ("avx2"))) static uint64_t H5VL_logi_isect_avx2 (int ndim,
+                                                                         const hsize_t *qstart,
+                                                                         const hsize_t *qend,
+                                                                         const hsize_t *starts,
+                                                                         const hsize_t *counts,
+                                                                         size_t bstride,
+                                                                         size_t dstride,
+                                                                         int k,
+                                                                         int n) {
+    int i;
+    uint64_t mask = 0;
+    const hsize_t *sp, *cp;
+    __m256i qs, qe, s, c, e, hit;
+    __m256i zero = _mm256_setzero_si256 ();
+    __m256i vidx = _mm256_set_epi64x (3 * bstride, 2 * bstride, bstride, 0);
+
+    // Coordinates are below 2^63, the signed comparison is exact
+    for (; k + 4 <= n; k += 4) {
+        sp  = starts + k * bstride;
+        cp  = counts + k * bstride;
+        hit = _mm256_set1_epi64x (-1);
+        for (i = 0; i < ndim; i++) {
+            qs = _mm256_set1_epi64x ((long long)(qstart[i]));
+            qe = _mm256_set1_epi64x ((long long)(qend[i]));
+            if (bstride == 1) {
+                s = _mm256_loadu_si256 ((const __m256i *)sp);
+                c = _mm256_loadu_si256 ((const __m256i *)cp);
+            } else {
+                s = _mm256_i64gather_epi64 ((const long long *)sp, vidx, 8);
+                c = _mm256_i64gather_epi64 ((const long long *)cp, vidx, 8);
+            }
+            e   = _mm256_add_epi64 (s, c);
+            hit = _mm256_and_si256 (hit, _mm256_cmpgt_epi64 (qe, s));
+            hit = _mm256_and_si256 (hit, _mm256_cmpgt_epi64 (e, qs));
+            hit = _mm256_andnot_si256 (_mm256_cmpeq_epi64 (c, zero), hit);
+            sp += dstride;
+            cp += dstride;
+        }
+        mask |= (uint64_t)(_mm256_movemask_pd (_mm256_castsi256_pd (hit))) << k;
+    }
+
+    return mask | H5VL_logi_isect_scalar (ndim, qstart, qend, starts, counts, bstride, dstride, k,
+                                          n);
+}
+
+__attribute__ ((target ("avx512f"))) static uint64_t H5VL_logi_isect_avx512 (
+    int ndim,
+    const hsize_t *qstart,
+    const hsize_t *qend,
+    const hsize_t *starts,
+    const hsize_t *counts,
+    size_t bstride,
+    size_t dstride,
+    int k,
+    int n) {
+    int i;
+    uint64_t mask = 0;
+    const hsize_t *sp, *cp;
+    __m512i qs, qe, s, c, e;
+    __mmask8 hit;
+    __m512i zero = _mm512_setzero_si512 ();
+    __m512i vidx = _mm512_set_epi64 (7 * bstride, 6 * bstride, 5 * bstride, 4 * bstride,
+                                     3 * bstride, 2 * bstride, bstride, 0);
+
+    for (; k + 8 <= n; k += 8) {
+        sp  = starts + k * bstride;
+        cp  = counts + k * bstride;
+        hit = 0xff;
+        for (i = 0; (i < ndim) && hit; i++) {
+            qs = _mm512_set1_epi64 ((long long)(qstart[i]));
+            qe = _mm512_set1_epi64 ((long long)(qend[i]));
+            if (bstride == 1) {
+                s = _mm512_loadu_si512 ((const void *)sp);
+                c = _mm512_loadu_si512 ((const void *)cp);
+            } else {
+                s = _mm512_mask_i64gather_epi64 (zero, 0xff, vidx, (const void *)sp, 8);
+                c = _mm512_mask_i64gather_epi64 (zero, 0xff, vidx, (const void *)cp, 8);
+            }
+            e   = _mm512_add_epi64 (s, c);
+            hit = _mm512_mask_cmplt_epu64_mask (hit, s, qe);
+            hit = _mm512_mask_cmplt_epu64_mask (hit, qs, e);
+            hit = _mm512_mask_test_epi64_mask (hit, c, c);
+            sp += dstride;
+            cp += dstride;
+        }
+        mask |= (uint64_t)hit << k;
+    }
+
+    return mask | H5VL_logi_isect_scalar (ndim, qstart, qend, starts, counts, bstride, dstride, k,
+                                          n);
+}
+#endif
+
+static H5VL_logi_isect_impl_t H5VL_logi_isect_detect () {
+#ifdef H5VL_LOGI_ISECT_X86
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx512f")) { return H5VL_LOGI_ISECT_AVX512; }
+    if (__builtin_cpu_supports ("avx2")) { return H5VL_LOGI_ISECT_AVX2; }
+#endif
+    return H5VL_LOGI_ISECT_SCALAR;
+}
+
+static H5VL_logi_isect_fn_t H5VL_logi_isect_fn (H5VL_logi_isect_impl_t impl) {
+    switch (impl) {
+#ifdef H5VL_LOGI_ISECT_X86
+        case H5VL_LOGI_ISECT_AVX512:
+            return H5VL_logi_isect_avx512;
+        case H5VL_LOGI_ISECT_AVX2:
+            return H5VL_logi_isect_avx2;
+#endif
+        default:
+            return H5VL_logi_isect_scalar;
+    }
+}
+
+static H5VL_logi_isect_impl_t H5VL_logi_isect_impl = H5VL_logi_isect_detect ();
+static H5VL_logi_isect_fn_t H5VL_logi_isect_kernel = H5VL_logi_isect_fn (H5VL_logi_isect_impl);
+
+uint64_t H5VL_logi_isect_batch (int ndim,
+                                const hsize_t *qstart,
+                                const hsize_t *qend,
+                                const hsize_t *starts,
+                                const hsize_t *counts,
+                                size_t bstride,
+                                size_t dstride,
+                                int n) {
+    int i;
+
+    // An empty query box intersects nothing
+    for (i = 0; i < ndim; i++) {
+        if (qend[i] <= qstart[i]) { return 0; }
+    }
+
+    return H5VL_logi_isect_kernel (ndim, qstart, qend, starts, counts, bstride, dstride, 0, n);
+}
+
+H5VL_logi_isect_impl_t H5VL_logi_isect_get_impl () { return H5VL_logi_isect_impl; }
+
+bool H5VL_logi_isect_set_impl (H5VL_logi_isect_impl_t impl) {
+#ifdef H5VL_LOGI_ISECT_X86
+    __builtin_cpu_init ();
+    if ((impl == H5VL_LOGI_ISECT_AVX512) && !__builtin_cpu_supports ("avx512f")) { return false; }
+    if ((impl == H5VL_LOGI_ISECT_AVX2) && !__builtin_cpu_supports ("avx2")) { return false; }
+#else
+    if (impl != H5VL_LOGI_ISECT_SCALAR) { return false; }
+#endif
+
+    H5VL_logi_isect_impl   = impl;
+    H5VL_logi_isect_kernel = H5VL_logi_isect_fn (impl);
+
+    return true;
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#pragma once
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#define H5VL_LOGI_ISECT_BATCH 64  // Maximal number of boxes tested in one call
+
+// Implementations of the batched intersection test
+typedef enum H5VL_logi_isect_impl_t {
+    H5VL_LOGI_ISECT_SCALAR = 0,
+    H5VL_LOGI_ISECT_AVX2   = 1,
+    H5VL_LOGI_ISECT_AVX512 = 2
+} H5VL_logi_isect_impl_t;
+
+/* Test the query box [qstart, qend) against n boxes (n <= H5VL_LOGI_ISECT_BATCH)
+ * Coordinate d of box k is starts[k * bstride + d * dstride], its size along d is at the same
+ * position in counts. Boxes stored dimension-major (bstride = 1) are loaded directly, others are
+ * gathered. Bit k of the returned mask is set if box k intersects the query box.
+ * Coordinates must be less than 2^63.
+ */
+uint64_t H5VL_logi_isect_batch (int ndim,
+                                const hsize_t *qstart,
+                                const hsize_t *qend,
+                                const hsize_t *starts,
+                                const hsize_t *counts,
+                                size_t bstride,
+                                size_t dstride,
+                                int n);
+
+// Implementation used by H5VL_logi_isect_batch, the fastest one the CPU supports by default
+H5VL_logi_isect_impl_t H5VL_logi_isect_get_impl ();
+// Use impl instead, return false if the CPU or compiler does not support it
+bool H5VL_logi_isect_set_impl (H5VL_logi_isect_impl_t impl);
+
+// Position of the lowest hit in mask, the hit is cleared
+inline int H5VL_logi_isect_next (uint64_t &mask) {
+    int k;
+
+#ifdef __GNUC__
+    k = __builtin_ctzll (mask);
+#else
+    for (k = 0; !(mask & ((uint64_t)1 << k)); k++);
+#endif
+    mask &= mask - 1;
+
+    return k;
+}
+
+// Intersection of two boxes, return false if they do not intersect
+inline bool H5VL_logi_isect (
+    int ndim, hsize_t *sa, hsize_t *ca, hsize_t *sb, hsize_t *cb, hsize_t *so, hsize_t *co) {
+    int i;
+
+    for (i = 0; i < ndim; i++) {
+        so[i] = std::max (sa[i], sb[i]);
+        co[i] = std::min (sa[i] + ca[i], sb[i] + cb[i]);
+        if (co[i] <= so[i]) return false;
+        co[i] -= so[i];
+    }
+
+    return true;
+}
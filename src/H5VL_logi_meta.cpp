@@ -8,6 +8,7 @@
 #include <config.h>
 #endif
 //
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <map>
@@ -17,12 +18,400 @@
 #include <mpi.h>
 //
 #include "H5VL_log_dataset.hpp"
+#include "H5VL_log_filei.hpp"
 #include "H5VL_logi_dataspace.hpp"
 #include "H5VL_logi_err.hpp"
 #include "H5VL_logi_meta.hpp"
 #include "H5VL_logi_util.hpp"
 #include "H5VL_logi_zip.hpp"
 
+/*
+ * Inflate the compressed metadata sections in [buf, buf + size) into one buffer of entries
+ * Sections written by processes without metadata are empty
+ * Returns the buffer, which the caller frees, and sets esize to the size of the entries
+ */
+char *H5VL_logi_meta_sec_inflate (char *buf, MPI_Offset size, MPI_Offset *esize) {
+#ifdef ENABLE_ZLIB
+    int clen;                     // Size of decompressed section
+    char *bp;                     // Current section
+    char *ebuf = NULL;            // Metadata entries
+    MPI_Offset eoff;              // Size of entries decompressed
+    H5VL_logi_meta_sec_hdr *hdr;  // Header of current section
+
+    // Total size of the entries
+    *esize = 0;
+    for (bp = buf; bp < buf + size; bp += sizeof (H5VL_logi_meta_sec_hdr) + hdr->zsize) {
+        hdr = (H5VL_logi_meta_sec_hdr *)bp;
+        *esize += hdr->size;
+    }
+    if (bp != buf + size) { RET_ERR ("Corrupted metadata section") }
+
+    ebuf = (char *)malloc (*esize ? *esize : 1);
+    CHECK_PTR (ebuf)
+
+    eoff = 0;
+    for (bp = buf; bp < buf + size; bp += sizeof (H5VL_logi_meta_sec_hdr) + hdr->zsize) {
+        hdr  = (H5VL_logi_meta_sec_hdr *)bp;
+        clen = (int)(hdr->size);
+        if (!H5VL_log_zip_decompress (bp + sizeof (H5VL_logi_meta_sec_hdr), (int)(hdr->zsize),
+                                      ebuf + eoff, &clen) ||
+            clen != hdr->size) {
+            free (ebuf);
+            RET_ERR ("Corrupted metadata section")
+        }
+        eoff += hdr->size;
+    }
+
+    return ebuf;
+#else
+    RET_ERR ("Compressed Metadata Support Not Enabled")
+#endif
+}
+
+/*
+ * Pack the entries in [buf, size) written by one process into pbuf
+ * The header of each entry is stored as variable-length integers. The dataset ID and file offset
+ * are relative to the previous entry, file offsets of consecutive entries are usually contiguous.
+ * pbuf must hold at least H5VL_logi_meta_sec_pack_bound (size) bytes
+ * Returns the size of the packed section
+ */
+MPI_Offset H5VL_logi_meta_sec_pack (char *buf, MPI_Offset size, char *pbuf) {
+    char *bp, *pp;
+    MPI_Offset nent = 0;     // Number of entries
+    int32_t did     = 0;     // Dataset ID of the previous entry
+    MPI_Offset end  = 0;     // Ending file offset of the data of the previous entry
+    H5VL_logi_meta_hdr hdr;  // Header of the current entry in native byte order
+
+    for (bp = buf; bp < buf + size; bp += hdr.meta_size) {
+        memcpy (&hdr, bp, sizeof (H5VL_logi_meta_hdr));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)&hdr, (uint32_t *)(&hdr + 1));
+#endif
+        if (hdr.meta_size < (int32_t)sizeof (H5VL_logi_meta_hdr)) {
+            RET_ERR ("Invalid metadata entry")
+        }
+        nent++;
+    }
+    if (bp != buf + size) { RET_ERR ("Invalid metadata entry") }
+
+    pp = H5VL_logi_varint_encode ((uint64_t)nent, pbuf);
+    for (bp = buf; bp < buf + size; bp += hdr.meta_size) {
+        memcpy (&hdr, bp, sizeof (H5VL_logi_meta_hdr));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)&hdr, (uint32_t *)(&hdr + 1));
+#endif
+        pp = H5VL_logi_varint_encode ((uint64_t) (hdr.meta_size - sizeof (H5VL_logi_meta_hdr)), pp);
+        pp = H5VL_logi_varint_encode ((uint64_t) (uint32_t) (hdr.flag), pp);
+        pp = H5VL_logi_varint_encode (H5VL_logi_zigzag_encode ((int64_t)hdr.did - did), pp);
+        pp = H5VL_logi_varint_encode (H5VL_logi_zigzag_encode (hdr.foff - end), pp);
+        pp = H5VL_logi_varint_encode ((uint64_t) (hdr.fsize), pp);
+        memcpy (pp, bp + sizeof (H5VL_logi_meta_hdr),
+                hdr.meta_size - sizeof (H5VL_logi_meta_hdr));
+        pp += hdr.meta_size - sizeof (H5VL_logi_meta_hdr);
+
+        did = hdr.did;
+        end = hdr.foff + hdr.fsize;
+    }
+
+    return (MPI_Offset) (pp - pbuf);
+}
+
+/*
+ * Restore the entries of the packed sections in [buf, buf + size) byte for byte
+ * Returns the buffer, which the caller frees, and sets esize to the size of the entries
+ */
+char *H5VL_logi_meta_sec_unpack (char *buf, MPI_Offset size, MPI_Offset *esize) {
+    char *bp, *ep;
+    char *ebuf = NULL;       // Metadata entries
+    uint64_t nent;           // Number of entries in the current section
+    uint64_t val;            // Decoded varint
+    uint64_t i;
+    MPI_Offset bsize;        // Size of the entry without the header
+    H5VL_logi_meta_hdr hdr;  // Header of the current entry in native byte order
+
+    // Total size of the entries
+    *esize = 0;
+    for (bp = buf; bp < buf + size;) {
+        bp = H5VL_logi_varint_decode (bp, &nent);
+        for (i = 0; i < nent && bp < buf + size; i++) {
+            bp = H5VL_logi_varint_decode (bp, &val);
+            bsize = (MPI_Offset)val;
+            bp    = H5VL_logi_varint_decode (bp, &val);
+            bp    = H5VL_logi_varint_decode (bp, &val);
+            bp    = H5VL_logi_varint_decode (bp, &val);
+            bp    = H5VL_logi_varint_decode (bp, &val);
+            bp += bsize;
+            *esize += sizeof (H5VL_logi_meta_hdr) + bsize;
+        }
+        if (i < nent) { break; }
+    }
+    if (bp != buf + size) { RET_ERR ("Corrupted metadata section") }
+
+    ebuf = (char *)malloc (*esize ? *esize : 1);
+    CHECK_PTR (ebuf)
+
+    for (bp = buf, ep = ebuf; bp < buf + size;) {
+        bp        = H5VL_logi_varint_decode (bp, &nent);
+        hdr.did   = 0;
+        hdr.foff  = 0;
+        hdr.fsize = 0;
+        for (i = 0; i < nent; i++) {
+            bp            = H5VL_logi_varint_decode (bp, &val);
+            bsize         = (MPI_Offset)val;
+            hdr.meta_size = (int32_t) (sizeof (H5VL_logi_meta_hdr) + bsize);
+            bp            = H5VL_logi_varint_decode (bp, &val);
+            hdr.flag      = (int32_t) (uint32_t)val;
+            bp            = H5VL_logi_varint_decode (bp, &val);
+            hdr.did       = (int32_t) (hdr.did + H5VL_logi_zigzag_decode (val));
+            bp            = H5VL_logi_varint_decode (bp, &val);
+            hdr.foff += hdr.fsize + H5VL_logi_zigzag_decode (val);
+            bp        = H5VL_logi_varint_decode (bp, &val);
+            hdr.fsize = (MPI_Offset)val;
+
+            memcpy (ep, &hdr, sizeof (H5VL_logi_meta_hdr));
+#ifdef WORDS_BIGENDIAN
+            H5VL_logi_lreverse ((uint32_t *)ep, (uint32_t *)(ep + sizeof (H5VL_logi_meta_hdr)));
+#endif
+            memcpy (ep + sizeof (H5VL_logi_meta_hdr), bp, bsize);
+            ep += hdr.meta_size;
+            bp += bsize;
+        }
+    }
+
+    return ebuf;
+}
+
+/*
+ * Append the records of a dictionary dataset to dict
+ * Record IDs follow the order of the records in the file
+ */
+void H5VL_logi_meta_dict_append (H5VL_logi_meta_dict_t &dict, char *buf, MPI_Offset size) {
+    char *bp;
+    int32_t rhdr[2];  // Flag and size of the record
+    MPI_Offset base;  // Offset of buf in dict.buf
+
+    base = (MPI_Offset)dict.buf.size ();
+    for (bp = buf; bp + sizeof (rhdr) <= buf + size; bp += sizeof (rhdr) + rhdr[1]) {
+        memcpy (rhdr, bp, sizeof (rhdr));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)rhdr, (uint32_t *)(rhdr + 2));
+#endif
+        if (rhdr[1] < 0) { break; }
+        dict.offs.push_back (base + (bp - buf));
+    }
+    if (bp != buf + size) { RET_ERR ("Selection dictionary is corrupted") }
+
+    dict.buf.insert (dict.buf.end (), buf, buf + size);
+}
+
+/*
+ * Load the dictionary datasets of metadata datasets dict.nmd to nmd - 1 in the log group lgid
+ * The dictionary dataset written along with metadata dataset i is named _dict_i, metadata
+ * datasets without new records have none. Used by the utilities, which open the file with the
+ * native VOL.
+ */
+void H5VL_logi_meta_dict_read (hid_t lgid, int nmd, H5VL_logi_meta_dict_t &dict) {
+    herr_t err = 0;
+    htri_t exists;
+    hid_t did  = -1;  // Dictionary dataset ID
+    hid_t dsid = -1;  // Dictionary dataset space ID
+    hsize_t size;     // Size of the dictionary dataset
+    std::vector<char> buf;
+    char name[32];
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (dsid >= 0) { H5Sclose (dsid); }
+        if (did >= 0) { H5Dclose (did); }
+    });
+
+    for (; dict.nmd < nmd; dict.nmd++) {
+        sprintf (name, "%s_%d", H5VL_LOG_FILEI_DSET_DICT, dict.nmd);
+        exists = H5Lexists (lgid, name, H5P_DEFAULT);
+        CHECK_ID (exists)
+        if (!exists) continue;
+
+        did = H5Dopen2 (lgid, name, H5P_DEFAULT);
+        CHECK_ID (did)
+        dsid = H5Dget_space (did);
+        CHECK_ID (dsid)
+        H5Sget_simple_extent_dims (dsid, &size, NULL);
+
+        buf.resize (size ? size : 1);
+        err = H5Dread (did, H5T_NATIVE_B8, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf.data ());
+        CHECK_ERR
+        H5VL_logi_meta_dict_append (dict, buf.data (), (MPI_Offset)size);
+
+        H5Sclose (dsid);
+        dsid = -1;
+        H5Dclose (did);
+        did = -1;
+    }
+}
+
+/*
+ * Replace the dictionary references (H5VL_LOGI_META_FLAG_SEL_DICT) in the entries in
+ * [buf, buf + size) with the selections in dict, so the entries can be parsed as usual
+ * Relative offsets of deduplicated entries (H5VL_LOGI_META_FLAG_SEL_REF) are moved along
+ * Returns NULL if there is no reference, otherwise a buffer the caller frees, with esize set to the
+ * size of the expanded entries
+ */
+char *H5VL_logi_meta_dict_expand (H5VL_logi_meta_dict_t &dict,
+                                  char *buf,
+                                  MPI_Offset size,
+                                  MPI_Offset *esize) {
+    char *bp, *ep;
+    char *ebuf = NULL;          // Expanded entries
+    bool found = false;         // Whether there is any reference
+    int32_t rhdr[2];            // Flag and size of the referenced record
+    MPI_Offset id;              // Record ID
+    MPI_Offset roff;            // Relative offset of the entry referenced by a SEL_REF entry
+    MPI_Offset psize;           // Size of the header and the record number
+    H5VL_logi_meta_hdr hdr;     // Header of the current entry in native byte order
+    std::vector<std::pair<MPI_Offset, MPI_Offset>> moved;  // Old and new offset of each entry
+
+    // Size of the expanded entries
+    *esize = 0;
+    for (bp = buf; bp < buf + size; bp += hdr.meta_size) {
+        memcpy (&hdr, bp, sizeof (H5VL_logi_meta_hdr));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)&hdr, (uint32_t *)(&hdr + 1));
+#endif
+        if (hdr.meta_size <= 0) { RET_ERR ("Invalid metadata entry") }
+        if (!(hdr.flag & H5VL_LOGI_META_FLAG_SEL_DICT)) {
+            *esize += hdr.meta_size;
+            continue;
+        }
+        found = true;
+
+        psize = sizeof (H5VL_logi_meta_hdr);
+        if (hdr.flag & H5VL_LOGI_META_FLAG_REC) { psize += sizeof (MPI_Offset); }
+        memcpy (&id, bp + psize, sizeof (MPI_Offset));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_llreverse ((uint64_t *)&id);
+#endif
+        if (id < 0 || id >= (MPI_Offset)dict.offs.size ()) {
+            RET_ERR ("Invalid selection dictionary ID")
+        }
+        memcpy (rhdr, dict.buf.data () + dict.offs[id], sizeof (rhdr));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)rhdr, (uint32_t *)(rhdr + 2));
+#endif
+        *esize += psize + rhdr[1];
+    }
+    if (bp != buf + size) { RET_ERR ("Invalid metadata entry") }
+    if (!found) { return NULL; }
+
+    ebuf = (char *)malloc (*esize ? *esize : 1);
+    CHECK_PTR (ebuf)
+
+    for (bp = buf, ep = ebuf; bp < buf + size; bp += hdr.meta_size) {
+        memcpy (&hdr, bp, sizeof (H5VL_logi_meta_hdr));
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)&hdr, (uint32_t *)(&hdr + 1));
+#endif
+        moved.push_back (std::make_pair ((MPI_Offset) (bp - buf), (MPI_Offset) (ep - ebuf)));
+
+        psize = sizeof (H5VL_logi_meta_hdr);
+        if (hdr.flag & H5VL_LOGI_META_FLAG_REC) { psize += sizeof (MPI_Offset); }
+
+        if (hdr.flag & H5VL_LOGI_META_FLAG_SEL_DICT) {
+            H5VL_logi_meta_hdr ehdr = hdr;  // Header of the expanded entry
+
+            memcpy (&id, bp + psize, sizeof (MPI_Offset));
+#ifdef WORDS_BIGENDIAN
+            H5VL_logi_llreverse ((uint64_t *)&id);
+#endif
+            memcpy (rhdr, dict.buf.data () + dict.offs[id], sizeof (rhdr));
+#ifdef WORDS_BIGENDIAN
+            H5VL_logi_lreverse ((uint32_t *)rhdr, (uint32_t *)(rhdr + 2));
+#endif
+            ehdr.meta_size = (int32_t) (psize + rhdr[1]);
+            ehdr.flag      = (hdr.flag & ~(H5VL_LOGI_META_FLAG_SEL_DICT)) | rhdr[0];
+#ifdef WORDS_BIGENDIAN
+            H5VL_logi_lreverse ((uint32_t *)&ehdr, (uint32_t *)(&ehdr + 1));
+#endif
+            memcpy (ep, &ehdr, sizeof (H5VL_logi_meta_hdr));
+            memcpy (ep + sizeof (H5VL_logi_meta_hdr), bp + sizeof (H5VL_logi_meta_hdr),
+                    psize - sizeof (H5VL_logi_meta_hdr));  // Record number
+            memcpy (ep + psize, dict.buf.data () + dict.offs[id] + sizeof (rhdr), rhdr[1]);
+            ep += psize + rhdr[1];
+            continue;
+        }
+
+        memcpy (ep, bp, hdr.meta_size);
+
+        // Point to the new location of the referenced entry
+        if (hdr.flag & H5VL_LOGI_META_FLAG_SEL_REF) {
+            memcpy (&roff, bp + psize, sizeof (MPI_Offset));
+#ifdef WORDS_BIGENDIAN
+            H5VL_logi_llreverse ((uint64_t *)&roff);
+#endif
+            auto it = std::lower_bound (
+                moved.begin (), moved.end (), (MPI_Offset) (bp - buf) + roff,
+                [] (const std::pair<MPI_Offset, MPI_Offset> &a, MPI_Offset off) -> bool {
+                    return a.first < off;
+                });
+            if (it == moved.end () || it->first != (MPI_Offset) (bp - buf) + roff) {
+                free (ebuf);
+                RET_ERR ("Invalid metadata entry")
+            }
+            roff = it->second - (MPI_Offset) (ep - ebuf);
+#ifdef WORDS_BIGENDIAN
+            H5VL_logi_llreverse ((uint64_t *)&roff);
+#endif
+            memcpy (ep + psize, &roff, sizeof (MPI_Offset));
+        }
+        ep += hdr.meta_size;
+    }
+
+    return ebuf;
+}
+
+/*
+ * Decode the metadata sections in [buf, buf + size) of a metadata dataset with flags decomp into
+ * plain entries: inflate compressed sections, restore packed entry headers, then replace the
+ * dictionary references with the selections in dict
+ * Returns NULL if the sections are already plain, otherwise a buffer the caller frees, with esize
+ * set to the size of the entries. buf is left to the caller either way.
+ */
+char *H5VL_logi_meta_sec_decode (MPI_Offset decomp,
+                                 H5VL_logi_meta_dict_t &dict,
+                                 char *buf,
+                                 MPI_Offset size,
+                                 MPI_Offset *esize) {
+    char *ebuf = NULL;  // Decoded entries
+    char *xbuf;         // Output of the current step
+
+    *esize = size;
+
+    try {
+        // Inflate compressed sections
+        if (decomp & H5VL_LOGI_META_DECOMP_FLAG_ZIP) {
+            ebuf = H5VL_logi_meta_sec_inflate (buf, size, esize);
+        }
+
+        // Restore packed entry headers
+        if (decomp & H5VL_LOGI_META_DECOMP_FLAG_PACK) {
+            xbuf = H5VL_logi_meta_sec_unpack (ebuf ? ebuf : buf, *esize, esize);
+            free (ebuf);
+            ebuf = xbuf;
+        }
+
+        // Replace selection dictionary references
+        if (dict.offs.size ()) {
+            xbuf = H5VL_logi_meta_dict_expand (dict, ebuf ? ebuf : buf, *esize, esize);
+            if (xbuf) {
+                free (ebuf);
+                ebuf = xbuf;
+            }
+        }
+    } catch (...) {
+        free (ebuf);
+        throw;
+    }
+
+    return ebuf;
+}
+
 void H5VL_logi_metaentry_ref_decode (H5VL_log_dset_info_t &dset,
                                      void *ent,
                                      H5VL_logi_metaentry_t &block,
@@ -82,6 +471,68 @@ void H5VL_logi_metaentry_ref_decode (H5VL_log_dset_info_t &dset,
     block.dsize += block.sels[block.sels.size () - 1].doff;
 }
 
+void H5VL_logi_metaentry_point_decode (H5VL_log_dset_info_t &dset,
+                                       void *ent,
+                                       H5VL_logi_meta_hdr &hdr,
+                                       hsize_t *recnum,
+                                       MPI_Offset *dsteps,
+                                       std::vector<MPI_Offset> &offs,
+                                       std::vector<MPI_Offset> &lens) {
+    int i;
+    int nsel;                  // Nunmber of selections in ent
+    int encdim;                // number of dim encoded (ndim or ndim - 1)
+    char *bufp = (char *)ent;  // Next byte to process in ent
+    uint64_t val;              // Decoded varint
+    MPI_Offset end = 0;        // Linearized offset after the previous block
+
+    // Get the header
+    hdr = *((H5VL_logi_meta_hdr *)bufp);
+    bufp += sizeof (H5VL_logi_meta_hdr);
+
+    // Entry size must be > 0
+    if (hdr.meta_size <= 0) { RET_ERR ("Invalid metadata entry") }
+    if (!(hdr.flag & H5VL_LOGI_META_FLAG_SEL_POINT)) { RET_ERR ("Not a point list entry") }
+
+    // Check if it is a record entry
+    if (hdr.flag & H5VL_LOGI_META_FLAG_REC) {
+        encdim = dset.ndim - 1;
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_llreverse ((uint64_t *)(bufp));
+#endif
+        *recnum = *((MPI_Offset *)bufp);
+        bufp += sizeof (MPI_Offset);
+    } else {
+        encdim = dset.ndim;
+    }
+
+    // Number of selections, point list entries always have more than 1 selection
+#ifdef WORDS_BIGENDIAN
+    H5VL_logi_lreverse ((uint32_t *)(bufp));
+#endif
+    nsel = *((int *)bufp);
+    bufp += sizeof (int);
+
+    // Selection encoding info
+#ifdef WORDS_BIGENDIAN
+    H5VL_logi_llreverse ((uint64_t *)(bufp), (uint64_t *)(bufp) + encdim - 1);
+#endif
+    memcpy (dsteps, bufp, sizeof (MPI_Offset) * (encdim - 1));
+    dsteps[encdim - 1] = 1;
+    bufp += sizeof (MPI_Offset) * (encdim - 1);
+
+    // Delta varint encoded blocks
+    offs.resize (nsel);
+    lens.resize (nsel);
+    for (i = 0; i < nsel; i++) {
+        bufp    = H5VL_logi_varint_decode (bufp, &val);
+        offs[i] = end + (MPI_Offset)val;
+        bufp    = H5VL_logi_varint_decode (bufp, &val);
+        lens[i] = (MPI_Offset)val + 1;
+        end     = offs[i] + lens[i];
+    }
+    if (bufp > (char *)ent + hdr.meta_size) { RET_ERR ("Corrupted point list metadata entry") }
+}
+
 void H5VL_logi_metaentry_decode (H5VL_log_dset_info_t &dset,
                                  void *ent,
                                  H5VL_logi_metaentry_t &block) {
@@ -119,6 +570,29 @@ void H5VL_logi_metaentry_decode (H5VL_log_dset_info_t &dset,
     // Entry size must be > 0
     if (block.hdr.meta_size <= 0) { RET_ERR ("Invalid metadata entry") }
 
+    // Point list entries are expanded into row segments
+    if (block.hdr.flag & H5VL_LOGI_META_FLAG_SEL_POINT) {
+        std::vector<MPI_Offset> offs, lens;
+
+        H5VL_logi_metaentry_point_decode (dset, ent, block.hdr, &recnum, dsteps, offs, lens);
+
+        isrec  = (block.hdr.flag & H5VL_LOGI_META_FLAG_REC) ? 1 : 0;
+        encdim = dset.ndim - isrec;
+        nsel   = (int)offs.size ();
+        block.sels.resize (nsel);
+        block.dsize = 0;
+        for (i = 0; i < nsel; i++) {
+            if (isrec) { block.sels[i].start[0] = recnum; }
+            H5VL_logi_sel_decode (encdim, dsteps, offs[i], block.sels[i].start + isrec);
+            for (j = 0; j < (int)(dset.ndim); j++) { block.sels[i].count[j] = 1; }
+            block.sels[i].count[dset.ndim - 1] = lens[i];
+            block.sels[i].doff                 = block.dsize;
+            block.dsize += dset.esize * lens[i];
+        }
+
+        return;
+    }
+
     // Check if it is a record entry
     if (block.hdr.flag & H5VL_LOGI_META_FLAG_REC) {
         encdim = dset.ndim - 1;
@@ -190,6 +664,44 @@ void H5VL_logi_metaentry_decode (H5VL_log_dset_info_t &dset,
 #endif
     }
 
+    // Zigzag varint deltas of the start and count from the previous block
+    if (block.hdr.flag & H5VL_LOGI_META_FLAG_SEL_VARINT) {
+        hsize_t pstart[H5S_MAX_RANK] = {0};  // Start of the previous block
+        hsize_t pcount[H5S_MAX_RANK] = {0};  // Count of the previous block
+        uint64_t val;                        // Decoded varint
+
+        bufp = zbuf;
+        block.sels.resize (nsel);
+        block.dsize = 0;
+        for (i = 0; i < nsel; i++) {
+            H5VL_logi_metasel_t &sel = block.sels[i];
+
+            if (isrec) {
+                sel.start[0] = recnum;
+                sel.count[0] = 1;
+            }
+            for (j = isrec; j < (int)(dset.ndim); j++) {
+                bufp         = H5VL_logi_varint_decode (bufp, &val);
+                sel.start[j] = pstart[j] + H5VL_logi_zigzag_decode (val);
+                pstart[j]    = sel.start[j];
+            }
+            for (j = isrec; j < (int)(dset.ndim); j++) {
+                bufp         = H5VL_logi_varint_decode (bufp, &val);
+                sel.count[j] = pcount[j] + H5VL_logi_zigzag_decode (val);
+                pcount[j]    = sel.count[j];
+            }
+
+            // Offset of the data of the block within the unfiltered data block
+            sel.doff = block.dsize;
+            esize    = dset.esize;
+            for (j = 0; j < (int)(dset.ndim); j++) { esize *= sel.count[j]; }
+            block.dsize += esize;
+        }
+        if (bufp > (char *)ent + block.hdr.meta_size) { RET_ERR ("Corrupted varint metadata entry") }
+
+        return;
+    }
+
     bp = (MPI_Offset *)zbuf;
 #ifdef WORDS_BIGENDIAN
     H5VL_logi_llreverse ((uint64_t *)(bp), (uint64_t *)(bp + bsize));
@@ -24,6 +24,31 @@
 #define H5VL_LOGI_META_FLAG_SEL_ENCODE  0x04
 #define H5VL_LOGI_META_FLAG_SEL_DEFLATE 0x08
 
+// The first word of a metadata dataset holds the number of sections and the flags of the dataset
+#define H5VL_LOGI_META_DECOMP_NSEC_MASK  0xffffffffLL
+#define H5VL_LOGI_META_DECOMP_FLAG_ZIP   0x100000000LL  // Each section is deflated as a whole
+#define H5VL_LOGI_META_DECOMP_FLAG_PACK  0x200000000LL  // Entry headers are packed as varints
+#define H5VL_LOGI_META_DECOMP_FLAG_XSIZE 0x400000000LL  // Decoded section sizes follow the offsets
+#define H5VL_LOGI_META_DECOMP_KNOWN                                                      \
+    (H5VL_LOGI_META_DECOMP_NSEC_MASK | H5VL_LOGI_META_DECOMP_FLAG_ZIP |                  \
+     H5VL_LOGI_META_DECOMP_FLAG_PACK | H5VL_LOGI_META_DECOMP_FLAG_XSIZE)
+
+// Offset of the first section in a metadata dataset, after the decomposition map
+inline MPI_Offset H5VL_logi_meta_sec_begin (MPI_Offset decomp) {
+    MPI_Offset nsec = decomp & H5VL_LOGI_META_DECOMP_NSEC_MASK;
+
+    if (decomp & H5VL_LOGI_META_DECOMP_FLAG_XSIZE) {
+        return (MPI_Offset)sizeof (MPI_Offset) * (nsec * 2 + 1);
+    }
+    return (MPI_Offset)sizeof (MPI_Offset) * (nsec + 1);
+}
+
+// Header of a compressed metadata section, followed by the deflate stream of the entries
+typedef struct H5VL_logi_meta_sec_hdr {
+    MPI_Offset size;   // Size of the metadata entries
+    MPI_Offset zsize;  // Size of the deflate stream
+} H5VL_logi_meta_sec_hdr;
+
 typedef struct H5VL_logi_meta_hdr {
     int32_t meta_size;  // Size of the metadata entry
     int32_t did;        // Target dataset ID
@@ -61,42 +86,93 @@ inline void H5VL_logi_sel_encode (int ndim, MPI_Offset *dsteps, hsize_t *cord, M
         *off += cord[i] * dsteps[i];  // Ending offset of the bounding box
     }
 }
-/*
-class H5VL_logi_wreq_hash {
-        // A hash function used to hash a pair of any kind
-        struct hash_pair {
-                size_t operator() (const std::pair<void *, size_t> &p) const {
-                        int i;
-                        size_t ret = 0;
-                        size_t *val;
-                        size_t *end = (size_t *)((char *)(p.first) + p.second - p.second % sizeof
-(size_t));
-
-                        for (val = (size_t *)(p.first); val < end; val++) { ret ^= *val; }
-
-                        return ret;
-                }
-        };
-
-        struct equal_pair {
-                bool operator() (const std::pair<void *, size_t> &a, const std::pair<void *, size_t>
-&b) const { if (a.second != b.second) { return false; } return memcmp (a.first, b.first, a.second)
-== 0;
-                }
-        };
-
-        std::unordered_map<std::pair<void *, size_t>, int, hash_pair, equal_pair>
-                table;
-
-        public:
-        H5VL_logi_wreq_hash();
-        ~H5VL_logi_wreq_hash();
-
-        int find(char *buf, size_t size);
-        int add(char *buf, size_t size);
-        void clear();
-};
-*/
+// Number of bytes needed to encode val as an unsigned LEB128 varint
+inline int H5VL_logi_varint_size (uint64_t val) {
+    int size = 1;
+    while (val >= 0x80) {
+        val >>= 7;
+        size++;
+    }
+    return size;
+}
+
+// Encode val as an unsigned LEB128 varint, return the next byte after the encoded value
+inline char *H5VL_logi_varint_encode (uint64_t val, char *buf) {
+    uint8_t *bp = (uint8_t *)buf;
+    while (val >= 0x80) {
+        *(bp++) = (uint8_t) (val | 0x80);
+        val >>= 7;
+    }
+    *(bp++) = (uint8_t)val;
+    return (char *)bp;
+}
+
+// Map a signed value to an unsigned one so that values close to 0 get short varints
+inline uint64_t H5VL_logi_zigzag_encode (int64_t val) {
+    return ((uint64_t)val << 1) ^ (uint64_t) (val >> 63);
+}
+
+inline int64_t H5VL_logi_zigzag_decode (uint64_t val) {
+    return (int64_t) (val >> 1) ^ -(int64_t) (val & 1);
+}
+
+// Decode an unsigned LEB128 varint, return the next byte after the encoded value
+inline char *H5VL_logi_varint_decode (char *buf, uint64_t *val) {
+    int shift    = 0;
+    uint8_t *bp  = (uint8_t *)buf;
+    uint64_t ret = 0;
+    while (*bp & 0x80) {
+        ret |= (uint64_t) (*(bp++) & 0x7f) << shift;
+        shift += 7;
+    }
+    ret |= (uint64_t) (*(bp++)) << shift;
+    *val = ret;
+    return (char *)bp;
+}
+
+// Inflate consecutive compressed metadata sections into a newly allocated buffer of entries
+char *H5VL_logi_meta_sec_inflate (char *buf, MPI_Offset size, MPI_Offset *esize);
+// Pack the entry headers of a section, the packed section is never larger than the bound
+MPI_Offset H5VL_logi_meta_sec_pack (char *buf, MPI_Offset size, char *pbuf);
+// Restore consecutive packed metadata sections into a newly allocated buffer of entries
+char *H5VL_logi_meta_sec_unpack (char *buf, MPI_Offset size, MPI_Offset *esize);
+
+// Largest size of a packed section of size bytes of entries
+// A packed header takes at most 7 bytes more than the 28-byte header, plus the entry count
+inline MPI_Offset H5VL_logi_meta_sec_pack_bound (MPI_Offset size) {
+    return size + (size / (MPI_Offset)sizeof (H5VL_logi_meta_hdr) + 2) * 7;
+}
+
+// Selection dictionary records loaded from the file
+typedef struct H5VL_logi_meta_dict_t {
+    std::vector<char> buf;         // Records, [flag (INT32), size (INT32), selection]
+    std::vector<MPI_Offset> offs;  // Offset of each record in buf, indexed by the record ID
+    int nmd = 0;  // Dictionary datasets of the first nmd metadata datasets are loaded
+} H5VL_logi_meta_dict_t;
+
+// Section table of a metadata dataset, kept for loading the metadata a window at a time
+typedef struct H5VL_logi_meta_sec_table_t {
+    MPI_Offset decomp;               // Number of sections and flags of the dataset
+    haddr_t foff;                    // File offset of the dataset, HADDR_UNDEF if unknown
+    std::vector<MPI_Offset> offs;    // Ending offset of each section within the dataset
+    std::vector<MPI_Offset> xsizes;  // Size of each section once inflated, unpacked and expanded
+} H5VL_logi_meta_sec_table_t;
+
+// Append the records of a dictionary dataset
+void H5VL_logi_meta_dict_append (H5VL_logi_meta_dict_t &dict, char *buf, MPI_Offset size);
+// Load the dictionary datasets of the first nmd metadata datasets in the log group with HDF5 API
+void H5VL_logi_meta_dict_read (hid_t lgid, int nmd, H5VL_logi_meta_dict_t &dict);
+// Replace the dictionary references in a block of entries, NULL if the block has none
+char *H5VL_logi_meta_dict_expand (H5VL_logi_meta_dict_t &dict,
+                                  char *buf,
+                                  MPI_Offset size,
+                                  MPI_Offset *esize);
+// Inflate, unpack and expand the sections of a metadata dataset, NULL if they are already plain
+char *H5VL_logi_meta_sec_decode (MPI_Offset decomp,
+                                 H5VL_logi_meta_dict_t &dict,
+                                 char *buf,
+                                 MPI_Offset size,
+                                 MPI_Offset *esize);
 
 struct H5VL_logi_idx_t;
 struct H5VL_log_dset_info_t;
@@ -107,6 +183,14 @@ void H5VL_logi_metaentry_decode (H5VL_log_dset_info_t &dset,
                                  void *ent,
                                  H5VL_logi_metaentry_t &block,
                                  MPI_Offset *dsteps);
+void H5VL_logi_metaentry_point_decode (
+    H5VL_log_dset_info_t &dset,
+    void *ent,
+    H5VL_logi_meta_hdr &hdr,
+    hsize_t *recnum,
+    MPI_Offset *dsteps,
+    std::vector<MPI_Offset> &offs,   // Linearized offset of each row segment
+    std::vector<MPI_Offset> &lens);  // Length of each row segment
 
 inline MPI_Offset H5VL_logi_get_metaentry_size (int ndim, H5VL_logi_meta_hdr &hdr, int nsel) {
     MPI_Offset size;
@@ -8,6 +8,7 @@
 #include <config.h>
 #endif
 //
+#include <algorithm>
 #include <cstring>
 #include <map>
 #include <unordered_map>
@@ -55,7 +56,9 @@ H5VL_log_wreq_t::H5VL_log_wreq_t (void *dset, H5VL_log_selections *sels) {
     H5VL_log_dset_t *dp       = (H5VL_log_dset_t *)dset;
     H5VL_log_dset_info_t *dip = dp->fp->dsets_info[dp->id];  // Dataset info
     size_t mbsize;
-    hsize_t recnum;  // Record number
+    size_t psize = 0;  // Size of the selection encoded as a point list
+    size_t vsize = 0;  // Size of the selection encoded as zigzag varints
+    hsize_t recnum;    // Record number
     int i;
     int encdim;  // number of dim encoded (ndim or ndim - 1)
     int flag;
@@ -92,6 +95,22 @@ H5VL_log_wreq_t::H5VL_log_wreq_t (void *dset, H5VL_log_selections *sels) {
             flag |= H5VL_LOGI_META_FLAG_SEL_DEFLATE;
         }
 #endif
+        // Row segments (e.g. point selections) are stored as delta varints of the linearized
+        // offsets, which is already smaller than the deflated start and count pairs
+        if ((encdim > 0) && (dp->fp->config & H5VL_FILEI_CONFIG_SEL_ENCODE)) {
+            psize = sels->get_point_list_size (dip->dsteps, dip->ndim - encdim);
+            if (psize) {
+                flag &= ~(H5VL_LOGI_META_FLAG_SEL_ENCODE | H5VL_LOGI_META_FLAG_SEL_DEFLATE);
+                flag |= H5VL_LOGI_META_FLAG_SEL_POINT;
+            }
+        }
+    }
+    // Other selections are stored as zigzag varint deltas from the previous block
+    if ((encdim > 0) && (dp->fp->config & H5VL_FILEI_CONFIG_SEL_VARINT) &&
+        !(flag & H5VL_LOGI_META_FLAG_SEL_POINT)) {
+        vsize = sels->get_varint_size (dip->ndim - encdim);
+        flag &= ~(H5VL_LOGI_META_FLAG_SEL_ENCODE | H5VL_LOGI_META_FLAG_SEL_DEFLATE);
+        flag |= H5VL_LOGI_META_FLAG_SEL_VARINT;
     }
 
     // Allocate metadata buffer
@@ -102,7 +121,11 @@ H5VL_log_wreq_t::H5VL_log_wreq_t (void *dset, H5VL_log_selections *sels) {
     if (flag & H5VL_LOGI_META_FLAG_MUL_SEL) {
         mbsize += sizeof (int);  // N
     }
-    if (flag & H5VL_LOGI_META_FLAG_SEL_ENCODE) {
+    if (flag & H5VL_LOGI_META_FLAG_SEL_POINT) {
+        mbsize += sizeof (MPI_Offset) * (encdim - 1) + psize;
+    } else if (flag & H5VL_LOGI_META_FLAG_SEL_VARINT) {
+        mbsize += vsize;
+    } else if (flag & H5VL_LOGI_META_FLAG_SEL_ENCODE) {
         mbsize += sizeof (MPI_Offset) * (encdim - 1 + nsel * 2);
     } else {
         mbsize += sizeof (MPI_Offset) * (encdim * nsel * 2);
@@ -149,12 +172,24 @@ H5VL_log_wreq_t::H5VL_log_wreq_t (void *dset, H5VL_log_selections *sels) {
 #endif
 
         // Dsteps
-        if (flag & H5VL_LOGI_META_FLAG_SEL_ENCODE) {
+        if (flag & (H5VL_LOGI_META_FLAG_SEL_ENCODE | H5VL_LOGI_META_FLAG_SEL_POINT)) {
             memcpy (bufp, dip->dsteps + (dip->ndim - encdim), sizeof (MPI_Offset) * (encdim - 1));
             bufp += sizeof (MPI_Offset) * (encdim - 1);
         }
 
-        if (flag & H5VL_LOGI_META_FLAG_SEL_ENCODE) {
+        if (flag & H5VL_LOGI_META_FLAG_SEL_POINT) {
+#ifdef WORDS_BIGENDIAN
+            // Varints are byte streams, only the dsteps need to be reversed
+            H5VL_logi_llreverse (rstart, (uint64_t *)bufp);
+            rstart = (uint64_t *)(meta_buf + mbsize);
+#endif
+            sels->encode_point_list (bufp, dip->dsteps, dip->ndim - encdim);
+        } else if (flag & H5VL_LOGI_META_FLAG_SEL_VARINT) {
+#ifdef WORDS_BIGENDIAN
+            rstart = (uint64_t *)(meta_buf + mbsize);  // Varints are byte streams
+#endif
+            sels->encode_varint (bufp, dip->ndim - encdim);
+        } else if (flag & H5VL_LOGI_META_FLAG_SEL_ENCODE) {
             sels->encode (bufp, dip->dsteps, flag & H5VL_LOGI_META_FLAG_REC ? 1 : 0);
         } else {
             sels->encode (bufp, NULL, flag & H5VL_LOGI_META_FLAG_REC ? 1 : 0);
@@ -183,18 +218,6 @@ void H5VL_log_wreq_t::resize (size_t size) {
     hdr->meta_size = size;
 }
 
-size_t std::hash<H5VL_log_wreq_t>::operator() (H5VL_log_wreq_t const &r) const noexcept {
-    size_t ret = 0;
-    size_t *val;
-    size_t *end;
-    size_t selsize = r.hdr->meta_size - (r.sel_buf - r.meta_buf);
-
-    end = (size_t *)((char *)(r.sel_buf) + selsize - selsize % sizeof (size_t));
-    for (val = (size_t *)(r.sel_buf); val < end; val++) { ret ^= *val; }
-
-    return ret;
-}
-
 bool H5VL_log_wreq_t::operator== (const H5VL_log_wreq_t rhs) const {
     if (hdr->meta_size != rhs.hdr->meta_size) { return false; }
     return memcmp (sel_buf, rhs.sel_buf, hdr->meta_size - (sel_buf - meta_buf)) == 0;
@@ -324,69 +347,460 @@ void H5VL_log_merged_wreq_t::append (H5VL_log_dset_t *dp,
     this->hdr->meta_size = this->mbufp - this->meta_buf;
 }
 
+// Search the index for requests lo to hi - 1, eliminate the shadowed parts of each if shadow_elim
+static void H5VL_log_read_idx_search_range (H5VL_log_file_t *fp,
+                                            std::vector<H5VL_log_rreq_t *> &reqs,
+                                            size_t lo,
+                                            size_t hi,
+                                            bool shadow_elim,
+                                            std::vector<H5VL_log_idx_search_ret_t> &intersecs) {
+    size_t i;
+    size_t begin;
+
+    for (i = lo; i < hi; i++) {
+        begin = intersecs.size ();
+        fp->idx->search (reqs[i], intersecs);
+        if (shadow_elim) { H5VL_logi_idx_shadow_elim (intersecs, begin); }
+    }
+}
+
+/*
+ * The requests are split into contiguous chunks searched by up to fp->idx_nthread threads, the
+ * index is not modified by a search. Each thread appends to its own vector, the vectors are
+ * concatenated in the order of the requests so the result does not depend on the number of threads.
+ */
+static void H5VL_log_read_idx_search_reqs (H5VL_log_file_t *fp,
+                                           std::vector<H5VL_log_rreq_t *> &reqs,
+                                           bool shadow_elim,
+                                           std::vector<H5VL_log_idx_search_ret_t> &intersecs) {
+    int nthread = (int)(std::min (reqs.size (), (size_t)(fp->idx_nthread)));
+    size_t n    = reqs.size ();
+    std::vector<std::vector<H5VL_log_idx_search_ret_t>> rets;  // Results of each thread
+
+    if (nthread <= 1) {
+        H5VL_log_read_idx_search_range (fp, reqs, 0, n, shadow_elim, intersecs);
+        return;
+    }
+
+    // The first chunk goes to intersecs directly
+    rets.resize (nthread);
+    H5VL_logi_idx_parallel (nthread, [&] (int t) -> void {
+        H5VL_log_read_idx_search_range (fp, reqs, n * t / nthread, n * (t + 1) / nthread,
+                                        shadow_elim, t ? rets[t] : intersecs);
+    });
+
+    for (auto &ret : rets) { intersecs.insert (intersecs.end (), ret.begin (), ret.end ()); }
+}
+
 inline void H5VL_log_read_idx_search (H5VL_log_file_t *fp,
                                       std::vector<H5VL_log_rreq_t *> &reqs,
                                       std::vector<H5VL_log_idx_search_ret_t> &intersecs) {
     int md, sec;  // Current metadata dataset and vurrent section
+    int w;        // Window being searched
+    int nwin;     // Number of windows searched
+    int nthread;
+    size_t r, n;
+    bool shadow_elim = fp->config & H5VL_FILEI_CONFIG_SHADOW_ELIM;
+    std::vector<std::vector<H5VL_log_idx_search_ret_t>>
+        rets;  // Search result of each request when searching metadata section by section
+    std::vector<std::vector<H5VL_log_idx_search_ret_t>>
+        hrets;  // Search result in the window held in the index, of each request or all requests
+    H5VL_log_filei_metawin_t wins[2];  // Window being searched and window being read
+    H5VL_logi_err_finally finally ([&wins] () -> void {
+        H5VL_log_filei_metawin_free (wins[0]);
+        H5VL_log_filei_metawin_free (wins[1]);
+    });
 
     // Flush metadata if dirty
     if (fp->metadirty) { H5VL_log_filei_metaflush (fp); }
 
     // If there is no metadata size limit, we load all the metadata at once
-    if (fp->mbuf_size == LOG_VOL_BSIZE_UNLIMITED) {
+    // If all the metadata fit into the metadata buffer size in the last search, it is still loaded
+    if ((fp->mbuf_size == LOG_VOL_BSIZE_UNLIMITED) || fp->idxvalid) {
         // Load metadata
         if (!(fp->idxvalid)) { H5VL_log_filei_metaupdate (fp); }
 
         // Search index
-        for (auto r : reqs) { fp->idx->search (r, intersecs); }
+        H5VL_log_read_idx_search_reqs (fp, reqs, shadow_elim, intersecs);
     } else {
+        // Shadow elimination needs the results of a request in log order, keep them apart
+        if (shadow_elim) { rets.resize (reqs.size ()); }
+        n       = reqs.size ();
+        nthread = (int)(std::min (n, (size_t)(fp->idx_nthread)));
+        if (nthread < 1) { nthread = 1; }
+
+        // The window left in the index by the last pass is searched without reading it again, its
+        // results are put in place when the pass gets to it
+        if (fp->idxwin_md != -1) {
+            if (shadow_elim) {
+                hrets.resize (n);
+                H5VL_logi_idx_parallel (nthread, [&] (int t) -> void {
+                    size_t i;
+
+                    for (i = n * t / nthread; i < n * (t + 1) / nthread; i++) {
+                        fp->idx->search (reqs[i], hrets[i]);
+                    }
+                });
+            } else {
+                hrets.resize (1);
+                H5VL_log_read_idx_search_reqs (fp, reqs, false, hrets[0]);
+            }
+        }
+
+        // All requests are searched in one pass over the metadata, the next window is read while
+        // the current one is searched
         md = sec = 0;
-        while (md != -1) {  // Until we iterated all metadata datasets
-                            // Load partial metadata
-            H5VL_log_filei_metaupdate_part (fp, md, sec);
+        w = nwin = 0;
+        if (fp->nmdset > 0) { H5VL_log_filei_metawin_start (fp, md, sec, wins[w]); }
+        while (wins[w].md != -1) {  // Until we iterated all metadata datasets
+            if (md != -1) { H5VL_log_filei_metawin_start (fp, md, sec, wins[w ^ 1]); }
+            nwin++;
+
+            if (wins[w].held) {
+                H5VL_log_filei_metawin_free (wins[w]);
+                w ^= 1;
+
+                if (shadow_elim) {
+                    for (r = 0; r < n; r++) {
+                        rets[r].insert (rets[r].end (), hrets[r].begin (), hrets[r].end ());
+                    }
+                } else {
+                    intersecs.insert (intersecs.end (), hrets[0].begin (), hrets[0].end ());
+                }
+                continue;
+            }
+
+            // Load partial metadata
+            H5VL_log_filei_metawin_load (fp, wins[w]);
+            w ^= 1;
+
             // Search index
-            for (auto &r : reqs) { fp->idx->search (r, intersecs); }
+            if (shadow_elim) {
+                H5VL_logi_idx_parallel (nthread, [&] (int t) -> void {
+                    size_t i;
+
+                    for (i = n * t / nthread; i < n * (t + 1) / nthread; i++) {
+                        fp->idx->search (reqs[i], rets[i]);
+                    }
+                });
+            } else {
+                H5VL_log_read_idx_search_reqs (fp, reqs, false, intersecs);
+            }
         }
+
+        if (shadow_elim) {
+            H5VL_logi_idx_parallel (nthread, [&] (int t) -> void {
+                size_t i;
+
+                for (i = n * t / nthread; i < n * (t + 1) / nthread; i++) {
+                    H5VL_logi_idx_shadow_elim (rets[i], 0);
+                }
+            });
+        }
+        for (auto &ret : rets) { intersecs.insert (intersecs.end (), ret.begin (), ret.end ()); }
+
+        // The index holds all the metadata if it fit into one window
+        fp->idxvalid = (nwin == 1);
     }
 }
 
-void H5VL_log_nb_perform_read (H5VL_log_file_t *fp,
-                               std::vector<H5VL_log_rreq_t *> &reqs,
-                               hid_t dxplid) {
-    herr_t err = 0;
+static bool intersect (
+    int ndim, hsize_t *sa, hsize_t *ca, hsize_t *sb, hsize_t *cb, hsize_t *so, hsize_t *co) {
+    int i;
+
+    for (i = 0; i < ndim; i++) {
+        so[i] = std::max (sa[i], sb[i]);
+        co[i] = std::min (sa[i] + ca[i], sb[i] + cb[i]);
+        if (co[i] <= so[i]) return false;
+        co[i] -= so[i];
+    }
+
+    return true;
+}
+
+/*
+ * Decode the selections of a queued write request
+ * Selections shared with an earlier request (SEL_REF) are taken from the referenced request,
+ * selections in the selection dictionary (SEL_DICT) from the dictionary
+ */
+static void H5VL_log_nb_decode_wreq (H5VL_log_file_t *fp,
+                                     H5VL_log_wreq_t *w,
+                                     H5VL_logi_metaentry_t &block) {
+    char *bufp;
+    hsize_t recnum = 0;  // Record number
+    MPI_Offset roff;     // Related offset of the referenced entry
+    std::vector<char> ent (w->meta_buf,
+                           w->meta_buf + w->hdr->meta_size);  // Decoding may swap bytes in place
+
+    // Rebuild the entry with the selection in the dictionary
+    if (w->hdr->flag & H5VL_LOGI_META_FLAG_SEL_DICT) {
+        int32_t flag, sel_size;
+        char *sel;
+        H5VL_logi_meta_hdr *hdr;
+
+        if (!fp->sel_dict.get (*((MPI_Offset *)(w->sel_buf)), &flag, &sel, &sel_size)) {
+            ERR_OUT ("Selection dictionary record not found")
+        }
+        ent.resize (w->sel_buf - w->meta_buf);
+        ent.insert (ent.end (), sel, sel + sel_size);
+        hdr            = (H5VL_logi_meta_hdr *)ent.data ();
+        hdr->meta_size = (int32_t)ent.size ();
+        hdr->flag      = (hdr->flag & ~(H5VL_LOGI_META_FLAG_SEL_DICT)) | flag;
+    }
+
+    if (!(w->hdr->flag & H5VL_LOGI_META_FLAG_SEL_REF)) {
+        H5VL_logi_metaentry_decode (*(fp->dsets_info[w->hdr->did]), ent.data (), block);
+        return;
+    }
+
+    bufp = ent.data () + sizeof (H5VL_logi_meta_hdr);
+    if (w->hdr->flag & H5VL_LOGI_META_FLAG_REC) {
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_llreverse ((uint64_t *)bufp);
+#endif
+        recnum = *((MPI_Offset *)bufp);
+        bufp += sizeof (MPI_Offset);
+    }
+#ifdef WORDS_BIGENDIAN
+    H5VL_logi_llreverse ((uint64_t *)bufp);
+#endif
+    roff = *((MPI_Offset *)bufp);
+
+    // Requests are queued in the order of their metadata offset
+    auto it = std::lower_bound (
+        fp->wreqs.begin (), fp->wreqs.end (), w->meta_off + roff,
+        [] (H5VL_log_wreq_t *a, MPI_Offset off) -> bool { return a->meta_off < off; });
+    if ((it == fp->wreqs.end ()) || ((*it)->meta_off != w->meta_off + roff)) {
+        ERR_OUT ("Referenced write request not found")
+    }
+    H5VL_log_nb_decode_wreq (fp, *it, block);
+
+    // Overwrite first dim if it is rec entry
+    block.hdr = *(w->hdr);
+    if (w->hdr->flag & H5VL_LOGI_META_FLAG_REC) {
+        for (auto &sel : block.sels) {
+            sel.start[0] = recnum;
+            sel.count[0] = 1;
+        }
+    }
+}
+
+/*
+ * Match the read requests against the write requests queued on this process and not yet flushed
+ * Write requests are visited in the order they were posted, so copying the matches in order lets
+ * the latest write win. Filtered data is unfiltered into buffers appended to bufs. If bufs is NULL,
+ * only the regions are matched and zbuf is left NULL.
+ */
+static void H5VL_log_nb_search_pending_writes (H5VL_log_file_t *fp,
+                                               std::vector<H5VL_log_rreq_t *> &reqs,
+                                               std::vector<H5VL_log_idx_search_ret_t> &ret,
+                                               std::vector<char *> *bufs) {
+    int i, j, k;
+    int csize;
+    size_t soff;
+    char *data;  // Unfiltered data of the write request
+    hsize_t os[H5S_MAX_RANK], oc[H5S_MAX_RANK];
+    H5VL_log_dset_info_t *dip;
+    H5VL_logi_metaentry_t block;
+    H5VL_log_idx_search_ret_t cur;
+    std::map<int, std::vector<H5VL_log_rreq_t *>> dreqs;  // Read requests of each dataset
+
+    for (auto r : reqs) { dreqs[r->hdr.did].push_back (r); }
+
+    for (i = fp->nflushed; i < (int)(fp->wreqs.size ()); i++) {
+        H5VL_log_wreq_t *w = fp->wreqs[i];
+
+        auto rs = dreqs.find (w->hdr->did);
+        if (rs == dreqs.end ()) continue;
+        dip = fp->dsets_info[w->hdr->did];
+
+        H5VL_log_nb_decode_wreq (fp, w, block);
+
+        data = w->dbufs[0].xbuf;
+        if (!bufs) {
+            data = NULL;
+        } else if (dip->filters.size ()) {
+            data  = NULL;
+            csize = 0;
+            H5VL_logi_unfilter (dip->filters, w->dbufs[0].xbuf, w->dbufs[0].size, (void **)&data,
+                                &csize);
+            bufs->push_back (data);
+        }
+
+        for (auto r : rs->second) {
+            soff = 0;
+            for (j = 0; j < r->sels->nsel; j++) {
+                for (auto &sel : block.sels) {
+                    if (intersect (r->ndim, sel.start, sel.count, r->sels->starts[j],
+                                   r->sels->counts[j], os, oc)) {
+                        for (k = 0; k < r->ndim; k++) {
+                            cur.dstart[k] = os[k] - sel.start[k];
+                            cur.dsize[k]  = sel.count[k];
+                            cur.mstart[k] = os[k] - r->sels->starts[j][k];
+                            cur.msize[k]  = r->sels->counts[j][k];
+                            cur.count[k]  = oc[k];
+                        }
+                        cur.info  = r->info;
+                        cur.foff  = -1;  // Not in the file
+                        cur.fsize = 0;
+                        cur.zbuf  = data;
+                        cur.doff  = sel.doff;
+                        cur.xsize = block.dsize;
+                        cur.xbuf  = r->xbuf + soff;
+                        ret.push_back (cur);
+                    }
+                }
+                soff += r->sels->get_sel_size (j) * r->esize;
+            }
+        }
+    }
+}
+
+/*
+ * Whether every selected block in the read requests is fully covered by the write requests queued
+ * on this process and not yet flushed, so the requests can be served without a flush
+ * Always false if read-own-writes is disabled.
+ */
+bool H5VL_log_nb_own_writes_cover (H5VL_log_file_t *fp, std::vector<H5VL_log_rreq_t *> &reqs) {
+    int i, j;
+    size_t soff;
+    hsize_t size;
+    std::vector<H5VL_log_idx_search_ret_t> pending;  // Regions written by the queued writes
+    std::vector<H5VL_log_idx_search_ret_t> blocks;   // Selected blocks of the requests
+    H5VL_log_idx_search_ret_t cur;
+
+    if (!(fp->config & H5VL_FILEI_CONFIG_READ_OWN_WRITES)) { return false; }
+    if (fp->wreqs.size () <= (size_t)(fp->nflushed)) {
+        // Nothing queued, covered only if nothing is selected
+        for (auto r : reqs) {
+            if (r->rsize > 0) { return false; }
+        }
+        return true;
+    }
+
+    H5VL_log_nb_search_pending_writes (fp, reqs, pending, NULL);
+
+    // Each selected block as a whole, remove the parts covered by the queued writes
+    for (auto r : reqs) {
+        soff = 0;
+        for (j = 0; j < r->sels->nsel; j++) {
+            size = r->sels->get_sel_size (j);
+            if (size > 0) {
+                for (i = 0; i < r->ndim; i++) {
+                    cur.dstart[i] = 0;
+                    cur.dsize[i]  = r->sels->counts[j][i];
+                    cur.mstart[i] = 0;
+                    cur.msize[i]  = r->sels->counts[j][i];
+                    cur.count[i]  = r->sels->counts[j][i];
+                }
+                cur.info = r->info;
+                cur.xbuf = r->xbuf + soff;
+                blocks.push_back (cur);
+            }
+            soff += size * r->esize;
+        }
+    }
+    H5VL_logi_idx_shadow_cut (blocks, pending);
+
+    return blocks.empty ();
+}
+
+/*
+ * Copy the intersection in an unfiltered data block (block.zbuf) to the request buffer
+ * tbuf must be large enough to hold the intersection
+ */
+static void H5VL_log_nb_unpack_block (H5VL_log_file_t *fp,
+                                      H5VL_log_idx_search_ret_t &block,
+                                      char *tbuf) {
     int mpierr;
     int i;
-    size_t esize;                             // Element size of the user buffer type
-    MPI_Datatype ftype  = MPI_DATATYPE_NULL;  // File type for reading the raw data blocks
-    MPI_Datatype mtype  = MPI_DATATYPE_NULL;  // Memory type for reading the raw data blocks
     MPI_Datatype zftype = MPI_DATATYPE_NULL;  // File type for packing the data
     MPI_Datatype zmtype = MPI_DATATYPE_NULL;  // Memory type for packing the data
     MPI_Datatype zetype = MPI_DATATYPE_NULL;  // Element type for packing the data
     bool compound_zetype =
         false;  // If element type for packing the data is compound (need to be freed)
+    H5VL_logi_err_finally finally ([&zftype, &zmtype, &compound_zetype, &zetype] () -> void {
+        if (zftype != MPI_DATATYPE_NULL) MPI_Type_free (&zftype);
+        if (zmtype != MPI_DATATYPE_NULL) MPI_Type_free (&zmtype);
+        if (compound_zetype && zetype != MPI_DATATYPE_NULL) MPI_Type_free (&zetype);
+    });
+
+    zetype = H5VL_logi_get_mpi_type_by_size (block.info->esize);
+    if (zetype == MPI_DATATYPE_NULL) {
+        mpierr = MPI_Type_contiguous (block.info->esize, MPI_BYTE, &zetype);
+        CHECK_MPIERR
+        mpierr = MPI_Type_commit (&zetype);
+        CHECK_MPIERR
+        compound_zetype = true;
+    }
+
+    mpierr = H5VL_log_debug_MPI_Type_create_subarray (block.info->ndim, block.dsize, block.count,
+                                                      block.dstart, MPI_ORDER_C, zetype, &zftype);
+    CHECK_MPIERR
+    mpierr = H5VL_log_debug_MPI_Type_create_subarray (block.info->ndim, block.msize, block.count,
+                                                      block.mstart, MPI_ORDER_C, zetype, &zmtype);
+
+    CHECK_MPIERR
+    mpierr = MPI_Type_commit (&zftype);
+    CHECK_MPIERR
+    mpierr = MPI_Type_commit (&zmtype);
+    CHECK_MPIERR
+
+    if (compound_zetype) {
+        mpierr = MPI_Type_free (&zetype);
+        CHECK_MPIERR
+    }
+
+    i = 0;
+    MPI_Pack (block.zbuf + block.doff, 1, zftype, tbuf, 1, &i, fp->comm);
+
+    i = 0;
+    MPI_Unpack (tbuf, 1, &i, block.xbuf, 1, zmtype, fp->comm);
+}
+
+void H5VL_log_nb_perform_read (H5VL_log_file_t *fp,
+                               std::vector<H5VL_log_rreq_t *> &reqs,
+                               hid_t dxplid) {
+    herr_t err = 0;
+    int mpierr;
+    int i;
+    size_t esize;                             // Element size of the user buffer type
+    MPI_Datatype ftype = MPI_DATATYPE_NULL;  // File type for reading the raw data blocks
+    MPI_Datatype mtype = MPI_DATATYPE_NULL;  // Memory type for reading the raw data blocks
     std::vector<H5VL_log_idx_search_ret_t>
         intersecs;  // Any intersection between selections in requests and the metadata entries
+    std::vector<H5VL_log_idx_search_ret_t>
+        pending;                // Intersections with the writes queued on this process
+    std::vector<char *> pbufs;  // Unfiltered data of the queued writes
     std::vector<H5VL_log_copy_ctx> overlaps;  // Any overlapping read regions
     std::map<MPI_Offset, char *> bufs;  // Temporary buffers for unfiltering filtered data blocks
     char *tbuf =
         NULL;  // Temporary buffers for packing data from unfiltered data block into request buffer
     size_t tbsize = 0;  // size of tbuf
     MPI_Status stat;
-    H5VL_logi_err_finally finally (
-        [&tbuf, &bufs, &mtype, &ftype, &zftype, &zmtype, &compound_zetype, &zetype] () -> void {
-            free (tbuf);
-            for (auto const &buf : bufs) { free (buf.second); }
-            if (mtype != MPI_DATATYPE_NULL) MPI_Type_free (&mtype);
-            if (ftype != MPI_DATATYPE_NULL) MPI_Type_free (&ftype);
-            if (zftype != MPI_DATATYPE_NULL) MPI_Type_free (&zftype);
-            if (zmtype != MPI_DATATYPE_NULL) MPI_Type_free (&zmtype);
-            if (compound_zetype && zetype != MPI_DATATYPE_NULL) MPI_Type_free (&zetype);
-        });
+    H5VL_logi_err_finally finally ([&tbuf, &bufs, &pbufs, &mtype, &ftype] () -> void {
+        free (tbuf);
+        for (auto const &buf : bufs) { free (buf.second); }
+        for (auto buf : pbufs) { free (buf); }
+        if (mtype != MPI_DATATYPE_NULL) MPI_Type_free (&mtype);
+        if (ftype != MPI_DATATYPE_NULL) MPI_Type_free (&ftype);
+    });
 
     H5VL_LOGI_PROFILING_TIMER_START;
 
     // Search index
     H5VL_log_read_idx_search (fp, reqs, intersecs);
+    fp->stat.read_intersections += intersecs.size ();
+
+    // Serve the parts written by this process but not yet flushed from memory
+    if ((fp->config & H5VL_FILEI_CONFIG_READ_OWN_WRITES) &&
+        (fp->wreqs.size () > (size_t)(fp->nflushed))) {
+        H5VL_log_nb_search_pending_writes (fp, reqs, pending, &pbufs);
+        H5VL_logi_idx_shadow_cut (intersecs, pending);
+        for (auto &block : pending) {
+            if (tbsize < (hsize_t)block.xsize) { tbsize = block.xsize; }
+        }
+    }
 
     // Allocate zbuf for filtered data
     for (auto &block : intersecs) {
@@ -453,47 +867,13 @@ void H5VL_log_nb_perform_read (H5VL_log_file_t *fp,
             }
 
             // Pack from zbuf to xbuf
-            zetype = H5VL_logi_get_mpi_type_by_size (block.info->esize);
-            if (zetype == MPI_DATATYPE_NULL) {
-                mpierr = MPI_Type_contiguous (block.info->esize, MPI_BYTE, &zetype);
-                CHECK_MPIERR
-                mpierr = MPI_Type_commit (&zetype);
-                CHECK_MPIERR
-                compound_zetype = true;
-            } else {
-                compound_zetype = false;
-            }
-
-            mpierr = H5VL_log_debug_MPI_Type_create_subarray (block.info->ndim, block.dsize,
-                                                              block.count, block.dstart,
-                                                              MPI_ORDER_C, zetype, &zftype);
-            CHECK_MPIERR
-            mpierr = H5VL_log_debug_MPI_Type_create_subarray (block.info->ndim, block.msize,
-                                                              block.count, block.mstart,
-                                                              MPI_ORDER_C, zetype, &zmtype);
-
-            CHECK_MPIERR
-            mpierr = MPI_Type_commit (&zftype);
-            CHECK_MPIERR
-            mpierr = MPI_Type_commit (&zmtype);
-            CHECK_MPIERR
-
-            if (compound_zetype) {
-                mpierr = MPI_Type_free (&zetype);
-                CHECK_MPIERR
-            }
-
-            i = 0;
-            MPI_Pack (block.zbuf + block.doff, 1, zftype, tbuf, 1, &i, fp->comm);
-
-            i = 0;
-            MPI_Unpack (tbuf, 1, &i, block.xbuf, 1, zmtype, fp->comm);
-
-            MPI_Type_free (&zftype);
-            MPI_Type_free (&zmtype);
+            H5VL_log_nb_unpack_block (fp, block, tbuf);
         }
     }
 
+    // Copy from the writes queued on this process, they are newer than anything in the file
+    for (auto &block : pending) { H5VL_log_nb_unpack_block (fp, block, tbuf); }
+
     // Post processing
     for (auto &r : reqs) {
         // Type conversion
@@ -573,7 +953,9 @@ void H5VL_log_nb_flush_read_reqs (void *file, std::vector<H5VL_log_rreq_t *> &re
             CHECK_ERR
             // Erase the index table of previous subfile
             fp->idx->clear ();
-            fp->idxvalid = false;
+            fp->idxvalid  = false;
+            fp->idxwin_md = -1;
+            fp->mdsecs.clear ();
 
             // Open the current subfile
             fp->group_id = (group_id + i) % fp->ngroup;
@@ -692,10 +1074,9 @@ void H5VL_log_nb_flush_write_reqs (void *file) {
     } else {
         mtype = MPI_DATATYPE_NULL;
     }
-#ifdef LOGVOL_PROFILING
     H5VL_log_profile_add_time (fp, TIMER_H5VL_LOG_NB_FLUSH_WRITE_REQS_SIZE,
                                (double)(fsize_local) / 1048576);
-#endif
+    fp->stat.data_bytes_written += fsize_local;
 
     H5VL_LOGI_PROFILING_TIMER_STOP (fp, TIMER_H5VL_LOG_NB_FLUSH_WRITE_REQS_INIT);
     H5VL_LOGI_PROFILING_TIMER_START;
@@ -1033,10 +1414,9 @@ void H5VL_log_nb_flush_write_reqs_align (void *file, hid_t dxplid) {
         fsize_local[fp->target_ost] += fp->wreqs[i]->hdr->fsize;
     }
 
-#ifdef LOGVOL_PROFILING
     H5VL_log_profile_add_time (fp, TIMER_H5VL_LOG_NB_FLUSH_WRITE_REQS_SIZE,
                                (double)(fsize_local[fp->target_ost]) / 1048576);
-#endif
+    fp->stat.data_bytes_written += fsize_local[fp->target_ost];
 
     // Get file offset and total size per ost
     mpierr = MPI_Allreduce (fsize_local, fsize_all, fp->scount, MPI_LONG_LONG, MPI_SUM, fp->comm);
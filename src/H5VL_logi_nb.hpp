@@ -20,6 +20,15 @@
 #define H5VL_LOGI_META_FLAG_SEL_DEFLATE 0x08
 #define H5VL_LOGI_META_FLAG_SEL_REF     0x10
 #define H5VL_LOGI_META_FLAG_REC         0x20
+#define H5VL_LOGI_META_FLAG_SEL_POINT   0x40
+#define H5VL_LOGI_META_FLAG_SEL_VARINT  0x80
+#define H5VL_LOGI_META_FLAG_SEL_DICT    0x100
+
+// Flags describing how the selection is stored, kept with the selection in the dictionary
+#define H5VL_LOGI_META_FLAG_SEL_MASK                                                     \
+    (H5VL_LOGI_META_FLAG_MUL_SEL | H5VL_LOGI_META_FLAG_MUL_SELX |                        \
+     H5VL_LOGI_META_FLAG_SEL_ENCODE | H5VL_LOGI_META_FLAG_SEL_DEFLATE |                  \
+     H5VL_LOGI_META_FLAG_SEL_POINT | H5VL_LOGI_META_FLAG_SEL_VARINT)
 
 typedef struct H5VL_log_req_data_block_t {
     char *ubuf;   // User buffer
@@ -59,10 +68,6 @@ class H5VL_log_wreq_t {
     H5VL_log_wreq_t (void *dp, H5VL_log_selections *sels);
     ~H5VL_log_wreq_t ();
 };
-template <>
-struct std::hash<H5VL_log_wreq_t> {
-    size_t operator() (H5VL_log_wreq_t const &s) const noexcept;
-};
 
 struct H5VL_log_dset_t;
 class H5VL_log_selections;
@@ -117,5 +122,6 @@ void H5VL_log_nb_perform_read (H5VL_log_file_t *fp,
                                std::vector<H5VL_log_rreq_t *> &reqs,
                                hid_t dxplid);
 void H5VL_log_nb_flush_write_reqs (void *file);
+bool H5VL_log_nb_own_writes_cover (H5VL_log_file_t *fp, std::vector<H5VL_log_rreq_t *> &reqs);
 void H5VL_log_nb_ost_write (void *file, off_t doff, off_t off, int cnt, int *mlens, off_t *moffs);
 void H5VL_log_nb_flush_write_reqs_align (void *file, hid_t dxplid);
@@ -27,11 +27,19 @@ dnl
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <string>
 #include "H5VL_log_file.hpp"
 #include "H5VL_logi.hpp"
 
 static double tmax[H5VL_LOG_NTIMER], tmin[H5VL_LOG_NTIMER], tmean[H5VL_LOG_NTIMER], tvar[H5VL_LOG_NTIMER], tvar_local[H5VL_LOG_NTIMER];
 
+#ifdef ENABLE_PROFILING
+bool H5VL_log_profile_enabled = true;
+#else
+bool H5VL_log_profile_enabled = false;
+#endif
+
 /*
  * Report performance profiling
  */
@@ -41,9 +49,31 @@ foreach(`t', H5VL_LOG_TIMERS, `"t",
 ')dnl
 };
 
+/*
+ * Turn the timers on or off according to the environment
+ * H5VL_LOG_PROFILING overrides the default chosen at configure time. Asking for a report through
+ * H5VL_LOG_SHOW_PROFILING_INFO or H5VL_LOG_PROFILING_OUTPUT also turns the timers on.
+ */
+void H5VL_log_profile_init (void) {
+    char *env;
+
+    env = getenv ("H5VL_LOG_PROFILING");
+    if (env) {
+        H5VL_log_profile_enabled = (*env != '0');
+        return;
+    }
+
+    env = getenv ("H5VL_LOG_SHOW_PROFILING_INFO");
+    if (env && *env != '0') { H5VL_log_profile_enabled = true; }
+    env = getenv ("H5VL_LOG_PROFILING_OUTPUT");
+    if (env && *env != '\0') { H5VL_log_profile_enabled = true; }
+}
+
 void H5VL_log_profile_add_time (void *file, int id, double t) {
     H5VL_log_file_t *fp = (H5VL_log_file_t *)file;
 
+    if (!H5VL_log_profile_enabled) return;
+
     assert (id >= 0 && id < H5VL_LOG_NTIMER);
     fp->tlocal[id] += t;
     fp->clocal[id]++;
@@ -52,6 +82,8 @@ void H5VL_log_profile_add_time (void *file, int id, double t) {
 void H5VL_log_profile_sub_time (void *file, int id, double t) {
     H5VL_log_file_t *fp = (H5VL_log_file_t *)file;
 
+    if (!H5VL_log_profile_enabled) return;
+
     assert (id >= 0 && id < H5VL_LOG_NTIMER);
     fp->tlocal[id] -= t;
 }
@@ -105,6 +137,78 @@ void H5VL_log_profile_print (void *file) {
         }
     }
 }
+
+/*
+ * Write the min, max, mean, and imbalance (max / mean) of each timer across processes to path
+ * The report is in CSV if path ends with .csv, otherwise in JSON. A %s in path is replaced by the
+ * name of the file. Timers never started on any process are omitted. Collective on the file.
+ */
+void H5VL_log_profile_report (void *file, const char *path) {
+    int i;
+    int np, rank;
+    bool csv;
+    bool first = true;
+    double cmax[H5VL_LOG_NTIMER], cmin[H5VL_LOG_NTIMER], cmean[H5VL_LOG_NTIMER];
+    H5VL_log_file_t *fp = (H5VL_log_file_t *)file;
+    std::string fname   = basename ((char *)(fp->name.c_str ()));
+    std::string opath (path);
+    size_t pos;
+    FILE *out;
+
+    MPI_Comm_size (fp->comm, &np);
+    MPI_Comm_rank (fp->comm, &rank);
+
+    MPI_Reduce (fp->tlocal, tmax, H5VL_LOG_NTIMER, MPI_DOUBLE, MPI_MAX, 0, fp->comm);
+    MPI_Reduce (fp->tlocal, tmin, H5VL_LOG_NTIMER, MPI_DOUBLE, MPI_MIN, 0, fp->comm);
+    MPI_Reduce (fp->tlocal, tmean, H5VL_LOG_NTIMER, MPI_DOUBLE, MPI_SUM, 0, fp->comm);
+    MPI_Reduce (fp->clocal, cmax, H5VL_LOG_NTIMER, MPI_DOUBLE, MPI_MAX, 0, fp->comm);
+    MPI_Reduce (fp->clocal, cmin, H5VL_LOG_NTIMER, MPI_DOUBLE, MPI_MIN, 0, fp->comm);
+    MPI_Reduce (fp->clocal, cmean, H5VL_LOG_NTIMER, MPI_DOUBLE, MPI_SUM, 0, fp->comm);
+    if (rank != 0) return;
+
+    pos = opath.find ("%s");
+    if (pos != std::string::npos) { opath.replace (pos, 2, fname); }
+    csv = opath.size () >= 4 && opath.compare (opath.size () - 4, 4, ".csv") == 0;
+
+    out = fopen (opath.c_str (), "w");
+    if (!out) {
+        printf ("Warning: cannot open profiling report %s\n", opath.c_str ());
+        return;
+    }
+
+    if (csv) {
+        fprintf (out, "file,nprocs,timer,count_min,count_max,count_mean,time_min,time_max,"
+                      "time_mean,time_imbalance\n");
+    } else {
+        fprintf (out, "{\n  \"file\": \"%s\",\n  \"nprocs\": %d,\n  \"timers\": [", fname.c_str (),
+                 np);
+    }
+    for (i = 0; i < H5VL_LOG_NTIMER; i++) {
+        double imb;
+
+        if (cmax[i] == 0 && tmax[i] == 0) continue;
+
+        tmean[i] /= np;
+        cmean[i] /= np;
+        imb = tmean[i] > 0 ? tmax[i] / tmean[i] : 0;
+        if (csv) {
+            fprintf (out, "%s,%d,%s,%.0lf,%.0lf,%lf,%lf,%lf,%lf,%lf\n", fname.c_str (), np,
+                     tname[i], cmin[i], cmax[i], cmean[i], tmin[i], tmax[i], tmean[i], imb);
+        } else {
+            fprintf (out,
+                     "%s\n    {\"name\": \"%s\", "
+                     "\"count\": {\"min\": %.0lf, \"max\": %.0lf, \"mean\": %lf}, "
+                     "\"time\": {\"min\": %lf, \"max\": %lf, \"mean\": %lf, \"imbalance\": %lf}}",
+                     first ? "" : ",", tname[i], cmin[i], cmax[i], cmean[i], tmin[i], tmax[i],
+                     tmean[i], imb);
+        }
+        first = false;
+    }
+    if (!csv) { fprintf (out, "\n  ]\n}\n"); }
+
+    fclose (out);
+}
+
 void H5VL_log_profile_reset (void *file) {
     int i;
     H5VL_log_file_t *fp = (H5VL_log_file_t *)file;
@@ -89,6 +89,7 @@ define(`H5VL_LOG_TIMERS', `( `H5VL_log_file_create', dnl
                             `H5VL_log_filei_metasize_dedup', dnl
                             `H5VL_log_filei_metasize_zip', dnl
                             `H5VL_log_filei_flush', dnl
+                            `H5VL_log_dataseti_put_atts', dnl
                             `H5VL_log_filei_metaflush', dnl
                             `H5VL_log_filei_metaflush_init', dnl
                             `H5VL_log_filei_metaflush_hash', dnl
@@ -105,6 +106,10 @@ define(`H5VL_LOG_TIMERS', `( `H5VL_log_file_create', dnl
                             `H5VL_log_filei_metaflush_size_zip', dnl
                             `H5VL_log_filei_metaflush_repeat_count', dnl
                             `H5VL_log_filei_metaupdate', dnl
+                            `H5VL_log_filei_catalog_write', dnl
+                            `H5VL_log_filei_catalog_read', dnl
+                            `H5VL_log_filei_dictflush', dnl
+                            `H5VL_log_filei_dictload', dnl
                             `H5VL_log_dataseti_readi_gen_rtypes', dnl
                             `H5VL_log_dataseti_open_with_uo', dnl
                             `H5VL_log_dataseti_wrap', dnl
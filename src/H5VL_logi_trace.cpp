@@ -0,0 +1,159 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <libgen.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+//
+#include <mpi.h>
+//
+#include "H5VL_log.h"
+#include "H5VL_log_file.hpp"
+#include "H5VL_logi.hpp"
+#include "H5VL_logi_dataspace.hpp"
+#include "H5VL_logi_trace.hpp"
+
+static inline void H5VL_logi_trace_put (H5VL_logi_trace_t *tp, const void *buf, size_t size) {
+    if (fwrite (buf, 1, size, tp->out) != size) { RET_ERR ("Cannot write the I/O trace") }
+}
+
+// Record type and time stamp
+static inline void H5VL_logi_trace_put_hdr (H5VL_logi_trace_t *tp, uint8_t type) {
+    double t = MPI_Wtime () - tp->t0;
+
+    H5VL_logi_trace_put (tp, &type, sizeof (uint8_t));
+    H5VL_logi_trace_put (tp, &t, sizeof (double));
+}
+
+// Write the DEF record of a dataset the first time it appears in the trace
+static void H5VL_logi_trace_def (H5VL_log_file_t *fp, int did) {
+    int32_t i32;
+    uint64_t u64;
+    H5VL_logi_trace_t *tp     = fp->trace;
+    H5VL_log_dset_info_t *dip = fp->dsets_info[did];
+
+    if (tp->defined.size () <= (size_t)did) { tp->defined.resize (did + 1, false); }
+    if (tp->defined[did]) { return; }
+    tp->defined[did] = true;
+
+    H5VL_logi_trace_put_hdr (tp, H5VL_LOGI_TRACE_DEF);
+    i32 = did;
+    H5VL_logi_trace_put (tp, &i32, sizeof (int32_t));
+    i32 = dip->ndim;
+    H5VL_logi_trace_put (tp, &i32, sizeof (int32_t));
+    u64 = dip->esize;
+    H5VL_logi_trace_put (tp, &u64, sizeof (uint64_t));
+    H5VL_logi_trace_put (tp, dip->dims, sizeof (hsize_t) * dip->ndim);
+    H5VL_logi_trace_put (tp, dip->mdims, sizeof (hsize_t) * dip->ndim);
+}
+
+void H5VL_logi_trace_open (H5VL_log_file_t *fp) {
+    int32_t hdr[3];
+    std::string path;
+    size_t pos;
+
+    fp->trace = NULL;
+
+    // Set by H5Pset_trace or H5VL_LOG_TRACE in H5VL_log_filei_parse_fapl
+    if (fp->trace_path.empty ()) { return; }
+
+    path = fp->trace_path;
+    pos  = path.find ("%s");
+    if (pos != std::string::npos) {
+        path.replace (pos, 2, basename ((char *)(fp->name.c_str ())));
+    }
+    path += "." + std::to_string (fp->rank);
+
+    fp->trace      = new H5VL_logi_trace_t ();
+    fp->trace->t0  = MPI_Wtime ();
+    fp->trace->out = fopen (path.c_str (), "wb");
+    if (!fp->trace->out) {
+        delete fp->trace;
+        fp->trace = NULL;
+        ERR_OUT ("Cannot create the I/O trace")
+    }
+
+    hdr[0] = H5VL_LOGI_TRACE_VERSION;
+    hdr[1] = fp->rank;
+    hdr[2] = fp->np;
+    H5VL_logi_trace_put (fp->trace, H5VL_LOGI_TRACE_MAGIC, 4);
+    H5VL_logi_trace_put (fp->trace, hdr, sizeof (hdr));
+}
+
+void H5VL_logi_trace_close (H5VL_log_file_t *fp) {
+    if (!fp->trace) { return; }
+
+    fclose (fp->trace->out);
+    delete fp->trace;
+    fp->trace = NULL;
+}
+
+void H5VL_logi_trace_io (H5VL_log_file_t *fp,
+                         int type,
+                         int did,
+                         hid_t mem_type_id,
+                         H5VL_log_selections *dsel,
+                         hid_t dxplid) {
+    herr_t err = 0;
+    int i;
+    int32_t i32;
+    uint8_t flag = 0;
+    uint64_t u64;
+    size_t mesize;
+    hbool_t buffered;
+    H5FD_mpio_xfer_t xfer_mode;
+    H5VL_logi_trace_t *tp = fp->trace;
+
+    H5VL_logi_trace_def (fp, did);
+
+    mesize = H5Tget_size (mem_type_id);
+    CHECK_ID (mesize)
+    if (H5Pget_dxpl_mpio (dxplid, &xfer_mode) >= 0 && xfer_mode == H5FD_MPIO_COLLECTIVE) {
+        flag |= H5VL_LOGI_TRACE_FLAG_COLL;
+    }
+    err = H5Pget_buffered (dxplid, &buffered);
+    CHECK_ERR
+    if (buffered) { flag |= H5VL_LOGI_TRACE_FLAG_BUFFERED; }
+
+    H5VL_logi_trace_put_hdr (tp, (uint8_t)type);
+    i32 = did;
+    H5VL_logi_trace_put (tp, &i32, sizeof (int32_t));
+    H5VL_logi_trace_put (tp, &flag, sizeof (uint8_t));
+    u64 = mesize;
+    H5VL_logi_trace_put (tp, &u64, sizeof (uint64_t));
+    u64 = dsel->get_sel_size () * mesize;
+    H5VL_logi_trace_put (tp, &u64, sizeof (uint64_t));
+    i32 = dsel->nsel;
+    H5VL_logi_trace_put (tp, &i32, sizeof (int32_t));
+    for (i = 0; i < dsel->nsel; i++) {
+        H5VL_logi_trace_put (tp, dsel->starts[i], sizeof (hsize_t) * dsel->ndim);
+        H5VL_logi_trace_put (tp, dsel->counts[i], sizeof (hsize_t) * dsel->ndim);
+    }
+}
+
+void H5VL_logi_trace_extent (H5VL_log_file_t *fp, int did, const hsize_t *dims) {
+    int32_t i32;
+    H5VL_logi_trace_t *tp = fp->trace;
+
+    // Define with the size before the extension
+    H5VL_logi_trace_def (fp, did);
+
+    H5VL_logi_trace_put_hdr (tp, H5VL_LOGI_TRACE_EXTENT);
+    i32 = did;
+    H5VL_logi_trace_put (tp, &i32, sizeof (int32_t));
+    H5VL_logi_trace_put (tp, dims, sizeof (hsize_t) * fp->dsets_info[did]->ndim);
+}
+
+void H5VL_logi_trace_flush (H5VL_log_file_t *fp) {
+    H5VL_logi_trace_put_hdr (fp->trace, H5VL_LOGI_TRACE_FLUSH);
+}
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#pragma once
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstdio>
+#include <vector>
+//
+#include <hdf5.h>
+
+/* I/O trace
+ * Enabled by H5Pset_trace or H5VL_LOG_TRACE with a path, %s is replaced by the name of the file.
+ * Every process writes its calls to <path>.<rank> in host byte order. The trace starts with
+ *     char magic[4]; int32 version; int32 rank; int32 np;
+ * followed by records of
+ *     uint8 type; double time;  // Seconds since the file is opened
+ * and, depending on the type,
+ *     DEF:        int32 did; int32 ndim; uint64 esize; uint64 dims[ndim]; uint64 mdims[ndim];
+ *     EXTENT:     int32 did; uint64 dims[ndim];
+ *     WRITE/READ: int32 did; uint8 flag; uint64 mem esize; uint64 bytes; int32 nsel;
+ *                 uint64 start[ndim], count[ndim] of each block;
+ *     FLUSH:      nothing
+ * A dataset is defined by a DEF record before the first record referring to it.
+ */
+#define H5VL_LOGI_TRACE_MAGIC   "H5LT"
+#define H5VL_LOGI_TRACE_VERSION 1
+
+#define H5VL_LOGI_TRACE_DEF    1  // Dataset definition
+#define H5VL_LOGI_TRACE_EXTENT 2  // H5Dset_extent
+#define H5VL_LOGI_TRACE_WRITE  3  // H5Dwrite or H5Dwrite_n
+#define H5VL_LOGI_TRACE_READ   4  // H5Dread or H5Dread_n
+#define H5VL_LOGI_TRACE_FLUSH  5  // H5Fflush
+
+#define H5VL_LOGI_TRACE_FLAG_COLL     0x01  // Collective transfer
+#define H5VL_LOGI_TRACE_FLAG_BUFFERED 0x02  // Buffered (H5Pset_buffered)
+
+struct H5VL_log_file_t;
+class H5VL_log_selections;
+
+typedef struct H5VL_logi_trace_t {
+    FILE *out;                  // Trace file
+    double t0;                  // Time the file is opened
+    std::vector<bool> defined;  // Whether a DEF record is written for each dataset
+} H5VL_logi_trace_t;
+
+void H5VL_logi_trace_open (H5VL_log_file_t *fp);
+void H5VL_logi_trace_close (H5VL_log_file_t *fp);
+void H5VL_logi_trace_io (H5VL_log_file_t *fp,
+                         int type,
+                         int did,
+                         hid_t mem_type_id,
+                         H5VL_log_selections *dsel,
+                         hid_t dxplid);
+void H5VL_logi_trace_extent (H5VL_log_file_t *fp, int did, const hsize_t *dims);
+void H5VL_logi_trace_flush (H5VL_log_file_t *fp);
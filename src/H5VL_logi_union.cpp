@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+//
+#include <hdf5.h>
+//
+#include "H5VL_logi_union.hpp"
+
+/*
+ * Union of the blocks in ids, restricted to dimensions d and above
+ * Blocks are stored as start[ndim] followed by count[ndim] in blocks. The result is a list of
+ * disjoint boxes of dimensions d and above, stored the same way with ndim - d dimensions, sorted by
+ * coordinate. Boxes adjacent along a dimension with identical extents in the lower dimensions are
+ * merged.
+ */
+static void H5VL_logi_union_dim (int ndim,
+                                 int d,
+                                 hsize_t *blocks,
+                                 std::vector<size_t> &ids,
+                                 std::vector<hsize_t> &out) {
+    int sdim = ndim - d;  // Number of dimensions in the result
+    int rdim = sdim - 1;  // Number of dimensions of the sub result
+    size_t j, k, s;
+    std::vector<hsize_t> bps;        // Break points along dimension d
+    std::vector<size_t> active;      // Blocks covering the current slab
+    std::vector<size_t> aids;        // Copy of active to be sorted by the sub union
+    std::vector<hsize_t> sub, psub;  // Union of the current and the previous slab
+    hsize_t pstart = 0, pcount = 0;  // Extent of the previous slab along dimension d
+
+#define H5VL_LOGI_UNION_START(b) (blocks[(b)*2 * ndim + d])
+#define H5VL_LOGI_UNION_END(b)   (blocks[(b)*2 * ndim + d] + blocks[(b)*2 * ndim + ndim + d])
+
+    out.clear ();
+    if (ids.empty ()) return;
+
+    // Sort by start along dimension d
+    std::sort (ids.begin (), ids.end (), [&] (size_t a, size_t b) {
+        return H5VL_LOGI_UNION_START (a) < H5VL_LOGI_UNION_START (b);
+    });
+
+    // Last dimension, merge overlapping and adjacent intervals
+    if (sdim == 1) {
+        hsize_t lo = H5VL_LOGI_UNION_START (ids[0]);
+        hsize_t hi = H5VL_LOGI_UNION_END (ids[0]);
+
+        for (j = 1; j < ids.size (); j++) {
+            if (H5VL_LOGI_UNION_START (ids[j]) > hi) {
+                out.push_back (lo);
+                out.push_back (hi - lo);
+                lo = H5VL_LOGI_UNION_START (ids[j]);
+            }
+            hi = std::max (hi, H5VL_LOGI_UNION_END (ids[j]));
+        }
+        out.push_back (lo);
+        out.push_back (hi - lo);
+        return;
+    }
+
+    // Sweep along dimension d, each slab between two break points is covered by the same blocks
+    for (auto b : ids) {
+        bps.push_back (H5VL_LOGI_UNION_START (b));
+        bps.push_back (H5VL_LOGI_UNION_END (b));
+    }
+    std::sort (bps.begin (), bps.end ());
+    bps.erase (std::unique (bps.begin (), bps.end ()), bps.end ());
+
+    k = 0;
+    for (j = 0; j + 1 < bps.size (); j++) {
+        // Update the blocks covering [bps[j], bps[j + 1])
+        active.erase (std::remove_if (active.begin (), active.end (),
+                                      [&] (size_t b) { return H5VL_LOGI_UNION_END (b) <= bps[j]; }),
+                      active.end ());
+        while (k < ids.size () && H5VL_LOGI_UNION_START (ids[k]) <= bps[j]) {
+            active.push_back (ids[k]);
+            k++;
+        }
+
+        if (active.empty ()) {
+            sub.clear ();
+        } else {
+            aids.assign (active.begin (), active.end ());
+            H5VL_logi_union_dim (ndim, d + 1, blocks, aids, sub);
+        }
+
+        // Same coverage as the previous slab and touching it, extend the previous slab
+        if (pcount && pstart + pcount == bps[j] && sub == psub) {
+            pcount += bps[j + 1] - bps[j];
+            continue;
+        }
+
+        // Emit the previous slab
+        for (s = 0; pcount && s < psub.size (); s += 2 * rdim) {
+            out.push_back (pstart);
+            out.insert (out.end (), psub.begin () + s, psub.begin () + s + rdim);
+            out.push_back (pcount);
+            out.insert (out.end (), psub.begin () + s + rdim, psub.begin () + s + 2 * rdim);
+        }
+
+        psub.swap (sub);
+        pstart = bps[j];
+        pcount = psub.empty () ? 0 : bps[j + 1] - bps[j];
+    }
+    for (s = 0; pcount && s < psub.size (); s += 2 * rdim) {
+        out.push_back (pstart);
+        out.insert (out.end (), psub.begin () + s, psub.begin () + s + rdim);
+        out.push_back (pcount);
+        out.insert (out.end (), psub.begin () + s + rdim, psub.begin () + s + 2 * rdim);
+    }
+
+#undef H5VL_LOGI_UNION_START
+#undef H5VL_LOGI_UNION_END
+}
+
+/*
+ * Replace blocks with disjoint boxes covering the same region, sorted by coordinate
+ * Used by h5lcompact to merge the selections of a dataset and by h5ldump to count the distinct
+ * elements written
+ */
+void H5VL_logi_union (int ndim, std::vector<hsize_t> &blocks) {
+    size_t i;
+    size_t nblock;
+    std::vector<size_t> ids;
+    std::vector<hsize_t> out;
+
+    // Scalar datasets have nothing to merge
+    if (ndim == 0) return;
+
+    // Drop empty blocks
+    nblock = blocks.size () / (2 * ndim);
+    for (i = 0; i < nblock; i++) {
+        hsize_t *count = blocks.data () + i * 2 * ndim + ndim;
+        if (std::find (count, count + ndim, (hsize_t)0) == count + ndim) { ids.push_back (i); }
+    }
+
+    H5VL_logi_union_dim (ndim, 0, blocks.data (), ids, out);
+    blocks.swap (out);
+}
@@ -0,0 +1,18 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#pragma once
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <vector>
+//
+#include <hdf5.h>
+
+// Replace blocks, start[ndim] followed by count[ndim] each, with disjoint boxes covering them
+void H5VL_logi_union (int ndim, std::vector<hsize_t> &blocks);
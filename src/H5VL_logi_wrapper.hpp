@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "H5VL_log_dataset.hpp"
 #include "H5VL_log_obj.hpp"
 #include "H5VL_logi.hpp"
@@ -98,6 +101,35 @@ inline hid_t H5VL_logi_dataset_get_dcpl (H5VL_log_file_t *fp,
     return args.args.get_dcpl.dcpl_id;
 }
 
+// Full path of an object in the under VOL, empty if the object is not linked
+inline std::string H5VL_logi_object_get_name (
+    H5VL_log_file_t *fp, void *obj, H5I_type_t type, hid_t connector_id, hid_t dxpl_id) {
+    herr_t err = 0;
+    H5VL_loc_params_t loc;
+    H5VL_object_get_args_t args;
+    size_t len = 0;
+    std::vector<char> buf;
+
+    loc.obj_type = type;
+    loc.type     = H5VL_OBJECT_BY_SELF;
+
+    args.op_type                = H5VL_OBJECT_GET_NAME;
+    args.args.get_name.buf_size = 0;
+    args.args.get_name.buf      = NULL;
+    args.args.get_name.name_len = &len;
+    err = H5VLobject_get (obj, &loc, connector_id, &args, dxpl_id, NULL);
+    CHECK_ERR
+    if (len == 0) { return std::string (); }
+
+    buf.resize (len + 1);
+    args.args.get_name.buf_size = len + 1;
+    args.args.get_name.buf      = buf.data ();
+    err = H5VLobject_get (obj, &loc, connector_id, &args, dxpl_id, NULL);
+    CHECK_ERR
+
+    return std::string (buf.data (), len);
+}
+
 inline void H5VL_logi_dataset_get_foff (
     H5VL_log_file_t *fp, void *obj, hid_t connector_id, hid_t dxpl_id, haddr_t *off) {
     herr_t err = 0;
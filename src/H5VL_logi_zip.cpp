@@ -202,3 +202,60 @@ void H5VL_log_zip_decompress_alloc (void *in, int in_len, void **out, int *out_l
     // Compressed data
     *out = buf;
 }
+
+/* Deflate stream at the fastest level, created on first use and reset for every later call so
+ * frequent metadata flushes do not pay for allocating the compression state
+ */
+static z_stream *H5VL_log_zip_stream_get (void **strm) {
+    int zerr;
+    z_stream *defstream = (z_stream *)(*strm);
+
+    if (defstream) {
+        zerr = deflateReset (defstream);
+        if (zerr != Z_OK) { ERR_OUT ("deflateReset fail") }
+    } else {
+        defstream = (z_stream *)malloc (sizeof (z_stream));
+        CHECK_PTR (defstream)
+        defstream->zalloc = Z_NULL;
+        defstream->zfree  = Z_NULL;
+        defstream->opaque = Z_NULL;
+        zerr              = deflateInit (defstream, Z_BEST_SPEED);
+        if (zerr != Z_OK) {
+            free (defstream);
+            ERR_OUT ("deflateInit fail")
+        }
+        *strm = defstream;
+    }
+
+    return defstream;
+}
+
+// Upper bound of the compressed size of in_len bytes using the stream at strm
+int H5VL_log_zip_stream_bound (void **strm, int in_len) {
+    return (int)deflateBound (H5VL_log_zip_stream_get (strm), (uLong)in_len);
+}
+
+/* Compress the data at in with the stream at strm and save it to out. out must be at least
+ * H5VL_log_zip_stream_bound bytes, out_len is set to the compressed size
+ */
+void H5VL_log_zip_stream_compress (void **strm, void *in, int in_len, void *out, int *out_len) {
+    int zerr;
+    z_stream *defstream = H5VL_log_zip_stream_get (strm);
+
+    defstream->avail_in  = (uInt) (in_len);
+    defstream->next_in   = (Bytef *)in;
+    defstream->avail_out = (uInt)deflateBound (defstream, (uLong)in_len);
+    defstream->next_out  = (Bytef *)out;
+
+    zerr = deflate (defstream, Z_FINISH);
+    if (zerr != Z_STREAM_END) { ERR_OUT ("deflate fail") }
+
+    *out_len = (int)defstream->total_out;
+}
+
+void H5VL_log_zip_stream_free (void *strm) {
+    if (strm) {
+        deflateEnd ((z_stream *)strm);
+        free (strm);
+    }
+}
@@ -17,4 +17,7 @@ bool H5VL_log_zip_compress (void *in, int in_len, void *out, int *out_len);
 void H5VL_log_zip_compress_alloc (void *in, int in_len, void **out, int *out_len);
 bool H5VL_log_zip_decompress (void *in, int in_len, void *out, int *out_len);
 void H5VL_log_zip_decompress_alloc (void *in, int in_len, void **out, int *out_len);
+int H5VL_log_zip_stream_bound (void **strm, int in_len);
+void H5VL_log_zip_stream_compress (void **strm, void *in, int in_len, void *out, int *out_len);
+void H5VL_log_zip_stream_free (void *strm);
 #endif
@@ -0,0 +1,302 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N    16
+#define FILL -7
+
+/* Dataset information restored on file open
+ * An extendable dataset with a fill value and a dataset in a group are created, the extendable one
+ * is enlarged after being written. The one in the group is opened again before its first handle is
+ * closed. After reopening the file, the dimensions, fill value and data must match what was
+ * written, including after another enlargement in read-write mode.
+ */
+static int check_dims (hid_t dset_id, int ndim, hsize_t *ref) {
+    int i, nerrs = 0;
+    hid_t sid;
+    hsize_t dims[2];
+
+    sid = H5Dget_space (dset_id);
+    if (sid < 0) return 1;
+    if (H5Sget_simple_extent_ndims (sid) != ndim) {
+        printf ("Error. Expect %d dimensions, but got %d\n", ndim, H5Sget_simple_extent_ndims (sid));
+        nerrs++;
+    } else {
+        H5Sget_simple_extent_dims (sid, dims, NULL);
+        for (i = 0; i < ndim; i++) {
+            if (dims[i] != ref[i]) {
+                printf ("Error. Expect dims[%d] = %llu, but got %llu\n", i,
+                        (unsigned long long)ref[i], (unsigned long long)dims[i]);
+                nerrs++;
+            }
+        }
+    }
+    H5Sclose (sid);
+
+    return nerrs;
+}
+
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, rank, np, nerrs = 0;
+    int fill = FILL;
+    int buf[N];
+    herr_t err;
+    hid_t fapl_id = -1, dcpl_id = -1, dxpl_id = -1;
+    hid_t file_id = -1, group_id = -1, dspace_id = -1, mspace_id = -1, dset_id = -1;
+    hid_t dset2_id = -1;
+    hsize_t dims[2], mdims[2], start[2], count[2];
+
+    int mpi_required;
+    MPI_Init_thread (&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "catalog.h5";
+    }
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+#endif
+    SHOW_TEST_INFO ("Dataset catalog")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Extendable dataset with a fill value
+    dims[0]  = np;
+    dims[1]  = N;
+    mdims[0] = H5S_UNLIMITED;
+    mdims[1] = N;
+    dspace_id = H5Screate_simple (2, dims, mdims);
+    CHECK_ERR (dspace_id)
+    dcpl_id = H5Pcreate (H5P_DATASET_CREATE);
+    CHECK_ERR (dcpl_id)
+    count[0] = 1;
+    count[1] = N;
+    err = H5Pset_chunk (dcpl_id, 2, count);
+    CHECK_ERR (err)
+    err = H5Pset_fill_value (dcpl_id, H5T_NATIVE_INT, &fill);
+    CHECK_ERR (err)
+    dset_id = H5Dcreate2 (file_id, "A", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, dcpl_id,
+                          H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // Enlarge the dataset and write the second half
+    dims[0] = np * 2;
+    err = H5Dset_extent (dset_id, dims);
+    CHECK_ERR (err)
+    dspace_id = H5Dget_space (dset_id);
+    CHECK_ERR (dspace_id)
+    start[0] = np + rank;
+    start[1] = 0;
+    err = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    mspace_id = H5Screate_simple (1, count + 1, NULL);
+    CHECK_ERR (mspace_id)
+    for (i = 0; i < N; i++) { buf[i] = rank * N + i; }
+    err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+
+    // Dataset in a group
+    group_id = H5Gcreate2 (file_id, "G", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK_ERR (group_id)
+    dims[0]   = N;
+    dspace_id = H5Screate_simple (1, dims, NULL);
+    CHECK_ERR (dspace_id)
+    dset_id = H5Dcreate2 (group_id, "B", H5T_NATIVE_DOUBLE, dspace_id, H5P_DEFAULT, H5P_DEFAULT,
+                          H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // Open the dataset again before its attributes are written at close
+    dset2_id = H5Dopen2 (file_id, "G/B", H5P_DEFAULT);
+    CHECK_ERR (dset2_id)
+    nerrs += check_dims (dset2_id, 1, dims);
+    err = H5Dclose (dset2_id);
+    CHECK_ERR (err)
+    dset2_id = -1;
+
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err = H5Gclose (group_id);
+    CHECK_ERR (err)
+    group_id = -1;
+
+    err = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    // Reopen, open the datasets in a different order than they were created
+    file_id = H5Fopen (file_name, H5F_ACC_RDWR, fapl_id);
+    CHECK_ERR (file_id)
+
+    dset_id = H5Dopen2 (file_id, "G/B", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    dims[0] = N;
+    nerrs += check_dims (dset_id, 1, dims);
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+
+    dset_id = H5Dopen2 (file_id, "A", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    dims[0] = np * 2;
+    dims[1] = N;
+    nerrs += check_dims (dset_id, 2, dims);
+
+    // Written row and unwritten row
+    dspace_id = H5Dget_space (dset_id);
+    CHECK_ERR (dspace_id)
+    start[0] = np + rank;
+    err = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (buf[i] != rank * N + i) {
+            printf ("Rank %d: Error. Expect buf[%d] = %d, but got %d\n", rank, i, rank * N + i,
+                    buf[i]);
+            nerrs++;
+            break;
+        }
+    }
+    start[0] = rank;
+    err = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (buf[i] != FILL) {
+            printf ("Rank %d: Error. Expect buf[%d] = %d, but got %d\n", rank, i, FILL, buf[i]);
+            nerrs++;
+            break;
+        }
+    }
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // Enlarge again in read-write mode
+    dims[0] = np * 3;
+    err = H5Dset_extent (dset_id, dims);
+    CHECK_ERR (err)
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+    dset_id = H5Dopen2 (file_id, "A", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    nerrs += check_dims (dset_id, 2, dims);
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset2_id != -1) {
+        err = H5Dclose (dset2_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (group_id != -1) {
+        err = H5Gclose (group_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (dcpl_id != -1) {
+        err = H5Pclose (dcpl_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
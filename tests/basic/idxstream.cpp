@@ -0,0 +1,259 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N        1024
+#define M        64  // Elements per queued read
+#define NSESSION 3   // Sessions writing the initial values
+
+// Expected value of element i written by rank
+static int expect (int rank, int i) {
+    int val = rank * N + i + 1;
+
+    if (i % 5 == 0) return val + 100000;  // Rewritten in the last session
+    return val;
+}
+
+/* Metadata index loaded a window at a time
+ * Every rank writes its N elements of a 1-D dataset one at a time over NSESSION file sessions,
+ * element i in session i % NSESSION. Another session rewrites every 5th element, so every session
+ * leaves a metadata dataset. The file is reopened with a metadata buffer size of 1 byte, so every
+ * metadata section is loaded into the index alone. The elements of the rank are read by N / M
+ * queued reads flushed together, then again by one blocking read; newer writes must win.
+ */
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, s, rank, np, nerrs = 0;
+    int buf, *rbuf = NULL;
+    herr_t err;
+    hid_t fapl_id = -1;
+    hid_t file_id = -1, dspace_id = -1, dset_id = -1, mspace_id = -1, dxpl_id = -1;
+    hid_t nb_dxpl_id = -1;
+    hsize_t dims[1], start[1], count[1], stride[1];
+
+    MPI_Init (&argc, &argv);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "idxstream.h5";
+    }
+
+    rbuf = (int *)malloc (sizeof (int) * N);
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+    // Queued reads, flushed by H5Fflush
+    nb_dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (nb_dxpl_id)
+    err = H5Pset_dxpl_mpio (nb_dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+    if (env.native_only == 0) {
+        err = H5Pset_buffered (nb_dxpl_id, true);
+        CHECK_ERR (err)
+    }
+#endif
+    SHOW_TEST_INFO ("Metadata index loaded a window at a time")
+
+    count[0]  = 1;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (s = 0; s <= NSESSION; s++) {
+        // Create or open file
+        if (s == 0) {
+            file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+            CHECK_ERR (file_id)
+
+            dims[0]   = np * N;
+            dspace_id = H5Screate_simple (1, dims, NULL);
+            CHECK_ERR (dspace_id)
+            dset_id = H5Dcreate (file_id, "D", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT,
+                                 H5P_DEFAULT, H5P_DEFAULT);
+            CHECK_ERR (dset_id)
+        } else {
+            file_id = H5Fopen (file_name, H5F_ACC_RDWR, fapl_id);
+            CHECK_ERR (file_id)
+
+            dset_id = H5Dopen2 (file_id, "D", H5P_DEFAULT);
+            CHECK_ERR (dset_id)
+            dspace_id = H5Dget_space (dset_id);
+            CHECK_ERR (dspace_id)
+        }
+
+        // One element at a time
+        for (i = 0; i < N; i++) {
+            if (s < NSESSION) {
+                if (i % NSESSION != s) continue;
+                buf = (i % 5 == 0) ? -1 : expect (rank, i);  // Overwritten later
+            } else {
+                if (i % 5 != 0) continue;
+                buf = expect (rank, i);
+            }
+            start[0] = rank * N + i;
+            err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+            CHECK_ERR (err)
+            err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, &buf);
+            CHECK_ERR (err)
+        }
+
+        // Close file
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+        dspace_id = -1;
+        err       = H5Dclose (dset_id);
+        CHECK_ERR (err)
+        dset_id = -1;
+        err     = H5Fclose (file_id);
+        CHECK_ERR (err)
+        file_id = -1;
+    }
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+
+#ifdef TEST_H5VL_LOG
+    // Load one metadata section at a time
+    if (env.native_only == 0 && getenv ("H5VL_LOG_IDX_BSIZE") == NULL) {
+        setenv ("H5VL_LOG_IDX_BSIZE", "1", 1);
+    }
+#endif
+
+    // Open file
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+    dset_id = H5Dopen2 (file_id, "D", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    dspace_id = H5Dget_space (dset_id);
+    CHECK_ERR (dspace_id)
+
+    // M elements of the rank per read, all searched in one pass when flushed
+    count[0]  = M;
+    stride[0] = 1;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (i = 0; i < N / M; i++) {
+        start[0] = rank * N + i * M;
+        err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, stride, count, NULL);
+        CHECK_ERR (err)
+        err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, nb_dxpl_id, rbuf + i * M);
+        CHECK_ERR (err)
+    }
+    err = H5Fflush (file_id, H5F_SCOPE_GLOBAL);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (rbuf[i] != expect (rank, i)) {
+            printf ("Rank %d: Error. Queued read expect D[%d] = %d, but got %d\n", rank,
+                    rank * N + i, expect (rank, i), rbuf[i]);
+            nerrs++;
+            break;
+        }
+    }
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+
+    // All elements of the rank at once, the metadata is loaded again
+    for (i = 0; i < N; i++) { rbuf[i] = 0; }
+    start[0]  = rank * N;
+    count[0]  = N;
+    err       = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, rbuf);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (rbuf[i] != expect (rank, i)) {
+            printf ("Rank %d: Error. Expect D[%d] = %d, but got %d\n", rank, rank * N + i,
+                    expect (rank, i), rbuf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+    if (nb_dxpl_id != -1) {
+        err = H5Pclose (nb_dxpl_id);
+        CHECK_ERR (err)
+    }
+    free (rbuf);
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
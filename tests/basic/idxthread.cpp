@@ -0,0 +1,262 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N 4096
+#define M 64  // Elements per queued read
+
+// Expected value of element i written by rank
+static int expect (int rank, int i) {
+    int val = rank * N + i + 1;
+
+    if (i % 7 == 0) return val + 100000;  // Rewritten
+    return val;
+}
+
+/* Index built and searched by multiple threads
+ * Every rank writes its N elements of a 1-D dataset one at a time, interleaved with other ranks,
+ * then rewrites every 7th element. Metadata sharing turns the rewrites into entries referring to
+ * earlier ones. After reopening the file, the index is built by 4 threads and the elements of the
+ * rank are read back, newer writes must win. The elements are then read again by N / M queued
+ * reads flushed together, which are searched by the 4 threads.
+ */
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, rank, np, nerrs = 0;
+    int nthread;
+    int buf, *rbuf = NULL;
+    herr_t err;
+    hid_t fapl_id = -1, fapl2_id = -1;
+    hid_t file_id = -1, dspace_id = -1, dset_id = -1, mspace_id = -1, dxpl_id = -1;
+    hid_t nb_dxpl_id = -1;
+    hsize_t dims[1], start[1], count[1], stride[1];
+
+    int mpi_required;
+    MPI_Init_thread (&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "idxthread.h5";
+    }
+
+    rbuf = (int *)malloc (sizeof (int) * N);
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+    // Queued reads, flushed by H5Fflush
+    nb_dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (nb_dxpl_id)
+    err = H5Pset_dxpl_mpio (nb_dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+    if (env.native_only == 0) {
+        err = H5Pset_meta_share (fapl_id, true);
+        CHECK_ERR (err)
+        err = H5Pset_idx_nthread (fapl_id, 4);
+        CHECK_ERR (err)
+        err = H5Pset_buffered (nb_dxpl_id, true);
+        CHECK_ERR (err)
+    }
+#endif
+    SHOW_TEST_INFO ("Index built and searched by multiple threads")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    dims[0]   = np * N;
+    dspace_id = H5Screate_simple (1, dims, NULL);
+    CHECK_ERR (dspace_id)
+    dset_id = H5Dcreate (file_id, "D", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, H5P_DEFAULT,
+                         H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+
+    // One element at a time, then every 7th element again
+    count[0]  = 1;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (i = 0; i < N + (N + 6) / 7; i++) {
+        start[0] = (i < N ? i : (i - N) * 7) * np + rank;
+        err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+        CHECK_ERR (err)
+        if (i < N) {
+            buf = (i % 7 == 0) ? -1 : expect (rank, i);  // Overwritten later
+        } else {
+            buf = expect (rank, (i - N) * 7);
+        }
+        err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, &buf);
+        CHECK_ERR (err)
+    }
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+    err       = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // Close file
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err     = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    // Open file
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+
+#ifdef TEST_H5VL_LOG
+    // The setting is reported in the file access property list
+    if (env.native_only == 0 && getenv ("H5VL_LOG_IDX_NTHREAD") == NULL) {
+        fapl2_id = H5Fget_access_plist (file_id);
+        CHECK_ERR (fapl2_id)
+        err = H5Pget_idx_nthread (fapl2_id, &nthread);
+        CHECK_ERR (err)
+        EXP_VAL (nthread, 4)
+        err = H5Pclose (fapl2_id);
+        CHECK_ERR (err)
+        fapl2_id = -1;
+    }
+#endif
+
+    dset_id = H5Dopen2 (file_id, "D", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    dspace_id = H5Dget_space (dset_id);
+    CHECK_ERR (dspace_id)
+
+    // All elements of the rank at once
+    start[0]  = rank;
+    stride[0] = np;
+    count[0]  = N;
+    err       = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, stride, count, NULL);
+    CHECK_ERR (err)
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, rbuf);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (rbuf[i] != expect (rank, i)) {
+            printf ("Rank %d: Error. Expect D[%d] = %d, but got %d\n", rank, i * np + rank,
+                    expect (rank, i), rbuf[i]);
+            nerrs++;
+            break;
+        }
+    }
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+
+    // M elements of the rank per read, all searched together when flushed
+    for (i = 0; i < N; i++) { rbuf[i] = 0; }
+    count[0]  = M;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (i = 0; i < N / M; i++) {
+        start[0] = i * M * np + rank;
+        err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, stride, count, NULL);
+        CHECK_ERR (err)
+        err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, nb_dxpl_id, rbuf + i * M);
+        CHECK_ERR (err)
+    }
+    err = H5Fflush (file_id, H5F_SCOPE_GLOBAL);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (rbuf[i] != expect (rank, i)) {
+            printf ("Rank %d: Error. Queued read expect D[%d] = %d, but got %d\n", rank,
+                    i * np + rank, expect (rank, i), rbuf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (fapl2_id != -1) {
+        err = H5Pclose (fapl2_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+    if (nb_dxpl_id != -1) {
+        err = H5Pclose (nb_dxpl_id);
+        CHECK_ERR (err)
+    }
+    free (rbuf);
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
@@ -0,0 +1,197 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N 32
+
+/* Querying I/O statistics
+ * Every rank writes a row, then checks the pending request count before the flush, the data size
+ * written by the flush, and the metadata size, index size, and intersections after reading the row
+ * back.
+ */
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, rank, np, nerrs = 0;
+    int buf[N];
+    bool query = false;
+    herr_t err;
+    hid_t fapl_id = -1;
+    hid_t file_id = -1, dspace_id = -1, dset_id = -1, mspace_id = -1, dxpl_id = -1;
+    hsize_t dims[2], start[2], count[2];
+#ifdef TEST_H5VL_LOG
+    H5VL_log_io_stat_t stat;
+#endif
+
+    int mpi_required;
+    MPI_Init_thread (&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "iostat.h5";
+    }
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+    // Statistics are only kept for log-based files
+    query = (env.native_only == 0) && (env.passthru == 0) &&
+            (env.connector == 0 || env.log_env == 1);
+#endif
+    SHOW_TEST_INFO ("I/O statistics")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Define dataset
+    dims[0]   = np;
+    dims[1]   = N;
+    dspace_id = H5Screate_simple (2, dims, NULL);  // Dataset space
+    CHECK_ERR (dspace_id)
+    dset_id = H5Dcreate (file_id, "M", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, H5P_DEFAULT,
+                         H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+
+    count[0]  = N;
+    mspace_id = H5Screate_simple (1, count, NULL);  // Memory space for I/O
+    CHECK_ERR (mspace_id)
+
+    start[0] = rank;
+    start[1] = 0;
+    count[0] = 1;
+    count[1] = N;
+    err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+
+    for (i = 0; i < N; i++) { buf[i] = rank * N + i; }
+    err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    if (query) {
+        err = H5Fget_io_stat (file_id, &stat);
+        CHECK_ERR (err)
+        EXP_VAL (stat.pending_reqs, 1)
+        EXP_VAL (stat.nflush, 0)
+        EXP_VAL (stat.data_bytes_written, 0)
+        if (stat.pending_meta_bytes == 0) { RET_ERR ("Pending metadata size is 0") }
+    }
+#endif
+
+    err = H5Fflush (file_id, H5F_SCOPE_GLOBAL);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    if (query) {
+        err = H5Fget_io_stat (file_id, &stat);
+        CHECK_ERR (err)
+        EXP_VAL (stat.pending_reqs, 0)
+        EXP_VAL (stat.nflush, 1)
+        EXP_VAL (stat.data_bytes_written, sizeof (int) * N)
+    }
+#endif
+
+    // Read the row back, the metadata is written before the read
+    for (i = 0; i < N; i++) { buf[i] = -1; }
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (buf[i] != rank * N + i) {
+            printf ("Rank %d: Error. Expect buf[%d] = %d, but got %d\n", rank, i, rank * N + i,
+                    buf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+#ifdef TEST_H5VL_LOG
+    if (query) {
+        err = H5Fget_io_stat (file_id, &stat);
+        CHECK_ERR (err)
+        EXP_VAL (stat.pending_meta_bytes, 0)
+        EXP_VAL (stat.read_intersections, 1)
+        if (stat.meta_bytes_written == 0) { RET_ERR ("Metadata size written is 0") }
+        if (stat.idx_bytes == 0) { RET_ERR ("Index size is 0") }
+    }
+#endif
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N 1200
+
+/* Scattered point selection that is logged as a point list
+ * Every rank writes the columns c of its row where c % 3 != 2, which makes 2-element row segments
+ * separated by gaps. The row is then read back with a hyperslab selection.
+ */
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, j, rank, np, nerrs=0, npoint;
+    int *buf = NULL;
+    herr_t err;
+    hid_t fapl_id=-1;
+    hid_t file_id=-1, dspace_id=-1, dset_id=-1, mspace_id=-1, dxpl_id=-1;
+    hsize_t dims[2], start[2], count[2];
+    hsize_t *cords = NULL;
+
+    int mpi_required;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "pointlist.h5";
+    }
+
+    buf   = (int *)malloc (sizeof (int) * N);
+    cords = (hsize_t *)malloc (sizeof (hsize_t) * N * 2);
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env(&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid=H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+#endif
+    SHOW_TEST_INFO ("Point list selection")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Define dataset
+    dims[0]   = np;
+    dims[1]   = N;
+    dspace_id = H5Screate_simple (2, dims, NULL);  // Dataset space
+    CHECK_ERR (dspace_id)
+    dset_id = H5Dcreate (file_id, "M", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+
+    // Select points
+    npoint = 0;
+    for (i = 0; i < N; i++) {
+        if (i % 3 == 2) continue;
+        cords[npoint * 2]     = rank;
+        cords[npoint * 2 + 1] = i;
+        buf[npoint]           = rank * N + i + 1;
+        npoint++;
+    }
+    err = H5Sselect_elements (dspace_id, H5S_SELECT_SET, npoint, cords);
+    CHECK_ERR (err)
+    count[0]  = npoint;
+    mspace_id = H5Screate_simple (1, count, NULL);  // Memory space for I/O
+    CHECK_ERR (mspace_id)
+
+    err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+
+    // Close file
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    // Open file
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Open dataset
+    dset_id = H5Dopen2 (file_id, "M", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+
+    // Read the whole row
+    start[0] = rank;
+    start[1] = 0;
+    count[0] = 1;
+    count[1] = N;
+    err = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    mspace_id = H5Screate_simple (1, count + 1, NULL);
+    CHECK_ERR (mspace_id)
+
+    for (i = 0; i < N; i++) { buf[i] = -1; }
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+
+    for (i = 0; i < N; i++) {
+        if (i % 3 == 2) continue;
+        j = rank * N + i + 1;
+        if (buf[i] != j) {
+            printf ("Rank %d: Error. Expect buf[%d] = %d, but got %d\n", rank, i, j, buf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+    free (buf);
+    free (cords);
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
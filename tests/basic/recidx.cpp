@@ -0,0 +1,267 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N    8
+#define NREC 8
+
+// Expected value of column i of record r written by rank
+static int expect (int rank, int r, int i) {
+    int val = (rank * NREC + r) * N + i + 1;
+
+    if (r == 2) return val + 10000;  // Record 2 is rewritten
+    if (r == 4) return val + 20000;  // Non-record write of records 4 and 5
+    if (r == 5) return val + 30000;  // Record 5 is rewritten after that
+    return val;
+}
+
+/* Record index
+ * Every rank writes its N columns of NREC records one record at a time. It then rewrites record 2,
+ * writes records 4 and 5 with one non-record entry, and rewrites record 5 again. After reopening
+ * the file, the records are read one at a time and as a range, newer writes must win.
+ */
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, r, rank, np, nerrs = 0;
+    int buf[2 * N], rbuf[NREC * N];
+    herr_t err;
+    hid_t fapl_id = -1, dcpl_id = -1;
+    hid_t file_id = -1, dspace_id = -1, dset_id = -1, mspace_id = -1, dxpl_id = -1;
+    hsize_t dims[2], mdims[2], start[2], count[2];
+
+    int mpi_required;
+    MPI_Init_thread (&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "recidx.h5";
+    }
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+#endif
+    SHOW_TEST_INFO ("Record index")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Record dataset, N columns per rank
+    dims[0]   = NREC;
+    dims[1]   = np * N;
+    mdims[0]  = H5S_UNLIMITED;
+    mdims[1]  = np * N;
+    dspace_id = H5Screate_simple (2, dims, mdims);
+    CHECK_ERR (dspace_id)
+    dcpl_id = H5Pcreate (H5P_DATASET_CREATE);
+    CHECK_ERR (dcpl_id)
+    count[0] = 1;
+    count[1] = N;
+    err      = H5Pset_chunk (dcpl_id, 2, count);
+    CHECK_ERR (err)
+    dset_id =
+        H5Dcreate (file_id, "R", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+
+    // One record at a time
+    count[0]  = N;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (r = 0; r < NREC + 2; r++) {
+        // Records 0 to NREC - 1, then record 2 and 5 again
+        start[0] = r < NREC ? r : (r == NREC ? 2 : 5);
+        start[1] = rank * N;
+        count[0] = 1;
+        count[1] = N;
+        err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+        CHECK_ERR (err)
+        for (i = 0; i < N; i++) { buf[i] = expect (rank, (int)(start[0]), i); }
+        if (r == 2 || r == 4 || r == 5) {  // Overwritten later
+            for (i = 0; i < N; i++) { buf[i] = -1; }
+        }
+        err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+        CHECK_ERR (err)
+
+        // Records 4 and 5 in one non-record entry, between the two rewrites
+        if (r == NREC) {
+            err = H5Sclose (mspace_id);
+            CHECK_ERR (err)
+            count[0]  = 2 * N;
+            mspace_id = H5Screate_simple (1, count, NULL);
+            CHECK_ERR (mspace_id)
+
+            start[0] = 4;
+            count[0] = 2;
+            err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+            CHECK_ERR (err)
+            for (i = 0; i < N; i++) {
+                buf[i]     = expect (rank, 4, i);
+                buf[N + i] = -1;
+            }
+            err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+            CHECK_ERR (err)
+
+            err = H5Sclose (mspace_id);
+            CHECK_ERR (err)
+            count[0]  = N;
+            mspace_id = H5Screate_simple (1, count, NULL);
+            CHECK_ERR (mspace_id)
+        }
+    }
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+    err       = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // Close file
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err     = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    // Open file
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+    dset_id = H5Dopen2 (file_id, "R", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    dspace_id = H5Dget_space (dset_id);
+    CHECK_ERR (dspace_id)
+
+    // One record at a time
+    count[0]  = N;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (r = 0; r < NREC; r++) {
+        start[0] = r;
+        start[1] = rank * N;
+        count[0] = 1;
+        count[1] = N;
+        err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+        CHECK_ERR (err)
+        err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, rbuf);
+        CHECK_ERR (err)
+        for (i = 0; i < N; i++) {
+            if (rbuf[i] != expect (rank, r, i)) {
+                printf ("Rank %d: Error. Expect R[%d][%d] = %d, but got %d\n", rank, r, i,
+                        expect (rank, r, i), rbuf[i]);
+                nerrs++;
+                break;
+            }
+        }
+    }
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+
+    // Records 1 to NREC - 2 at once
+    start[0] = 1;
+    start[1] = rank * N;
+    count[0] = NREC - 2;
+    count[1] = N;
+    err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    count[0]  = (NREC - 2) * N;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, rbuf);
+    CHECK_ERR (err)
+    for (r = 1; r < NREC - 1; r++) {
+        for (i = 0; i < N; i++) {
+            if (rbuf[(r - 1) * N + i] != expect (rank, r, i)) {
+                printf ("Rank %d: Error. Expect R[%d][%d] = %d, but got %d\n", rank, r, i,
+                        expect (rank, r, i), rbuf[(r - 1) * N + i]);
+                nerrs++;
+                break;
+            }
+        }
+    }
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (dcpl_id != -1) {
+        err = H5Pclose (dcpl_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
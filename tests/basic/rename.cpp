@@ -0,0 +1,260 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N 16
+
+/* Datasets renamed before the file is reopened
+ * Dataset A is created in group G and dataset B in the root group. B is renamed to C while it is
+ * still open, then opened again by its new name. Group G is renamed to H and dataset D is created
+ * and deleted. After reopening the file, H/A and C must hold what was written, and the old names
+ * must be gone.
+ */
+static int check_data (hid_t dset_id, int rank, int np, int base) {
+    int i, nerrs = 0;
+    int buf[N];
+    herr_t err;
+    hid_t sid = -1, msid = -1;
+    hsize_t dims[1], start[1], count[1];
+
+    sid = H5Dget_space (dset_id);
+    CHECK_ERR (sid)
+    H5Sget_simple_extent_dims (sid, dims, NULL);
+    if (dims[0] != (hsize_t)np * N) {
+        printf ("Rank %d: Error. Expect %d elements, but got %llu\n", rank, np * N,
+                (unsigned long long)dims[0]);
+        nerrs++;
+        goto err_out;
+    }
+
+    start[0] = rank * N;
+    count[0] = N;
+    err      = H5Sselect_hyperslab (sid, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    msid = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (msid)
+    err = H5Dread (dset_id, H5T_NATIVE_INT, msid, sid, H5P_DEFAULT, buf);
+    CHECK_ERR (err)
+    for (i = 0; i < N; i++) {
+        if (buf[i] != base + rank * N + i) {
+            printf ("Rank %d: Error. Expect buf[%d] = %d, but got %d\n", rank, i,
+                    base + rank * N + i, buf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+err_out:
+    if (sid != -1) H5Sclose (sid);
+    if (msid != -1) H5Sclose (msid);
+    return nerrs;
+}
+
+// Create a 1-D dataset of np * N integers and write base + i at element i
+static hid_t create_dset (hid_t loc_id, const char *name, int rank, int np, int base) {
+    int i, nerrs = 0;
+    int buf[N];
+    herr_t err;
+    hid_t sid = -1, msid = -1, did = -1;
+    hsize_t dims[1], start[1], count[1];
+
+    dims[0] = np * N;
+    sid     = H5Screate_simple (1, dims, NULL);
+    CHECK_ERR (sid)
+    did = H5Dcreate2 (loc_id, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK_ERR (did)
+
+    start[0] = rank * N;
+    count[0] = N;
+    err      = H5Sselect_hyperslab (sid, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    msid = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (msid)
+    for (i = 0; i < N; i++) { buf[i] = base + rank * N + i; }
+    err = H5Dwrite (did, H5T_NATIVE_INT, msid, sid, H5P_DEFAULT, buf);
+    CHECK_ERR (err)
+
+err_out:
+    if (sid != -1) H5Sclose (sid);
+    if (msid != -1) H5Sclose (msid);
+    if (nerrs && did != -1) {
+        H5Dclose (did);
+        did = -1;
+    }
+    return did;
+}
+
+int main (int argc, char **argv) {
+    const char *file_name;
+    int rank, np, nerrs = 0;
+    herr_t err;
+    htri_t exists;
+    hid_t fapl_id = -1;
+    hid_t file_id = -1, group_id = -1, dset_id = -1, dset2_id = -1;
+
+    int mpi_required;
+    MPI_Init_thread (&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "rename.h5";
+    }
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+#endif
+    SHOW_TEST_INFO ("Rename datasets")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Dataset in a group
+    group_id = H5Gcreate2 (file_id, "G", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK_ERR (group_id)
+    dset_id = create_dset (group_id, "A", rank, np, 0);
+    CHECK_ERR (dset_id)
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err     = H5Gclose (group_id);
+    CHECK_ERR (err)
+    group_id = -1;
+
+    // Rename a dataset while it is open, then open it again by the new name
+    dset_id = create_dset (file_id, "B", rank, np, 1000);
+    CHECK_ERR (dset_id)
+    err = H5Lmove (file_id, "B", file_id, "C", H5P_DEFAULT, H5P_DEFAULT);
+    CHECK_ERR (err)
+    dset2_id = H5Dopen2 (file_id, "C", H5P_DEFAULT);
+    CHECK_ERR (dset2_id)
+    err = H5Dclose (dset2_id);
+    CHECK_ERR (err)
+    dset2_id = -1;
+    err      = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+
+    // Rename the group
+    err = H5Lmove (file_id, "G", file_id, "H", H5P_DEFAULT, H5P_DEFAULT);
+    CHECK_ERR (err)
+
+    // Delete a dataset
+    dset_id = create_dset (file_id, "D", rank, np, 2000);
+    CHECK_ERR (dset_id)
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err     = H5Ldelete (file_id, "D", H5P_DEFAULT);
+    CHECK_ERR (err)
+
+    err = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    // Reopen, the datasets are found by their new names
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+
+    dset_id = H5Dopen2 (file_id, "H/A", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    nerrs += check_data (dset_id, rank, np, 0);
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+
+    dset_id = H5Dopen2 (file_id, "C", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    nerrs += check_data (dset_id, rank, np, 1000);
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+
+    // Old names are gone
+    exists = H5Lexists (file_id, "B", H5P_DEFAULT);
+    if (exists != 0) {
+        printf ("Rank %d: Error. B exists after being renamed\n", rank);
+        nerrs++;
+    }
+    exists = H5Lexists (file_id, "G", H5P_DEFAULT);
+    if (exists != 0) {
+        printf ("Rank %d: Error. G exists after being renamed\n", rank);
+        nerrs++;
+    }
+    exists = H5Lexists (file_id, "D", H5P_DEFAULT);
+    if (exists != 0) {
+        printf ("Rank %d: Error. D exists after being deleted\n", rank);
+        nerrs++;
+    }
+
+err_out:
+    if (dset2_id != -1) {
+        err = H5Dclose (dset2_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (group_id != -1) {
+        err = H5Gclose (group_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
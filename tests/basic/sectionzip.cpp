@@ -0,0 +1,276 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N 16
+
+/* Section-level metadata compression
+ * Every rank writes its 4 rows of dataset D one row at a time, then flushes the file. After that,
+ * only even ranks write their rows of dataset E as 2 x 2 tiles, so odd ranks contribute empty
+ * metadata sections. The data is read back after reopening the file.
+ */
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, j, rank, np, nerrs = 0;
+    int buf[4 * N], rbuf[4 * N];
+    herr_t err;
+    hbool_t zip;
+    hid_t fapl_id = -1, fapl2_id = -1;
+    hid_t file_id = -1, dspace_id = -1, dset_id[2] = {-1, -1}, mspace_id = -1, dxpl_id = -1;
+    hsize_t dims[2], start[2], count[2], block[2], stride[2];
+
+    int mpi_required;
+    MPI_Init_thread (&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "sectionzip.h5";
+    }
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+    if (env.native_only == 0) {
+        err = H5Pset_meta_section_zip (fapl_id, true);
+        CHECK_ERR (err)
+        err = H5Pset_meta_share (fapl_id, true);
+        CHECK_ERR (err)
+    }
+#endif
+    SHOW_TEST_INFO ("Section-level metadata compression")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+#ifdef TEST_H5VL_LOG
+    // The setting is reported in the file access property list, it is ignored without zlib
+    if (H5VL_LOG_HAVE_METADATA_COMPRESSION && env.native_only == 0 &&
+        getenv ("H5VL_LOG_METADATA_SECTION_ZIP") == NULL) {
+        fapl2_id = H5Fget_access_plist (file_id);
+        CHECK_ERR (fapl2_id)
+        err = H5Pget_meta_section_zip (fapl2_id, &zip);
+        CHECK_ERR (err)
+        EXP_VAL (zip, true)
+        err = H5Pclose (fapl2_id);
+        CHECK_ERR (err)
+        fapl2_id = -1;
+    }
+#endif
+
+    // 4 rows per rank
+    dims[0]   = np * 4;
+    dims[1]   = N;
+    dspace_id = H5Screate_simple (2, dims, NULL);
+    CHECK_ERR (dspace_id)
+    dset_id[0] = H5Dcreate (file_id, "D", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, H5P_DEFAULT,
+                            H5P_DEFAULT);
+    CHECK_ERR (dset_id[0])
+    dset_id[1] = H5Dcreate (file_id, "E", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, H5P_DEFAULT,
+                            H5P_DEFAULT);
+    CHECK_ERR (dset_id[1])
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    for (i = 0; i < 4 * N; i++) { buf[i] = rank * 4 * N + i + 1; }
+
+    // One entry per row
+    dspace_id = H5Dget_space (dset_id[0]);
+    CHECK_ERR (dspace_id)
+    count[0]  = N;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (i = 0; i < 4; i++) {
+        start[0] = rank * 4 + i;
+        start[1] = 0;
+        count[0] = 1;
+        count[1] = N;
+        err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+        CHECK_ERR (err)
+        err = H5Dwrite (dset_id[0], H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf + i * N);
+        CHECK_ERR (err)
+    }
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+    err       = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // First metadata dataset
+    err = H5Fflush (file_id, H5F_SCOPE_GLOBAL);
+    CHECK_ERR (err)
+
+    // 2 x 2 tiles on the even columns, odd ranks write nothing
+    dspace_id = H5Dget_space (dset_id[1]);
+    CHECK_ERR (dspace_id)
+    start[0]  = rank * 4;
+    start[1]  = 0;
+    stride[0] = 2;
+    stride[1] = 4;
+    count[0]  = 2;
+    count[1]  = N / 4;
+    block[0]  = 2;
+    block[1]  = 2;
+    err       = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, stride, count, block);
+    CHECK_ERR (err)
+    if (rank % 2) {
+        err = H5Sselect_none (dspace_id);
+        CHECK_ERR (err)
+        count[0] = 0;
+    } else {
+        count[0] = 2 * N;
+    }
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    err = H5Dwrite (dset_id[1], H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+    err       = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // Close file
+    for (i = 0; i < 2; i++) {
+        err = H5Dclose (dset_id[i]);
+        CHECK_ERR (err)
+        dset_id[i] = -1;
+    }
+    err = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    // Open file
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+    dset_id[0] = H5Dopen2 (file_id, "D", H5P_DEFAULT);
+    CHECK_ERR (dset_id[0])
+    dset_id[1] = H5Dopen2 (file_id, "E", H5P_DEFAULT);
+    CHECK_ERR (dset_id[1])
+
+    // Read the rows of the rank
+    count[0]  = 4 * N;
+    mspace_id = H5Screate_simple (1, count, NULL);
+    CHECK_ERR (mspace_id)
+    dspace_id = H5Dget_space (dset_id[0]);
+    CHECK_ERR (dspace_id)
+    start[0] = rank * 4;
+    start[1] = 0;
+    count[0] = 4;
+    count[1] = N;
+    err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    err = H5Dread (dset_id[0], H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, rbuf);
+    CHECK_ERR (err)
+    for (i = 0; i < 4 * N; i++) {
+        if (rbuf[i] != buf[i]) {
+            printf ("Rank %d: Error. Expect D[%d] = %d, but got %d\n", rank, i, buf[i], rbuf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+    err = H5Dread (dset_id[1], H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, rbuf);
+    CHECK_ERR (err)
+    if (rank % 2 == 0) {
+        for (i = 0, j = 0; i < 4 * N; i++) {
+            if ((i % N) % 4 >= 2) continue;  // Not written
+            if (rbuf[i] != buf[j]) {
+                printf ("Rank %d: Error. Expect E[%d] = %d, but got %d\n", rank, i, buf[j],
+                        rbuf[i]);
+                nerrs++;
+                break;
+            }
+            j++;
+        }
+    }
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    for (i = 0; i < 2; i++) {
+        if (dset_id[i] != -1) {
+            err = H5Dclose (dset_id[i]);
+            CHECK_ERR (err)
+        }
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (fapl2_id != -1) {
+        err = H5Pclose (fapl2_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
@@ -0,0 +1,203 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N     64
+#define NSTEP 8
+#define SHIFT 4
+
+/* Reading a region that has been overwritten many times
+ * At step s, every rank writes columns [s * SHIFT, s * SHIFT + N / 2) of its row and flushes the
+ * file, so every column is covered by several log entries. The row is read back with shadow
+ * elimination enabled, each column must hold the value of the last step that wrote it.
+ */
+int main (int argc, char **argv) {
+    const char *file_name;
+    int i, j, s, rank, np, nerrs=0;
+    int *buf = NULL, *ref = NULL;
+    herr_t err;
+    hid_t fapl_id=-1;
+    hid_t file_id=-1, dspace_id=-1, dset_id=-1, mspace_id=-1, dxpl_id=-1;
+    hsize_t dims[2], start[2], count[2];
+
+    int mpi_required;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_required);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 2) {
+        if (!rank) printf ("Usage: %s [filename]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+    } else {
+        file_name = "shadow.h5";
+    }
+
+    buf = (int *)malloc (sizeof (int) * N);
+    ref = (int *)malloc (sizeof (int) * N);
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env(&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid=H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+    err = H5Pset_shadow_elim (fapl_id, true);
+    CHECK_ERR (err)
+#endif
+    SHOW_TEST_INFO ("Shadow elimination")
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Define dataset
+    dims[0]   = np;
+    dims[1]   = N;
+    dspace_id = H5Screate_simple (2, dims, NULL);  // Dataset space
+    CHECK_ERR (dspace_id)
+    dset_id = H5Dcreate (file_id, "M", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+
+    count[0]  = N / 2;
+    mspace_id = H5Screate_simple (1, count, NULL);  // Memory space for I/O
+    CHECK_ERR (mspace_id)
+
+    // Overwrite the row step by step
+    for (i = 0; i < N; i++) { ref[i] = -1; }
+    for (s = 0; s < NSTEP; s++) {
+        start[0] = rank;
+        start[1] = s * SHIFT;
+        count[0] = 1;
+        count[1] = N / 2;
+        err = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+        CHECK_ERR (err)
+
+        for (i = 0; i < N / 2; i++) {
+            buf[i]             = (rank * NSTEP + s) * N + i + 1;
+            ref[s * SHIFT + i] = buf[i];
+        }
+        err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+        CHECK_ERR (err)
+
+        err = H5Fflush (file_id, H5F_SCOPE_GLOBAL);
+        CHECK_ERR (err)
+    }
+
+    // Close file
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    mspace_id = -1;
+    err = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+    // Open file
+    file_id = H5Fopen (file_name, H5F_ACC_RDONLY, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Open dataset
+    dset_id = H5Dopen2 (file_id, "M", H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+
+    // Read the whole row
+    start[0] = rank;
+    start[1] = 0;
+    count[0] = 1;
+    count[1] = N;
+    err = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    mspace_id = H5Screate_simple (1, count + 1, NULL);
+    CHECK_ERR (mspace_id)
+
+    for (i = 0; i < N; i++) { buf[i] = -1; }
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+
+    for (i = 0; i < N; i++) {
+        if (ref[i] == -1) continue;  // Never written
+        j = ref[i];
+        if (buf[i] != j) {
+            printf ("Rank %d: Error. Expect buf[%d] = %d, but got %d\n", rank, i, j, buf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+    free (buf);
+    free (ref);
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
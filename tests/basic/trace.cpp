@@ -0,0 +1,421 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#include <string>
+#include <vector>
+
+#ifdef TEST_H5VL_LOG
+#include "H5VL_log.h"
+#include "H5VL_logi_trace.hpp"
+#include "testutils.hpp"
+#else
+#include "common.hpp"
+#endif
+
+#define N 16
+
+/* I/O trace recorded by H5Pset_trace
+ * Every rank writes its row of a 2-D dataset collectively. The dataset is extended and every rank
+ * writes a row of the new part in buffered mode. After a flush, every rank reads 2 blocks of its
+ * first row collectively. The trace must hold the records of these calls in order.
+ * trace_replay.sh replays the trace by benchmarks/trace_replay while recording it again through
+ * H5VL_LOG_TRACE, then runs this program with the prefix of the new trace to check it the same way.
+ */
+
+#ifdef TEST_H5VL_LOG
+// Cursor over a trace
+typedef struct trace_buf_t {
+    std::vector<char> data;
+    size_t off;
+
+    bool get (void *buf, size_t size) {
+        if (off + size > data.size ()) return false;
+        memcpy (buf, data.data () + off, size);
+        off += size;
+        return true;
+    }
+} trace_buf_t;
+
+#define GET_VAL(A)                                                                    \
+    {                                                                                 \
+        if (!tb.get (&(A), sizeof (A))) { RET_ERR ("Trace truncated at " << tb.off) } \
+    }
+
+// Check an I/O record against the expected dataset ID, flag, byte count, and selection
+static int check_io (trace_buf_t &tb, int type, int flag, int nsel, hsize_t *sel) {
+    int i, nerrs = 0;
+    int32_t i32;
+    uint8_t u8;
+    uint64_t u64;
+    double t;
+    hsize_t h;
+    uint64_t nelem = 0;
+
+    for (i = 0; i < nsel; i++) { nelem += sel[i * 4 + 2] * sel[i * 4 + 3]; }
+
+    GET_VAL (u8)
+    EXP_VAL ((int)u8, type)
+    GET_VAL (t)
+    GET_VAL (i32)
+    EXP_VAL (i32, 0)
+    GET_VAL (u8)
+    EXP_VAL ((int)u8, flag)
+    GET_VAL (u64)
+    EXP_VAL (u64, sizeof (int))
+    GET_VAL (u64)
+    EXP_VAL (u64, nelem * sizeof (int))
+    GET_VAL (i32)
+    EXP_VAL (i32, nsel)
+    for (i = 0; i < nsel * 4; i++) {
+        GET_VAL (h)
+        EXP_VAL (h, sel[i])
+    }
+
+err_out:;
+    return nerrs;
+}
+
+// Check the trace of this rank, path is the prefix
+static int check_trace (const char *prefix, int rank, int np) {
+    int i, nerrs = 0;
+    char magic[4];
+    int32_t hdr[3], i32;
+    uint8_t u8;
+    double t;
+    uint64_t u64;
+    hsize_t h;
+    long size;
+    FILE *fin = NULL;
+    hsize_t dims[2], mdims[2];
+    hsize_t sel[8];  // start[2] and count[2] of each block
+    std::string path = std::string (prefix) + "." + std::to_string (rank);
+    trace_buf_t tb;
+
+    fin = fopen (path.c_str (), "rb");
+    if (!fin) { RET_ERR ("Cannot open " << path) }
+    fseek (fin, 0, SEEK_END);
+    size = ftell (fin);
+    fseek (fin, 0, SEEK_SET);
+    tb.data.resize (size);
+    tb.off = 0;
+    if (fread (tb.data.data (), 1, size, fin) != (size_t)size) { RET_ERR ("Cannot read " << path) }
+
+    // Header
+    GET_VAL (magic)
+    if (memcmp (magic, H5VL_LOGI_TRACE_MAGIC, 4)) { RET_ERR (path << " is not a trace") }
+    GET_VAL (hdr)
+    EXP_VAL (hdr[0], H5VL_LOGI_TRACE_VERSION)
+    EXP_VAL (hdr[1], rank)
+    EXP_VAL (hdr[2], np)
+
+    // Dataset defined before the first write
+    dims[0]  = np;
+    dims[1]  = N;
+    mdims[0] = H5S_UNLIMITED;
+    mdims[1] = N;
+    GET_VAL (u8)
+    EXP_VAL ((int)u8, H5VL_LOGI_TRACE_DEF)
+    GET_VAL (t)
+    GET_VAL (i32)
+    EXP_VAL (i32, 0)
+    GET_VAL (i32)
+    EXP_VAL (i32, 2)
+    GET_VAL (u64)
+    EXP_VAL (u64, sizeof (int))
+    for (i = 0; i < 2; i++) {
+        GET_VAL (h)
+        EXP_VAL (h, dims[i])
+    }
+    for (i = 0; i < 2; i++) {
+        GET_VAL (h)
+        EXP_VAL (h, mdims[i])
+    }
+
+    // Collective write of row rank
+    sel[0] = rank;
+    sel[1] = 0;
+    sel[2] = 1;
+    sel[3] = N;
+    nerrs += check_io (tb, H5VL_LOGI_TRACE_WRITE, H5VL_LOGI_TRACE_FLAG_COLL, 1, sel);
+    if (nerrs) goto err_out;
+
+    // Extension
+    GET_VAL (u8)
+    EXP_VAL ((int)u8, H5VL_LOGI_TRACE_EXTENT)
+    GET_VAL (t)
+    GET_VAL (i32)
+    EXP_VAL (i32, 0)
+    GET_VAL (h)
+    EXP_VAL (h, (hsize_t)np * 2)
+    GET_VAL (h)
+    EXP_VAL (h, (hsize_t)N)
+
+    // Buffered write of row np + rank
+    sel[0] = np + rank;
+    nerrs += check_io (tb, H5VL_LOGI_TRACE_WRITE, H5VL_LOGI_TRACE_FLAG_BUFFERED, 1, sel);
+    if (nerrs) goto err_out;
+
+    // Flush
+    GET_VAL (u8)
+    EXP_VAL ((int)u8, H5VL_LOGI_TRACE_FLUSH)
+    GET_VAL (t)
+
+    // Collective read of 2 blocks of row rank
+    sel[0] = rank;
+    sel[1] = 0;
+    sel[2] = 1;
+    sel[3] = 2;
+    sel[4] = rank;
+    sel[5] = N / 2;
+    sel[6] = 1;
+    sel[7] = 2;
+    nerrs += check_io (tb, H5VL_LOGI_TRACE_READ, H5VL_LOGI_TRACE_FLAG_COLL, 2, sel);
+    if (nerrs) goto err_out;
+
+    if (tb.off != tb.data.size ()) {
+        RET_ERR (tb.data.size () - tb.off << " bytes after the last record of " << path)
+    }
+
+err_out:;
+    if (fin) fclose (fin);
+    return nerrs;
+}
+#endif
+
+int main (int argc, char **argv) {
+    const char *file_name, *check_prefix = NULL;
+    int i, rank, np, nerrs = 0;
+    int buf[N];
+    herr_t err;
+    hid_t fapl_id = -1;
+    hid_t file_id = -1, dspace_id = -1, dset_id = -1, mspace_id = -1, dxpl_id = -1;
+    hid_t nb_dxpl_id = -1, dcpl_id = -1;
+    hsize_t dims[2], mdims[2], start[2], count[2];
+    std::string prefix;
+#ifdef TEST_H5VL_LOG
+    ssize_t len;
+    char path[1024];
+#endif
+
+    MPI_Init (&argc, &argv);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    if (argc > 3) {
+        if (!rank) printf ("Usage: %s [filename] [trace prefix to check]\n", argv[0]);
+        MPI_Finalize ();
+        return 1;
+    } else if (argc > 1) {
+        file_name = argv[1];
+        if (argc > 2) { check_prefix = argv[2]; }
+    } else {
+        file_name = "trace.h5";
+    }
+    prefix = std::string (file_name) + ".trace";
+
+    // Set MPI-IO and parallel access proterty.
+    fapl_id = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ERR (fapl_id)
+    err = H5Pset_fapl_mpio (fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR (err)
+    err = H5Pset_all_coll_metadata_ops (fapl_id, 1);
+    CHECK_ERR (err)
+    err = H5Pset_coll_metadata_write (fapl_id, 1);
+    CHECK_ERR (err)
+
+    // Collective I/O
+    dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (dxpl_id)
+    err = H5Pset_dxpl_mpio (dxpl_id, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR (err)
+
+    // Buffered independent I/O
+    nb_dxpl_id = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ERR (nb_dxpl_id)
+
+#ifdef TEST_H5VL_LOG
+    /* check VOL related environment variables */
+    vol_env env;
+    check_env (&env);
+    if (env.native_only == 0 && env.connector == 0) {
+        hid_t log_vlid = H5I_INVALID_HID;
+        // Register LOG VOL plugin
+        log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+        CHECK_ERR (log_vlid)
+        err = H5Pset_vol (fapl_id, log_vlid, NULL);
+        CHECK_ERR (err)
+        err = H5VLclose (log_vlid);
+        CHECK_ERR (err)
+    }
+    if (env.native_only == 0) {
+        err = H5Pset_buffered (nb_dxpl_id, true);
+        CHECK_ERR (err)
+
+        // Record the trace to <file_name>.trace.<rank>
+        err = H5Pset_trace (fapl_id, prefix.c_str ());
+        CHECK_ERR (err)
+        len = H5Pget_trace (fapl_id, NULL, 0);
+        EXP_VAL (len, (ssize_t)prefix.size ())
+        len = H5Pget_trace (fapl_id, path, sizeof (path));
+        EXP_VAL (len, (ssize_t)prefix.size ())
+        EXP_VAL (std::string (path), prefix)
+    }
+#endif
+    SHOW_TEST_INFO ("I/O trace")
+
+#ifdef TEST_H5VL_LOG
+    // Only check a trace recorded by trace_replay
+    if (check_prefix) {
+        nerrs += check_trace (check_prefix, rank, np);
+        goto err_out;
+    }
+#endif
+
+    // Create file
+    file_id = H5Fcreate (file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    CHECK_ERR (file_id)
+
+    // Extendible dataset of np rows
+    dims[0]  = np;
+    dims[1]  = N;
+    mdims[0] = H5S_UNLIMITED;
+    mdims[1] = N;
+    dspace_id = H5Screate_simple (2, dims, mdims);
+    CHECK_ERR (dspace_id)
+    dcpl_id = H5Pcreate (H5P_DATASET_CREATE);
+    CHECK_ERR (dcpl_id)
+    count[0] = 1;
+    count[1] = N;
+    err      = H5Pset_chunk (dcpl_id, 2, count);
+    CHECK_ERR (err)
+    dset_id = H5Dcreate2 (file_id, "D", H5T_NATIVE_INT, dspace_id, H5P_DEFAULT, dcpl_id,
+                          H5P_DEFAULT);
+    CHECK_ERR (dset_id)
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    mspace_id = H5Screate_simple (2, count, NULL);
+    CHECK_ERR (mspace_id)
+    for (i = 0; i < N; i++) { buf[i] = rank * N + i; }
+
+    // Collective write of row rank
+    dspace_id = H5Dget_space (dset_id);
+    CHECK_ERR (dspace_id)
+    start[0] = rank;
+    start[1] = 0;
+    err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+
+    // Extend to 2 * np rows, then buffered write of row np + rank
+    dims[0] = np * 2;
+    err     = H5Dset_extent (dset_id, dims);
+    CHECK_ERR (err)
+    dspace_id = H5Dget_space (dset_id);
+    CHECK_ERR (dspace_id)
+    start[0] = np + rank;
+    err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    err = H5Dwrite (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, nb_dxpl_id, buf);
+    CHECK_ERR (err)
+
+    err = H5Fflush (file_id, H5F_SCOPE_GLOBAL);
+    CHECK_ERR (err)
+
+    // Collective read of 2 blocks of row rank
+    start[0] = rank;
+    start[1] = 0;
+    count[1] = 2;
+    err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    start[1] = N / 2;
+    err      = H5Sselect_hyperslab (dspace_id, H5S_SELECT_OR, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    err = H5Sclose (mspace_id);
+    CHECK_ERR (err)
+    dims[0]   = 4;
+    mspace_id = H5Screate_simple (1, dims, NULL);
+    CHECK_ERR (mspace_id)
+    err = H5Dread (dset_id, H5T_NATIVE_INT, mspace_id, dspace_id, dxpl_id, buf);
+    CHECK_ERR (err)
+    for (i = 0; i < 4; i++) {
+        int expect = rank * N + (i < 2 ? i : N / 2 + i - 2);
+        if (buf[i] != expect) {
+            printf ("Rank %d: Error. Expect buf[%d] = %d, but got %d\n", rank, i, expect, buf[i]);
+            nerrs++;
+            break;
+        }
+    }
+
+    // Close file, the trace is complete
+    err = H5Sclose (dspace_id);
+    CHECK_ERR (err)
+    dspace_id = -1;
+    err       = H5Dclose (dset_id);
+    CHECK_ERR (err)
+    dset_id = -1;
+    err     = H5Fclose (file_id);
+    CHECK_ERR (err)
+    file_id = -1;
+
+#ifdef TEST_H5VL_LOG
+    // No trace is recorded when the Log VOL connector is not used or only passes the calls through
+    if (env.native_only == 0 && env.passthru == 0 && (env.connector == 0 || env.log_env)) {
+        nerrs += check_trace (prefix.c_str (), rank, np);
+    }
+#endif
+
+err_out:
+    if (dspace_id != -1) {
+        err = H5Sclose (dspace_id);
+        CHECK_ERR (err)
+    }
+    if (mspace_id != -1) {
+        err = H5Sclose (mspace_id);
+        CHECK_ERR (err)
+    }
+    if (dset_id != -1) {
+        err = H5Dclose (dset_id);
+        CHECK_ERR (err)
+    }
+    if (file_id != -1) {
+        err = H5Fclose (file_id);
+        CHECK_ERR (err)
+    }
+    if (dcpl_id != -1) {
+        err = H5Pclose (dcpl_id);
+        CHECK_ERR (err)
+    }
+    if (fapl_id != -1) {
+        err = H5Pclose (fapl_id);
+        CHECK_ERR (err)
+    }
+    if (dxpl_id != -1) {
+        err = H5Pclose (dxpl_id);
+        CHECK_ERR (err)
+    }
+    if (nb_dxpl_id != -1) {
+        err = H5Pclose (nb_dxpl_id);
+        CHECK_ERR (err)
+    }
+
+    SHOW_TEST_RESULT
+
+    MPI_Finalize ();
+
+    return (nerrs > 0);
+}
@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+# Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+# See COPYRIGHT notice in top-level directory.
+#
+# Record an I/O trace by the test program trace, replay it by benchmarks/trace_replay while
+# recording the replay through H5VL_LOG_TRACE, then check that the second trace holds the same
+# calls as the first one.
+#
+
+# Exit immediately if a command exits with a non-zero status.
+set -e
+set -x
+
+outfile=${TESTOUTDIR}/trace_replay
+TRACE_REPLAY=${top_builddir}/benchmarks/trace_replay
+
+# both programs register the Log VOL connector themselves, as a terminal connector
+unset HDF5_VOL_CONNECTOR
+unset HDF5_PLUGIN_PATH
+unset H5VL_LOG_PASSTHRU
+unset H5VL_LOG_TRACE
+
+# record through H5Pset_trace, to ${outfile}.h5.trace.<rank>
+${TESTSEQRUN} ./trace ${outfile}.h5
+
+# replay, recording to ${outfile}.replay.<rank>
+export H5VL_LOG_TRACE=${outfile}.replay
+${TESTSEQRUN} ${TRACE_REPLAY} -i ${outfile}.h5.trace -o ${outfile}_r.h5
+unset H5VL_LOG_TRACE
+
+# the replay must issue the same calls
+${TESTSEQRUN} ./trace ${outfile}_r.h5 ${outfile}.replay
+
+exit 0
@@ -0,0 +1,542 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+//
+#include <getopt.h>
+#include <hdf5.h>
+#include <mpi.h>
+//
+#include "H5VL_log.h"
+#include "H5VL_log_filei.hpp"
+#include "H5VL_logi_union.hpp"
+#include "h5lcompact.hpp"
+
+// Default memory used to buffer data, in bytes
+#define H5LCOMPACT_MLIMIT_DEFAULT (1024 * 1024 * 1024)
+
+const char hdf5sig[] = {(char)0x89, (char)0x48, (char)0x44, (char)0x46,
+                        (char)0x0d, (char)0x0a, (char)0x1a, (char)0x0a};
+
+// A box of a dataset copied in a round
+typedef struct h5lcompact_box_t {
+    int did;       // Dataset ID
+    size_t off;    // Offset of the box in the box list of the dataset
+    size_t nelem;  // Number of elements in the box
+} h5lcompact_box_t;
+
+/*----< parse_size() >-------------------------------------------------------*/
+// Parse a size in bytes with an optional k, m, or g suffix, return 0 on error
+static size_t parse_size (const char *str) {
+    char *end;
+    size_t size;
+
+    size = (size_t)strtoull (str, &end, 10);
+    switch (*end) {
+        case 'g':
+        case 'G':
+            size *= 1024;
+            // fall through
+        case 'm':
+        case 'M':
+            size *= 1024;
+            // fall through
+        case 'k':
+        case 'K':
+            size *= 1024;
+            end++;
+            break;
+        default:;
+    }
+    if (*end != '\0') { return 0; }
+
+    return size;
+}
+
+int main (int argc, char *argv[]) {
+    herr_t err = 0;
+    int rank, np;
+    int opt;
+    size_t mlimit = H5LCOMPACT_MLIMIT_DEFAULT;  // Memory limit of the data buffer
+    static struct option lopts[] = {{"help", no_argument, NULL, 'h'},
+                                    {"input", required_argument, NULL, 'i'},
+                                    {"output", required_argument, NULL, 'o'},
+                                    {"memory-limit", required_argument, NULL, 'm'},
+                                    {NULL, 0, NULL, 0}};
+    std::string inpath, outpath;
+    std::ifstream fin;  // File stream for reading file signature
+    char sig[8];        // File signature
+
+    MPI_Init (&argc, &argv);
+    MPI_Comm_size (MPI_COMM_WORLD, &np);
+    MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+
+    // Parse input
+    while ((opt = getopt_long (argc, argv, "hi:o:m:", lopts, NULL)) != -1) {
+        switch (opt) {
+            case 'i':
+                inpath = std::string (optarg);
+                break;
+            case 'o':
+                outpath = std::string (optarg);
+                break;
+            case 'm':
+                mlimit = parse_size (optarg);
+                if (mlimit == 0) {
+                    if (rank == 0) {
+                        std::cout << "Error: invalid memory limit " << optarg << std::endl;
+                    }
+                    return -1;
+                }
+                break;
+            case 'h':
+            default:
+                if (rank == 0) {
+                    std::cout << "Usage: h5lcompact -i <input file path> -o <output file path> "
+                                 "[-m <memory limit in bytes, k/m/g suffix allowed>]"
+                              << std::endl;
+                }
+                return 0;
+        }
+    }
+
+    // Make sure input file is HDF5 file
+    if (!rank) {
+        fin.open (inpath, std::ios_base::in);
+        if (fin.is_open ()) {
+            memset (sig, 0, sizeof (sig));
+            fin.read (sig, 8);
+            if (memcmp (hdf5sig, sig, 8)) {
+                std::cout << "Error: " << inpath << " is not a valid HDF5 file." << std::endl;
+                err = -1;
+            }
+        } else {
+            std::cout << "Error: cannot open " << inpath << std::endl;
+            err = -1;
+        }
+    }
+    MPI_Bcast (&err, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (err) { goto err_out; }
+
+    try {
+        h5lcompact_core (inpath, outpath, rank, np, mlimit);
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    MPI_Finalize ();
+    return err == 0 ? 0 : -1;
+}
+
+static herr_t h5lcompact_attr_copy_handler (hid_t location_id,
+                                            const char *attr_name,
+                                            const H5A_info_t *ainfo,
+                                            void *op_data) {
+    herr_t err    = 0;
+    int i;
+    hid_t pid     = *((hid_t *)op_data);
+    hid_t src_aid = -1;
+    hid_t dst_aid = -1;
+    hid_t sid     = -1;
+    hid_t tid     = -1;
+    int ndim;
+    hsize_t dims[H5S_MAX_RANK];
+    size_t bsize;  // Buffer size
+    void *buf = NULL;
+
+    try {
+        // The log-based VOL hides its internal attributes
+        src_aid = H5Aopen (location_id, attr_name, H5P_DEFAULT);
+        CHECK_ID (src_aid)
+        sid = H5Aget_space (src_aid);
+        CHECK_ID (sid)
+        tid = H5Aget_type (src_aid);
+        CHECK_ID (tid)
+
+        ndim = H5Sget_simple_extent_dims (sid, dims, NULL);
+        CHECK_ID (ndim)
+        bsize = H5Tget_size (tid);
+        if (bsize == 0) { ERR_OUT ("Attribute element size unknown") }
+        for (i = 0; i < ndim; i++) { bsize *= dims[i]; }
+        buf = malloc (bsize ? bsize : 1);
+        CHECK_PTR (buf)
+
+        err = H5Aread (src_aid, tid, buf);
+        CHECK_ERR
+        dst_aid = H5Acreate2 (pid, attr_name, tid, sid, H5P_DEFAULT, H5P_DEFAULT);
+        CHECK_ID (dst_aid)
+        err = H5Awrite (dst_aid, tid, buf);
+        CHECK_ERR
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    if (buf) { free (buf); }
+    if (sid >= 0) { H5Sclose (sid); }
+    if (tid >= 0) { H5Tclose (tid); }
+    if (src_aid >= 0) { H5Aclose (src_aid); }
+    if (dst_aid >= 0) { H5Aclose (dst_aid); }
+
+    return err;
+}
+
+/*
+ * Copy the attributes of an object
+ */
+static void h5lcompact_copy_atts (hid_t src, hid_t dst) {
+    herr_t err = 0;
+    hsize_t n  = 0;  // Attr iterate idx position
+
+    err = H5Aiterate2 (src, H5_INDEX_CRT_ORDER, H5_ITER_INC, &n, h5lcompact_attr_copy_handler,
+                       &dst);
+    CHECK_ERR
+}
+
+/*
+ * Split boxes with more than budget bytes into slabs along the first dimension
+ */
+static void h5lcompact_split (h5lcompact_dset_t &dset, size_t budget) {
+    int i;
+    int ndim = (int)(dset.ndim);
+    size_t j;
+    size_t rsize;  // Size of a row in the first dimension
+    hsize_t rows;  // Rows per slab
+    hsize_t r;
+    std::vector<hsize_t> out;
+
+    for (j = 0; j < dset.blocks.size (); j += 2 * ndim) {
+        hsize_t *start = dset.blocks.data () + j;
+        hsize_t *count = start + ndim;
+
+        rsize = dset.esize;
+        for (i = 1; i < ndim; i++) { rsize *= count[i]; }
+        rows = std::max ((hsize_t)1, (hsize_t)(budget / rsize));
+
+        for (r = 0; r < count[0]; r += rows) {
+            out.push_back (start[0] + r);
+            out.insert (out.end (), start + 1, start + ndim);
+            out.push_back (std::min (rows, count[0] - r));
+            out.insert (out.end (), count + 1, count + ndim);
+        }
+    }
+
+    dset.blocks.swap (out);
+}
+
+/*
+ * Select the union of n boxes of a dataset starting at box off
+ */
+static void h5lcompact_select (
+    hid_t sid, h5lcompact_dset_t &dset, size_t off, size_t n, size_t *nelem) {
+    herr_t err = 0;
+    size_t i;
+    int j;
+    int ndim = (int)(dset.ndim);
+    hsize_t *start, *count;
+
+    if (ndim == 0) {
+        err = H5Sselect_all (sid);
+        CHECK_ERR
+        *nelem = 1;
+        return;
+    }
+
+    *nelem = 0;
+    for (i = 0; i < n; i++) {
+        size_t ne = 1;
+
+        start = dset.blocks.data () + (off + i) * 2 * ndim;
+        count = start + ndim;
+        for (j = 0; j < ndim; j++) { ne *= count[j]; }
+        *nelem += ne;
+
+        err = H5Sselect_hyperslab (sid, i ? H5S_SELECT_OR : H5S_SELECT_SET, start, NULL, count,
+                                   NULL);
+        CHECK_ERR
+    }
+}
+
+void h5lcompact_core (
+    std::string &inpath, std::string &outpath, int rank, int np, size_t mlimit) {
+    herr_t err = 0;
+    int mpierr;
+    int i;
+    size_t j, k;
+    hid_t log_vlid = -1;  // Log VOL ID
+    hid_t faplid   = -1;
+    hid_t dxplid   = -1;
+    hid_t finid    = -1;  // ID of the input file
+    hid_t foutid   = -1;  // ID of the output file
+    hid_t src_id   = -1;
+    hid_t dst_id   = -1;
+    hid_t gsrc_id  = -1;  // Group in the input file
+    hid_t gdst_id  = -1;  // Group in the output file
+    hid_t tid      = -1;
+    hid_t sid      = -1;
+    hid_t dcplid   = -1;
+    hid_t fsid     = -1;  // File space of the current box group
+    hid_t msid     = -1;  // Memory space of the current box group
+    int att_buf[H5VL_LOG_FILEI_NATTR];      // Temporary buffer for reading file attributes
+    size_t budget;                          // Data buffer size of a round
+    int nround, r;                          // Number of rounds
+    size_t rstart, rend;                    // Boxes of the current round
+    std::vector<h5lcompact_obj_t> objs;     // User objects in creation order
+    std::vector<h5lcompact_dset_t> dsets;   // Dataset information
+    std::vector<hid_t> dins, douts;         // Datasets in the input and output file
+    std::vector<h5lcompact_box_t> boxes;    // Boxes handled by this process in dataset order
+    std::vector<size_t> rends;              // End of each round in boxes
+    std::vector<char *> bufs;               // Data buffer of the current round
+    H5VL_logi_err_finally finally ([&] () -> void {
+        for (auto buf : bufs) { free (buf); }
+        if (fsid >= 0) { H5Sclose (fsid); }
+        if (msid >= 0) { H5Sclose (msid); }
+        if (dcplid >= 0) { H5Pclose (dcplid); }
+        if (sid >= 0) { H5Sclose (sid); }
+        if (tid >= 0) { H5Tclose (tid); }
+        if (gsrc_id >= 0) { H5Gclose (gsrc_id); }
+        if (gdst_id >= 0) { H5Gclose (gdst_id); }
+        for (auto did : dins) {
+            if (did >= 0) { H5Dclose (did); }
+        }
+        for (auto did : douts) {
+            if (did >= 0) { H5Dclose (did); }
+        }
+        if (finid >= 0) { H5Fclose (finid); }
+        if (foutid >= 0) { H5Fclose (foutid); }
+        if (dxplid >= 0) { H5Pclose (dxplid); }
+        if (faplid >= 0) { H5Pclose (faplid); }
+        if (log_vlid >= 0) { H5VLclose (log_vlid); }
+    });
+
+    // Objects and the region written to each dataset
+    h5lcompact_visit (inpath, objs, dsets, att_buf);
+    h5lcompact_parse_meta (inpath, rank, np, att_buf, dsets);
+    h5lcompact_gather_blocks (rank, np, dsets);
+
+    // Remove shadowed and duplicated regions, then cut the boxes to fit in the buffer
+    budget = std::max (mlimit / 2, (size_t)1);
+    for (i = rank; i < (int)(dsets.size ()); i += np) {
+        h5lcompact_dset_t &dset = dsets[i];
+        size_t nbox, bsize;
+
+        if (!dset.written) continue;
+
+        H5VL_logi_union ((int)(dset.ndim), dset.blocks);
+        if (dset.ndim == 0) {
+            boxes.push_back ({i, 0, 1});
+            continue;
+        }
+        h5lcompact_split (dset, budget);
+
+        nbox = dset.blocks.size () / (2 * dset.ndim);
+        for (j = 0; j < nbox; j++) {
+            bsize = 1;
+            for (k = 0; k < dset.ndim; k++) {
+                bsize *= dset.blocks[j * 2 * dset.ndim + dset.ndim + k];
+            }
+            boxes.push_back ({i, j, bsize});
+        }
+    }
+
+    // Group consecutive boxes into rounds that fit in the buffer
+    {
+        size_t rsize = 0;
+        for (j = 0; j < boxes.size (); j++) {
+            size_t bsize = boxes[j].nelem * dsets[boxes[j].did].esize;
+            if (rsize && rsize + bsize > budget) {
+                rends.push_back (j);
+                rsize = 0;
+            }
+            rsize += bsize;
+        }
+        if (!boxes.empty ()) { rends.push_back (boxes.size ()); }
+    }
+    nround = (int)(rends.size ());
+    mpierr = MPI_Allreduce (MPI_IN_PLACE, &nround, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    CHECK_MPIERR
+
+    // Open the input and create the output through the log-based VOL
+    log_vlid = H5VLregister_connector (&H5VL_log_g, H5P_DEFAULT);
+    CHECK_ID (log_vlid)
+    faplid = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ID (faplid)
+    err = H5Pset_fapl_mpio (faplid, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR
+    err = H5Pset_all_coll_metadata_ops (faplid, 1);
+    CHECK_ERR
+    err = H5Pset_vol (faplid, log_vlid, NULL);
+    CHECK_ERR
+
+    finid = H5Fopen (inpath.c_str (), H5F_ACC_RDONLY, faplid);
+    CHECK_ID (finid)
+    foutid = H5Fcreate (outpath.c_str (), H5F_ACC_TRUNC, H5P_DEFAULT, faplid);
+    CHECK_ID (foutid)
+
+    // Data is read and written with buffered requests, carried out collectively at H5Fflush
+    dxplid = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ID (dxplid)
+    err = H5Pset_buffered (dxplid, true);
+    CHECK_ERR
+
+    // Recreate the objects in creation order
+    h5lcompact_copy_atts (finid, foutid);
+    dins.resize (dsets.size (), -1);
+    douts.resize (dsets.size (), -1);
+    for (auto &obj : objs) {
+        if (obj.type == H5O_TYPE_DATASET) {
+            src_id = H5Dopen2 (finid, obj.name.c_str (), H5P_DEFAULT);
+            CHECK_ID (src_id)
+            dins[obj.id] = src_id;
+
+            tid = H5Dget_type (src_id);
+            CHECK_ID (tid)
+            sid = H5Dget_space (src_id);
+            CHECK_ID (sid)
+            dcplid = H5Dget_create_plist (src_id);
+            CHECK_ID (dcplid)
+
+            dst_id = H5Dcreate2 (foutid, obj.name.c_str (), tid, sid, H5P_DEFAULT, dcplid,
+                                 H5P_DEFAULT);
+            CHECK_ID (dst_id)
+            douts[obj.id] = dst_id;
+
+            H5Pclose (dcplid);
+            dcplid = -1;
+            H5Sclose (sid);
+            sid = -1;
+            H5Tclose (tid);
+            tid = -1;
+
+            h5lcompact_copy_atts (src_id, dst_id);
+        } else if (obj.type == H5O_TYPE_GROUP) {
+            gsrc_id = H5Gopen2 (finid, obj.name.c_str (), H5P_DEFAULT);
+            CHECK_ID (gsrc_id)
+            gdst_id =
+                H5Gcreate2 (foutid, obj.name.c_str (), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            CHECK_ID (gdst_id)
+
+            h5lcompact_copy_atts (gsrc_id, gdst_id);
+
+            H5Gclose (gsrc_id);
+            gsrc_id = -1;
+            H5Gclose (gdst_id);
+            gdst_id = -1;
+        } else {
+            src_id = H5Topen2 (finid, obj.name.c_str (), H5P_DEFAULT);
+            CHECK_ID (src_id)
+            tid = H5Tcopy (src_id);
+            H5Tclose (src_id);
+            CHECK_ID (tid)
+            err = H5Tcommit2 (foutid, obj.name.c_str (), tid, H5P_DEFAULT, H5P_DEFAULT,
+                              H5P_DEFAULT);
+            CHECK_ERR
+            H5Tclose (tid);
+            tid = -1;
+        }
+    }
+
+    // Copy the data round by round
+    // Reading through the log-based VOL resolves overlapping writes, the newest one wins
+    rstart = 0;
+    for (r = 0; r < nround; r++, rstart = rend) {
+        std::vector<std::pair<size_t, size_t>> groups;  // Box range of each dataset in the round
+
+        // Processes running out of boxes still join the collective flushes
+        rend = r < (int)(rends.size ()) ? rends[r] : boxes.size ();
+        for (j = rstart; j < rend; j = k) {
+            for (k = j + 1; k < rend && boxes[k].did == boxes[j].did; k++)
+                ;
+            groups.push_back (std::make_pair (j, k));
+        }
+
+        // Post the reads
+        for (auto &g : groups) {
+            h5lcompact_dset_t &dset = dsets[boxes[g.first].did];
+            hid_t did               = dins[boxes[g.first].did];
+            size_t nelem;
+            hsize_t mdim;
+            char *buf;
+
+            fsid = H5Dget_space (did);
+            CHECK_ID (fsid)
+            h5lcompact_select (fsid, dset, boxes[g.first].off, g.second - g.first, &nelem);
+            mdim = nelem;
+            msid = dset.ndim ? H5Screate_simple (1, &mdim, &mdim) : H5Screate (H5S_SCALAR);
+            CHECK_ID (msid)
+
+            buf = (char *)malloc (nelem * dset.esize);
+            CHECK_PTR (buf)
+            bufs.push_back (buf);
+
+            tid = H5Dget_type (did);
+            CHECK_ID (tid)
+            err = H5Dread (did, tid, msid, fsid, dxplid, buf);
+            CHECK_ERR
+            H5Tclose (tid);
+            tid = -1;
+            H5Sclose (msid);
+            msid = -1;
+            H5Sclose (fsid);
+            fsid = -1;
+        }
+        err = H5Fflush (finid, H5F_SCOPE_GLOBAL);
+        CHECK_ERR
+
+        // Post the writes with the same selection
+        for (i = 0; i < (int)(groups.size ()); i++) {
+            auto &g                 = groups[i];
+            h5lcompact_dset_t &dset = dsets[boxes[g.first].did];
+            hid_t did               = douts[boxes[g.first].did];
+            size_t nelem;
+            hsize_t mdim;
+
+            fsid = H5Dget_space (did);
+            CHECK_ID (fsid)
+            h5lcompact_select (fsid, dset, boxes[g.first].off, g.second - g.first, &nelem);
+            mdim = nelem;
+            msid = dset.ndim ? H5Screate_simple (1, &mdim, &mdim) : H5Screate (H5S_SCALAR);
+            CHECK_ID (msid)
+
+            tid = H5Dget_type (did);
+            CHECK_ID (tid)
+            err = H5Dwrite (did, tid, msid, fsid, dxplid, bufs[i]);
+            CHECK_ERR
+            H5Tclose (tid);
+            tid = -1;
+            H5Sclose (msid);
+            msid = -1;
+            H5Sclose (fsid);
+            fsid = -1;
+        }
+        err = H5Fflush (foutid, H5F_SCOPE_GLOBAL);
+        CHECK_ERR
+
+        for (auto buf : bufs) { free (buf); }
+        bufs.clear ();
+    }
+
+    // Metadata of all rounds is written into a single metadata dataset at file close
+    for (auto &did : douts) {
+        if (did >= 0) {
+            H5Dclose (did);
+            did = -1;
+        }
+    }
+    err = H5Fclose (foutid);
+    foutid = -1;
+    CHECK_ERR
+}
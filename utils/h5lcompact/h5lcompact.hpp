@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+//
+#include <hdf5.h>
+#include <mpi.h>
+//
+#include "H5VL_log_dataset.hpp"
+#include "H5VL_logi_err.hpp"
+
+// An object of the input file to be recreated in the output file
+typedef struct h5lcompact_obj_t {
+    std::string name;  // Path of the object as seen by the application
+    H5O_type_t type;   // Object type
+    int id;            // Log VOL dataset ID, datasets only
+} h5lcompact_obj_t;
+
+// Region of a dataset written in the input file
+typedef struct h5lcompact_dset_t : H5VL_log_dset_info_t {
+    bool written = false;         // Any metadata entry refers to the dataset
+    std::vector<hsize_t> blocks;  // Selection blocks, start[ndim] followed by count[ndim]
+} h5lcompact_dset_t;
+
+void h5lcompact_core (
+    std::string &inpath, std::string &outpath, int rank, int np, size_t mlimit);
+
+void h5lcompact_visit (std::string &inpath,
+                       std::vector<h5lcompact_obj_t> &objs,
+                       std::vector<h5lcompact_dset_t> &dsets,
+                       int *att_buf);
+
+void h5lcompact_parse_meta (std::string &inpath,
+                            int rank,
+                            int np,
+                            int *att_buf,
+                            std::vector<h5lcompact_dset_t> &dsets);
+
+void h5lcompact_gather_blocks (int rank, int np, std::vector<h5lcompact_dset_t> &dsets);
@@ -0,0 +1,436 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <cassert>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+//
+#include <hdf5.h>
+#include <libgen.h>
+#include <mpi.h>
+//
+#include "H5VL_log_dataseti.hpp"
+#include "H5VL_log_filei.hpp"
+#include "H5VL_logi_meta.hpp"
+#include "H5VL_logi_util.hpp"
+#include "h5lcompact.hpp"
+
+typedef struct h5lcompact_visit_arg_t {
+    std::vector<h5lcompact_obj_t> *objs;
+    std::vector<h5lcompact_dset_t> *dsets;
+} h5lcompact_visit_arg_t;
+
+/*
+ * Map the path of an object in the log-based file back to the one used by the application
+ * Names starting with '_' are stored with an extra '_' by the log-based VOL
+ */
+static std::string h5lcompact_unmap_name (const char *name) {
+    std::string ret;
+    const char *cp = name;
+
+    while (*cp) {
+        if ((cp == name || cp[-1] == '/') && cp[0] == '_' && cp[1] == '_') { cp++; }
+        ret.push_back (*cp);
+        cp++;
+    }
+
+    return ret;
+}
+
+static herr_t h5lcompact_visit_handler (hid_t o_id,
+                                        const char *name,
+                                        const H5O_info_t *object_info,
+                                        void *op_data) {
+    herr_t err   = 0;
+    hid_t did    = -1;  // Current dataset ID
+    hid_t aid    = -1;  // Dataset attribute ID
+    hid_t sid    = -1;  // Dataset attribute space ID
+    hid_t tid    = -1;  // Dataset type ID
+    hsize_t hndim;
+    h5lcompact_obj_t obj;
+    h5lcompact_visit_arg_t *argp = (h5lcompact_visit_arg_t *)op_data;
+
+    // Skip unnamed and hidden object
+    if ((name == NULL) || (name[0] == '_' && name[1] != '_') ||
+        (name[0] == '/' || (name[0] == '.'))) {
+        goto err_out;
+    }
+
+    try {
+        obj.name = h5lcompact_unmap_name (name);
+        obj.type = object_info->type;
+        obj.id   = -1;
+
+        if (object_info->type == H5O_TYPE_DATASET) {
+            did = H5Dopen2 (o_id, name, H5P_DEFAULT);
+            CHECK_ID (did)
+
+            // Read dataset ID
+            aid = H5Aopen (did, H5VL_LOG_DATASETI_ATTR_ID, H5P_DEFAULT);
+            CHECK_ID (aid)
+            err = H5Aread (aid, H5T_NATIVE_INT, &(obj.id));
+            CHECK_ERR
+            H5Aclose (aid);
+            aid = -1;
+
+            h5lcompact_dset_t &dset = (*(argp->dsets))[obj.id];
+
+            // Read ndim and dims
+            aid = H5Aopen (did, H5VL_LOG_DATASETI_ATTR_DIMS, H5P_DEFAULT);
+            CHECK_ID (aid)
+            sid = H5Aget_space (aid);
+            CHECK_ID (sid)
+            H5Sget_simple_extent_dims (sid, &hndim, NULL);
+            dset.ndim = hndim;
+            err       = H5Aread (aid, H5T_NATIVE_INT64, dset.dims);
+            CHECK_ERR
+
+            // Element size
+            tid = H5Dget_type (did);
+            CHECK_ID (tid)
+            dset.esize = H5Tget_size (tid);
+        }
+
+        if (object_info->type == H5O_TYPE_DATASET || object_info->type == H5O_TYPE_GROUP ||
+            object_info->type == H5O_TYPE_NAMED_DATATYPE) {
+            argp->objs->push_back (obj);
+        }
+    }
+    H5VL_LOGI_EXP_CATCH_ERR
+
+err_out:;
+    if (sid >= 0) { H5Sclose (sid); }
+    if (tid >= 0) { H5Tclose (tid); }
+    if (aid >= 0) { H5Aclose (aid); }
+    if (did >= 0) { H5Dclose (did); }
+    return err;
+}
+
+/*
+ * List the objects in the input file in creation order and read the layout of its datasets
+ * att_buf receives the file attribute of the log-based VOL
+ */
+void h5lcompact_visit (std::string &inpath,
+                       std::vector<h5lcompact_obj_t> &objs,
+                       std::vector<h5lcompact_dset_t> &dsets,
+                       int *att_buf) {
+    herr_t err       = 0;
+    hid_t fid        = -1;  // File ID
+    hid_t aid        = -1;  // ID of file attribute
+    hid_t faplid     = -1;  // File access property ID
+    hid_t nativevlid = -1;  // Native VOL ID
+    htri_t islog;
+    h5lcompact_visit_arg_t arg;
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (aid >= 0) { H5Aclose (aid); }
+        if (fid >= 0) { H5Fclose (fid); }
+        if (faplid >= 0) { H5Pclose (faplid); }
+    });
+
+    // Always use native VOL
+    nativevlid = H5VLget_connector_id_by_name ("native");
+    CHECK_ID (nativevlid)
+    faplid = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ID (faplid)
+    err = H5Pset_fapl_mpio (faplid, MPI_COMM_WORLD, MPI_INFO_NULL);
+    CHECK_ERR
+    err = H5Pset_vol (faplid, nativevlid, NULL);
+    CHECK_ERR
+    err = H5VLclose (nativevlid);
+    CHECK_ERR
+
+    fid = H5Fopen (inpath.c_str (), H5F_ACC_RDONLY, faplid);
+    CHECK_ID (fid)
+
+    // Read file metadata
+    islog = H5Aexists (fid, H5VL_LOG_FILEI_ATTR);
+    CHECK_ID (islog)
+    if (!islog) { ERR_OUT ("Input file is not a log-based file") }
+    aid = H5Aopen (fid, H5VL_LOG_FILEI_ATTR, H5P_DEFAULT);
+    CHECK_ID (aid)
+    err = H5Aread (aid, H5T_NATIVE_INT, att_buf);
+    CHECK_ERR
+    if (att_buf[3] & H5VL_FILEI_FEATURE_MASK & ~H5VL_FILEI_FEATURE_KNOWN) {
+        ERR_OUT ("File uses a metadata format feature not supported by this version")
+    }
+    dsets.resize (att_buf[0]);
+
+    arg.objs  = &objs;
+    arg.dsets = &dsets;
+    err = H5Ovisit3 (fid, H5_INDEX_CRT_ORDER, H5_ITER_INC, h5lcompact_visit_handler, &arg,
+                     H5O_INFO_ALL);
+    CHECK_ERR
+}
+
+/*
+ * Record the selection blocks of all entries in a metadata section
+ */
+static void h5lcompact_parse_sec (char *buf, size_t len, std::vector<h5lcompact_dset_t> &dsets) {
+    int i;
+    char *bufp = buf;              // Current decoding location in buf
+    H5VL_logi_meta_hdr *hdr;       // Header of current decoding entry
+    H5VL_logi_metaentry_t block;  // Current metadata entry
+    std::map<char *, std::vector<H5VL_logi_metasel_t>>
+        bcache;  // Cache for deduplicated metadata entry
+
+    while (bufp < buf + len) {
+        hdr = (H5VL_logi_meta_hdr *)bufp;
+
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)bufp, (uint32_t *)(bufp + sizeof (H5VL_logi_meta_hdr)));
+#endif
+
+        h5lcompact_dset_t &dset = dsets[hdr->did];
+        if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_REF) {
+            H5VL_logi_metaentry_ref_decode (dset, bufp, block, bcache);
+        } else {
+            H5VL_logi_metaentry_decode (dset, bufp, block);
+            bcache[bufp] = block.sels;
+        }
+        bufp += hdr->meta_size;
+
+        dset.written = true;
+        for (auto &sel : block.sels) {
+            for (i = 0; i < (int)(dset.ndim); i++) { dset.blocks.push_back (sel.start[i]); }
+            for (i = 0; i < (int)(dset.ndim); i++) { dset.blocks.push_back (sel.count[i]); }
+        }
+    }
+}
+
+/*
+ * Record the selection blocks of all entries in a metadata dataset
+ */
+static void h5lcompact_parse_mdset (hid_t lgid,
+                                    int idx,
+                                    H5VL_logi_meta_dict_t &dict,
+                                    std::vector<h5lcompact_dset_t> &dsets) {
+    herr_t err = 0;
+    int i;
+    hid_t did  = -1;  // Metadata dataset ID
+    hid_t dsid = -1;  // Metadata dataset space ID
+    hsize_t size;     // Size of the metadata dataset
+    MPI_Offset nsec;  // Number of sections
+    MPI_Offset decomp;  // Number of sections and flags
+    MPI_Offset esize;   // Size of decoded metadata entries
+    char *ebuf;         // Decoded metadata entries, NULL if the section is plain
+    MPI_Offset *offs;  // End of each section
+    char *buf = NULL;  // Content of the metadata dataset
+    char mdname[32];
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (buf) { free (buf); }
+        if (dsid >= 0) { H5Sclose (dsid); }
+        if (did >= 0) { H5Dclose (did); }
+    });
+
+    sprintf (mdname, "%s_%d", H5VL_LOG_FILEI_DSET_META, idx);
+    did = H5Dopen2 (lgid, mdname, H5P_DEFAULT);
+    CHECK_ID (did)
+    dsid = H5Dget_space (did);
+    CHECK_ID (dsid)
+    H5Sget_simple_extent_dims (dsid, &size, NULL);
+
+    buf = (char *)malloc (size ? size : 1);
+    CHECK_PTR (buf)
+    err = H5Dread (did, H5T_NATIVE_B8, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+    CHECK_ERR
+
+    // The first 8 bytes is the number of sections, followed by the end offset of each section
+    decomp = *((MPI_Offset *)buf);
+    nsec   = decomp & H5VL_LOGI_META_DECOMP_NSEC_MASK;
+    if (decomp & ~H5VL_LOGI_META_DECOMP_KNOWN) { ERR_OUT ("Unknown metadata format") }
+    offs   = (MPI_Offset *)buf;
+#ifdef WORDS_BIGENDIAN
+    H5VL_logi_llreverse ((uint64_t *)offs, (uint64_t *)(offs + nsec + 1));
+#endif
+    for (i = 0; i < nsec; i++) {
+        MPI_Offset start = i ? offs[i] : H5VL_logi_meta_sec_begin (decomp);
+
+        ebuf = H5VL_logi_meta_sec_decode (decomp, dict, buf + start, offs[i + 1] - start, &esize);
+        h5lcompact_parse_sec (ebuf ? ebuf : buf + start, esize, dsets);
+        free (ebuf);
+    }
+}
+
+/*
+ * Record the selection blocks of the metadata datasets assigned to this process
+ * Metadata datasets of the main file, or of all subfiles, are dealt round robin
+ */
+void h5lcompact_parse_meta (std::string &inpath,
+                            int rank,
+                            int np,
+                            int *att_buf,
+                            std::vector<h5lcompact_dset_t> &dsets) {
+    herr_t err = 0;
+    int mpierr;
+    int i, j, k;
+    int config = att_buf[3];
+    std::vector<std::string> paths;  // Files holding metadata
+    std::vector<int> nmdsets;        // Number of metadata datasets in each file
+    hid_t faplid = -1;
+    hid_t fid    = -1;
+    hid_t aid    = -1;
+    hid_t lgid   = -1;
+    int fatt[H5VL_LOG_FILEI_NATTR];
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (lgid >= 0) { H5Gclose (lgid); }
+        if (aid >= 0) { H5Aclose (aid); }
+        if (fid >= 0) { H5Fclose (fid); }
+        if (faplid >= 0) { H5Pclose (faplid); }
+    });
+
+    faplid = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ID (faplid)
+    {
+        hid_t nativevlid = H5VLget_connector_id_by_name ("native");
+        CHECK_ID (nativevlid)
+        err = H5Pset_vol (faplid, nativevlid, NULL);
+        CHECK_ERR
+        err = H5VLclose (nativevlid);
+        CHECK_ERR
+    }
+
+    if (config & H5VL_FILEI_CONFIG_SUBFILING) {
+        for (i = 0; i < att_buf[4]; i++) {
+            paths.push_back (inpath + ".subfiles/" +
+                             std::string (basename ((char *)(inpath.c_str ()))) + "." +
+                             std::to_string (i));
+        }
+
+        // Number of metadata datasets in each subfile
+        nmdsets.resize (paths.size ());
+        if (rank == 0) {
+            for (i = 0; i < (int)(paths.size ()); i++) {
+                fid = H5Fopen (paths[i].c_str (), H5F_ACC_RDONLY, faplid);
+                CHECK_ID (fid)
+                aid = H5Aopen (fid, H5VL_LOG_FILEI_ATTR, H5P_DEFAULT);
+                CHECK_ID (aid)
+                err = H5Aread (aid, H5T_NATIVE_INT, fatt);
+                CHECK_ERR
+                nmdsets[i] = fatt[2];
+                H5Aclose (aid);
+                aid = -1;
+                H5Fclose (fid);
+                fid = -1;
+            }
+        }
+        mpierr = MPI_Bcast (nmdsets.data (), (int)(nmdsets.size ()), MPI_INT, 0, MPI_COMM_WORLD);
+        CHECK_MPIERR
+    } else {
+        paths.push_back (inpath);
+        nmdsets.push_back (att_buf[2]);
+    }
+
+    k = 0;
+    for (i = 0; i < (int)(paths.size ()); i++) {
+        H5VL_logi_meta_dict_t dict;  // Selection dictionary of the file
+
+        for (j = 0; j < nmdsets[i]; j++, k++) {
+            if (k % np != rank) continue;
+
+            if (fid < 0) {
+                fid = H5Fopen (paths[i].c_str (), H5F_ACC_RDONLY, faplid);
+                CHECK_ID (fid)
+                lgid = H5Gopen2 (fid, H5VL_LOG_FILEI_GROUP_LOG, H5P_DEFAULT);
+                CHECK_ID (lgid)
+            }
+            H5VL_logi_meta_dict_read (lgid, j + 1, dict);
+            h5lcompact_parse_mdset (lgid, j, dict, dsets);
+        }
+        if (fid >= 0) {
+            H5Gclose (lgid);
+            lgid = -1;
+            H5Fclose (fid);
+            fid = -1;
+        }
+    }
+}
+
+/*
+ * Send the selection blocks of each dataset to the process handling it
+ * Dataset i is handled by process i % np. Afterwards only the handled datasets have blocks.
+ */
+void h5lcompact_gather_blocks (int rank, int np, std::vector<h5lcompact_dset_t> &dsets) {
+    int mpierr;
+    int i;
+    size_t j;
+    size_t nblock;
+    std::vector<std::vector<uint64_t>> sbufs;  // Blocks to each process
+    std::vector<uint64_t> sbuf, rbuf;
+    std::vector<int> scnt, sdsp, rcnt, rdsp;
+    size_t ssize, rsize;
+
+    // did, number of blocks, then the blocks
+    sbufs.resize (np);
+    for (i = 0; i < (int)(dsets.size ()); i++) {
+        h5lcompact_dset_t &dset = dsets[i];
+        std::vector<uint64_t> &dst = sbufs[i % np];
+
+        if (!dset.written) continue;
+
+        nblock = dset.ndim ? dset.blocks.size () / (2 * dset.ndim) : 1;
+        dst.push_back (i);
+        dst.push_back (nblock);
+        dst.insert (dst.end (), dset.blocks.begin (), dset.blocks.end ());
+
+        dset.written = false;
+        dset.blocks.clear ();
+        dset.blocks.shrink_to_fit ();
+    }
+
+    scnt.resize (np);
+    sdsp.resize (np);
+    rcnt.resize (np);
+    rdsp.resize (np);
+    ssize = 0;
+    for (i = 0; i < np; i++) {
+        scnt[i] = (int)(sbufs[i].size ());
+        sdsp[i] = (int)ssize;
+        ssize += sbufs[i].size ();
+        if (ssize > INT_MAX) { ERR_OUT ("Too many selection blocks to exchange") }
+    }
+    sbuf.reserve (ssize);
+    for (i = 0; i < np; i++) {
+        sbuf.insert (sbuf.end (), sbufs[i].begin (), sbufs[i].end ());
+        std::vector<uint64_t> ().swap (sbufs[i]);
+    }
+
+    mpierr = MPI_Alltoall (scnt.data (), 1, MPI_INT, rcnt.data (), 1, MPI_INT, MPI_COMM_WORLD);
+    CHECK_MPIERR
+    rsize = 0;
+    for (i = 0; i < np; i++) {
+        rdsp[i] = (int)rsize;
+        rsize += rcnt[i];
+        if (rsize > INT_MAX) { ERR_OUT ("Too many selection blocks to exchange") }
+    }
+    rbuf.resize (rsize);
+    mpierr = MPI_Alltoallv (sbuf.data (), scnt.data (), sdsp.data (), MPI_UINT64_T, rbuf.data (),
+                            rcnt.data (), rdsp.data (), MPI_UINT64_T, MPI_COMM_WORLD);
+    CHECK_MPIERR
+
+    for (j = 0; j < rsize;) {
+        h5lcompact_dset_t &dset = dsets[rbuf[j]];
+        size_t len;
+
+        nblock = rbuf[j + 1];
+        len    = nblock * 2 * dset.ndim;
+        j += 2;
+
+        assert ((int)(rbuf[j - 2] % np) == rank);
+        dset.written = true;
+        dset.blocks.insert (dset.blocks.end (), rbuf.begin () + j, rbuf.begin () + j + len);
+        j += len;
+    }
+}
@@ -0,0 +1,82 @@
+#!/bin/sh
+#
+# Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+# See COPYRIGHT notice in top-level directory.
+#
+
+# Exit immediately if a command exits with a non-zero status.
+set -e
+set -x
+
+outfile="test"
+H5LCOMPACT=${top_builddir}/utils/h5lcompact/h5lcompact
+H5LREPLAY=${top_builddir}/utils/h5lreplay/h5lreplay
+H5LGEN=${top_builddir}/utils/h5lreplay/h5lgen
+
+export HDF5_VOL_CONNECTOR="LOG under_vol=0;under_info={}" 
+export HDF5_PLUGIN_PATH="../../src/.libs"
+
+${TESTSEQRUN} ${H5LGEN} ${TESTOUTDIR}/${outfile}.h5l
+
+# ensure these 2 environment variables are not set
+unset HDF5_VOL_CONNECTOR
+unset HDF5_PLUGIN_PATH
+
+# use a small memory limit to copy the data in many rounds
+${TESTSEQRUN} ${H5LCOMPACT} -i ${TESTOUTDIR}/${outfile}.h5l -o ${TESTOUTDIR}/${outfile}.h5c --memory-limit 1k
+
+FILE_KIND=`${top_builddir}/utils/h5ldump/h5ldump -k ${TESTOUTDIR}/${outfile}.h5c`
+if test "x${FILE_KIND}" != xHDF5-LogVOL ; then
+   echo "Error: Output file ${outfile}.h5c is not Log VOL, but ${FILE_KIND}"
+   exit 1
+else
+   echo "Success: Output file ${outfile}.h5c is ${FILE_KIND}"
+fi
+
+# overwritten regions are removed from the compacted file
+STATS_L=`${TESTSEQRUN} ${top_builddir}/utils/h5ldump/h5ldump --stats ${TESTOUTDIR}/${outfile}.h5l`
+STATS_C=`${TESTSEQRUN} ${top_builddir}/utils/h5ldump/h5ldump --stats ${TESTOUTDIR}/${outfile}.h5c`
+echo "${STATS_L}"
+echo "${STATS_C}"
+
+# the first line is the file total, the rest are per dataset
+RATIO='s/.*Overwrite ratio: //'
+RATIO_L=`echo "${STATS_L}" | grep "Overwrite ratio" | ${SED} -e "${RATIO}" | head -n 1`
+RATIO_C=`echo "${STATS_C}" | grep "Overwrite ratio" | ${SED} -e "${RATIO}" | sort -u`
+if test "x${RATIO_L}" = x || test "x${RATIO_L}" = x0 ; then
+   echo "Error: ${outfile}.h5l has no overwritten elements, overwrite ratio is '${RATIO_L}'"
+   exit 1
+fi
+if test "x${RATIO_C}" != x0 ; then
+   echo "Error: ${outfile}.h5c still has overwritten elements, overwrite ratio is '${RATIO_C}'"
+   exit 1
+else
+   echo "Success: overwrite ratio is ${RATIO_L} in ${outfile}.h5l and 0 in ${outfile}.h5c"
+fi
+
+DISTINCT='s/.*Distinct elements: \([0-9]*\);.*/\1/'
+DISTINCT_L=`echo "${STATS_L}" | grep "Distinct elements" | ${SED} -e "${DISTINCT}" | sort -n`
+DISTINCT_C=`echo "${STATS_C}" | grep "Distinct elements" | ${SED} -e "${DISTINCT}" | sort -n`
+if test "x${DISTINCT_L}" = x || test "x${DISTINCT_L}" != "x${DISTINCT_C}" ; then
+   echo "Error: distinct elements differ, ${outfile}.h5l:" ${DISTINCT_L}
+   echo "       ${outfile}.h5c:" ${DISTINCT_C}
+   exit 1
+else
+   echo "Success: ${outfile}.h5c and ${outfile}.h5l have the same distinct elements"
+fi
+
+# the compacted file must hold the same data as the original one
+${TESTSEQRUN} ${H5LREPLAY} -i ${TESTOUTDIR}/${outfile}.h5l -o ${TESTOUTDIR}/${outfile}.h5r
+${TESTSEQRUN} ${H5LREPLAY} -i ${TESTOUTDIR}/${outfile}.h5c -o ${TESTOUTDIR}/${outfile}_c.h5r
+
+if test "x$H5DIFF" != x ; then
+   ${TESTSEQRUN} ${H5DIFF} ${TESTOUTDIR}/${outfile}.h5r ${TESTOUTDIR}/${outfile}_c.h5r
+   if test "x$?" != x0 ; then
+      echo "Error: ${outfile}.h5c differs from ${outfile}.h5l"
+      exit 1
+   else
+      echo "Success: ${outfile}.h5c and ${outfile}.h5l are the same"
+   fi
+fi
+
+exit 0
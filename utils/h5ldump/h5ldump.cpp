@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 //
+#include <getopt.h>
 #include <hdf5.h>
 #include <libgen.h>
 #include <mpi.h>
@@ -98,6 +99,8 @@ static void usage (char *argv0) {
        [-h] Print this help message\n\
        [-v] Verbose mode\n\
        [-H] Dump header metadata only\n\
+       [-s] Print summary statistics of the log layout instead of the entries,\n\
+            can run in parallel (long option --stats)\n\
        [-k] Print the kind of file, one of 'HDF5', 'HDF5-LogVOL', 'NetCDF-4',\n\
             'NetCDF classic', 'NetCDF 64-bit offset', or 'NetCDF 64-bit data'\n\
        FILE: Input file name\n";
@@ -110,9 +113,13 @@ int main (int argc, char *argv[]) {
     int opt;
     bool dumpdata  = true;                    // Dump data along with metadata
     bool showftype = false;                   // Show file type
+    bool showstats = false;                   // Show statistics instead of entries
     std::string inpath;                       // Input file path
     std::vector<H5VL_log_dset_info_t> dsets;  // Dataset infos
     std::string ftype;                        // File type
+    static struct option lopts[] = {{"help", no_argument, NULL, 'h'},
+                                    {"stats", no_argument, NULL, 's'},
+                                    {NULL, 0, NULL, 0}};
 
     MPI_Init (&argc, &argv);
     MPI_Comm_size (MPI_COMM_WORLD, &np);
@@ -120,17 +127,15 @@ int main (int argc, char *argv[]) {
 
     verbose = 0;
 
-    if (np > 1) {
-        if (rank == 0) { std::cout << "Warning: h5ldump is sequential" << std::endl; }
-        return 0;
-    }
-
     // Parse input
-    while ((opt = getopt (argc, argv, "hvkH")) != -1) {
+    while ((opt = getopt_long (argc, argv, "hvkHs", lopts, NULL)) != -1) {
         switch (opt) {
             case 'H':
                 dumpdata = false;
                 break;
+            case 's':
+                showstats = true;
+                break;
             case 'k':
                 showftype = true;
                 break;
@@ -152,6 +157,12 @@ int main (int argc, char *argv[]) {
     }
     inpath = std::string (argv[optind]);
 
+    // Only the statistics are computed in parallel
+    if (np > 1 && !showstats) {
+        if (rank == 0) { std::cout << "Warning: h5ldump is sequential" << std::endl; }
+        return 0;
+    }
+
     try {
         // Make sure input file is HDF5 file
         ftype = get_file_signature (inpath);
@@ -179,8 +190,13 @@ int main (int argc, char *argv[]) {
         // Get dataaset metadata
         h5ldump_visit (inpath, dsets);
 
-        // Dump the logs
-        h5ldump_file (inpath, dsets, dumpdata, 0);
+        if (showstats) {
+            // Summarize the logs
+            h5ldump_stats (inpath, dsets, rank, np);
+        } else {
+            // Dump the logs
+            h5ldump_file (inpath, dsets, dumpdata, 0);
+        }
 
         // Cleanup dataset contec
         for (auto &d : dsets) {
@@ -212,6 +228,7 @@ void h5ldump_file (std::string path,
     int nsubfile;                       // Number of subfiles
     int config;                         // File config flags
     int att_buf[H5VL_LOG_FILEI_NATTR];  // attribute buffer
+    H5VL_logi_meta_dict_t dict;         // Selection dictionary
     H5VL_logi_err_finally finally ([&] () -> void {
         if (fh != MPI_FILE_NULL) { MPI_File_close (&fh); }
         if (aid >= 0) { H5Aclose (aid); }
@@ -250,6 +267,9 @@ void h5ldump_file (std::string path,
     }
     err = H5Aread (aid, H5T_NATIVE_INT, att_buf);
     CHECK_ERR
+    if (att_buf[3] & H5VL_FILEI_FEATURE_MASK & ~H5VL_FILEI_FEATURE_KNOWN) {
+        ERR_OUT ("File uses a metadata format feature not supported by this version")
+    }
     ndset    = att_buf[0];
     nldset   = att_buf[1];
     nmdset   = att_buf[2];
@@ -299,11 +319,17 @@ void h5ldump_file (std::string path,
                       << std::endl;
             ERR_OUT ("File not recognized")
         }
+        // Selections referred by the metadata entries
+        H5VL_logi_meta_dict_read (lgid, nmdset, dict);
+        if (dict.offs.size ()) {
+            std::cout << std::string (indent, ' ') << "Selection dictionary records: "
+                      << dict.offs.size () << std::endl;
+        }
         // Iterate through metadata datasets
         for (i = 0; i < nmdset; i++) {
             std::cout << std::string (indent, ' ') << "Metadata dataset " << i << std::endl;
             h5ldump_mdset (lgid, H5VL_LOG_FILEI_DSET_META + std::string ("_") + std::to_string (i),
-                           dsets, fh, indent + 4);
+                           dsets, dict, fh, indent + 4);
             // std::cout << std::string (indent, ' ') << "End metadata dataset " << i << std::endl;
         }
     }
@@ -26,8 +26,10 @@ void h5ldump_file (std::string path,
 void h5ldump_mdset (hid_t lgid,
                     std::string name,
                     std::vector<H5VL_log_dset_info_t> &dsets,
+                    H5VL_logi_meta_dict_t &dict,
                     MPI_File fh,
                     int indent);
+void h5ldump_stats (std::string path, std::vector<H5VL_log_dset_info_t> &dsets, int rank, int np);
 void h5ldump_visit (std::string path, std::vector<H5VL_log_dset_info_t> &dsets);
 herr_t h5ldump_visit_handler (hid_t o_id,
                               const char *name,
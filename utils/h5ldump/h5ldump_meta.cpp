@@ -20,6 +20,7 @@
 #include <mpi.h>
 //
 #include "H5VL_log_filei.hpp"
+#include "H5VL_logi_meta.hpp"
 #include "H5VL_logi_nb.hpp"
 #include "H5VL_logi_util.hpp"
 #include "h5ldump.hpp"
@@ -27,6 +28,7 @@
 void h5ldump_mdset (hid_t lgid,
                     std::string name,
                     std::vector<H5VL_log_dset_info_t> &dsets,
+                    H5VL_logi_meta_dict_t &dict,
                     MPI_File fh,
                     int indent) {
     herr_t err = 0;
@@ -36,6 +38,9 @@ void h5ldump_mdset (hid_t lgid,
     hid_t msid = -1;                // Memory space ID
     hsize_t start, count, one = 1;  // Start and count to set dataspace selections
     MPI_Offset nsec;                // Number of processes writing to this metadata dataset
+    MPI_Offset decomp;              // Number of sections and flags of the metadata dataset
+    MPI_Offset esize;               // Size of decoded metadata entries
+    char *ebuf;                     // Decoded metadata entries, NULL if the section is plain
     MPI_Offset *offs = NULL;        // Offset of each metadata section
     uint8_t *buf;                   // Metadata buffer
     size_t bsize = 0;               // Size of metadata buffer
@@ -56,10 +61,18 @@ void h5ldump_mdset (hid_t lgid,
     count = sizeof (MPI_Offset);
     err   = H5Sselect_hyperslab (dsid, H5S_SELECT_SET, &start, NULL, &one, &count);
     CHECK_ERR
-    err = H5Dread (did, H5T_NATIVE_B8, H5S_ALL, dsid, H5P_DEFAULT, &nsec);
+    err = H5Dread (did, H5T_NATIVE_B8, H5S_ALL, dsid, H5P_DEFAULT, &decomp);
     CHECK_ERR
+    nsec = decomp & H5VL_LOGI_META_DECOMP_NSEC_MASK;
+    if (decomp & ~H5VL_LOGI_META_DECOMP_KNOWN) { ERR_OUT ("Unknown metadata format") }
 
     std::cout << std::string (indent, ' ') << "Number of metadata sections: " << nsec << std::endl;
+    if (decomp & H5VL_LOGI_META_DECOMP_FLAG_ZIP) {
+        std::cout << std::string (indent, ' ') << "Sections compressed: yes" << std::endl;
+    }
+    if (decomp & H5VL_LOGI_META_DECOMP_FLAG_PACK) {
+        std::cout << std::string (indent, ' ') << "Entry headers packed: yes" << std::endl;
+    }
 
     // Getting the offsets of sections
     start = sizeof (MPI_Offset);
@@ -69,7 +82,7 @@ void h5ldump_mdset (hid_t lgid,
     CHECK_ERR
     err = H5Dread (did, H5T_NATIVE_B8, H5S_ALL, dsid, H5P_DEFAULT, offs);
     CHECK_ERR
-    offs[0] = start + count;
+    offs[0] = H5VL_logi_meta_sec_begin (decomp);
 
     // Allocate metadata buffer
     for (i = 0; i < nsec; i++) {
@@ -91,7 +104,13 @@ void h5ldump_mdset (hid_t lgid,
         CHECK_ERR
 
         std::cout << std::string (indent, ' ') << "Metadata section " << i << ": " << std::endl;
-        h5ldump_mdsec (buf, count, dsets, fh, indent + 4);
+        ebuf = H5VL_logi_meta_sec_decode (decomp, dict, (char *)buf, count, &esize);
+        if (decomp & H5VL_LOGI_META_DECOMP_FLAG_ZIP) {
+            std::cout << std::string (indent + 4, ' ') << "Compressed size: " << count
+                      << ", decoded size: " << esize << std::endl;
+        }
+        h5ldump_mdsec (ebuf ? (uint8_t *)ebuf : buf, esize, dsets, fh, indent + 4);
+        free (ebuf);
         // std::cout << std::string (indent, ' ') << "End metadata section " << i << ": " <<
         // std::endl;
     }
@@ -255,6 +274,8 @@ void h5ldump_mdsec (
         if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_DEFLATE) { std::cout << "compressed, "; }
         if (hdr->flag & H5VL_LOGI_META_FLAG_REC) { std::cout << "record, "; }
         if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_REF) { std::cout << "duplicate, "; }
+        if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_POINT) { std::cout << "point list, "; }
+        if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_VARINT) { std::cout << "varint, "; }
         std::cout << std::endl;
         if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_REF) {
             // Get referenced selections
@@ -263,7 +284,7 @@ void h5ldump_mdsec (
             std::cout << std::string (indent, ' ')
                       << "Referenced entry offset: " << (off_t) (bufp - buf + roff) << std::endl;
         }
-        if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_ENCODE) {
+        if (hdr->flag & (H5VL_LOGI_META_FLAG_SEL_ENCODE | H5VL_LOGI_META_FLAG_SEL_POINT)) {
             std::cout << std::string (indent, ' ') << "Encoding slice size: (";
             for (i = 0; i < (int)(dsets[hdr->did].ndim) - 1; i++) {
                 std::cout << dsteps[i] << ", ";
@@ -0,0 +1,547 @@
+/*
+ *  Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+ *  See COPYRIGHT notice in top-level directory.
+ */
+/* $Id$ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+//
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+//
+#include <hdf5.h>
+#include <libgen.h>
+#include <mpi.h>
+//
+#include "H5VL_log_filei.hpp"
+#include "H5VL_logi_meta.hpp"
+#include "H5VL_logi_nb.hpp"
+#include "H5VL_logi_union.hpp"
+#include "H5VL_logi_util.hpp"
+#include "h5ldump.hpp"
+
+// Number of bins in the histograms, bin i counts values in [2^i, 2^(i+1))
+#define H5LDUMP_STATS_NBIN 32
+
+// Statistics of a dataset, all counters are uint64_t so they can be reduced as an array
+typedef struct h5ldump_dset_stat_t {
+    uint64_t nentry;                     // Number of metadata entries
+    uint64_t nsel;                       // Number of selection blocks
+    uint64_t nref;                       // Entries referring to the selection of another entry
+    uint64_t nzip;                       // Entries with compressed selections
+    uint64_t nenc;                       // Entries with encoded selections
+    uint64_t nrec;                       // Record entries
+    uint64_t npoint;                     // Point list entries
+    uint64_t mbytes;                     // Size of the metadata entries
+    uint64_t msave_dedup;                // Metadata saved by referring to other entries
+    uint64_t msave_zip;                  // Metadata saved by compressing the selections
+    uint64_t msave_enc;                  // Metadata saved by encoding the selections
+    uint64_t dbytes;                     // Size of the data in the file
+    uint64_t rbytes;                     // Size of the data before filtering
+    uint64_t nelem;                      // Number of elements written
+    uint64_t uelem;                      // Number of distinct elements written
+    uint64_t nhist[H5LDUMP_STATS_NBIN];  // Histogram of the number of blocks in an entry
+    uint64_t shist[H5LDUMP_STATS_NBIN];  // Histogram of the number of elements in a block
+} h5ldump_dset_stat_t;
+
+// Statistics of the main file or a subfile
+typedef struct h5ldump_file_stat_t {
+    uint64_t nsec;    // Number of metadata sections
+    uint64_t nentry;  // Number of metadata entries
+    uint64_t mbytes;  // Size of the metadata entries
+    uint64_t dbytes;  // Size of the data
+} h5ldump_file_stat_t;
+
+#define H5LDUMP_STATS_NFIELD(T) (sizeof (T) / sizeof (uint64_t))
+
+static inline int h5ldump_stats_bin (uint64_t val) {
+    int bin = 0;
+
+    while (val > 1 && bin < H5LDUMP_STATS_NBIN - 1) {
+        val >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+/*
+ * Accumulate the statistics of a metadata section
+ * The selection blocks of each dataset are appended to blocks for computing the overlap
+ */
+static void h5ldump_stats_mdsec (char *buf,
+                                 size_t len,
+                                 std::vector<H5VL_log_dset_info_t> &dsets,
+                                 std::vector<h5ldump_dset_stat_t> &stats,
+                                 std::vector<std::vector<hsize_t>> &blocks,
+                                 h5ldump_file_stat_t &fstat) {
+    int i;
+    char *bufp = buf;                 // Current decoding location in buf
+    H5VL_logi_meta_hdr *hdr;          // Header of current decoding entry
+    H5VL_logi_metaentry_t block;      // Current metadata block
+    MPI_Offset dsteps[H5S_MAX_RANK];  // coordinate to offset encoding info in ent
+    std::map<char *, std::vector<H5VL_logi_metasel_t>>
+        bcache;  // Cache for deduplicated metadata entry
+
+    while (bufp < buf + len) {
+        int isrec;       // Is a record entry
+        int encdim;      // Number of dimensions in the selections of the entry
+        uint64_t nelem;  // Number of elements in a block
+        uint64_t rsize;  // Size of the entry without dedup, compression, and encoding
+        uint64_t esize;  // Size of the entry without dedup and compression
+        uint64_t nsel;   // Number of selection blocks
+
+        hdr = (H5VL_logi_meta_hdr *)bufp;
+
+#ifdef WORDS_BIGENDIAN
+        H5VL_logi_lreverse ((uint32_t *)bufp, (uint32_t *)(bufp + sizeof (H5VL_logi_meta_hdr)));
+#endif
+
+        // Have to parse all entries for reference purpose
+        if (hdr->flag & H5VL_LOGI_META_FLAG_SEL_REF) {
+            H5VL_logi_metaentry_ref_decode (dsets[hdr->did], bufp, block, bcache);
+        } else {
+            H5VL_logi_metaentry_decode (dsets[hdr->did], bufp, block, dsteps);
+
+            // Insert to cache
+            bcache[bufp] = block.sels;
+        }
+        bufp += hdr->meta_size;
+
+        H5VL_log_dset_info_t &dset = dsets[block.hdr.did];
+        h5ldump_dset_stat_t &st    = stats[block.hdr.did];
+        std::vector<hsize_t> &bs   = blocks[block.hdr.did];
+
+        st.nentry++;
+        fstat.nentry++;
+        st.mbytes += block.hdr.meta_size;
+        fstat.mbytes += block.hdr.meta_size;
+        st.dbytes += block.hdr.fsize;
+        fstat.dbytes += block.hdr.fsize;
+
+        // Selections
+        nsel = block.sels.size ();
+        st.nsel += nsel;
+        st.nhist[h5ldump_stats_bin (nsel)]++;
+        if (dset.ndim == 0) {
+            st.nelem++;
+            st.rbytes += dset.esize;
+        }
+        for (auto &s : block.sels) {
+            nelem = 1;
+            for (i = 0; i < (int)(dset.ndim); i++) {
+                nelem *= s.count[i];
+                bs.push_back (s.start[i]);
+            }
+            for (i = 0; i < (int)(dset.ndim); i++) { bs.push_back (s.count[i]); }
+            st.shist[h5ldump_stats_bin (nelem)]++;
+            st.nelem += nelem;
+            st.rbytes += nelem * dset.esize;
+        }
+
+        // Savings of each metadata feature, relative to listing start and count of every block
+        isrec  = (block.hdr.flag & H5VL_LOGI_META_FLAG_REC) ? 1 : 0;
+        encdim = (int)(dset.ndim) - isrec;
+        rsize  = sizeof (H5VL_logi_meta_hdr) + isrec * sizeof (MPI_Offset) +
+                (nsel > 1 ? sizeof (int) : 0) + nsel * 2 * encdim * sizeof (MPI_Offset);
+        if (block.hdr.flag & H5VL_LOGI_META_FLAG_REC) { st.nrec++; }
+        if (block.hdr.flag & H5VL_LOGI_META_FLAG_SEL_REF) {
+            st.nref++;
+            if (rsize > (uint64_t)block.hdr.meta_size) {
+                st.msave_dedup += rsize - block.hdr.meta_size;
+            }
+        } else if (block.hdr.flag & H5VL_LOGI_META_FLAG_SEL_POINT) {
+            st.npoint++;
+        } else {
+            esize = block.hdr.meta_size;
+            if (block.hdr.flag & H5VL_LOGI_META_FLAG_SEL_DEFLATE) {
+                st.nzip++;
+                esize = sizeof (H5VL_logi_meta_hdr) + isrec * sizeof (MPI_Offset) + sizeof (int);
+                if (block.hdr.flag & H5VL_LOGI_META_FLAG_SEL_ENCODE) {
+                    esize += (encdim - 1 + nsel * 2) * sizeof (MPI_Offset);
+                } else {
+                    esize += nsel * 2 * encdim * sizeof (MPI_Offset);
+                }
+                if (esize > (uint64_t)block.hdr.meta_size) {
+                    st.msave_zip += esize - block.hdr.meta_size;
+                }
+            }
+            if (block.hdr.flag &
+                (H5VL_LOGI_META_FLAG_SEL_ENCODE | H5VL_LOGI_META_FLAG_SEL_VARINT)) {
+                st.nenc++;
+                if (rsize > esize) { st.msave_enc += rsize - esize; }
+            }
+        }
+    }
+}
+
+/*
+ * Accumulate the statistics of a metadata dataset
+ */
+static void h5ldump_stats_mdset (hid_t lgid,
+                                 int idx,
+                                 H5VL_logi_meta_dict_t &dict,
+                                 std::vector<H5VL_log_dset_info_t> &dsets,
+                                 std::vector<h5ldump_dset_stat_t> &stats,
+                                 std::vector<std::vector<hsize_t>> &blocks,
+                                 h5ldump_file_stat_t &fstat) {
+    herr_t err = 0;
+    int i;
+    hid_t did  = -1;   // Metadata dataset ID
+    hid_t dsid = -1;   // Metadata dataset space ID
+    hsize_t size;      // Size of the metadata dataset
+    MPI_Offset nsec;   // Number of sections
+    MPI_Offset decomp;  // Number of sections and flags
+    MPI_Offset esize;   // Size of decoded metadata entries
+    char *ebuf;         // Decoded metadata entries, NULL if the section is plain
+    MPI_Offset *offs;  // End of each section
+    char *buf = NULL;  // Content of the metadata dataset
+    std::string name = H5VL_LOG_FILEI_DSET_META + std::string ("_") + std::to_string (idx);
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (buf) { free (buf); }
+        if (dsid >= 0) { H5Sclose (dsid); }
+        if (did >= 0) { H5Dclose (did); }
+    });
+
+    did = H5Dopen2 (lgid, name.c_str (), H5P_DEFAULT);
+    CHECK_ID (did)
+    dsid = H5Dget_space (did);
+    CHECK_ID (dsid)
+    H5Sget_simple_extent_dims (dsid, &size, NULL);
+
+    buf = (char *)malloc (size ? size : 1);
+    CHECK_PTR (buf)
+    err = H5Dread (did, H5T_NATIVE_B8, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+    CHECK_ERR
+
+    // The first 8 bytes is the number of sections, followed by the end offset of each section
+    decomp = *((MPI_Offset *)buf);
+    nsec   = decomp & H5VL_LOGI_META_DECOMP_NSEC_MASK;
+    if (decomp & ~H5VL_LOGI_META_DECOMP_KNOWN) { ERR_OUT ("Unknown metadata format") }
+    offs   = (MPI_Offset *)buf;
+#ifdef WORDS_BIGENDIAN
+    H5VL_logi_llreverse ((uint64_t *)offs, (uint64_t *)(offs + nsec + 1));
+#endif
+    fstat.nsec += nsec;
+    for (i = 0; i < nsec; i++) {
+        MPI_Offset start = i ? offs[i] : H5VL_logi_meta_sec_begin (decomp);
+
+        ebuf = H5VL_logi_meta_sec_decode (decomp, dict, buf + start, offs[i + 1] - start, &esize);
+        h5ldump_stats_mdsec (ebuf ? ebuf : buf + start, esize, dsets, stats, blocks, fstat);
+        free (ebuf);
+    }
+}
+
+/*
+ * Count the distinct elements written to each dataset
+ * The blocks of dataset i are sent to process i % np, which records the count in stats
+ */
+static void h5ldump_stats_overlap (int rank,
+                                   int np,
+                                   std::vector<H5VL_log_dset_info_t> &dsets,
+                                   std::vector<h5ldump_dset_stat_t> &stats,
+                                   std::vector<std::vector<hsize_t>> &blocks) {
+    int mpierr;
+    int i, k;
+    size_t j;
+    std::vector<std::vector<uint64_t>> sbufs;  // Blocks to each process
+    std::vector<uint64_t> sbuf, rbuf;
+    std::vector<int> scnt, sdsp, rcnt, rdsp;
+    size_t ssize, rsize;
+
+    // did, number of values, then the blocks
+    sbufs.resize (np);
+    for (i = 0; i < (int)(dsets.size ()); i++) {
+        std::vector<uint64_t> &dst = sbufs[i % np];
+
+        if (blocks[i].empty ()) continue;
+
+        dst.push_back (i);
+        dst.push_back (blocks[i].size ());
+        dst.insert (dst.end (), blocks[i].begin (), blocks[i].end ());
+        std::vector<hsize_t> ().swap (blocks[i]);
+    }
+
+    scnt.resize (np);
+    sdsp.resize (np);
+    rcnt.resize (np);
+    rdsp.resize (np);
+    ssize = 0;
+    for (i = 0; i < np; i++) {
+        scnt[i] = (int)(sbufs[i].size ());
+        sdsp[i] = (int)ssize;
+        ssize += sbufs[i].size ();
+        if (ssize > INT_MAX) { ERR_OUT ("Too many selection blocks to exchange") }
+    }
+    sbuf.reserve (ssize);
+    for (i = 0; i < np; i++) {
+        sbuf.insert (sbuf.end (), sbufs[i].begin (), sbufs[i].end ());
+        std::vector<uint64_t> ().swap (sbufs[i]);
+    }
+
+    mpierr = MPI_Alltoall (scnt.data (), 1, MPI_INT, rcnt.data (), 1, MPI_INT, MPI_COMM_WORLD);
+    CHECK_MPIERR
+    rsize = 0;
+    for (i = 0; i < np; i++) {
+        rdsp[i] = (int)rsize;
+        rsize += rcnt[i];
+        if (rsize > INT_MAX) { ERR_OUT ("Too many selection blocks to exchange") }
+    }
+    rbuf.resize (rsize);
+    mpierr = MPI_Alltoallv (sbuf.data (), scnt.data (), sdsp.data (), MPI_UINT64_T, rbuf.data (),
+                            rcnt.data (), rdsp.data (), MPI_UINT64_T, MPI_COMM_WORLD);
+    CHECK_MPIERR
+
+    for (j = 0; j < rsize; j += 2 + rbuf[j + 1]) {
+        blocks[rbuf[j]].insert (blocks[rbuf[j]].end (), rbuf.begin () + j + 2,
+                                rbuf.begin () + j + 2 + rbuf[j + 1]);
+    }
+
+    // Scalar datasets have at most one element
+    for (i = rank; i < (int)(dsets.size ()); i += np) {
+        int ndim = (int)(dsets[i].ndim);
+
+        if (ndim == 0) {
+            stats[i].uelem = stats[i].nelem ? 1 : 0;
+            continue;
+        }
+
+        // The boxes of the union are disjoint, the distinct elements are the sum of their sizes
+        H5VL_logi_union (ndim, blocks[i]);
+        stats[i].uelem = 0;
+        for (j = 0; j < blocks[i].size (); j += 2 * ndim) {
+            uint64_t nelem = 1;
+            for (k = 0; k < ndim; k++) { nelem *= blocks[i][j + ndim + k]; }
+            stats[i].uelem += nelem;
+        }
+        std::vector<hsize_t> ().swap (blocks[i]);
+    }
+    // The count is kept only by the owner, other processes contribute 0 to the reduction
+    for (i = 0; i < (int)(dsets.size ()); i++) {
+        if (i % np != rank) { stats[i].uelem = 0; }
+    }
+}
+
+static void h5ldump_stats_print_hist (const char *title, uint64_t *hist, int indent) {
+    int i;
+
+    std::cout << std::string (indent, ' ') << title << ":" << std::endl;
+    for (i = 0; i < H5LDUMP_STATS_NBIN; i++) {
+        if (hist[i] == 0) continue;
+        std::cout << std::string (indent + 4, ' ') << "[" << (i ? (1ULL << i) : 0) << ", "
+                  << ((1ULL << (i + 1)) - 1) << "]: " << hist[i] << std::endl;
+    }
+}
+
+static inline double h5ldump_stats_ratio (uint64_t a, uint64_t b) {
+    return b ? (double)a / (double)b : 0;
+}
+
+static void h5ldump_stats_print_dset (h5ldump_dset_stat_t &st, int indent) {
+    std::cout << std::string (indent, ' ') << "Metadata entries: " << st.nentry
+              << "; Selection blocks: " << st.nsel << std::endl;
+    std::cout << std::string (indent, ' ') << "Duplicate entries: " << st.nref
+              << "; Compressed entries: " << st.nzip << "; Encoded entries: " << st.nenc
+              << "; Record entries: " << st.nrec << "; Point list entries: " << st.npoint
+              << std::endl;
+    std::cout << std::string (indent, ' ') << "Metadata size: " << st.mbytes
+              << "; Data size: " << st.dbytes << "; Metadata to data ratio: "
+              << h5ldump_stats_ratio (st.mbytes, st.dbytes) << std::endl;
+    std::cout << std::string (indent, ' ')
+              << "Metadata saved by deduplication: " << st.msave_dedup
+              << "; by compression: " << st.msave_zip << "; by encoding: " << st.msave_enc
+              << std::endl;
+    std::cout << std::string (indent, ' ') << "Data size before filtering: " << st.rbytes
+              << "; Saved by filters: " << (st.rbytes > st.dbytes ? st.rbytes - st.dbytes : 0)
+              << std::endl;
+    std::cout << std::string (indent, ' ') << "Elements written: " << st.nelem
+              << "; Distinct elements: " << st.uelem << "; Overwrite ratio: "
+              << h5ldump_stats_ratio (st.nelem - st.uelem, st.nelem) << std::endl;
+    h5ldump_stats_print_hist ("Blocks per entry", st.nhist, indent);
+    h5ldump_stats_print_hist ("Elements per block", st.shist, indent);
+}
+
+void h5ldump_stats (std::string path, std::vector<H5VL_log_dset_info_t> &dsets, int rank, int np) {
+    herr_t err = 0;
+    int mpierr;
+    int i, j, k;
+    hid_t fid    = -1;                         // File ID
+    hid_t faplid = -1;                         // File access property ID
+    hid_t lgid   = -1;                         // Log group ID
+    hid_t aid    = -1;                         // File attribute ID
+    int att_buf[H5VL_LOG_FILEI_NATTR];         // attribute buffer
+    int fatt[H5VL_LOG_FILEI_NATTR];            // attribute buffer of subfiles
+    std::vector<std::string> paths;            // Files holding metadata
+    std::vector<int> nmdsets;                  // Number of metadata datasets in each file
+    std::vector<h5ldump_dset_stat_t> stats;    // Statistics of each dataset
+    std::vector<h5ldump_file_stat_t> fstats;   // Statistics of each file
+    std::vector<std::vector<hsize_t>> blocks;  // Selection blocks of each dataset
+    h5ldump_dset_stat_t total;                 // Statistics of all datasets
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (lgid >= 0) { H5Gclose (lgid); }
+        if (aid >= 0) { H5Aclose (aid); }
+        if (fid >= 0) { H5Fclose (fid); }
+        if (faplid >= 0) { H5Pclose (faplid); }
+    });
+
+    // Always use native VOL
+    faplid = H5Pcreate (H5P_FILE_ACCESS);
+    CHECK_ID (faplid)
+    {
+        hid_t nativevlid = H5VLget_connector_id_by_name ("native");
+        CHECK_ID (nativevlid)
+        err = H5Pset_vol (faplid, nativevlid, NULL);
+        CHECK_ERR
+        err = H5VLclose (nativevlid);
+        CHECK_ERR
+    }
+
+    fid = H5Fopen (path.c_str (), H5F_ACC_RDONLY, faplid);
+    CHECK_ID (fid)
+    aid = H5Aopen (fid, H5VL_LOG_FILEI_ATTR, H5P_DEFAULT);
+    CHECK_ID (aid)
+    err = H5Aread (aid, H5T_NATIVE_INT, att_buf);
+    CHECK_ERR
+    if (att_buf[3] & H5VL_FILEI_FEATURE_MASK & ~H5VL_FILEI_FEATURE_KNOWN) {
+        ERR_OUT ("File uses a metadata format feature not supported by this version")
+    }
+    H5Aclose (aid);
+    aid = -1;
+    H5Fclose (fid);
+    fid = -1;
+
+    // Files holding metadata and number of metadata datasets in each of them
+    if (att_buf[3] & H5VL_FILEI_CONFIG_SUBFILING) {
+        for (i = 0; i < att_buf[4]; i++) {
+            paths.push_back (path + ".subfiles/" +
+                             std::string (basename ((char *)(path.c_str ()))) + "." +
+                             std::to_string (i));
+        }
+        nmdsets.resize (paths.size ());
+        if (rank == 0) {
+            for (i = 0; i < (int)(paths.size ()); i++) {
+                fid = H5Fopen (paths[i].c_str (), H5F_ACC_RDONLY, faplid);
+                CHECK_ID (fid)
+                aid = H5Aopen (fid, H5VL_LOG_FILEI_ATTR, H5P_DEFAULT);
+                CHECK_ID (aid)
+                err = H5Aread (aid, H5T_NATIVE_INT, fatt);
+                CHECK_ERR
+                nmdsets[i] = fatt[2];
+                H5Aclose (aid);
+                aid = -1;
+                H5Fclose (fid);
+                fid = -1;
+            }
+        }
+        mpierr = MPI_Bcast (nmdsets.data (), (int)(nmdsets.size ()), MPI_INT, 0, MPI_COMM_WORLD);
+        CHECK_MPIERR
+    } else {
+        paths.push_back (path);
+        nmdsets.push_back (att_buf[2]);
+    }
+
+    // Metadata datasets are dealt round robin
+    stats.resize (dsets.size ());
+    memset (stats.data (), 0, sizeof (h5ldump_dset_stat_t) * stats.size ());
+    fstats.resize (paths.size ());
+    memset (fstats.data (), 0, sizeof (h5ldump_file_stat_t) * fstats.size ());
+    blocks.resize (dsets.size ());
+    k = 0;
+    for (i = 0; i < (int)(paths.size ()); i++) {
+        H5VL_logi_meta_dict_t dict;  // Selection dictionary of the file
+
+        for (j = 0; j < nmdsets[i]; j++, k++) {
+            if (k % np != rank) continue;
+
+            if (fid < 0) {
+                fid = H5Fopen (paths[i].c_str (), H5F_ACC_RDONLY, faplid);
+                CHECK_ID (fid)
+                lgid = H5Gopen2 (fid, H5VL_LOG_FILEI_GROUP_LOG, H5P_DEFAULT);
+                CHECK_ID (lgid)
+            }
+            H5VL_logi_meta_dict_read (lgid, j + 1, dict);
+            h5ldump_stats_mdset (lgid, j, dict, dsets, stats, blocks, fstats[i]);
+        }
+        if (fid >= 0) {
+            H5Gclose (lgid);
+            lgid = -1;
+            H5Fclose (fid);
+            fid = -1;
+        }
+    }
+    h5ldump_stats_overlap (rank, np, dsets, stats, blocks);
+
+    // Sum up the statistics on rank 0
+    mpierr = MPI_Reduce (rank ? stats.data () : MPI_IN_PLACE, stats.data (),
+                         (int)(H5LDUMP_STATS_NFIELD (h5ldump_dset_stat_t) * stats.size ()),
+                         MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    CHECK_MPIERR
+    mpierr = MPI_Reduce (rank ? fstats.data () : MPI_IN_PLACE, fstats.data (),
+                         (int)(H5LDUMP_STATS_NFIELD (h5ldump_file_stat_t) * fstats.size ()),
+                         MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    CHECK_MPIERR
+    if (rank) return;
+
+    // Per file summary
+    memset (&total, 0, sizeof (total));
+    for (auto &st : stats) {
+        uint64_t *dst = (uint64_t *)&total;
+        uint64_t *src = (uint64_t *)&st;
+        for (i = 0; i < (int)H5LDUMP_STATS_NFIELD (h5ldump_dset_stat_t); i++) { dst[i] += src[i]; }
+    }
+    std::cout << "File: " << path << std::endl;
+    std::cout << std::string (4, ' ') << "Number of user datasets: " << att_buf[0] << std::endl;
+    std::cout << std::string (4, ' ') << "Number of data datasets: " << att_buf[1] << std::endl;
+    std::cout << std::string (4, ' ') << "Number of metadata datasets: " << att_buf[2]
+              << std::endl;
+    h5ldump_stats_print_dset (total, 4);
+
+    // Balance among subfiles
+    if (att_buf[3] & H5VL_FILEI_CONFIG_SUBFILING) {
+        uint64_t dmin = ULLONG_MAX, dmax = 0, dsum = 0;
+        uint64_t emin = ULLONG_MAX, emax = 0, esum = 0;
+        double dmean, emean;
+
+        std::cout << std::string (4, ' ') << "Number of subfiles: " << paths.size () << std::endl;
+        for (i = 0; i < (int)(paths.size ()); i++) {
+            std::cout << std::string (8, ' ') << "Subfile " << i << ": Metadata sections: "
+                      << fstats[i].nsec << "; Metadata entries: " << fstats[i].nentry
+                      << "; Metadata size: " << fstats[i].mbytes
+                      << "; Data size: " << fstats[i].dbytes << std::endl;
+            dmin = std::min (dmin, fstats[i].dbytes);
+            dmax = std::max (dmax, fstats[i].dbytes);
+            dsum += fstats[i].dbytes;
+            emin = std::min (emin, fstats[i].nentry);
+            emax = std::max (emax, fstats[i].nentry);
+            esum += fstats[i].nentry;
+        }
+        dmean = (double)dsum / paths.size ();
+        emean = (double)esum / paths.size ();
+        std::cout << std::string (4, ' ') << "Subfile data size: min " << dmin << "; max " << dmax
+                  << "; mean " << dmean << "; imbalance (max / mean) "
+                  << (dmean > 0 ? dmax / dmean : 0) << std::endl;
+        std::cout << std::string (4, ' ') << "Subfile metadata entries: min " << emin << "; max "
+                  << emax << "; mean " << emean << "; imbalance (max / mean) "
+                  << (emean > 0 ? emax / emean : 0) << std::endl;
+    } else {
+        std::cout << std::string (4, ' ') << "Metadata sections: " << fstats[0].nsec << std::endl;
+    }
+
+    // Per dataset summary
+    for (i = 0; i < (int)(stats.size ()); i++) {
+        if (stats[i].nentry == 0) continue;
+
+        std::cout << std::string (4, ' ') << "Dataset " << i;
+        if (dsets[i].path.size ()) { std::cout << " (" << dsets[i].path << ")"; }
+        std::cout << std::endl;
+        h5ldump_stats_print_dset (stats[i], 8);
+    }
+}
@@ -126,6 +126,9 @@ herr_t h5ldump_visit_handler (hid_t o_id,
             CHECK_ID (dcplid)
             H5VL_logi_get_filters (dcplid, dset.filters);
 
+            // Path as seen by the application
+            dset.path = std::string (name[0] == '_' ? name + 1 : name);
+
             ((*dsets)[id]) = dset;
         }
     }
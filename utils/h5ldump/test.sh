@@ -0,0 +1,51 @@
+#!/bin/sh
+#
+# Copyright (C) 2022, Northwestern University and Argonne National Laboratory
+# See COPYRIGHT notice in top-level directory.
+#
+
+# Exit immediately if a command exits with a non-zero status.
+set -e
+set -x
+
+outfile="test"
+H5LDUMP=${top_builddir}/utils/h5ldump/h5ldump
+H5LGEN=${top_builddir}/utils/h5lreplay/h5lgen
+
+export HDF5_VOL_CONNECTOR="LOG under_vol=0;under_info={}" 
+export HDF5_PLUGIN_PATH="../../src/.libs"
+
+# 2 datasets of 10 x 10 elements, the first row of /D is written twice
+${TESTSEQRUN} ${H5LGEN} ${TESTOUTDIR}/${outfile}.h5l
+
+# ensure these 2 environment variables are not set
+unset HDF5_VOL_CONNECTOR
+unset HDF5_PLUGIN_PATH
+
+STATS=`${TESTSEQRUN} ${H5LDUMP} --stats ${TESTOUTDIR}/${outfile}.h5l`
+echo "${STATS}"
+
+NDSET=`echo "${STATS}" | grep "Number of user datasets" | ${SED} -e 's/.*: //'`
+if test "x${NDSET}" != x2 ; then
+   echo "Error: expect 2 user datasets in ${outfile}.h5l, but got '${NDSET}'"
+   exit 1
+fi
+
+# the first line is the file total
+EXPECT="Elements written: 210; Distinct elements: 200; Overwrite ratio: 0.047619"
+TOTAL=`echo "${STATS}" | grep "Distinct elements" | head -n 1 | ${SED} -e 's/^ *//'`
+if test "x${TOTAL}" != "x${EXPECT}" ; then
+   echo "Error: unexpected element counts in ${outfile}.h5l: '${TOTAL}'"
+   exit 1
+else
+   echo "Success: ${TOTAL}"
+fi
+
+# the dataset written once has no overwritten elements
+NZERO=`echo "${STATS}" | grep -c "Distinct elements: 100; Overwrite ratio: 0$"`
+if test "x${NZERO}" != x1 ; then
+   echo "Error: expect 1 dataset without overwritten elements, but got '${NZERO}'"
+   exit 1
+fi
+
+exit 0
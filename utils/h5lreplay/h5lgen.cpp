@@ -34,6 +34,7 @@ int main (int argc, char **argv) {
     hid_t faplid    = -1;
     hid_t log_vlid  = -1;  // Logvol ID
     hsize_t dims[2] = {N, M};
+    hsize_t start[2], count[2];
 
     MPI_Init (&argc, &argv);
     MPI_Comm_size (MPI_COMM_WORLD, &np);
@@ -105,6 +106,18 @@ int main (int argc, char **argv) {
     err = H5Dwrite (gdid, H5T_NATIVE_INT32, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
     CHECK_ERR (err)
 
+    // Overwrite the first row of the file dataset, so the log holds overwritten data
+    start[0] = 0;
+    start[1] = 0;
+    count[0] = 1;
+    count[1] = M;
+    err      = H5Sselect_hyperslab (sid, H5S_SELECT_SET, start, NULL, count, NULL);
+    CHECK_ERR (err)
+    msid = H5Screate_simple (2, count, count);
+    CHECK_ID (msid)
+    err = H5Dwrite (did, H5T_NATIVE_INT32, msid, sid, H5P_DEFAULT, buf + M);
+    CHECK_ERR (err)
+
 err_out:
     if (sid >= 0) H5Sclose (sid);
     if (asid >= 0) H5Sclose (asid);
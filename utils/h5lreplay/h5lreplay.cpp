@@ -17,6 +17,7 @@
 #include <vector>
 //
 #include <dirent.h>
+#include <getopt.h>
 #include <hdf5.h>
 #include <libgen.h>
 #include <mpi.h>
@@ -30,13 +31,50 @@
 #include "h5lreplay_data.hpp"
 #include "h5lreplay_meta.hpp"
 
+// Default memory used to buffer data, in bytes
+#define H5LREPLAY_MLIMIT_DEFAULT (1024 * 1024 * 1024)
+
 const char hdf5sig[] = {(char)0x89, (char)0x48, (char)0x44, (char)0x46,
                         (char)0x0d, (char)0x0a, (char)0x1a, (char)0x0a};
 
+/*----< parse_size() >-------------------------------------------------------*/
+// Parse a size in bytes with an optional k, m, or g suffix, return 0 on error
+static size_t parse_size (const char *str) {
+    char *end;
+    size_t size;
+
+    size = (size_t)strtoull (str, &end, 10);
+    switch (*end) {
+        case 'g':
+        case 'G':
+            size *= 1024;
+            // fall through
+        case 'm':
+        case 'M':
+            size *= 1024;
+            // fall through
+        case 'k':
+        case 'K':
+            size *= 1024;
+            end++;
+            break;
+        default:;
+    }
+    if (*end != '\0') { return 0; }
+
+    return size;
+}
+
 int main (int argc, char *argv[]) {
     herr_t err = 0;
     int rank, np;
     int opt;
+    size_t mlimit = H5LREPLAY_MLIMIT_DEFAULT;  // Memory limit of the data buffer
+    static struct option lopts[] = {{"help", no_argument, NULL, 'h'},
+                                    {"input", required_argument, NULL, 'i'},
+                                    {"output", required_argument, NULL, 'o'},
+                                    {"memory-limit", required_argument, NULL, 'm'},
+                                    {NULL, 0, NULL, 0}};
     std::string inpath, outpath;
     std::ifstream fin;  // File stream for reading file signature
     char sig[8];        // File signature
@@ -46,7 +84,7 @@ int main (int argc, char *argv[]) {
     MPI_Comm_rank (MPI_COMM_WORLD, &rank);
 
     // Parse input
-    while ((opt = getopt (argc, argv, "hi:o:")) != -1) {
+    while ((opt = getopt_long (argc, argv, "hi:o:m:", lopts, NULL)) != -1) {
         switch (opt) {
             case 'i':
                 inpath = std::string (optarg);
@@ -54,10 +92,20 @@ int main (int argc, char *argv[]) {
             case 'o':
                 outpath = std::string (optarg);
                 break;
+            case 'm':
+                mlimit = parse_size (optarg);
+                if (mlimit == 0) {
+                    if (rank == 0) {
+                        std::cout << "Error: invalid memory limit " << optarg << std::endl;
+                    }
+                    return -1;
+                }
+                break;
             case 'h':
             default:
                 if (rank == 0) {
-                    std::cout << "Usage: h5lreplay -i <input file path> -o <output file path>"
+                    std::cout << "Usage: h5lreplay -i <input file path> -o <output file path> "
+                                 "[-m <memory limit in bytes, k/m/g suffix allowed>]"
                               << std::endl;
                 }
                 return 0;
@@ -82,7 +130,7 @@ int main (int argc, char *argv[]) {
     MPI_Bcast (&err, 1, MPI_INT, 0, MPI_COMM_WORLD);
 
     try {
-        h5lreplay_core (inpath, outpath, rank, np);
+        h5lreplay_core (inpath, outpath, rank, np, mlimit);
     }
     H5VL_LOGI_EXP_CATCH_ERR
 
@@ -129,7 +177,8 @@ static int split_comm (MPI_Comm orig_comm, MPI_Comm *sub_comm, int *num_subfiles
     return (mpierr != MPI_SUCCESS);
 }
 
-void h5lreplay_core (std::string &inpath, std::string &outpath, int rank, int np) {
+void h5lreplay_core (
+    std::string &inpath, std::string &outpath, int rank, int np, size_t mlimit) {
     herr_t err = 0;
     int mpierr;
     int i;
@@ -207,6 +256,9 @@ void h5lreplay_core (std::string &inpath, std::string &outpath, int rank, int np
     CHECK_ERR
     err = H5Aread (aid, H5T_NATIVE_INT, att_buf);
     CHECK_ERR
+    if (att_buf[3] & H5VL_FILEI_FEATURE_MASK & ~H5VL_FILEI_FEATURE_KNOWN) {
+        ERR_OUT ("File uses a metadata format feature not supported by this version")
+    }
     ndset = att_buf[0];
     // nldset = att_buf[1];
     nmdset = att_buf[2];
@@ -275,13 +327,10 @@ void h5lreplay_core (std::string &inpath, std::string &outpath, int rank, int np
 
                 // Read the metadata
                 h5lreplay_parse_meta (subrank, subnp, lgid, nmdset, copy_arg.dsets, reqs, config);
-
-                // Read the data
-                h5lreplay_read_data (fsub, copy_arg.dsets, reqs);
             }
 
-            // Write the data
-            h5lreplay_write_data (foutid, copy_arg.dsets, reqs);
+            // Read and write the data, processes without a subfile join the collective writes
+            h5lreplay_replay_data (MPI_COMM_WORLD, fsub, copy_arg.dsets, reqs, mlimit);
 
             if (i + subid < nsubfiles) {
                 // Close the subfile
@@ -303,10 +352,7 @@ void h5lreplay_core (std::string &inpath, std::string &outpath, int rank, int np
         // Read the metadata
         h5lreplay_parse_meta (rank, np, lgid, nmdset, copy_arg.dsets, reqs, config);
 
-        // Read the data
-        h5lreplay_read_data (fin, copy_arg.dsets, reqs);
-
-        // Write the data
-        h5lreplay_write_data (foutid, copy_arg.dsets, reqs);
+        // Read and write the data
+        h5lreplay_replay_data (MPI_COMM_WORLD, fin, copy_arg.dsets, reqs, mlimit);
     }
 }
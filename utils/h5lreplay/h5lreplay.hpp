@@ -19,4 +19,5 @@ typedef struct dset_info : H5VL_log_dset_info_t {
     hid_t id;
 } dset_info;
 
-void h5lreplay_core (std::string &inpath, std::string &outpath, int rank, int np);
+void h5lreplay_core (
+    std::string &inpath, std::string &outpath, int rank, int np, size_t mlimit);
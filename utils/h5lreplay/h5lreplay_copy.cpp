@@ -117,6 +117,7 @@ herr_t h5lreplay_copy_handler (hid_t o_id,
             dset.dtype = tid;
             dset.esize = H5Tget_size (tid);
             dset.ndim  = ndim;
+            for (int i = 0; i < ndim; i++) { dset.dims[i] = dims[i]; }
 
             // Record did for replaying data
             // Do not close dst_did
@@ -10,6 +10,8 @@
 //
 #include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -26,144 +28,738 @@
 #include "h5lreplay_data.hpp"
 #include "h5lreplay_meta.hpp"
 
-typedef struct hidx {
-    MPI_Aint foff;
-    MPI_Aint moff;
-    int len;
-    bool operator< (const struct hidx &rhs) const { return foff < rhs.foff; }
-} hidx;
+// Largest read issued at once, MPI counts are int
+#define H5LREPLAY_MAX_READ (1 << 30)
 
-void h5lreplay_read_data (MPI_File fin,
-                          std::vector<dset_info> &dsets,
-                          std::vector<h5lreplay_idx_t> &reqs) {
+// Round up to multiple of 8 bytes, pieces are packed 8 bytes aligned
+#define H5LREPLAY_PAD(A) (((A) + 7) & ~((size_t)7))
+
+// Part of a selection block going to the process owning that region of the dataset
+typedef struct h5lreplay_part_t {
+    int rank;                     // Process owning the part
+    size_t blk;                   // Entry in the window
+    size_t sel;                   // Selection block in the entry
+    hsize_t start[H5S_MAX_RANK];  // Start of the part
+    hsize_t count[H5S_MAX_RANK];  // Size of the part
+} h5lreplay_part_t;
+
+/*
+ * Copy the box (start, count) from the box buffer src covering (sstart, scount) into the box
+ * buffer dst covering (dstart, dcount)
+ */
+static void h5lreplay_copy_box (int ndim,
+                                size_t esize,
+                                hsize_t *start,
+                                hsize_t *count,
+                                char *src,
+                                hsize_t *sstart,
+                                hsize_t *scount,
+                                char *dst,
+                                hsize_t *dstart,
+                                hsize_t *dcount) {
+    int i;
+    hsize_t idx[H5S_MAX_RANK];  // Current row, relative to start
+    size_t soff, doff;          // Offset of the current row in src and dst, in elements
+    size_t len;                 // Size of a row
+
+    if (ndim == 0) {
+        memcpy (dst, src, esize);
+        return;
+    }
+    for (i = 0; i < ndim; i++) {
+        if (count[i] == 0) return;
+        idx[i] = 0;
+    }
+
+    len = count[ndim - 1] * esize;
+    while (true) {
+        soff = doff = 0;
+        for (i = 0; i < ndim; i++) {
+            soff = soff * scount[i] + (start[i] + idx[i] - sstart[i]);
+            doff = doff * dcount[i] + (start[i] + idx[i] - dstart[i]);
+        }
+        memcpy (dst + doff * esize, src + soff * esize, len);
+
+        // Move to the next row
+        for (i = ndim - 2; i >= 0; i--) {
+            if (++idx[i] < count[i]) break;
+            idx[i] = 0;
+        }
+        if (i < 0) break;
+    }
+}
+
+/*
+ * Pick the dimension the dataset is decomposed along and the extent each process owns
+ * The first dimension large enough to give every process a share is used, otherwise the largest
+ */
+static void h5lreplay_decomp (dset_info &dip, int np, int &kdim, hsize_t &rows) {
+    int i;
+
+    kdim = 0;
+    rows = 1;
+    if (dip.ndim == 0) return;
+
+    for (i = 0; i < (int)(dip.ndim); i++) {
+        if (dip.dims[i] >= (hsize_t)np) {
+            kdim = i;
+            break;
+        }
+        if (dip.dims[i] > dip.dims[kdim]) { kdim = i; }
+    }
+    rows = (dip.dims[kdim] + np - 1) / np;
+    if (rows == 0) { rows = 1; }
+}
+
+/*
+ * Split a selection block of an entry into the parts owned by each process
+ */
+static void h5lreplay_split (dset_info &dip,
+                             int np,
+                             int kdim,
+                             hsize_t rows,
+                             size_t blk,
+                             size_t sel,
+                             H5VL_logi_metasel_t &block,
+                             std::vector<h5lreplay_part_t> &parts) {
+    int i;
+    hsize_t lo, hi, end;
+    h5lreplay_part_t part;
+
+    part.blk = blk;
+    part.sel = sel;
+
+    if (dip.ndim == 0) {
+        part.rank = 0;
+        parts.push_back (part);
+        return;
+    }
+
+    for (i = 0; i < (int)(dip.ndim); i++) {
+        if (block.count[i] == 0) return;
+        part.start[i] = block.start[i];
+        part.count[i] = block.count[i];
+    }
+
+    lo        = block.start[kdim];
+    hi        = lo + block.count[kdim];
+    part.rank = (int)std::min (lo / rows, (hsize_t) (np - 1));
+    while (lo < hi) {
+        end = part.rank == np - 1 ? hi : std::min (hi, (hsize_t) (part.rank + 1) * rows);
+        part.start[kdim] = lo;
+        part.count[kdim] = end - lo;
+        parts.push_back (part);
+        lo = end;
+        part.rank++;
+    }
+}
+
+/*
+ * Size of a part in the exchange buffer, a header followed by the data padded to 8 bytes
+ */
+static size_t h5lreplay_part_size (dset_info &dip, h5lreplay_part_t &part) {
+    int i;
+    size_t msize = dip.esize;
+
+    for (i = 0; i < (int)(dip.ndim); i++) { msize *= part.count[i]; }
+    return sizeof (int64_t) + sizeof (uint64_t) + sizeof (hsize_t) * 2 * dip.ndim +
+           H5LREPLAY_PAD (msize);
+}
+
+/*
+ * Whether no process receives more than budget bytes in the exchange of the entries in ents[k:]
+ * ordered before end, dests and dsizes hold the parts of entry e in [eoff[e], eoff[e + 1])
+ * Collective over comm
+ */
+static bool h5lreplay_window_fits (MPI_Comm comm,
+                                   int np,
+                                   std::vector<meta_block *> &ents,
+                                   size_t k,
+                                   uint64_t end,
+                                   std::vector<size_t> &eoff,
+                                   std::vector<int> &dests,
+                                   std::vector<uint64_t> &dsizes,
+                                   size_t budget) {
+    int mpierr;
+    int i;
+    size_t e, j;
+    std::vector<uint64_t> rsize (np, 0);  // Size of data received by each process
+
+    for (e = k; e < ents.size () && ents[e]->seq < end; e++) {
+        for (j = eoff[e]; j < eoff[e + 1]; j++) { rsize[dests[j]] += dsizes[j]; }
+    }
+    mpierr = MPI_Allreduce (MPI_IN_PLACE, rsize.data (), np, MPI_UINT64_T, MPI_SUM, comm);
+    CHECK_MPIERR
+
+    for (i = 0; i < np; i++) {
+        if (rsize[i] > budget) return false;
+    }
+    return true;
+}
+
+/*
+ * Cut the entries of all processes into windows by their order in the file
+ * A window holds the entries whose order falls in a range agreed on by all processes, so every
+ * entry of a window precedes every entry of the next one and later windows overwrite earlier ones.
+ * The range is the largest one in which no process reads or sends more than budget bytes and no
+ * process receives more than budget bytes, or a single entry if none fits. All processes get the
+ * same number of windows, some may be empty.
+ */
+static void h5lreplay_window_cut (MPI_Comm comm,
+                                  std::vector<dset_info> &dsets,
+                                  std::vector<h5lreplay_idx_t> &reqs,
+                                  size_t budget,
+                                  std::vector<h5lreplay_window_t> &wins) {
     int mpierr;
     int i, j;
-    size_t bsize;   // Data buffer size of a req
-    size_t esize;   // Size of a sel block
-    size_t zbsize;  // Size of the decompression buffer
-    char *buf;
-    std::vector<MPI_Aint> foffs, moffs;
-    std::vector<int> lens;
-    std::vector<hidx> idxs;
-    MPI_Datatype ftype = MPI_DATATYPE_NULL;
-    MPI_Datatype mtype = MPI_DATATYPE_NULL;
-    MPI_Status stat;
-    H5VL_logi_err_finally finally ([&] () -> void {
-        if (ftype != MPI_DATATYPE_NULL) { MPI_Type_free (&ftype); }
-        if (mtype != MPI_DATATYPE_NULL) { MPI_Type_free (&mtype); }
-    });
+    int np;
+    size_t k, e;
+    size_t wsize;                         // Data size of this process in the window
+    uint64_t bnd[2];                      // Order of the first entry and the end of the window
+    uint64_t l, h, m;                     // Range of the window end being searched
+    std::vector<meta_block *> ents;       // Entries of this process in log order
+    std::vector<int> kdims;               // Dimension each dataset is decomposed along
+    std::vector<hsize_t> rows;            // Extent of each dataset owned by a process
+    std::vector<h5lreplay_part_t> parts;  // Parts of the current entry
+    std::vector<size_t> eoff;             // First part of each entry in dests and dsizes
+    std::vector<int> dests;               // Process each part goes to
+    std::vector<uint64_t> dsizes;         // Size of each part in the exchange
+    std::vector<uint64_t> esizes;         // Data size of each entry, read or sent
+
+    MPI_Comm_size (comm, &np);
+
+    kdims.resize (dsets.size ());
+    rows.resize (dsets.size ());
+    for (i = 0; i < (int)(dsets.size ()); i++) {
+        h5lreplay_decomp (dsets[i], np, kdims[i], rows[i]);
+    }
 
-    // Allocate buffer
-    zbsize = 0;
     for (auto &reqp : reqs) {
-        for (auto &req : reqp.entries) {
-            req.bufs.resize (req.sels.size ());
-            bsize = 0;
-            for (j = 0; j < (int)(req.sels.size ()); j++) {
-                esize = dsets[req.hdr.did].esize;
-                for (i = 0; i < (int)(dsets[req.hdr.did].ndim); i++) {
-                    esize *= req.sels[j].count[i];
+        for (auto &req : reqp.entries) { ents.push_back (&req); }
+    }
+    std::sort (ents.begin (), ents.end (),
+               [] (meta_block *a, meta_block *b) -> bool { return a->seq < b->seq; });
+
+    // Size of data each entry sends to each process
+    eoff.push_back (0);
+    for (auto b : ents) {
+        dset_info &dip = dsets[b->hdr.did];
+        uint64_t ssize = 0;
+
+        parts.clear ();
+        for (j = 0; j < (int)(b->sels.size ()); j++) {
+            h5lreplay_split (dip, np, kdims[b->hdr.did], rows[b->hdr.did], 0, j, b->sels[j],
+                             parts);
+        }
+        for (auto &part : parts) {
+            dests.push_back (part.rank);
+            dsizes.push_back (h5lreplay_part_size (dip, part));
+            ssize += dsizes.back ();
+        }
+        eoff.push_back (dests.size ());
+        esizes.push_back (std::max (ssize, (uint64_t) (b->hdr.fsize)));
+    }
+
+    k = 0;
+    while (true) {
+        // Largest range in which this process reads and sends at most budget bytes
+        wsize = 0;
+        for (e = k; e < ents.size () && (e == k || wsize + esizes[e] <= budget); e++) {
+            wsize += esizes[e];
+        }
+        bnd[0] = k < ents.size () ? ents[k]->seq : UINT64_MAX;
+        bnd[1] = e < ents.size () ? ents[e]->seq : UINT64_MAX;
+        mpierr = MPI_Allreduce (MPI_IN_PLACE, bnd, 2, MPI_UINT64_T, MPI_MIN, comm);
+        CHECK_MPIERR
+        if (bnd[0] == UINT64_MAX) break;  // No entry left on any process
+
+        // Shrink the range until no process receives more than budget bytes
+        if (!h5lreplay_window_fits (comm, np, ents, k, bnd[1], eoff, dests, dsizes, budget)) {
+            l = bnd[0] + 1;  // The first entry is always taken
+            h = bnd[1];
+            while (h - l > 1) {
+                m = l + (h - l) / 2;
+                if (h5lreplay_window_fits (comm, np, ents, k, m, eoff, dests, dsizes, budget)) {
+                    l = m;
+                } else {
+                    h = m;
                 }
-                req.bufs[j] = (char *)bsize;
-                bsize += esize;
             }
-            if (zbsize < bsize) { zbsize = bsize; }
-            // Compressed size can be larger
-            if (bsize < (size_t) (req.hdr.fsize)) { bsize = req.hdr.fsize; }
-            // Allocate buffer
-            buf = (char *)malloc (bsize);
-            assert (buf != NULL);
-            for (j = 0; j < (int)(req.sels.size ()); j++) {
-                req.bufs[j] = buf + (size_t)req.bufs[j];
+            bnd[1] = l;
+        }
+
+        wins.resize (wins.size () + 1);
+        for (; k < ents.size () && ents[k]->seq < bnd[1]; k++) {
+            wins.back ().blocks.push_back (ents[k]);
+        }
+    }
+}
+
+/*
+ * Issue nonblocking reads of the raw data of all entries in the window
+ * Entries are laid out in the window buffer in file offset order, so entries that are adjacent in
+ * the file are read with a single request
+ */
+static void h5lreplay_window_read (MPI_File fin, h5lreplay_window_t &win) {
+    int mpierr;
+    size_t i;
+    size_t bsize;               // Window buffer size
+    std::vector<size_t> order;  // Entries sorted by file offset
+    MPI_Offset roff = 0;        // File offset of the current read
+    size_t rlen     = 0;        // Size of the current read
+    char *rbuf      = NULL;     // Memory location of the current read
+    MPI_Request req;
+
+    order.resize (win.blocks.size ());
+    for (i = 0; i < order.size (); i++) { order[i] = i; }
+    std::sort (order.begin (), order.end (), [&win] (size_t a, size_t b) {
+        return win.blocks[a]->hdr.foff < win.blocks[b]->hdr.foff;
+    });
+
+    bsize = 0;
+    for (auto b : win.blocks) { bsize += b->hdr.fsize; }
+    win.buf = (char *)malloc (bsize ? bsize : 1);
+    CHECK_PTR (win.buf)
+
+    win.raws.resize (win.blocks.size ());
+    bsize = 0;
+    for (auto j : order) {
+        meta_block *b = win.blocks[j];
+
+        win.raws[j] = win.buf + bsize;
+        bsize += b->hdr.fsize;
+
+        // Extend the current read if the entry follows it in the file
+        if (rlen && roff + (MPI_Offset)rlen == b->hdr.foff &&
+            rlen + b->hdr.fsize <= H5LREPLAY_MAX_READ) {
+            rlen += b->hdr.fsize;
+            continue;
+        }
+        if (rlen) {
+            mpierr = MPI_File_iread_at (fin, roff, rbuf, (int)rlen, MPI_BYTE, &req);
+            CHECK_MPIERR
+            win.reqs.push_back (req);
+        }
+        roff = b->hdr.foff;
+        rlen = b->hdr.fsize;
+        rbuf = win.raws[j];
+    }
+    if (rlen) {
+        mpierr = MPI_File_iread_at (fin, roff, rbuf, (int)rlen, MPI_BYTE, &req);
+        CHECK_MPIERR
+        win.reqs.push_back (req);
+    }
+}
+
+/*
+ * Wait for the data of the window, unfilter it, and send each part of it to the process owning
+ * that region of the dataset
+ * Received pieces are returned in pieces, sorted by dataset and entry order, pointing into rbuf
+ */
+static void h5lreplay_window_exchange (MPI_Comm comm,
+                                       std::vector<dset_info> &dsets,
+                                       h5lreplay_window_t &win,
+                                       std::vector<h5lreplay_piece_t> &pieces,
+                                       char *&rbuf) {
+    int mpierr;
+    int i, j;
+    int np;
+    size_t k;
+    std::vector<int> kdims;               // Dimension each dataset is decomposed along
+    std::vector<hsize_t> rows;            // Extent of each dataset owned by a process
+    std::vector<h5lreplay_part_t> parts;  // Parts to send
+    std::vector<MPI_Offset> ssize;        // Size of data to each process
+    std::vector<int> scnt, sdsp, rcnt, rdsp;
+    std::vector<size_t> soff;   // Packing position for each process
+    std::vector<size_t> doffs;  // Offset of each selection block in the entry data
+    MPI_Offset rsize;           // Size of data received
+    char *sbuf = NULL;          // Packed parts
+    char *zbuf = NULL;          // Unfiltered data
+    char *data = NULL;          // Data of the current entry
+    char *ep;
+    size_t cur;  // Entry the data is unfiltered for
+    int zsize;
+    hsize_t msize;
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (sbuf) { free (sbuf); }
+        if (zbuf) { free (zbuf); }
+        if (win.buf) {
+            free (win.buf);
+            win.buf = NULL;
+        }
+    });
+
+    MPI_Comm_size (comm, &np);
+
+    if (win.reqs.size ()) {
+        mpierr = MPI_Waitall ((int)win.reqs.size (), win.reqs.data (), MPI_STATUSES_IGNORE);
+        CHECK_MPIERR
+        win.reqs.clear ();
+    }
+
+    // Decompose the datasets
+    kdims.resize (dsets.size ());
+    rows.resize (dsets.size ());
+    for (i = 0; i < (int)(dsets.size ()); i++) {
+        h5lreplay_decomp (dsets[i], np, kdims[i], rows[i]);
+    }
+
+    // Split selection blocks and count the size of data to each process
+    ssize.assign (np, 0);
+    for (k = 0; k < win.blocks.size (); k++) {
+        meta_block *b  = win.blocks[k];
+        dset_info &dip = dsets[b->hdr.did];
+        size_t first   = parts.size ();
+
+        for (j = 0; j < (int)(b->sels.size ()); j++) {
+            h5lreplay_split (dip, np, kdims[b->hdr.did], rows[b->hdr.did], k, j, b->sels[j],
+                             parts);
+        }
+        for (; first < parts.size (); first++) {
+            ssize[parts[first].rank] += h5lreplay_part_size (dip, parts[first]);
+        }
+    }
+
+    scnt.resize (np);
+    sdsp.resize (np);
+    soff.resize (np);
+    rcnt.resize (np);
+    rdsp.resize (np);
+    rsize = 0;
+    for (i = 0; i < np; i++) {
+        scnt[i] = (int)ssize[i];
+        sdsp[i] = (int)rsize;
+        soff[i] = rsize;
+        rsize += ssize[i];
+        if (rsize > INT_MAX) { ERR_OUT ("Data exchanged in a window exceeds 2 GiB") }
+    }
+
+    // Pack the parts
+    sbuf = (char *)malloc (rsize ? rsize : 1);
+    CHECK_PTR (sbuf)
+    cur = (size_t)-1;
+    for (auto &part : parts) {
+        meta_block *b          = win.blocks[part.blk];
+        dset_info &dip         = dsets[b->hdr.did];
+        H5VL_logi_metasel_t &s = b->sels[part.sel];
+
+        // Unfilter the entry and locate its selection blocks
+        if (part.blk != cur) {
+            cur  = part.blk;
+            data = win.raws[cur];
+            if (zbuf) {
+                free (zbuf);
+                zbuf = NULL;
+            }
+            if (dip.filters.size () > 0) {
+                zsize = 0;
+                H5VL_logi_unfilter (dip.filters, data, b->hdr.fsize, (void **)&zbuf, &zsize);
+                data = zbuf;
             }
+            doffs.resize (b->sels.size ());
+            msize = 0;
+            for (k = 0; k < b->sels.size (); k++) {
+                hsize_t n = dip.esize;
 
-            // Record off and len for mpi type
-            idxs.push_back ({req.hdr.foff, (MPI_Aint)req.bufs[0], (int)req.hdr.fsize});
+                for (i = 0; i < (int)(dip.ndim); i++) { n *= b->sels[k].count[i]; }
+                doffs[k] = msize;
+                msize += n;
+            }
         }
+
+        ep               = sbuf + soff[part.rank];
+        *((int64_t *)ep) = b->hdr.did;
+        ep += sizeof (int64_t);
+        *((uint64_t *)ep) = b->seq;
+        ep += sizeof (uint64_t);
+        memcpy (ep, part.start, sizeof (hsize_t) * dip.ndim);
+        ep += sizeof (hsize_t) * dip.ndim;
+        memcpy (ep, part.count, sizeof (hsize_t) * dip.ndim);
+        ep += sizeof (hsize_t) * dip.ndim;
+        h5lreplay_copy_box ((int)(dip.ndim), dip.esize, part.start, part.count,
+                            data + doffs[part.sel], s.start, s.count, ep, part.start, part.count);
+        msize = dip.esize;
+        for (i = 0; i < (int)(dip.ndim); i++) { msize *= part.count[i]; }
+        ep += H5LREPLAY_PAD (msize);
+        soff[part.rank] = ep - sbuf;
     }
-    // zbuf = (char *)malloc (zbsize);
 
-    // Read the data
-    foffs.reserve (idxs.size ());
-    moffs.reserve (idxs.size ());
-    lens.reserve (idxs.size ());
-    std::sort (idxs.begin (), idxs.end ());
-    for (auto &idx : idxs) {
-        foffs.push_back (idx.foff);
-        moffs.push_back (idx.moff);
-        lens.push_back (idx.len);
+    // The raw data is no longer needed
+    free (win.buf);
+    win.buf = NULL;
+    if (zbuf) {
+        free (zbuf);
+        zbuf = NULL;
     }
-    mpierr =
-        MPI_Type_create_hindexed (foffs.size (), lens.data (), foffs.data (), MPI_BYTE, &ftype);
-    CHECK_MPIERR
-    mpierr =
-        MPI_Type_create_hindexed (moffs.size (), lens.data (), moffs.data (), MPI_BYTE, &mtype);
-    CHECK_MPIERR
-    mpierr = MPI_Type_commit (&ftype);
-    CHECK_MPIERR
-    mpierr = MPI_Type_commit (&mtype);
-    CHECK_MPIERR
-    mpierr = MPI_File_set_view (fin, 0, MPI_BYTE, ftype, "native", MPI_INFO_NULL);
+
+    // Exchange
+    mpierr = MPI_Alltoall (scnt.data (), 1, MPI_INT, rcnt.data (), 1, MPI_INT, comm);
     CHECK_MPIERR
-    mpierr = MPI_File_read_all (fin, MPI_BOTTOM, 1, mtype, &stat);
+    rsize = 0;
+    for (i = 0; i < np; i++) {
+        rdsp[i] = (int)rsize;
+        rsize += rcnt[i];
+        if (rsize > INT_MAX) { ERR_OUT ("Data exchanged in a window exceeds 2 GiB") }
+    }
+    rbuf = (char *)malloc (rsize ? rsize : 1);
+    CHECK_PTR (rbuf)
+    mpierr = MPI_Alltoallv (sbuf, scnt.data (), sdsp.data (), MPI_BYTE, rbuf, rcnt.data (),
+                            rdsp.data (), MPI_BYTE, comm);
     CHECK_MPIERR
+    free (sbuf);
+    sbuf = NULL;
 
-    // Unfilter the data
-    for (auto &reqp : reqs) {
-        for (auto &req : reqp.entries) {
-            if (dsets[req.hdr.did].filters.size () > 0) {
-                char *buf = NULL;
-                int csize = 0;
+    // Unpack
+    ep = rbuf;
+    while (ep < rbuf + rsize) {
+        h5lreplay_piece_t piece;
 
-                H5VL_logi_unfilter (dsets[req.hdr.did].filters, req.bufs[0], req.hdr.fsize,
-                                    (void **)&buf, &csize);
+        piece.did = (int)(*((int64_t *)ep));
+        ep += sizeof (int64_t);
+        piece.seq = *((uint64_t *)ep);
+        ep += sizeof (uint64_t);
 
-                memcpy (buf, req.bufs[0], csize);
-            }
-        }
+        dset_info &dip = dsets[piece.did];
+        memcpy (piece.start, ep, sizeof (hsize_t) * dip.ndim);
+        ep += sizeof (hsize_t) * dip.ndim;
+        memcpy (piece.count, ep, sizeof (hsize_t) * dip.ndim);
+        ep += sizeof (hsize_t) * dip.ndim;
+        piece.buf = ep;
+        msize     = dip.esize;
+        for (i = 0; i < (int)(dip.ndim); i++) { msize *= piece.count[i]; }
+        ep += H5LREPLAY_PAD (msize);
+
+        pieces.push_back (piece);
     }
+    std::stable_sort (pieces.begin (), pieces.end (),
+                      [] (const h5lreplay_piece_t &a, const h5lreplay_piece_t &b) {
+                          return a.did < b.did || (a.did == b.did && a.seq < b.seq);
+                      });
 }
 
-void h5lreplay_write_data (hid_t foutid,
-                           std::vector<dset_info> &dsets,
-                           std::vector<h5lreplay_idx_t> &reqs) {
+/*
+ * Write a band of a dataset with one collective call
+ * Pieces in [pb, pe) are copied into the band buffer in entry order, so later entries overwrite
+ * earlier ones, and their union is written. An empty range joins the call with no selection.
+ */
+static void h5lreplay_write_band (dset_info &dip,
+                                  hid_t dxplid,
+                                  h5lreplay_piece_t *pb,
+                                  h5lreplay_piece_t *pe,
+                                  hsize_t *bstart,
+                                  hsize_t *bcount) {
     herr_t err = 0;
+    int i;
+    int ndim   = (int)(dip.ndim);
     hid_t dsid = -1;
     hid_t msid = -1;
-    hsize_t one[H5S_MAX_RANK];
-    hsize_t zero = 0;
-    hsize_t msize;
-    int i, j, k;
+    hsize_t start[H5S_MAX_RANK], count[H5S_MAX_RANK];
+    hsize_t mstart[H5S_MAX_RANK];
+    hsize_t bsize;
+    hsize_t one = 1;
+    char *buf   = NULL;
+    h5lreplay_piece_t *p;
     H5VL_logi_err_finally finally ([&] () -> void {
         if (dsid >= 0) { H5Sclose (dsid); }
         if (msid >= 0) { H5Sclose (msid); }
+        if (buf) { free (buf); }
     });
 
-    one[0] = INT_MAX;
-    msid   = H5Screate_simple (1, one, one);
+    dsid = H5Dget_space (dip.id);
+    CHECK_ID (dsid)
+    err = H5Sselect_none (dsid);
+    CHECK_ERR
 
-    for (i = 0; i < H5S_MAX_RANK; i++) { one[i] = 1; }
+    if (pb == pe) {
+        msid = H5Screate_simple (1, &one, &one);
+        CHECK_ID (msid)
+        err = H5Sselect_none (msid);
+        CHECK_ERR
+        err = H5Dwrite (dip.id, dip.dtype, msid, dsid, dxplid, &one);
+        CHECK_ERR
+        return;
+    }
 
-    for (i = 0; i < (int)(dsets.size ()); i++) {
-        dsid = H5Dget_space (dsets[i].id);
-        for (auto &req : reqs[i].entries) {
-            for (k = 0; k < (int)(req.sels.size ()); k++) {
-                msize = 1;
-                for (j = 0; j < (int)(dsets[req.hdr.did].ndim); j++) {
-                    msize *= req.sels[k].count[j];
-                }
-                err = H5Sselect_hyperslab (msid, H5S_SELECT_SET, &zero, NULL, one, &msize);
-                CHECK_ERR
-                if (dsets[i].ndim) {
-                    err = H5Sselect_hyperslab (dsid, H5S_SELECT_SET, req.sels[k].start, NULL, one,
-                                               req.sels[k].count);
-                    CHECK_ERR
-                }
-                err = H5Dwrite (dsets[i].id, dsets[i].dtype, msid, dsid, H5P_DEFAULT, req.bufs[k]);
-                CHECK_ERR
+    if (ndim == 0) {
+        msid = H5Screate (H5S_SCALAR);
+        CHECK_ID (msid)
+        err = H5Sselect_all (dsid);
+        CHECK_ERR
+        err = H5Dwrite (dip.id, dip.dtype, msid, dsid, dxplid, (pe - 1)->buf);
+        CHECK_ERR
+        return;
+    }
+
+    bsize = dip.esize;
+    for (i = 0; i < ndim; i++) { bsize *= bcount[i]; }
+    buf = (char *)malloc (bsize);
+    CHECK_PTR (buf)
+    msid = H5Screate_simple (ndim, bcount, bcount);
+    CHECK_ID (msid)
+    err = H5Sselect_none (msid);
+    CHECK_ERR
+
+    for (p = pb; p < pe; p++) {
+        // Clip the piece to the band
+        for (i = 0; i < ndim; i++) {
+            start[i] = std::max (p->start[i], bstart[i]);
+            if (start[i] >= std::min (p->start[i] + p->count[i], bstart[i] + bcount[i])) break;
+            count[i]  = std::min (p->start[i] + p->count[i], bstart[i] + bcount[i]) - start[i];
+            mstart[i] = start[i] - bstart[i];
+        }
+        if (i < ndim) continue;
+
+        h5lreplay_copy_box (ndim, dip.esize, start, count, p->buf, p->start, p->count, buf, bstart,
+                            bcount);
+        err = H5Sselect_hyperslab (dsid, H5S_SELECT_OR, start, NULL, count, NULL);
+        CHECK_ERR
+        err = H5Sselect_hyperslab (msid, H5S_SELECT_OR, mstart, NULL, count, NULL);
+        CHECK_ERR
+    }
+
+    err = H5Dwrite (dip.id, dip.dtype, msid, dsid, dxplid, buf);
+    CHECK_ERR
+}
+
+/*
+ * Write the data of the window to the output file
+ * Every dataset written in the window by any process is written with a few collective calls. Each
+ * process writes the region it owns, in bands of at most budget bytes.
+ */
+static void h5lreplay_window_write (MPI_Comm comm,
+                                    hid_t dxplid,
+                                    std::vector<dset_info> &dsets,
+                                    h5lreplay_window_t &win,
+                                    size_t budget) {
+    int mpierr;
+    int i, j, d;
+    size_t k;
+    int ndset = (int)(dsets.size ());
+    std::vector<h5lreplay_piece_t> pieces;  // Data received, sorted by dataset and entry order
+    std::vector<size_t> pidx;               // First piece of each dataset
+    std::vector<int> nband;                 // Number of bands of each dataset on this process
+    std::vector<int> gnband;                // Number of bands of each dataset on any process
+    std::vector<hsize_t> rpbs;              // Extent of a band of each dataset along dimension 0
+    std::vector<hsize_t> bstarts, bends;    // Bounding box of pieces of each dataset
+    hsize_t bstart[H5S_MAX_RANK], bcount[H5S_MAX_RANK];
+    hsize_t rowsize;
+    char *rbuf = NULL;  // Received data
+    H5VL_logi_err_finally finally ([&] () -> void {
+        if (rbuf) { free (rbuf); }
+    });
+
+    h5lreplay_window_exchange (comm, dsets, win, pieces, rbuf);
+    win.blocks.clear ();
+    win.raws.clear ();
+
+    // Bound the pieces of each dataset and cut the box into bands
+    pidx.assign (ndset + 1, 0);
+    nband.assign (ndset, 0);
+    gnband.resize (ndset);
+    rpbs.assign (ndset, 1);
+    bstarts.assign ((size_t)ndset * H5S_MAX_RANK, 0);
+    bends.assign ((size_t)ndset * H5S_MAX_RANK, 0);
+    for (auto &p : pieces) { pidx[p.did + 1]++; }
+    for (i = 0; i < ndset; i++) { pidx[i + 1] += pidx[i]; }
+    for (i = 0; i < ndset; i++) {
+        hsize_t *lo    = bstarts.data () + (size_t)i * H5S_MAX_RANK;
+        hsize_t *hi    = bends.data () + (size_t)i * H5S_MAX_RANK;
+        dset_info &dip = dsets[i];
+
+        if (pidx[i] == pidx[i + 1]) continue;
+        if (dip.ndim == 0) {
+            nband[i] = 1;
+            continue;
+        }
+
+        for (d = 0; d < (int)(dip.ndim); d++) {
+            lo[d] = pieces[pidx[i]].start[d];
+            hi[d] = lo[d] + pieces[pidx[i]].count[d];
+        }
+        for (k = pidx[i] + 1; k < pidx[i + 1]; k++) {
+            for (d = 0; d < (int)(dip.ndim); d++) {
+                lo[d] = std::min (lo[d], pieces[k].start[d]);
+                hi[d] = std::max (hi[d], pieces[k].start[d] + pieces[k].count[d]);
             }
         }
-        H5Sclose (dsid);
-        dsid = -1;
+
+        rowsize = dip.esize;
+        for (d = 1; d < (int)(dip.ndim); d++) { rowsize *= hi[d] - lo[d]; }
+        rpbs[i]  = std::max ((hsize_t)1, (hsize_t)budget / rowsize);
+        nband[i] = (int)((hi[0] - lo[0] + rpbs[i] - 1) / rpbs[i]);
+    }
+
+    // Every process joins the writes of every dataset written by any process
+    mpierr = MPI_Allreduce (nband.data (), gnband.data (), ndset, MPI_INT, MPI_MAX, comm);
+    CHECK_MPIERR
+
+    for (i = 0; i < ndset; i++) {
+        hsize_t *lo    = bstarts.data () + (size_t)i * H5S_MAX_RANK;
+        hsize_t *hi    = bends.data () + (size_t)i * H5S_MAX_RANK;
+        dset_info &dip = dsets[i];
+
+        for (j = 0; j < gnband[i]; j++) {
+            if (j >= nband[i]) {
+                h5lreplay_write_band (dip, dxplid, NULL, NULL, NULL, NULL);
+                continue;
+            }
+
+            for (d = 0; d < (int)(dip.ndim); d++) {
+                bstart[d] = lo[d];
+                bcount[d] = hi[d] - lo[d];
+            }
+            if (dip.ndim) {
+                bstart[0] = lo[0] + j * rpbs[i];
+                bcount[0] = std::min (rpbs[i], hi[0] - bstart[0]);
+            }
+            h5lreplay_write_band (dip, dxplid, pieces.data () + pidx[i],
+                                  pieces.data () + pidx[i + 1], bstart, bcount);
+        }
+    }
+}
+
+/*
+ * Replay all entries in reqs into the output file
+ * Entries are processed in windows in which no process reads, sends, or receives more than a
+ * quarter of mlimit bytes, leaving the rest for the next window and the write buffers. The data of
+ * the next window is read while the current window is exchanged and written. All processes in comm
+ * take part in every window.
+ */
+void h5lreplay_replay_data (MPI_Comm comm,
+                            MPI_File fin,
+                            std::vector<dset_info> &dsets,
+                            std::vector<h5lreplay_idx_t> &reqs,
+                            size_t mlimit) {
+    herr_t err = 0;
+    size_t i;
+    size_t budget;                         // Data size allowed in a window
+    std::vector<h5lreplay_window_t> wins;  // Windows of this process
+    hid_t dxplid = -1;
+    H5VL_logi_err_finally finally ([&] () -> void {
+        for (auto &w : wins) {
+            if (w.reqs.size ()) {
+                MPI_Waitall ((int)w.reqs.size (), w.reqs.data (), MPI_STATUSES_IGNORE);
+            }
+            if (w.buf) { free (w.buf); }
+        }
+        if (dxplid >= 0) { H5Pclose (dxplid); }
+    });
+
+    // MPI counts in the exchange are int
+    budget = std::min (std::max (mlimit / 4, (size_t)1), (size_t)INT_MAX);
+
+    // Cut the entries into windows
+    h5lreplay_window_cut (comm, dsets, reqs, budget, wins);
+
+    dxplid = H5Pcreate (H5P_DATASET_XFER);
+    CHECK_ID (dxplid)
+    err = H5Pset_dxpl_mpio (dxplid, H5FD_MPIO_COLLECTIVE);
+    CHECK_ERR
+
+    if (wins.size () > 0) { h5lreplay_window_read (fin, wins[0]); }
+    for (i = 0; i < wins.size (); i++) {
+        // Start reading the next window before writing the current one
+        if (i + 1 < wins.size ()) { h5lreplay_window_read (fin, wins[i + 1]); }
+        h5lreplay_window_write (comm, dxplid, dsets, wins[i], budget);
     }
 }
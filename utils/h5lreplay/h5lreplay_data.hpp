@@ -6,14 +6,32 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+//
 #include <mpi.h>
-
+//
 #include "h5lreplay_meta.hpp"
 
-void h5lreplay_read_data (MPI_File fin,
-                          std::vector<dset_info> &dsets,
-                          std::vector<h5lreplay_idx_t> &reqs);
+// Entries replayed together and the buffer holding their raw data
+typedef struct h5lreplay_window_t {
+    std::vector<meta_block *> blocks;  // Entries in log order
+    std::vector<char *> raws;          // Raw data of each entry in buf
+    char *buf = NULL;                  // Raw data of all entries, in file offset order
+    std::vector<MPI_Request> reqs;     // Pending reads
+} h5lreplay_window_t;
+
+// Part of an entry received by the process owning that region of the dataset
+typedef struct h5lreplay_piece_t {
+    int did;                      // Dataset ID
+    uint64_t seq;                 // Order of the entry, later entries overwrite earlier ones
+    hsize_t start[H5S_MAX_RANK];  // Start of the block
+    hsize_t count[H5S_MAX_RANK];  // Size of the block
+    char *buf;                    // Data of the block
+} h5lreplay_piece_t;
 
-void h5lreplay_write_data (hid_t foutid,
-                           std::vector<dset_info> &dsets,
-                           std::vector<h5lreplay_idx_t> &reqs);
+void h5lreplay_replay_data (MPI_Comm comm,
+                            MPI_File fin,
+                            std::vector<dset_info> &dsets,
+                            std::vector<h5lreplay_idx_t> &reqs,
+                            size_t mlimit);
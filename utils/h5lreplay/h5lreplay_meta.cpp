@@ -28,6 +28,9 @@
 #include "h5lreplay.hpp"
 #include "h5lreplay_meta.hpp"
 
+// Order of the j-th entry of a section in the i-th metadata dataset
+#define H5LREPLAY_SEQ(i, j) (((uint64_t) (i) << 32) | (uint64_t) (j))
+
 void h5lreplay_parse_meta (int rank,
                            int np,
                            hid_t lgid,
@@ -39,6 +42,8 @@ void h5lreplay_parse_meta (int rank,
     int i, j;
     hid_t did = -1;
     MPI_Offset nsec;
+    MPI_Offset decomp;  // Number of sections and flags
+    MPI_Offset esize;   // Size of decoded metadata entries
     hid_t dsid = -1, msid = -1;
     hsize_t start, count, one = 1;
     meta_sec sec;
@@ -47,6 +52,7 @@ void h5lreplay_parse_meta (int rank,
     char *zbuf = NULL;
     H5VL_logi_metaentry_t block;                                 // Buffer of decoded metadata entry
     std::map<char *, std::vector<H5VL_logi_metasel_t> > bcache;  // Cache for linked metadata entry
+    H5VL_logi_meta_dict_t dict;                                  // Selection dictionary
     H5VL_logi_err_finally finally ([&] () -> void {
         if (zbufalloc && zbuf) { free (zbuf); }
         if (did >= 0) { H5Dclose (did); }
@@ -58,6 +64,9 @@ void h5lreplay_parse_meta (int rank,
     start = count = INT64_MAX - 1;
     msid          = H5Screate_simple (1, &start, &count);
 
+    // Selections referred by the metadata entries
+    H5VL_logi_meta_dict_read (lgid, nmdset, dict);
+
     // Read the metadata
     for (i = 0; i < nmdset; i++) {
         char mdname[16];
@@ -76,8 +85,10 @@ void h5lreplay_parse_meta (int rank,
         CHECK_ERR
         err = H5Sselect_hyperslab (msid, H5S_SELECT_SET, &start, NULL, &one, &count);
         CHECK_ERR
-        err = H5Dread (did, H5T_NATIVE_B8, msid, dsid, H5P_DEFAULT, &nsec);
+        err = H5Dread (did, H5T_NATIVE_B8, msid, dsid, H5P_DEFAULT, &decomp);
         CHECK_ERR
+        nsec = decomp & H5VL_LOGI_META_DECOMP_NSEC_MASK;
+        if (decomp & ~H5VL_LOGI_META_DECOMP_KNOWN) { ERR_OUT ("Unknown metadata format") }
 
         if (nsec > 0) {
             // Dividing jobs
@@ -95,7 +106,7 @@ void h5lreplay_parse_meta (int rank,
             CHECK_ERR
             if (start == 0) {  // For processes that start in the first section, the start offset is
                                // right after the end of the decomposition map
-                sec.start = sizeof (MPI_Offset) * (nsec + 1);
+                sec.start = H5VL_logi_meta_sec_begin (decomp);
             }
             // Ending section
             if (nsec >= np) {  // More section than processes, likely
@@ -145,6 +156,14 @@ void h5lreplay_parse_meta (int rank,
             H5Dclose (did);
             did = -1;
 
+            // Inflate, unpack and expand the sections
+            ep = H5VL_logi_meta_sec_decode (decomp, dict, sec.buf, count, &esize);
+            if (ep) {
+                free (sec.buf);
+                sec.buf = ep;
+                count   = esize;
+            }
+
             // Parse the metadata
             ep = sec.buf;
             if (config &
@@ -172,7 +191,7 @@ void h5lreplay_parse_meta (int rank,
                     // Only insert to index if we are responsible to the entry
                     if ((j - sec.off) % sec.stride == 0) {
                         // Insert to the index
-                        reqs[hdr->did].insert (block);
+                        reqs[hdr->did].insert (block, H5LREPLAY_SEQ (i, j));
                     }
                 }
 
@@ -186,7 +205,7 @@ void h5lreplay_parse_meta (int rank,
                         ep += hdr->meta_size;
 
                         // Insert to the index
-                        reqs[hdr->did].insert (block);
+                        reqs[hdr->did].insert (block, H5LREPLAY_SEQ (i, j));
                     }
                 }
             }
@@ -200,12 +219,15 @@ void h5lreplay_idx_t::clear () { this->entries.clear (); }
 
 void h5lreplay_idx_t::reserve (size_t size) {}
 
-void h5lreplay_idx_t::insert (H5VL_logi_metaentry_t &meta) {
+void h5lreplay_idx_t::insert (H5VL_logi_metaentry_t &meta) { this->insert (meta, 0); }
+
+void h5lreplay_idx_t::insert (H5VL_logi_metaentry_t &meta, uint64_t seq) {
     meta_block block;
 
     block.dsize = meta.dsize;
     block.hdr   = meta.hdr;
     block.sels  = meta.sels;
+    block.seq   = seq;
     this->entries.push_back (block);
 }
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 //
 #include <hdf5.h>
@@ -23,6 +24,7 @@ typedef struct meta_sec {
 
 typedef struct meta_block : H5VL_logi_metaentry_t {
     std::vector<char *> bufs;
+    uint64_t seq;  // Order of the entry in the file, metadata dataset then position in it
 } meta_block;
 
 class h5lreplay_idx_t : public H5VL_logi_idx_t {
@@ -33,6 +35,7 @@ class h5lreplay_idx_t : public H5VL_logi_idx_t {
     void clear ();                              // Remove all entries
     void reserve (size_t size);                 // Make space for at least size datasets
     void insert (H5VL_logi_metaentry_t &meta);  // Add an entry
+    void insert (H5VL_logi_metaentry_t &meta, uint64_t seq);  // Add an entry with its order
     void parse_block (char *block,
                       size_t size);  // Parse a block of encoded metadata and insert all entries
     void search (H5VL_log_rreq_t *req,
@@ -59,4 +59,17 @@ if test "x$H5DIFF" != x ; then
    fi
 fi
 
+# replay again with a memory limit small enough to split the data into many windows
+${TESTSEQRUN} ./${H5LREPLAY} -i ${TESTOUTDIR}/${outfile}.h5l -o ${TESTOUTDIR}/${outfile}.h5w --memory-limit 1k
+
+if test "x$H5DIFF" != x ; then
+   ${TESTSEQRUN} ${H5DIFF} ${TESTOUTDIR}/${outfile}.h5 ${TESTOUTDIR}/${outfile}.h5w
+   if test "x$?" != x0 ; then
+      echo "Error: ${outfile}.h5w differs from ${outfile}.h5"
+      exit 1
+   else
+      echo "Success: ${outfile}.h5w and ${outfile}.h5 are the same"
+   fi
+fi
+
 exit 0